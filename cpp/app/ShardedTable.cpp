@@ -0,0 +1,178 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A table split by the key into multiple shards, each owned by its own thread.
+
+#include <app/ShardedTable.h>
+#include <table/Table.h>
+#include <common/StringUtil.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+// Executes the lookups in a shard's table.
+class ShardLookupLabel : public Label
+{
+public:
+	ShardLookupLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name,
+			Table *table, Label *dest) :
+		Label(unit, rtype, name),
+		table_(table),
+		dest_(dest)
+	{ }
+
+protected:
+	// from Label
+	virtual void execute(Rowop *arg) const
+	{
+		RowHandle *rh = table_->findRow(arg->getRow());
+		if (rh != NULL)
+			unit_->call(new Rowop(dest_, Rowop::OP_INSERT, rh->getRow()));
+		else
+			unit_->call(new Rowop(dest_, Rowop::OP_NOP, arg->getRow()));
+	}
+
+	virtual void clearSubclass()
+	{
+		table_ = NULL;
+		dest_ = NULL;
+	}
+
+	Autoref<Table> table_;
+	Autoref<Label> dest_;
+};
+
+///////////////////////////////////////////////////////////////////////////
+
+ShardedTable::RouteLabel::RouteLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name,
+		ShardedTable *st, const string &lname) :
+	Label(unit, rtype, name),
+	st_(st)
+{
+	for (FacetVec::iterator it = st->inputs_.begin(); it != st->inputs_.end(); ++it)
+		dest_.push_back((*it)->getFnReturn()->getLabel(lname));
+}
+
+void ShardedTable::RouteLabel::execute(Rowop *arg) const
+{
+	if (st_ == NULL)
+		throw Exception::f("Can not send more input to a destroyed sharded table");
+	unit_->call(dest_[st_->shardOf(arg->getRow())]->adopt(arg));
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+ShardedTable::ShardThread::ShardThread(const string &tname, const string &ownerName,
+		const string &inName, const string &outName, TableType *tt) :
+	BasicPthread(tname),
+	ownerName_(ownerName),
+	inName_(inName),
+	outName_(outName),
+	tableType_(tt)
+{ }
+
+void ShardedTable::ShardThread::execute(TrieadOwner *to)
+{
+	// the nexuses were created before this thread has started
+	Autoref<Facet> in = to->importReaderImmed(ownerName_, inName_);
+	Autoref<Facet> out = to->importWriterImmed(ownerName_, outName_);
+	Unit *unit = to->unit();
+
+	Autoref<Table> table = tableType_->makeTable(unit, "table");
+	in->getFnReturn()->getLabel("in")->chain(table->getInputLabel());
+	table->getLabel()->chain(out->getFnReturn()->getLabel("out"));
+	Autoref<Label> lookup = new ShardLookupLabel(unit, table->getRowType(), "lookup",
+		table, out->getFnReturn()->getLabel("lookup"));
+	in->getFnReturn()->getLabel("lookup")->chain(lookup);
+
+	to->readyReady();
+	to->mainLoop();
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+ShardedTable::ShardedTable(TrieadOwner *owner, const string &name, Onceref<TableType> tt,
+		Onceref<NameSet> key, int nshards, bool importOutput) :
+	name_(name),
+	tableType_(tt)
+{
+	if (!tableType_->isInitialized())
+		throw Exception::fTrace("The sharded table '%s' requires an initialized table type.", name.c_str());
+	if (nshards < 1)
+		throw Exception::fTrace("The sharded table '%s' requires at least 1 shard, got %d.", name.c_str(), nshards);
+
+	rowType_ = tableType_->rowType();
+	Autoref<NameSet> keyref = key;
+	if (keyref->empty())
+		throw Exception::fTrace("The sharded table '%s' requires at least one key field.", name.c_str());
+	for (NameSet::iterator it = keyref->begin(); it != keyref->end(); ++it) {
+		int idx = rowType_->findIdx(*it);
+		if (idx < 0)
+			throw Exception::fTrace("The sharded table '%s' can not find the key field '%s' in the row type:\n%s",
+				name.c_str(), it->c_str(), rowType_->print("  ").c_str());
+		keyIdx_.push_back(idx);
+	}
+
+	for (int i = 0; i < nshards; i++) {
+		inputs_.push_back(owner->makeNexusWriter(strprintf("%s.in%d", name.c_str(), i))
+			->addLabel("in", rowType_)
+			->addLabel("lookup", rowType_)
+			->complete()
+		);
+	}
+	if (importOutput) {
+		output_ = owner->makeNexusReader(getOutputNexusName())
+			->addLabel("out", rowType_)
+			->addLabel("lookup", rowType_)
+			->setReverse()
+			->complete()
+		;
+	} else {
+		owner->makeNexusNoImport(getOutputNexusName())
+			->addLabel("out", rowType_)
+			->addLabel("lookup", rowType_)
+			->complete()
+		;
+	}
+
+	Unit *unit = owner->unit();
+	inputLabel_ = new RouteLabel(unit, rowType_, name + ".in", this, "in");
+	lookupLabel_ = new RouteLabel(unit, rowType_, name + ".lookup", this, "lookup");
+
+	const string &ownerName = owner->get()->getName();
+	for (int i = 0; i < nshards; i++) {
+		Autoref<ShardThread> th = new ShardThread(strprintf("%s.shard%d", name.c_str(), i),
+			ownerName, strprintf("%s.in%d", name.c_str(), i), getOutputNexusName(), tableType_);
+		th->start(owner->app());
+	}
+}
+
+ShardedTable::~ShardedTable()
+{
+	inputLabel_->reset();
+	lookupLabel_->reset();
+}
+
+Label *ShardedTable::getOutputLabel() const
+{
+	if (output_.isNull())
+		return NULL;
+	return output_->getFnReturn()->getLabel("out");
+}
+
+Label *ShardedTable::getLookupResultLabel() const
+{
+	if (output_.isNull())
+		return NULL;
+	return output_->getFnReturn()->getLabel("lookup");
+}
+
+int ShardedTable::shardOf(const Row *row) const
+{
+	return (int)(rowType_->hashFields(row, keyIdx_) % inputs_.size());
+}
+
+}; // TRICEPS_NS
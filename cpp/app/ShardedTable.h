@@ -0,0 +1,179 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A table split by the key into multiple shards, each owned by its own thread.
+
+#ifndef __Triceps_ShardedTable_h__
+#define __Triceps_ShardedTable_h__
+
+#include <app/BasicPthread.h>
+#include <type/TableType.h>
+#include <type/NameSet.h>
+
+namespace TRICEPS_NS {
+
+// The ShardedTable builds the usual fan-out/fan-in topology around
+// the copies of a table: the rows are split by the hash of the key fields
+// between N shards, each shard is a Table in its own thread, and the
+// output of all the shards is merged back into one nexus.
+//
+// It gets created by the thread that will feed it (the "owner" thread),
+// before that thread becomes ready. In this thread it creates:
+//   * the nexuses <name>.in<N>, one per shard, imported for writing,
+//     with the labels "in" (the data for the table) and "lookup"
+//     (the lookup requests);
+//   * the nexus <name>.out with the labels "out" (the output of the tables)
+//     and "lookup" (the lookup results), written by all the shards;
+//   * the input label and the lookup label that route the rowops by the key
+//     to the right shard.
+// Then it starts the shard threads <name>.shard<N> that import these
+// nexuses and own the tables.
+//
+// The output nexus can be either imported by the owner thread for reading
+// (it's then marked as reverse, since it forms a loop with the input
+// nexuses), and its labels become available through getOutputLabel()
+// and getLookupResultLabel(); or it can be left for the other threads
+// to import as "<owner>/<name>.out".
+//
+// The rowops for the same key always go to the same shard, and
+// the output of each shard comes in the same order as its input.
+// The output of the different shards is interleaved in an arbitrary order.
+// The key fields must contain the key of the table's indexes (or its
+// part), so that all the rows that might replace each other get into the
+// same shard.
+//
+// The lookups are asynchronous: the row sent to the lookup label gets
+// routed to the owning shard, which sends the found row with OP_INSERT,
+// or the request row with OP_NOP if nothing is found, to the "lookup"
+// label of the output nexus.
+//
+// As usual with the nexuses, the data written by the owner thread gets
+// sent to the shards when the owner thread flushes its writers (which
+// the main loop does after each processed Xtray).
+class ShardedTable : public Starget
+{
+public:
+	// The constructor creates the nexuses and starts the threads.
+	// Throws an Exception on errors.
+	//
+	// @param owner - the owner thread, must not be ready yet
+	// @param name - the base name for the nexuses and threads
+	// @param tt - the type of the tables, must be initialized
+	// @param key - names of the key fields that determine the shard
+	// @param nshards - number of shards, must be at least 1
+	// @param importOutput - flag: import the output nexus into the
+	//        owner thread (as a reverse nexus)
+	ShardedTable(TrieadOwner *owner, const string &name, Onceref<TableType> tt,
+		Onceref<NameSet> key, int nshards, bool importOutput = true);
+	~ShardedTable();
+
+	const string &getName() const
+	{
+		return name_;
+	}
+
+	int getShardCount() const
+	{
+		return (int)inputs_.size();
+	}
+
+	TableType *getTableType() const
+	{
+		return tableType_;
+	}
+
+	// Get the label that routes the data into the shard tables.
+	Label *getInputLabel() const
+	{
+		return inputLabel_;
+	}
+
+	// Get the label that routes the lookup requests to the shards.
+	Label *getLookupLabel() const
+	{
+		return lookupLabel_;
+	}
+
+	// Get the label with the merged output of the shard tables,
+	// NULL if the output was not imported.
+	Label *getOutputLabel() const;
+
+	// Get the label with the merged lookup results,
+	// NULL if the output was not imported.
+	Label *getLookupResultLabel() const;
+
+	// Get the name of the output nexus, for import by the other threads.
+	string getOutputNexusName() const
+	{
+		return name_ + ".out";
+	}
+
+	// Compute the shard where a row belongs.
+	// @param row - the row, of the table's row type
+	// @return - the index of the shard
+	int shardOf(const Row *row) const;
+
+protected:
+	// Routes the incoming rowops to the label of the same name
+	// in the shard's nexus.
+	class RouteLabel : public Label
+	{
+		friend class ShardedTable;
+	public:
+		// @param lname - name of the destination label in the shard's nexus
+		RouteLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name,
+			ShardedTable *st, const string &lname);
+
+	protected:
+		// from Label
+		virtual void execute(Rowop *arg) const;
+
+		// when the ShardedTable gets destroyed, it resets this back-link
+		void reset()
+		{
+			st_ = NULL;
+		}
+
+		ShardedTable *st_;
+		vector<Label *> dest_; // destination labels by shard
+	};
+
+	// The thread that owns one shard.
+	class ShardThread : public BasicPthread
+	{
+	public:
+		ShardThread(const string &tname, const string &ownerName, const string &inName,
+			const string &outName, TableType *tt);
+
+		// from BasicPthread
+		virtual void execute(TrieadOwner *to);
+
+	protected:
+		string ownerName_; // name of the owner thread
+		string inName_; // name of the input nexus
+		string outName_; // name of the output nexus
+		Autoref<TableType> tableType_;
+	};
+
+	typedef vector<Autoref<Facet> > FacetVec;
+
+	string name_;
+	Autoref<TableType> tableType_;
+	const_Autoref<RowType> rowType_;
+	vector<int> keyIdx_; // indexes of the key fields
+	FacetVec inputs_; // the writer facets of the shards' inputs
+	Autoref<Facet> output_; // the reader facet of the output, may be NULL
+	Autoref<RouteLabel> inputLabel_;
+	Autoref<RouteLabel> lookupLabel_;
+
+private:
+	ShardedTable(const ShardedTable &);
+	void operator=(const ShardedTable &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_ShardedTable_h__
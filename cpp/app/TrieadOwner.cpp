@@ -198,6 +198,7 @@ bool TrieadOwner::nextXtray(bool wait, const struct timespec &abstime)
 				rhi.popread();
 				if (filled)
 					triead_->qev_->reset();
+				stepCursors();
 				flushWriters();
 				return true;
 			}
@@ -220,6 +221,13 @@ bool TrieadOwner::nextXtray(bool wait, const struct timespec &abstime)
 			rlo.popread();
 			if (filled)
 				triead_->qev_->reset();
+			stepCursors();
+			flushWriters();
+			return true;
+		}
+
+		// no more input, use the time for the background dumps
+		if (stepCursors()) {
 			flushWriters();
 			return true;
 		}
@@ -262,6 +270,14 @@ void TrieadOwner::mainLoop()
 		{ }
 }
 
+Rowop *TrieadOwner::makeXtrayRowop(Label *lab, const Xtray::Op &op)
+{
+	if (op.oldRow_ == NULL)
+		return new Rowop(lab, op.opcode_, op.row_);
+	else
+		return Rowop::makeWithOldRow(lab, op.opcode_, op.row_, op.oldRow_);
+}
+
 void TrieadOwner::processXtray(Xtray *xt, Facet *facet)
 {
 	if (xt->empty()) // should never happen
@@ -283,10 +299,19 @@ void TrieadOwner::processXtray(Xtray *xt, Facet *facet)
 			}
 		}
 	}
-	for (int i = 0; i < sz; i++) {
-		const Xtray::Op &op = xt->at(i);
-		mainUnit_->call(new Rowop(
-			fret->getLabel(op.idx_), op.opcode_, op.row_));
+	for (int i = 0; i < sz; ) {
+		int idx = xt->at(i).idx_;
+		Label *lab = fret->getLabel(idx);
+		if (lab->isBatching() && i + 1 < sz && xt->at(i + 1).idx_ == idx) {
+			// the consecutive rowops for a batching label go together
+			Autoref<Tray> tray = new Tray;
+			for (; i < sz && xt->at(i).idx_ == idx; i++)
+				tray->push_back(makeXtrayRowop(lab, xt->at(i)));
+			mainUnit_->callTray(tray);
+		} else {
+			mainUnit_->call(makeXtrayRowop(lab, xt->at(i)));
+			i++;
+		}
 		drainUnits();
 	}
 
@@ -305,6 +330,25 @@ void TrieadOwner::processXtray(Xtray *xt, Facet *facet)
 	}
 }
 
+bool TrieadOwner::stepCursors()
+{
+	if (cursors_.empty())
+		return false;
+
+	for (size_t i = 0; i < cursors_.size(); i++) {
+		cursors_[i].cursor_->step(cursors_[i].chunk_);
+		drainUnits();
+	}
+	// forget the cursors that are done
+	size_t j = 0;
+	for (size_t i = 0; i < cursors_.size(); i++) {
+		if (!cursors_[i].cursor_->isDone())
+			cursors_[j++] = cursors_[i];
+	}
+	cursors_.resize(j, CursorStep(NULL, 0));
+	return true;
+}
+
 void TrieadOwner::drainUnits()
 {
 	// an optimization for the frequent case
@@ -13,6 +13,7 @@
 #include <app/App.h>
 #include <app/Facet.h>
 #include <app/FileInterrupt.h>
+#include <table/DumpCursor.h>
 
 namespace TRICEPS_NS {
 
@@ -465,6 +466,26 @@ public:
 	// the thread as dead.
 	void mainLoop();
 
+	// Add a dump cursor to be driven by nextXtray() in the background:
+	// after each processed Xtray, and when the input queues are empty,
+	// every added cursor sends the next portion of its table, until it's done.
+	// This lets a large dump interleave with the live processing.
+	// The cursor's table must belong to one of this thread's units.
+	// When the cursor is done, it gets forgotten by the TrieadOwner.
+	//
+	// @param cursor - the cursor to drive
+	// @param chunk - the number of rows sent in each step
+	void addDumpCursor(DumpCursor *cursor, size_t chunk)
+	{
+		cursors_.push_back(CursorStep(cursor, chunk));
+	}
+
+	// Get the number of the dump cursors still being driven.
+	size_t dumpCursorCount() const
+	{
+		return cursors_.size();
+	}
+
 	// Check if the drain is currently requested.
 	// It allows the thread code to stop generating the data
 	// out of nowhere when the drain is requested.
@@ -533,14 +554,27 @@ protected:
 
 	// Convert the Xtray entries to Rowops and run them through the
 	// Facet's FnReturn. The Xtray must match the Facet.
+	// The consecutive rowops for a batching label of the FnReturn
+	// (see Label::setBatching()) get called together as a tray.
 	//
 	// May propagate an Exception.
 	void processXtray(Xtray *xt, Facet *facet);
 
+	// Convert an Xtray entry to a Rowop.
+	// @param lab - label of the FnReturn for the entry
+	// @param op - the entry
+	// @return - the new Rowop
+	static Rowop *makeXtrayRowop(Label *lab, const Xtray::Op &op);
+
 	// Drain any scheduled rowops from all the units. Done after
-	// executing every rowop from Xtray.
+	// executing every rowop (or a batch of rowops) from Xtray.
 	void drainUnits();
 
+	// Do one step of all the background dump cursors and drain the units.
+	// May propagate an Exception.
+	// @return - true if there were any cursors to step
+	bool stepCursors();
+
 	// Get the QueEvent.
 	QueEvent *queEvent()
 	{
@@ -556,6 +590,20 @@ protected:
 	bool appReady_; // waited for App to be ready, permits the processing
 	bool busy_; // flag: processing an Xtray
 
+	// a dump cursor driven in the background
+	struct CursorStep
+	{
+		CursorStep(DumpCursor *cursor, size_t chunk) :
+			cursor_(cursor),
+			chunk_(chunk)
+		{ }
+
+		Autoref<DumpCursor> cursor_;
+		size_t chunk_; // rows per step
+	};
+	typedef vector<CursorStep> CursorStepVec;
+	CursorStepVec cursors_; // the dump cursors driven in the background
+
 private:
 	TrieadOwner();
 	TrieadOwner(const TrieadOwner &);
@@ -26,15 +26,23 @@ Xtray::~Xtray()
 			if (row->decref() <= 0) // manual reference keeping
 				type_->getRowType(it->idx_)->destroyRow(row);
 		}
+		row = it->oldRow_;
+		if (row) {
+			if (row->decref() <= 0)
+				type_->getRowType(it->idx_)->destroyRow(row);
+		}
 	}
 }
 
 void Xtray::push_back(const Op &data)
 {
 	Row *row = data.row_;
+	Row *oldRow = data.oldRow_;
 	ops_.push_back(data);
 	if (row)
 		row->incref(); // manual reference keeping
+	if (oldRow)
+		oldRow->incref();
 }
 
 }; // TRICEPS_NS
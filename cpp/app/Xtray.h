@@ -42,14 +42,17 @@ public:
 	class Op
 	{
 	public:
-		// The constructor silently strips the const-ness of the row.
-		Op(int idx, const Row *row, Rowop::Opcode op):
+		// The constructor silently strips the const-ness of the rows.
+		// @param oldRow - the old row of an OP_UPDATE, NULL for the other opcodes
+		Op(int idx, const Row *row, Rowop::Opcode op, const Row *oldRow = NULL):
 			row_(const_cast<Row *>(row)),
+			oldRow_(const_cast<Row *>(oldRow)),
 			idx_(idx),
 			opcode_(op)
 		{ }
 
 		Row *row_; // will be referenced manually when Op is inserted into Xtray
+		Row *oldRow_; // the old row of an OP_UPDATE, referenced like row_
 		int idx_; // index of this row's type in the nexus type; -1 has a special meaning:
 			// the boundary between multiple transactions clumped into one Xtray,
 			// in this case row_ must be NULL
@@ -83,9 +86,10 @@ public:
 	// @param idx - index of the row type in the row set
 	// @param row - row of this type
 	// @param opcode - opcode of the rowop
-	void push_back(int idx, const Row *row, Rowop::Opcode opcode)
+	// @param oldRow - the old row of an OP_UPDATE, NULL for the other opcodes
+	void push_back(int idx, const Row *row, Rowop::Opcode opcode, const Row *oldRow = NULL)
 	{
-		push_back(Op(idx, row, opcode));
+		push_back(Op(idx, row, opcode, oldRow));
 	}
 
 	// Get an op at the index.
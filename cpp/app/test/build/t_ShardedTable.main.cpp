@@ -0,0 +1,16 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase sharded;
+	driver.addcase(sharded, "sharded");
+
+	extern Utest::Testcase sharded_errors;
+	driver.addcase(sharded_errors, "sharded_errors");
+
+	return driver.run();
+}
@@ -2279,3 +2279,89 @@ UTESTCASE pass_begin_end(Utest *utest)
 
 	restore_uncatchable();
 }
+
+// The dump cursors driven by nextXtray().
+UTESTCASE dump_cursor(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<App> a1 = App::make("a1");
+	a1->setTimeout(0); // will replace all waits with an Exception
+	Autoref<TrieadOwner> ow1 = a1->makeTriead("t1");
+	Autoref<TrieadOwner> ow2 = a1->makeTriead("t2");
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	FdataVec dv;
+	mkfdata(dv);
+	int32_t val = 2;
+	dv[1].setPtr(true, &val, sizeof(val));
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	Autoref<Unit> unit1 = ow1->unit();
+	Autoref<Unit> unit2 = ow2->unit();
+
+	Autoref<Facet> fa1a = ow1->makeNexusWriter("nxa")
+		->addLabel("one", rt1)
+		->complete()
+	;
+	ow1->markReady();
+
+	Autoref<Facet> fa2a = ow2->importReader("t1", "nxa", "");
+	ow2->markReady();
+
+	// a table in t2 with 10 rows, to be dumped by 3
+	Autoref<TableType> tt = initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("fifo", FifoIndexType::make())
+	);
+	Autoref<Table> t2 = tt->makeTable(unit2, "tab");
+	for (int i = 0; i < 10; i++)
+		t2->insertRow(r1);
+	Autoref<Unit::StringNameTracer> trace2 = new Unit::StringNameTracer;
+	unit2->setTracer(trace2);
+	Autoref<Label> dumpDest = new DummyLabel(unit2, rt1, "dumpDest");
+	t2->getDumpLabel()->chain(dumpDest);
+
+	ow1->readyReady();
+	ow2->readyReady();
+
+	Autoref<DumpCursor> cur = new DumpCursor(t2);
+	ow2->addDumpCursor(cur, 3);
+	UT_IS(ow2->dumpCursorCount(), 1);
+
+	// a step after each Xtray
+	unit1->call(new Rowop(fa1a->getFnReturn()->getLabel("one"), Rowop::OP_INSERT, r1));
+	ow1->flushWriters();
+	UT_ASSERT(ow2->nextXtray());
+	UT_IS(cur->getSent(), 3);
+	string tlog = trace2->getBuffer()->print();
+	trace2->clearBuffer();
+	UT_IS(tlog,
+		"unit 't2' before label 'nxa.one' op OP_INSERT\n"
+		"unit 't2' before label 'tab.dump' op OP_INSERT\n"
+		"unit 't2' before label 'dumpDest' (chain 'tab.dump') op OP_INSERT\n"
+		"unit 't2' before label 'tab.dump' op OP_INSERT\n"
+		"unit 't2' before label 'dumpDest' (chain 'tab.dump') op OP_INSERT\n"
+		"unit 't2' before label 'tab.dump' op OP_INSERT\n"
+		"unit 't2' before label 'dumpDest' (chain 'tab.dump') op OP_INSERT\n"
+	);
+
+	// and when there is no more input
+	UT_ASSERT(ow2->nextXtray(false));
+	UT_IS(cur->getSent(), 6);
+	UT_ASSERT(ow2->nextXtray(false));
+	UT_ASSERT(ow2->nextXtray(false));
+	UT_IS(cur->getSent(), 10);
+	UT_ASSERT(cur->isDone());
+	UT_IS(ow2->dumpCursorCount(), 0);
+	UT_ASSERT(!ow2->nextXtray(false));
+
+	// clean-up, since the apps catalog is global
+	ow1->markDead();
+	ow2->markDead();
+	a1->harvester();
+
+	restore_uncatchable();
+}
@@ -0,0 +1,173 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the table sharded between the threads.
+
+#include <assert.h>
+#include <utest/Utest.h>
+#include <type/AllTypes.h>
+#include <app/ShardedTable.h>
+#include <table/Table.h>
+#include "AppTest.h"
+
+// collects the output by shard and key
+class CollectLabel : public Label
+{
+public:
+	CollectLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name),
+		count_(0)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		int32_t b = getType()->getInt32(arg->getRow(), 1);
+		int64_t c = getType()->getInt64(arg->getRow(), 2);
+		ops_[b].push_back(strprintf("%s %lld", Rowop::opcodeString(arg->getOpcode()), (long long)c));
+		count_++;
+	}
+
+	mutable map<int32_t, vector<string> > ops_;
+	mutable int count_;
+};
+
+Rowref mkrow(RowType *rt1, int32_t b, int64_t c)
+{
+	FdataVec dv;
+	mkfdata(dv);
+	dv[1].setPtr(true, &b, sizeof(b));
+	dv[2].setPtr(true, &c, sizeof(c));
+	return Rowref(rt1,  rt1->makeRow(dv));
+}
+
+UTESTCASE sharded(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<App> a1 = App::make("a1");
+	Autoref<TrieadOwner> ow1 = a1->makeTriead("t1");
+	Unit *unit1 = ow1->unit();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)
+		)
+	);
+
+	Autoref<ShardedTable> st = new ShardedTable(ow1, "st", tt, NameSet::make()->add("b"), 3);
+	UT_IS(st->getShardCount(), 3);
+	UT_IS(st->getOutputNexusName(), "st.out");
+
+	Autoref<CollectLabel> out = new CollectLabel(unit1, rt1, "out");
+	st->getOutputLabel()->chain(out);
+	Autoref<CollectLabel> lookup = new CollectLabel(unit1, rt1, "lookup");
+	st->getLookupResultLabel()->chain(lookup);
+
+	ow1->readyReady();
+
+	// the same key always goes to the same shard, and the keys get spread
+	int perShard[3] = { 0, 0, 0 };
+	for (int i = 0; i < 30; i++) {
+		Rowref r = mkrow(rt1, i, 0);
+		int s = st->shardOf(r);
+		UT_ASSERT(s >= 0 && s < 3);
+		UT_IS(st->shardOf(mkrow(rt1, i, 100)), s);
+		perShard[s]++;
+	}
+	UT_ASSERT(perShard[0] > 0 && perShard[1] > 0 && perShard[2] > 0);
+
+	for (int i = 0; i < 30; i++)
+		unit1->call(new Rowop(st->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, i, 1)));
+	for (int i = 0; i < 30; i += 2)
+		unit1->call(new Rowop(st->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, i, 2)));
+	for (int i = 0; i < 30; i += 3)
+		unit1->call(new Rowop(st->getInputLabel(), Rowop::OP_DELETE, mkrow(rt1, i, 0)));
+	unit1->call(new Rowop(st->getLookupLabel(), Rowop::OP_INSERT, mkrow(rt1, 4, 0)));
+	unit1->call(new Rowop(st->getLookupLabel(), Rowop::OP_INSERT, mkrow(rt1, 6, 0)));
+	ow1->flushWriters();
+
+	// 30 inserts, 15 replacements (delete+insert), 10 deletes
+	int expect = 30 + 15*2 + 10;
+	while (out->count_ < expect || lookup->count_ < 2) {
+		if (!ow1->nextXtrayTimeout(10, 0))
+			break;
+	}
+	UT_IS(out->count_, expect);
+	UT_IS(lookup->count_, 2);
+
+	// the per-key order is preserved
+	UT_IS(out->ops_[0].size(), 4);
+	UT_IS(out->ops_[0][0], "OP_INSERT 1");
+	UT_IS(out->ops_[0][1], "OP_DELETE 1");
+	UT_IS(out->ops_[0][2], "OP_INSERT 2");
+	UT_IS(out->ops_[0][3], "OP_DELETE 2");
+	UT_IS(out->ops_[1].size(), 1);
+	UT_IS(out->ops_[3].size(), 2);
+
+	UT_IS(lookup->ops_[4].size(), 1);
+	UT_IS(lookup->ops_[4][0], "OP_INSERT 2");
+	UT_IS(lookup->ops_[6].size(), 1);
+	UT_IS(lookup->ops_[6][0], "OP_NOP 0");
+
+	ow1->markDead();
+	a1->shutdown();
+	a1->harvester();
+
+	restore_uncatchable();
+}
+
+UTESTCASE sharded_errors(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<App> a1 = App::make("a1");
+	a1->setTimeout(0); // will replace all waits with an Exception
+	Autoref<TrieadOwner> ow1 = a1->makeTriead("t1");
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)
+		)
+	);
+
+	string msg;
+	try {
+		new ShardedTable(ow1, "st", tt, NameSet::make()->add("zz"), 3);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("The sharded table 'st' can not find the key field 'zz' in the row type") != string::npos);
+
+	msg.clear();
+	try {
+		new ShardedTable(ow1, "st", tt, NameSet::make()->add("b"), 0);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("The sharded table 'st' requires at least 1 shard, got 0.") != string::npos);
+
+	Autoref<TableType> ttu = TableType::make(rt1);
+	msg.clear();
+	try {
+		new ShardedTable(ow1, "st", ttu, NameSet::make()->add("b"), 1);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("The sharded table 'st' requires an initialized table type.") != string::npos);
+
+	ow1->markDead();
+	a1->harvester();
+
+	restore_uncatchable();
+}
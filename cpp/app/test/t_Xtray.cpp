@@ -57,8 +57,22 @@ UTESTCASE xtray(Utest *utest)
 	UT_IS(back2.row_, r1.get());
 	UT_IS(back2.opcode_, Rowop::OP_DELETE);
 
+	// an update carries the old row too
+	Rowref r2(rt1,  rt1->makeRow(dv));
+	xt1->push_back(0, r2, Rowop::OP_UPDATE, r1);
+	UT_IS(r1->getref(), 4);
+	UT_IS(r2->getref(), 2);
+	UT_IS(xt1->size(), 3);
+
+	const Xtray::Op &back3 = xt1->at(2);
+	UT_IS(back3.row_, r2.get());
+	UT_IS(back3.oldRow_, r1.get());
+	UT_IS(back3.opcode_, Rowop::OP_UPDATE);
+	UT_IS(xt1->at(0).oldRow_, NULL);
+
 	// delete
 	xt1 = NULL;
 	UT_IS(r1->getref(), 1);
+	UT_IS(r2->getref(), 1);
 }
 
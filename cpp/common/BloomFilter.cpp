@@ -0,0 +1,44 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A blocked Bloom filter on the hash values.
+
+#include <common/BloomFilter.h>
+#include <math.h>
+
+namespace TRICEPS_NS {
+
+BloomFilter::BloomFilter(size_t capacity, double fpRate)
+{
+	if (capacity == 0)
+		capacity = 1;
+	if (!(fpRate > 0. && fpRate < 1.))
+		fpRate = 0.01;
+	capacity_ = capacity;
+	fpRate_ = fpRate;
+
+	// the classic formulas: bits = -n*ln(p)/ln(2)^2, hashes = bits/n * ln(2)
+	double bits = -(double)capacity * log(fpRate) / (M_LN2 * M_LN2);
+	blocks_ = (size_t)ceil(bits / BLOCK_BITS);
+	if (blocks_ < 1)
+		blocks_ = 1;
+	if (blocks_ > ((size_t)1 << 24))
+		blocks_ = ((size_t)1 << 24); // blockOf() uses 24 bits of block number
+	hashes_ = (int)floor(bits / capacity * M_LN2 + 0.5);
+	if (hashes_ < 1)
+		hashes_ = 1;
+	if (hashes_ > MAX_HASHES)
+		hashes_ = MAX_HASHES;
+
+	data_.resize(blocks_ * BLOCK_WORDS);
+}
+
+void BloomFilter::clear()
+{
+	data_.assign(data_.size(), 0);
+}
+
+}; // TRICEPS_NS
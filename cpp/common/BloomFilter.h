@@ -0,0 +1,123 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A blocked Bloom filter on the hash values.
+
+#ifndef __Triceps_BloomFilter_h__
+#define __Triceps_BloomFilter_h__
+
+#include <common/Common.h>
+#include <common/Hash.h>
+
+namespace TRICEPS_NS {
+
+// The filter is split into blocks of one cache line each, and all the
+// bits of a value are placed into the same block. So checking a value
+// costs one cache miss at most, at the price of a slightly higher false
+// positive rate than a classic Bloom filter of the same size.
+//
+// The values can only be added, not removed. The users that need the
+// removal are expected to rebuild the filter periodically.
+class BloomFilter
+{
+public:
+	enum {
+		BLOCK_BITS = 512, // a 64-byte cache line
+		BLOCK_WORDS = BLOCK_BITS / 64,
+		MAX_HASHES = 16, // limit on the number of bits set per value
+	};
+
+	// Computes the size for the expected number of values and
+	// the wanted false positive rate.
+	// @param capacity - expected number of values (0 is treated as 1)
+	// @param fpRate - the wanted rate of the false positives, 0 < fpRate < 1
+	BloomFilter(size_t capacity, double fpRate);
+
+	// Forget all the values.
+	void clear();
+
+	// Add a value.
+	// @param h - the hash value
+	void add(Hash::Value h)
+	{
+		uint64_t x = mix(h);
+		uint64_t *block = &data_[blockOf(x) * BLOCK_WORDS];
+		uint32_t pos = (uint32_t)x;
+		uint32_t step = (uint32_t)(x >> 32) | 1;
+		for (int i = 0; i < hashes_; i++, pos += step)
+			block[(pos >> 6) & (BLOCK_WORDS - 1)] |= ((uint64_t)1 << (pos & 63));
+	}
+
+	// Check whether a value might have been added.
+	// @param h - the hash value
+	// @return - false if the value has definitely not been added,
+	//        true if it might have been
+	bool mayContain(Hash::Value h) const
+	{
+		uint64_t x = mix(h);
+		const uint64_t *block = &data_[blockOf(x) * BLOCK_WORDS];
+		uint32_t pos = (uint32_t)x;
+		uint32_t step = (uint32_t)(x >> 32) | 1;
+		for (int i = 0; i < hashes_; i++, pos += step) {
+			if ((block[(pos >> 6) & (BLOCK_WORDS - 1)] & ((uint64_t)1 << (pos & 63))) == 0)
+				return false;
+		}
+		return true;
+	}
+
+	// Get the size of the filter in bits.
+	size_t getBits() const
+	{
+		return blocks_ * BLOCK_BITS;
+	}
+
+	// Get the number of bits set per value.
+	int getHashes() const
+	{
+		return hashes_;
+	}
+
+	// Get the number of values the filter has been sized for.
+	size_t getCapacity() const
+	{
+		return capacity_;
+	}
+
+	// Get the false positive rate the filter has been sized for.
+	double getFpRate() const
+	{
+		return fpRate_;
+	}
+
+protected:
+	// Spread the 32-bit hash to 64 bits, since the FNV hash has
+	// rather weak low bits for the short keys.
+	static uint64_t mix(Hash::Value h)
+	{
+		uint64_t x = (uint64_t)h * 0x9E3779B97F4A7C15ULL;
+		x ^= x >> 29;
+		x *= 0xBF58476D1CE4E5B9ULL;
+		x ^= x >> 32;
+		return x;
+	}
+
+	// The block selected by the high bits of the mixed value
+	// (the low bits select the positions inside the block).
+	size_t blockOf(uint64_t x) const
+	{
+		return (size_t)(((x >> 40) * blocks_) >> 24);
+	}
+
+	vector<uint64_t> data_;
+	size_t blocks_; // number of blocks in data_
+	int hashes_; // number of bits set per value
+	size_t capacity_; // number of values it's sized for
+	double fpRate_; // false positive rate it's sized for
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_BloomFilter_h__
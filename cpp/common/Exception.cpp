@@ -49,7 +49,8 @@ Exception::Exception(Autoref<Errors> err, const char *msg) :
 }
 
 Exception::Exception(const Exception &exc, const string &msg) :
-	error_(new Errors(msg, exc.getErrors()))
+	error_(new Errors(msg, exc.error_)),
+	trace_(exc.trace_) // the nested backtrace stays pending
 {
 	checkTrace(false); // really does nothing
 	checkAbort();
@@ -114,12 +115,23 @@ Exception::~Exception()
 
 const char *Exception::what() const throw()
 {
-	error_->printTo(what_);
+	// what() must not throw, and both the symbolization of the
+	// backtrace and the printing allocate memory
+	try {
+		symbolize();
+		what_.clear();
+		error_->printTo(what_);
+	} catch (...) {
+		// keep whatever got printed before running out of memory
+		if (what_.empty())
+			return "Triceps exception (out of memory when printing the message)";
+	}
 	return what_.c_str();
 }
 
 Errors *Exception::getErrors() const
 {
+	symbolize();
 	return error_.get();
 }
 
@@ -127,25 +139,28 @@ void Exception::checkTrace(bool trace)
 {
 #if TRICEPS_BACKTRACE // {
 	if (enableBacktrace_ && (trace || abort_) ) { // if aborting, the stack trace never hurts because the calling labels won't be printed
-		void *buffer[100];
-		int sz = backtrace(buffer, sizeof(buffer)/sizeof(buffer[0]));
-		char **symbols = backtrace_symbols(buffer, sz);
+		// Reserve the place for the trace in the message right away,
+		// so that it stays in the same order relative to the messages
+		// that will be added later.
 		Erref log(new Errors);
-		for (int i = 0; i < sz; i++) {
-			log->appendMsg(false, symbols[i]);
-		}
-		if (sz == sizeof(buffer)/sizeof(buffer[0])) {
-			log->appendMsg(false, "..."); // show that the trace is likely incomplete
-		}
-		free(symbols);
-		error_->append("Stack trace:", log);
+		error_->elist_.push_back(Errors::Epair("Stack trace:", log));
+		trace_ = new Backtrace(log);
 	}
 #endif // } TRICEPS_BACKTRACE
 }
 
+void Exception::symbolize() const
+{
+	if (!trace_.isNull()) {
+		trace_->symbolize();
+		trace_ = NULL;
+	}
+}
+
 void Exception::checkAbort()
 {
 	if (abort_) {
+		symbolize();
 		error_->printTo(what_, "  ");
 		fprintf(stderr, "Triceps fatal error, aborting:\n%s\n", what_.c_str());
 		if (__testAbort_ == NULL)
@@ -155,5 +170,41 @@ void Exception::checkAbort()
 	}
 }
 
+// ------------------------------------ Exception::Backtrace ----------------------------------
+
+Exception::Backtrace::Backtrace(Errors *dest) :
+	dest_(dest),
+	size_(0)
+{
+#if TRICEPS_BACKTRACE // {
+	size_ = backtrace(frames_, MAX_FRAMES);
+#endif // } TRICEPS_BACKTRACE
+}
+
+void Exception::Backtrace::symbolize()
+{
+	if (size_ < 0)
+		return;
+	int n = size_;
+	size_ = -1; // even if the appending below throws, don't repeat it
+#if TRICEPS_BACKTRACE // {
+	char **symbols = backtrace_symbols(frames_, n);
+	try {
+		for (int i = 0; i < n; i++) {
+			if (symbols != NULL)
+				dest_->appendMsg(false, symbols[i]);
+			else // no memory for the symbols, fall back to the raw addresses
+				dest_->appendMsg(false, strprintf("%p", frames_[i]));
+		}
+		if (n == MAX_FRAMES) {
+			dest_->appendMsg(false, "..."); // show that the trace is likely incomplete
+		}
+	} catch (...) {
+		free(symbols);
+		throw;
+	}
+	free(symbols);
+#endif // } TRICEPS_BACKTRACE
+}
 
 }; // TRICEPS_NS
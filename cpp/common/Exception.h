@@ -98,11 +98,28 @@ public:
 		__attribute__((format(printf, 2, 3)));
 
 	// from std::exception
+	// Converts the pending backtrace and prints the message. If the memory
+	// runs out while doing it, returns as much as has been printed.
 	virtual const char *what() const throw();
 
 	// Get the error message in the original structured form.
+	// If the stack backtrace has been captured but not converted
+	// to the text yet, it gets converted now.
 	virtual Errors *getErrors() const;
 
+	// Get the error message without converting the captured stack backtrace.
+	// The backtrace stays pending and gets converted when the message
+	// is eventually printed through what() or getErrors(). This is
+	// intended for the code that only adds the information to the
+	// message on the way up and re-throws it, such as the Label calls,
+	// so that the conversion of the backtrace to the symbolic form
+	// (that is quite expensive) is done only if the message actually
+	// gets used. The result must not be printed directly.
+	Errors *peekErrors() const
+	{
+		return error_.get();
+	}
+
 	// Flag: when attempting to create an exception, instead print
 	// the message and abort. This behavior is more convenient for
 	// debugging of the C++ programs, and is the default one.
@@ -124,10 +141,39 @@ public:
 	static bool *__testAbort_;
 
 protected:
-	// Check the trace flag, and append the trace to the error
+	// The stack backtrace, captured as raw addresses. The addresses get
+	// converted to the symbolic form only when the message is requested,
+	// and placed into the Errors object that has been reserved for them
+	// in the message at the time of capture. It's shared between the
+	// copies of the Exception and the Exceptions that wrap it.
+	class Backtrace : public Starget
+	{
+	public:
+		enum {
+			MAX_FRAMES = 100,
+		};
+
+		// Capture the current stack.
+		// @param dest - the place to put the symbolic trace into later
+		Backtrace(Errors *dest);
+
+		// Convert the addresses to the symbolic form, if not done yet.
+		// If there is no memory for the symbols, puts the raw addresses.
+		// May throw std::bad_alloc from appending to the message.
+		void symbolize();
+
+	protected:
+		Autoref<Errors> dest_; // where to put the symbolic trace
+		void *frames_[MAX_FRAMES];
+		int size_; // number of the frames in frames_, -1 after symbolized
+	};
+
+	// Check the trace flag, and capture the trace for the error
 	// message if it says so.
 	// @param trace - the trace flag
 	void checkTrace(bool trace);
+	// Convert the pending backtrace, if any, to the symbolic form.
+	void symbolize() const;
 	// Check the abort_ flag and abort if it says so.
 	void checkAbort();
 
@@ -135,6 +181,7 @@ protected:
 	explicit Exception();
 
 	Erref error_; // the error message
+	mutable Autoref<Backtrace> trace_; // the pending backtrace, NULL if none or already converted
 	mutable string what_; // used to keep the return value of what()
 };
 
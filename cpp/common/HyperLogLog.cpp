@@ -0,0 +1,91 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A mergeable sketch for the approximate count of the distinct values.
+
+#include <common/HyperLogLog.h>
+
+namespace TRICEPS_NS {
+
+HyperLogLog::HyperLogLog(int precision) :
+	precision_(precision < MIN_PRECISION? MIN_PRECISION
+		: (precision > MAX_PRECISION? MAX_PRECISION : precision))
+{
+	regs_.resize((size_t)1 << precision_);
+	resum();
+}
+
+void HyperLogLog::clear()
+{
+	regs_.assign(regs_.size(), 0);
+	resum();
+}
+
+void HyperLogLog::resum()
+{
+	zeros_ = 0;
+	invSum_ = 0.;
+	for (vector<uint8_t>::const_iterator it = regs_.begin(); it != regs_.end(); ++it) {
+		if (*it == 0)
+			++zeros_;
+		invSum_ += ldexp(1., -(int)*it);
+	}
+}
+
+bool HyperLogLog::merge(const HyperLogLog &other)
+{
+	if (other.precision_ < precision_)
+		return false;
+
+	int shift = other.precision_ - precision_;
+	size_t lowmask = ((size_t)1 << shift) - 1;
+	for (size_t i = 0; i < other.regs_.size(); i++) {
+		uint8_t r = other.regs_[i];
+		if (r == 0)
+			continue;
+		// the low bits of the other's register index become the top
+		// bits of the rest of the hash here
+		size_t low = (i & lowmask);
+		if (low != 0)
+			r = rankOf((uint64_t)low << (64 - shift), shift);
+		else
+			r += shift;
+		uint8_t &reg = regs_[i >> shift];
+		if (r > reg)
+			reg = r;
+	}
+	resum();
+	return true;
+}
+
+double HyperLogLog::estimate() const
+{
+	double m = (double)regs_.size();
+	double alpha;
+	switch (precision_) {
+	case 4:
+		alpha = 0.673;
+		break;
+	case 5:
+		alpha = 0.697;
+		break;
+	case 6:
+		alpha = 0.709;
+		break;
+	default:
+		alpha = 0.7213 / (1. + 1.079 / m);
+		break;
+	}
+
+	double est = alpha * m * m / invSum_;
+	// the small counts are more precise by the linear counting
+	// of the empty registers
+	if (est <= 2.5 * m && zeros_ != 0)
+		est = m * log(m / (double)zeros_);
+	return est;
+}
+
+}; // TRICEPS_NS
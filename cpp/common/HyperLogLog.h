@@ -0,0 +1,141 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A mergeable sketch for the approximate count of the distinct values.
+
+#ifndef __Triceps_HyperLogLog_h__
+#define __Triceps_HyperLogLog_h__
+
+#include <math.h>
+#include <common/Common.h>
+#include <common/Hash.h>
+
+namespace TRICEPS_NS {
+
+// The HyperLogLog estimator: the hash values are split by their high
+// bits into 2^precision registers, and each register remembers the
+// longest run of the leading zero bits seen in the rest of the hash.
+// The memory is one byte per register, and the standard error of the
+// estimate is about 1.04/sqrt(2^precision) (1.6% for the default
+// precision of 12).
+//
+// Since the hash values are 32-bit, the estimates are meaningful up to
+// a few hundred million distinct values, after that the collisions of
+// the hash values start adding up.
+//
+// The sketches built from the different parts of the data can be merged,
+// the result is the same as if all the values went into one sketch.
+//
+// The values can only be added, not removed. The users that need the
+// removal are expected to rebuild the sketch.
+class HyperLogLog
+{
+public:
+	enum {
+		MIN_PRECISION = 4,
+		MAX_PRECISION = 16,
+		DEFAULT_PRECISION = 12,
+	};
+
+	// @param precision - the number of the hash bits that select the
+	//        register; limited to the range MIN_PRECISION...MAX_PRECISION
+	HyperLogLog(int precision = DEFAULT_PRECISION);
+
+	// Forget all the values.
+	void clear();
+
+	// Add a value.
+	// @param h - the hash value
+	void add(Hash::Value h)
+	{
+		uint64_t x = mix(h);
+		size_t idx = (size_t)(x >> (64 - precision_));
+		uint8_t r = rankOf(x << precision_, 64 - precision_);
+		uint8_t &reg = regs_[idx];
+		if (r > reg)
+			setRegister(reg, r);
+	}
+
+	// Add a value by its bytes.
+	// @param v - bytes of the value
+	// @param len - number of bytes
+	void addBytes(const char *v, size_t len)
+	{
+		add(Hash::append(Hash::basis_, v, len));
+	}
+
+	// Merge the values from another sketch into this one.
+	// If the other sketch has a higher precision, its registers get folded
+	// down to the precision of this one, with the exactly same result
+	// as if its values were added here directly. A sketch with a lower
+	// precision can not be merged into one with a higher precision.
+	// @param other - sketch to merge from
+	// @return - false if the other sketch has a lower precision
+	//        (and nothing gets merged)
+	bool merge(const HyperLogLog &other);
+
+	// Get the estimated number of the distinct values.
+	double estimate() const;
+
+	// Check whether no values have been added.
+	bool empty() const
+	{
+		return zeros_ == regs_.size();
+	}
+
+	// Get back the precision.
+	int getPrecision() const
+	{
+		return precision_;
+	}
+
+protected:
+	// Spread the 32-bit hash to 64 bits, since the FNV hash has
+	// rather weak low bits for the short keys (the same as in BloomFilter).
+	static uint64_t mix(Hash::Value h)
+	{
+		uint64_t x = (uint64_t)h * 0x9E3779B97F4A7C15ULL;
+		x ^= x >> 29;
+		x *= 0xBF58476D1CE4E5B9ULL;
+		x ^= x >> 32;
+		return x;
+	}
+
+	// Get the position of the first 1 bit, counting from 1 at the top.
+	// @param w - bits, aligned at the top
+	// @param width - number of the meaningful bits in w
+	static uint8_t rankOf(uint64_t w, int width)
+	{
+		if (w == 0)
+			return (uint8_t)(width + 1);
+		int r = __builtin_clzll(w) + 1;
+		return (uint8_t)(r > width + 1? width + 1 : r);
+	}
+
+	// Raise a register, keeping the summary up to date.
+	// @param reg - the register
+	// @param r - the new value, greater than the current one
+	void setRegister(uint8_t &reg, uint8_t r)
+	{
+		if (reg == 0)
+			--zeros_;
+		invSum_ += ldexp(1., -(int)r) - ldexp(1., -(int)reg);
+		reg = r;
+	}
+
+	// Recompute the summary from the registers.
+	void resum();
+
+	vector<uint8_t> regs_; // the registers
+	int precision_; // the register count is 2^precision_
+	// The summary of the registers, to make the estimate O(1).
+	size_t zeros_; // number of the registers still at 0
+	double invSum_; // the sum of 2^-register
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_HyperLogLog_h__
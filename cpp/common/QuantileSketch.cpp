@@ -0,0 +1,171 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A mergeable sketch for the approximate quantiles.
+
+#include <math.h>
+#include <algorithm>
+#include <common/QuantileSketch.h>
+
+namespace TRICEPS_NS {
+
+QuantileSketch::QuantileSketch(int k) :
+	levels_(1),
+	k_(k < MIN_K? MIN_K : k),
+	n_(0),
+	size_(0),
+	coin_(false)
+{
+	updateMaxSize();
+}
+
+void QuantileSketch::clear()
+{
+	levels_.clear();
+	levels_.resize(1);
+	n_ = 0;
+	size_ = 0;
+	coin_ = false;
+	updateMaxSize();
+}
+
+size_t QuantileSketch::capacity(size_t level) const
+{
+	size_t depth = levels_.size() - 1 - level;
+	size_t cap = (size_t)ceil(k_ * pow(2. / 3., (double)depth));
+	return cap < 2? 2 : cap;
+}
+
+void QuantileSketch::updateMaxSize()
+{
+	maxSize_ = 0;
+	for (size_t h = 0; h < levels_.size(); h++)
+		maxSize_ += capacity(h);
+}
+
+void QuantileSketch::compress()
+{
+	while (size_ >= maxSize_) {
+		for (size_t h = 0; h < levels_.size(); h++) {
+			if (levels_[h].size() < capacity(h))
+				continue;
+
+			if (h + 1 == levels_.size()) {
+				levels_.resize(h + 2);
+				updateMaxSize();
+			}
+
+			Level &cur = levels_[h];
+			Level &up = levels_[h + 1];
+			sort(cur.begin(), cur.end());
+
+			// with an odd count, one item stays on this level
+			size_t keep = (cur.size() & 1);
+			size_t start = keep + (coin_? 1 : 0);
+			coin_ = !coin_;
+			for (size_t i = start; i < cur.size(); i += 2)
+				up.push_back(cur[i]);
+			size_t moved = (cur.size() - keep) / 2;
+			cur.resize(keep);
+			size_ -= moved; // 2*moved items became moved items
+			break;
+		}
+	}
+}
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+	if (other.levels_.size() > levels_.size()) {
+		levels_.resize(other.levels_.size());
+		updateMaxSize();
+	}
+	for (size_t h = 0; h < other.levels_.size(); h++) {
+		const Level &src = other.levels_[h];
+		levels_[h].insert(levels_[h].end(), src.begin(), src.end());
+	}
+	n_ += other.n_;
+	size_ += other.size_;
+	if (size_ >= maxSize_)
+		compress();
+}
+
+uint64_t QuantileSketch::rank(double v) const
+{
+	uint64_t res = 0;
+	for (size_t h = 0; h < levels_.size(); h++) {
+		const Level &lev = levels_[h];
+		for (Level::const_iterator it = lev.begin(); it != lev.end(); ++it) {
+			if (*it <= v)
+				res += ((uint64_t)1 << h);
+		}
+	}
+	return res;
+}
+
+void QuantileSketch::getWeighted(WeightedVec &res) const
+{
+	res.clear();
+	res.reserve(size_);
+	for (size_t h = 0; h < levels_.size(); h++) {
+		const Level &lev = levels_[h];
+		for (Level::const_iterator it = lev.begin(); it != lev.end(); ++it) {
+			WeightedValue wv;
+			wv.val_ = *it;
+			wv.weight_ = ((uint64_t)1 << h);
+			res.push_back(wv);
+		}
+	}
+	sort(res.begin(), res.end());
+}
+
+bool QuantileSketch::quantile(double q, double &res) const
+{
+	if (n_ == 0)
+		return false;
+
+	WeightedVec items;
+	getWeighted(items);
+
+	// the compactions keep the total weight equal to n_
+	double target = q * (double)n_;
+	uint64_t cum = 0;
+	for (WeightedVec::iterator it = items.begin(); it != items.end(); ++it) {
+		cum += it->weight_;
+		if ((double)cum >= target) {
+			res = it->val_;
+			return true;
+		}
+	}
+	res = items.back().val_;
+	return true;
+}
+
+bool QuantileSketch::netQuantile(const QuantileSketch &ins, const QuantileSketch &del, double q, double &res)
+{
+	if (ins.n_ <= del.n_)
+		return false;
+
+	WeightedVec iitems, ditems;
+	ins.getWeighted(iitems);
+	del.getWeighted(ditems);
+
+	double target = q * (double)(ins.n_ - del.n_);
+	int64_t net = 0;
+	WeightedVec::iterator dit = ditems.begin();
+	for (WeightedVec::iterator it = iitems.begin(); it != iitems.end(); ++it) {
+		net += it->weight_;
+		for (; dit != ditems.end() && dit->val_ <= it->val_; ++dit)
+			net -= dit->weight_;
+		if ((double)net >= target && net > 0) {
+			res = it->val_;
+			return true;
+		}
+	}
+	res = iitems.back().val_;
+	return true;
+}
+
+}; // TRICEPS_NS
@@ -0,0 +1,146 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A mergeable sketch for the approximate quantiles.
+
+#ifndef __Triceps_QuantileSketch_h__
+#define __Triceps_QuantileSketch_h__
+
+#include <common/Common.h>
+
+namespace TRICEPS_NS {
+
+// This is the KLL sketch: a stack of the compactors, where the items on the
+// level h represent 2^h original values each. When the sketch overflows,
+// the lowest full level gets sorted and every other item of it moves
+// one level up. The capacities of the levels decrease geometrically
+// (by 2/3) going down from the top level that has the capacity k,
+// so the number of the retained items stays under about 3*k, no matter
+// how many values have been added. The rank error is around 1.7/k
+// of the count of the values (about 1% for the default k = 200).
+//
+// The choice of the odd or even items in a compaction normally uses
+// a random coin. Here the coin is deterministic, alternating on each
+// compaction, so the results are repeatable.
+//
+// The sketches built from the different parts of the data can be merged
+// with the same accuracy as if all the values went into one sketch.
+//
+// The values can only be added, not removed. The users that need the
+// removal can keep a separate sketch of the removed values, with the
+// net rank being the difference of the ranks.
+class QuantileSketch
+{
+public:
+	enum {
+		DEFAULT_K = 200,
+		MIN_K = 8,
+	};
+
+	// An item with its weight, for the external rank computations.
+	struct WeightedValue
+	{
+		double val_;
+		uint64_t weight_;
+
+		bool operator<(const WeightedValue &other) const
+		{
+			return val_ < other.val_;
+		}
+	};
+	typedef vector<WeightedValue> WeightedVec;
+
+	// @param k - accuracy, the capacity of the top level; the values
+	//        below MIN_K are treated as MIN_K
+	QuantileSketch(int k = DEFAULT_K);
+
+	// Forget all the values.
+	void clear();
+
+	// Add a value.
+	// @param v - value to add
+	void add(double v)
+	{
+		levels_[0].push_back(v);
+		++n_;
+		if (++size_ >= maxSize_)
+			compress();
+	}
+
+	// Merge the values from another sketch into this one.
+	// The other sketch may have a different k, the accuracy
+	// is then limited by the smaller one.
+	// @param other - sketch to merge from
+	void merge(const QuantileSketch &other);
+
+	// Get the number of the values added (including the merged ones).
+	uint64_t getCount() const
+	{
+		return n_;
+	}
+
+	// Get the number of the items retained in the sketch.
+	size_t getRetained() const
+	{
+		return size_;
+	}
+
+	// Get back the accuracy.
+	int getK() const
+	{
+		return k_;
+	}
+
+	// Get the estimated number of the values less or equal to v.
+	// @param v - the value to find the rank of
+	uint64_t rank(double v) const;
+
+	// Get the estimated quantile.
+	// @param q - the quantile, 0 <= q <= 1; 0.5 is the median
+	// @param res - place to return the result
+	// @return - false if the sketch is empty (and res is not changed)
+	bool quantile(double q, double &res) const;
+
+	// Get all the retained items with their weights, sorted by value.
+	// @param res - place to return the items, the previous contents
+	//        gets replaced
+	void getWeighted(WeightedVec &res) const;
+
+	// Get the estimated quantile of the values that have been added
+	// to one sketch and not removed (by adding them to the other sketch).
+	// The error is relative to the total count in both sketches, not to
+	// the net count, so it grows with the share of the removed values.
+	// @param ins - sketch of the added values
+	// @param del - sketch of the removed values
+	// @param q - the quantile, 0 <= q <= 1; 0.5 is the median
+	// @param res - place to return the result
+	// @return - false if no values are left (and res is not changed)
+	static bool netQuantile(const QuantileSketch &ins, const QuantileSketch &del, double q, double &res);
+
+protected:
+	typedef vector<double> Level;
+	typedef vector<Level> LevelVec;
+
+	// Get the capacity of a level.
+	size_t capacity(size_t level) const;
+
+	// Recompute maxSize_ after the number of levels changes.
+	void updateMaxSize();
+
+	// Compact the levels until the size gets under the limit.
+	void compress();
+
+	LevelVec levels_; // items at the level h have the weight 2^h
+	int k_; // capacity of the top level
+	uint64_t n_; // number of the values added
+	size_t size_; // number of the items retained
+	size_t maxSize_; // the sum of the level capacities
+	bool coin_; // alternates the odd and even items kept on compaction
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_QuantileSketch_h__
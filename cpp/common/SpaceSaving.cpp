@@ -0,0 +1,142 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A bounded summary of the most frequent values.
+
+#include <algorithm>
+#include <common/SpaceSaving.h>
+
+namespace TRICEPS_NS {
+
+SpaceSaving::SpaceSaving(size_t capacity) :
+	capacity_(capacity == 0? 1 : capacity)
+{ }
+
+SpaceSaving::~SpaceSaving()
+{
+	clear();
+}
+
+void SpaceSaving::clear()
+{
+	for (vector<Counter *>::iterator it = heap_.begin(); it != heap_.end(); ++it)
+		delete *it;
+	heap_.clear();
+	map_.clear();
+}
+
+void SpaceSaving::siftUp(size_t pos)
+{
+	Counter *c = heap_[pos];
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 2;
+		if (heap_[parent]->count_ <= c->count_)
+			break;
+		place(heap_[parent], pos);
+		pos = parent;
+	}
+	place(c, pos);
+}
+
+void SpaceSaving::siftDown(size_t pos)
+{
+	Counter *c = heap_[pos];
+	size_t n = heap_.size();
+	for (;;) {
+		size_t child = pos * 2 + 1;
+		if (child >= n)
+			break;
+		if (child + 1 < n && heap_[child + 1]->count_ < heap_[child]->count_)
+			++child;
+		if (c->count_ <= heap_[child]->count_)
+			break;
+		place(heap_[child], pos);
+		pos = child;
+	}
+	place(c, pos);
+}
+
+bool SpaceSaving::add(const string &key, const Counter *&counter, string &evicted)
+{
+	Counter *c;
+	bool took = false;
+	CounterMap::iterator it = map_.find(key);
+	if (it != map_.end()) {
+		c = it->second;
+		++c->count_;
+	} else if (heap_.size() < capacity_) {
+		c = new Counter;
+		c->key_ = key;
+		c->count_ = 1;
+		c->error_ = 0;
+		heap_.push_back(c);
+		c->pos_ = heap_.size() - 1;
+		map_[key] = c;
+		siftUp(c->pos_);
+		counter = c;
+		return false;
+	} else {
+		// take over the smallest counter
+		c = heap_[0];
+		map_.erase(c->key_);
+		evicted.swap(c->key_);
+		took = true;
+		c->key_ = key;
+		c->error_ = c->count_;
+		++c->count_;
+		map_[key] = c;
+	}
+	siftDown(c->pos_);
+	counter = c;
+	return took;
+}
+
+bool SpaceSaving::remove(const string &key)
+{
+	CounterMap::iterator it = map_.find(key);
+	if (it == map_.end())
+		return false;
+
+	Counter *c = it->second;
+	if (--c->count_ > 0) {
+		if (c->error_ > c->count_)
+			c->error_ = c->count_;
+		siftUp(c->pos_);
+		return true;
+	}
+
+	// drop the counter
+	map_.erase(it);
+	size_t pos = c->pos_;
+	Counter *last = heap_.back();
+	heap_.pop_back();
+	if (last != c) {
+		place(last, pos);
+		siftUp(pos);
+		siftDown(last->pos_);
+	}
+	delete c;
+	return true;
+}
+
+const SpaceSaving::Counter *SpaceSaving::find(const string &key) const
+{
+	CounterMap::const_iterator it = map_.find(key);
+	if (it == map_.end())
+		return NULL;
+	return it->second;
+}
+
+void SpaceSaving::top(size_t k, CounterVec &res) const
+{
+	res.assign(heap_.begin(), heap_.end());
+	if (k > res.size())
+		k = res.size();
+	partial_sort(res.begin(), res.begin() + k, res.end(), ranks);
+	res.resize(k);
+}
+
+}; // TRICEPS_NS
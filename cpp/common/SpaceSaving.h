@@ -0,0 +1,132 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A bounded summary of the most frequent values.
+
+#ifndef __Triceps_SpaceSaving_h__
+#define __Triceps_SpaceSaving_h__
+
+#include <map>
+#include <common/Common.h>
+
+namespace TRICEPS_NS {
+
+// The Space-Saving algorithm: keeps up to a fixed number of counters.
+// A value that already has a counter increases it. A new value takes
+// a free counter, or if there are none, takes over the counter with
+// the smallest count, adding 1 to it and remembering the previous count
+// as the possible error. So the counts are the upper bounds of the real
+// frequencies, overestimated by at most the error, and any value that
+// occurs more than total/capacity times is guaranteed to have a counter.
+//
+// The values may also be removed: this decreases the counter if the
+// value has one, and drops the counter when it goes down to 0. This is
+// not a part of the classic algorithm, and the guarantees hold only for
+// the values that stayed counted all the time. It's good enough for the
+// windows where the frequent values stay frequent.
+//
+// The values are kept as the byte strings.
+class SpaceSaving
+{
+public:
+	struct Counter
+	{
+		string key_; // the value
+		int64_t count_; // the estimated count, an upper bound
+		int64_t error_; // the maximal overestimation of count_
+		size_t pos_; // position in the heap
+	};
+	typedef vector<const Counter *> CounterVec;
+
+	// @param capacity - the maximal number of counters (0 is treated as 1)
+	SpaceSaving(size_t capacity);
+	~SpaceSaving();
+
+	// Forget all the values.
+	void clear();
+
+	// Count a value.
+	// @param key - the value
+	// @return - the counter of this value
+	const Counter *add(const string &key)
+	{
+		const Counter *c;
+		string evicted;
+		add(key, c, evicted);
+		return c;
+	}
+
+	// Count a value, reporting if it took over the counter of another value.
+	// Any value may get evicted, including an empty string.
+	// @param key - the value
+	// @param counter - returns the counter of this value
+	// @param evicted - if a counter got taken over, returns its previous
+	//        value, otherwise left unchanged
+	// @return - true if a counter got taken over by this value
+	bool add(const string &key, const Counter *&counter, string &evicted);
+
+	// Uncount a value.
+	// @param key - the value
+	// @return - true if the value had a counter
+	bool remove(const string &key);
+
+	// Find the counter of a value.
+	// @param key - the value
+	// @return - the counter, or NULL if the value has none
+	const Counter *find(const string &key) const;
+
+	// Get the most frequent values, in the order of ranks().
+	// @param k - the maximal number of values to return
+	// @param res - place to return the counters, the previous contents
+	//        gets replaced
+	void top(size_t k, CounterVec &res) const;
+
+	// The order of the ranks: by the count descending, the equal counts
+	// by the value, to make the order repeatable.
+	// @return - true if a goes before b
+	static bool ranks(const Counter *a, const Counter *b)
+	{
+		if (a->count_ != b->count_)
+			return a->count_ > b->count_;
+		return a->key_ < b->key_;
+	}
+
+	// Get the number of the counters in use.
+	size_t size() const
+	{
+		return heap_.size();
+	}
+
+	// Get back the capacity.
+	size_t getCapacity() const
+	{
+		return capacity_;
+	}
+
+protected:
+	typedef map<string, Counter *> CounterMap;
+
+	// The heap is ordered by the count, the smallest at the top.
+	void siftUp(size_t pos);
+	void siftDown(size_t pos);
+	void place(Counter *c, size_t pos)
+	{
+		heap_[pos] = c;
+		c->pos_ = pos;
+	}
+
+	vector<Counter *> heap_; // the counters, as a min-heap
+	CounterMap map_; // the counters by the value
+	size_t capacity_;
+
+private:
+	SpaceSaving(const SpaceSaving &);
+	void operator=(const SpaceSaving &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_SpaceSaving_h__
@@ -0,0 +1,47 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A cheap clock for the timestamps and the measurement of short intervals.
+
+#include <pthread.h>
+#include <common/Tsc.h>
+
+namespace TRICEPS_NS {
+
+// calibrated once, on the first use
+static double tscRate = 0.;
+static pthread_once_t tscOnce = PTHREAD_ONCE_INIT;
+
+static uint64_t monotonicNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void calibrateTsc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	uint64_t ns0 = monotonicNs();
+	uint64_t t0 = Tsc::now();
+	struct timespec delay = { 0, 10 * 1000 * 1000 };
+	nanosleep(&delay, NULL);
+	uint64_t ns1 = monotonicNs();
+	uint64_t t1 = Tsc::now();
+	tscRate = (ns1 > ns0 && t1 > t0)? (double)(t1 - t0) / (double)(ns1 - ns0) : 1.;
+#else
+	tscRate = 1.;
+#endif
+}
+
+double Tsc::ticksPerNs()
+{
+	// pthread_once() makes the result visible to all the threads
+	pthread_once(&tscOnce, calibrateTsc);
+	return tscRate;
+}
+
+}; // TRICEPS_NS
@@ -0,0 +1,59 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A cheap clock for the timestamps and the measurement of short intervals.
+
+#ifndef __Triceps_Tsc_h__
+#define __Triceps_Tsc_h__
+
+#include <time.h>
+#include <common/Common.h>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+namespace TRICEPS_NS {
+
+// The clock reads the CPU timestamp counter where it's available (x86),
+// which costs a few nanoseconds. Elsewhere it falls back to the
+// monotonic clock of the OS, with the ticks in nanoseconds.
+//
+// The counter is assumed to run at a constant rate and to be synchronized
+// between the CPUs, as it is on all the modern x86 CPUs. The ticks can be
+// converted to the nanoseconds with the rate calibrated against the
+// monotonic clock.
+class Tsc
+{
+public:
+	// @return - the current value of the clock, in ticks
+	static uint64_t now()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+	}
+
+	// Get the rate of the clock. On the first call it gets calibrated
+	// against the monotonic clock, which takes about 10 milliseconds.
+	// @return - the number of ticks per nanosecond
+	static double ticksPerNs();
+
+	// Convert a number of ticks to the nanoseconds.
+	// @param ticks - an interval in ticks
+	// @return - the interval in nanoseconds
+	static double toNs(uint64_t ticks)
+	{
+		return (double)ticks / ticksPerNs();
+	}
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_Tsc_h__
@@ -0,0 +1,16 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase sizing;
+	driver.addcase(sizing, "sizing");
+
+	extern Utest::Testcase addcheck;
+	driver.addcase(addcheck, "addcheck");
+
+	return driver.run();
+}
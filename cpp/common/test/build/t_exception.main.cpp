@@ -0,0 +1,19 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase throw_catch;
+	driver.addcase(throw_catch, "throw_catch");
+
+	extern Utest::Testcase lazy_trace;
+	driver.addcase(lazy_trace, "lazy_trace");
+
+	extern Utest::Testcase abort;
+	driver.addcase(abort, "abort");
+
+	return driver.run();
+}
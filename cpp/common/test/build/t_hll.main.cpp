@@ -0,0 +1,19 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase empty;
+	driver.addcase(empty, "empty");
+
+	extern Utest::Testcase accuracy;
+	driver.addcase(accuracy, "accuracy");
+
+	extern Utest::Testcase merge;
+	driver.addcase(merge, "merge");
+
+	return driver.run();
+}
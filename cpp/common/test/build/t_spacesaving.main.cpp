@@ -0,0 +1,22 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase exact;
+	driver.addcase(exact, "exact");
+
+	extern Utest::Testcase eviction;
+	driver.addcase(eviction, "eviction");
+
+	extern Utest::Testcase evictionEmpty;
+	driver.addcase(evictionEmpty, "evictionEmpty");
+
+	extern Utest::Testcase heavy;
+	driver.addcase(heavy, "heavy");
+
+	return driver.run();
+}
@@ -0,0 +1,69 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the Bloom filter.
+
+#include <utest/Utest.h>
+
+#include <common/BloomFilter.h>
+
+UTESTCASE sizing(Utest *utest)
+{
+	BloomFilter bf(1000, 0.01);
+	UT_IS(bf.getCapacity(), 1000);
+	UT_IS(bf.getFpRate(), 0.01);
+	// about 9.6 bits per value, rounded up to the blocks
+	UT_IS(bf.getBits(), 9728);
+	UT_IS(bf.getHashes(), 7);
+
+	BloomFilter bf0(0, 0.);
+	UT_IS(bf0.getCapacity(), 1);
+	UT_IS(bf0.getFpRate(), 0.01);
+	UT_IS(bf0.getBits(), (size_t)BloomFilter::BLOCK_BITS);
+	UT_ASSERT(bf0.getHashes() >= 1);
+
+	BloomFilter bfs(10, 1e-30);
+	UT_IS(bfs.getHashes(), (int)BloomFilter::MAX_HASHES);
+}
+
+UTESTCASE addcheck(Utest *utest)
+{
+	const int n = 10000;
+	BloomFilter bf(n, 0.01);
+
+	for (int i = 0; i < n; i++)
+		UT_ASSERT(!bf.mayContain(i * 2));
+
+	for (int i = 0; i < n; i++) {
+		int v = i * 2;
+		bf.add(Hash::append(Hash::basis_, (const char *)&v, sizeof(v)));
+	}
+
+	// no false negatives
+	for (int i = 0; i < n; i++) {
+		int v = i * 2;
+		if (UT_ASSERT(bf.mayContain(Hash::append(Hash::basis_, (const char *)&v, sizeof(v)))))
+			break;
+	}
+
+	// and the false positives are about as configured
+	int fp = 0;
+	for (int i = 0; i < n; i++) {
+		int v = i * 2 + 1;
+		if (bf.mayContain(Hash::append(Hash::basis_, (const char *)&v, sizeof(v))))
+			fp++;
+	}
+	UT_ASSERT(fp < n / 50);
+
+	bf.clear();
+	fp = 0;
+	for (int i = 0; i < n; i++) {
+		int v = i * 2;
+		if (bf.mayContain(Hash::append(Hash::basis_, (const char *)&v, sizeof(v))))
+			fp++;
+	}
+	UT_IS(fp, 0);
+}
@@ -160,6 +160,46 @@ UTESTCASE throw_catch(Utest *utest)
 	Exception::enableBacktrace_ = true; // restore back
 }
 
+// the backtrace gets converted to the text only when the message is used
+UTESTCASE lazy_trace(Utest *utest)
+{
+	Exception::abort_ = false;
+
+	try {
+		throw Exception::fTrace("message %d", 99);
+	} catch (Exception e) {
+		// the place is reserved but the trace is not converted yet
+		UT_IS(e.peekErrors()->print(), "message 99\nStack trace:\n");
+		Erref err = e.peekErrors();
+		err.f("added later");
+
+		string what = e.what();
+		UT_IS(what.find("message 99\nStack trace:\n  "), 0);
+		UT_ASSERT(what.find("\nadded later\n") != string::npos);
+		UT_IS(what.find("\nadded later\n") + 13, what.size()); // the trace went before it
+	}
+
+	// the trace stays pending through the wrapping and the copying
+	try {
+		try {
+			throw Exception::fTrace("message");
+		} catch (Exception e) {
+			Exception e2(e, "wrapper");
+			UT_IS(e2.peekErrors()->print(), "wrapper\n  message\n  Stack trace:\n");
+			throw e2;
+		}
+	} catch (Exception e) {
+		Exception ecopy = e;
+		string what = ecopy.getErrors()->print();
+		UT_IS(what.find("wrapper\n  message\n  Stack trace:\n    "), 0);
+		// converted only once, visible through all the copies
+		UT_IS(e.getErrors()->print(), what);
+		UT_IS(e.peekErrors()->print(), what);
+	}
+
+	Exception::abort_ = true; // restore back
+}
+
 bool aborted;
 
 UTESTCASE abort(Utest *utest)
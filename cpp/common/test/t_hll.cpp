@@ -0,0 +1,92 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the HyperLogLog distinct count.
+
+#include <utest/Utest.h>
+#include <math.h>
+
+#include <common/HyperLogLog.h>
+
+// the relative error of an estimate
+static double relerr(double est, double n)
+{
+	return fabs(est - n) / n;
+}
+
+UTESTCASE empty(Utest *utest)
+{
+	HyperLogLog hll;
+	UT_IS(hll.getPrecision(), (int)HyperLogLog::DEFAULT_PRECISION);
+	UT_ASSERT(hll.empty());
+	UT_IS(hll.estimate(), 0.);
+
+	HyperLogLog hlow(1), hhigh(100);
+	UT_IS(hlow.getPrecision(), (int)HyperLogLog::MIN_PRECISION);
+	UT_IS(hhigh.getPrecision(), (int)HyperLogLog::MAX_PRECISION);
+}
+
+UTESTCASE accuracy(Utest *utest)
+{
+	HyperLogLog hll;
+	int checks[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+	int next = 0;
+	for (int i = 1; i <= 1000000; i++) {
+		hll.add(i);
+		hll.add(i); // the repeated values don't count
+		if (i == checks[next]) {
+			double est = hll.estimate();
+			// 4 standard errors
+			if (UT_ASSERT(relerr(est, i) < 0.065))
+				printf("n=%d est=%g\n", i, est);
+			++next;
+		}
+	}
+	UT_ASSERT(!hll.empty());
+
+	hll.clear();
+	UT_ASSERT(hll.empty());
+	UT_IS(hll.estimate(), 0.);
+
+	// the values by their bytes
+	for (int i = 0; i < 5000; i++) {
+		char buf[20];
+		int len = snprintf(buf, sizeof(buf), "v%d", i % 2000);
+		hll.addBytes(buf, len);
+	}
+	UT_ASSERT(relerr(hll.estimate(), 2000) < 0.065);
+}
+
+UTESTCASE merge(Utest *utest)
+{
+	const int n = 200000;
+	// the overlapping ranges
+	HyperLogLog h1, h2, hall;
+	for (int i = 0; i < n; i++) {
+		if (i < n * 3 / 4)
+			h1.add(i);
+		if (i >= n / 4)
+			h2.add(i);
+		hall.add(i);
+	}
+	UT_ASSERT(h1.merge(h2));
+	UT_IS(h1.estimate(), hall.estimate());
+	UT_ASSERT(relerr(h1.estimate(), n) < 0.065);
+
+	// folding from the higher precision gives the same registers
+	// as adding directly
+	HyperLogLog hlow(8), hdirect(8), hhigh(14);
+	for (int i = 0; i < n; i++) {
+		hhigh.add(i * 3);
+		hdirect.add(i * 3);
+	}
+	UT_ASSERT(hlow.merge(hhigh));
+	UT_IS(hlow.estimate(), hdirect.estimate());
+	UT_ASSERT(relerr(hlow.estimate(), n) < 0.3);
+
+	// can't go the other way
+	UT_ASSERT(!hhigh.merge(hlow));
+}
@@ -0,0 +1,169 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the quantile sketch.
+
+#include <utest/Utest.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <common/QuantileSketch.h>
+
+// a permutation of 0..n-1
+static void mkperm(vector<int> &v, int n, unsigned seed)
+{
+	v.resize(n);
+	for (int i = 0; i < n; i++)
+		v[i] = i;
+	srandom(seed);
+	for (int i = n - 1; i > 0; i--) {
+		int j = random() % (i + 1);
+		int x = v[i];
+		v[i] = v[j];
+		v[j] = x;
+	}
+}
+
+UTESTCASE empty(Utest *utest)
+{
+	QuantileSketch qs;
+	UT_IS(qs.getK(), (int)QuantileSketch::DEFAULT_K);
+	UT_IS(qs.getCount(), 0);
+	double res = -1.;
+	UT_ASSERT(!qs.quantile(0.5, res));
+	UT_IS(res, -1.);
+	UT_IS(qs.rank(10.), 0);
+
+	QuantileSketch qsmall(1);
+	UT_IS(qsmall.getK(), (int)QuantileSketch::MIN_K);
+}
+
+UTESTCASE exact(Utest *utest)
+{
+	// while nothing is compacted, the results are exact
+	QuantileSketch qs;
+	for (int i = 1; i <= 100; i++)
+		qs.add(i);
+	UT_IS(qs.getCount(), 100);
+	UT_IS(qs.getRetained(), 100);
+	double res;
+	UT_ASSERT(qs.quantile(0.5, res));
+	UT_IS(res, 50.);
+	UT_ASSERT(qs.quantile(0., res));
+	UT_IS(res, 1.);
+	UT_ASSERT(qs.quantile(1., res));
+	UT_IS(res, 100.);
+	UT_IS(qs.rank(10.), 10);
+
+	qs.clear();
+	UT_IS(qs.getCount(), 0);
+	UT_ASSERT(!qs.quantile(0.5, res));
+}
+
+UTESTCASE accuracy(Utest *utest)
+{
+	const int n = 100000;
+	vector<int> perm;
+	mkperm(perm, n, 1);
+
+	QuantileSketch qs;
+	size_t maxRetained = 0;
+	for (int i = 0; i < n; i++) {
+		qs.add(perm[i]);
+		if (qs.getRetained() > maxRetained)
+			maxRetained = qs.getRetained();
+	}
+	UT_IS(qs.getCount(), (uint64_t)n);
+	// the memory stays bounded
+	UT_ASSERT(maxRetained < 3 * QuantileSketch::DEFAULT_K + 64);
+
+	double qv[] = { 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99 };
+	for (size_t i = 0; i < sizeof(qv)/sizeof(qv[0]); i++) {
+		double res;
+		UT_ASSERT(qs.quantile(qv[i], res));
+		// the values are the ranks, within 2%
+		if (UT_ASSERT(fabs(res - qv[i] * n) < 0.02 * n))
+			printf("q=%g res=%g\n", qv[i], res);
+		double r = (double)qs.rank(qv[i] * n);
+		UT_ASSERT(fabs(r - qv[i] * n) < 0.02 * n);
+	}
+
+	// the weights add up to the count
+	QuantileSketch::WeightedVec items;
+	qs.getWeighted(items);
+	UT_IS(items.size(), qs.getRetained());
+	uint64_t total = 0;
+	for (size_t i = 0; i < items.size(); i++) {
+		total += items[i].weight_;
+		if (i > 0)
+			UT_ASSERT(items[i-1].val_ <= items[i].val_);
+	}
+	UT_IS(total, (uint64_t)n);
+}
+
+UTESTCASE merge(Utest *utest)
+{
+	const int n = 50000;
+	vector<int> perm;
+	mkperm(perm, n, 2);
+
+	// the sketches get different halves of the value range
+	QuantileSketch qs1, qs2, qs3(50);
+	for (int i = 0; i < n; i++) {
+		if (perm[i] < n / 2)
+			qs1.add(perm[i]);
+		else
+			qs2.add(perm[i]);
+	}
+	qs1.merge(qs2);
+	UT_IS(qs1.getCount(), (uint64_t)n);
+	UT_ASSERT(qs1.getRetained() < 3 * QuantileSketch::DEFAULT_K + 64);
+
+	double res;
+	UT_ASSERT(qs1.quantile(0.5, res));
+	UT_ASSERT(fabs(res - 0.5 * n) < 0.02 * n);
+	UT_ASSERT(qs1.quantile(0.9, res));
+	UT_ASSERT(fabs(res - 0.9 * n) < 0.02 * n);
+
+	// merging into a less accurate sketch
+	qs3.merge(qs1);
+	UT_IS(qs3.getCount(), (uint64_t)n);
+	UT_ASSERT(qs3.getRetained() < 3 * 50 + 64);
+	UT_ASSERT(qs3.quantile(0.5, res));
+	UT_ASSERT(fabs(res - 0.5 * n) < 0.05 * n);
+}
+
+UTESTCASE netQuantile(Utest *utest)
+{
+	const int n = 20000;
+	vector<int> perm;
+	mkperm(perm, n, 3);
+
+	// add all, then remove the lower half
+	QuantileSketch ins, del;
+	double res = -1.;
+	UT_ASSERT(!QuantileSketch::netQuantile(ins, del, 0.5, res));
+	for (int i = 0; i < n; i++)
+		ins.add(perm[i]);
+	for (int i = 0; i < n; i++) {
+		if (perm[i] < n / 2)
+			del.add(perm[i]);
+	}
+
+	UT_ASSERT(QuantileSketch::netQuantile(ins, del, 0.5, res));
+	UT_ASSERT(fabs(res - 0.75 * n) < 0.03 * n);
+	UT_ASSERT(QuantileSketch::netQuantile(ins, del, 0.1, res));
+	UT_ASSERT(fabs(res - 0.55 * n) < 0.03 * n);
+
+	// everything removed
+	for (int i = 0; i < n; i++) {
+		if (perm[i] >= n / 2)
+			del.add(perm[i]);
+	}
+	res = -1.;
+	UT_ASSERT(!QuantileSketch::netQuantile(ins, del, 0.5, res));
+	UT_IS(res, -1.);
+}
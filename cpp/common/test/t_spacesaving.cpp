@@ -0,0 +1,123 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the Space-Saving summary of the frequent values.
+
+#include <utest/Utest.h>
+#include <stdlib.h>
+
+#include <common/SpaceSaving.h>
+#include <common/StringUtil.h>
+
+UTESTCASE exact(Utest *utest)
+{
+	// while the counters are enough, the counts are exact
+	SpaceSaving ss(10);
+	UT_IS(ss.getCapacity(), 10);
+	UT_IS(ss.size(), 0);
+	for (int i = 0; i < 5; i++) {
+		for (int j = 0; j <= i; j++)
+			ss.add(strprintf("v%d", i));
+	}
+	UT_IS(ss.size(), 5);
+
+	SpaceSaving::CounterVec top;
+	ss.top(3, top);
+	UT_IS(top.size(), 3);
+	UT_IS(top[0]->key_, "v4");
+	UT_IS(top[0]->count_, 5);
+	UT_IS(top[0]->error_, 0);
+	UT_IS(top[1]->key_, "v3");
+	UT_IS(top[2]->key_, "v2");
+
+	// the ties go by the value
+	ss.add("v2");
+	ss.top(10, top);
+	UT_IS(top.size(), 5);
+	UT_IS(top[1]->key_, "v2");
+	UT_IS(top[2]->key_, "v3");
+
+	// the removal down to 0 drops the counter
+	UT_ASSERT(ss.remove("v0"));
+	UT_ASSERT(!ss.remove("v0"));
+	UT_ASSERT(ss.find("v0") == NULL);
+	UT_IS(ss.size(), 4);
+	UT_ASSERT(ss.remove("v4"));
+	UT_IS(ss.find("v4")->count_, 4);
+
+	ss.clear();
+	UT_IS(ss.size(), 0);
+
+	SpaceSaving ss0(0);
+	UT_IS(ss0.getCapacity(), 1);
+}
+
+UTESTCASE eviction(Utest *utest)
+{
+	SpaceSaving ss(3);
+	const SpaceSaving::Counter *c;
+	string ev = "none";
+	UT_ASSERT(!ss.add("a", c, ev));
+	UT_ASSERT(!ss.add("a", c, ev));
+	UT_ASSERT(!ss.add("b", c, ev));
+	UT_ASSERT(!ss.add("c", c, ev));
+	UT_IS(c->key_, "c");
+	UT_IS(ev, "none");
+	// takes over the smallest of b and c
+	UT_ASSERT(ss.add("d", c, ev));
+	UT_ASSERT(ev == "b" || ev == "c");
+	UT_IS(c->key_, "d");
+	UT_IS(c->count_, 2);
+	UT_IS(c->error_, 1);
+	UT_IS(ss.size(), 3);
+	UT_ASSERT(ss.find(ev) == NULL);
+}
+
+UTESTCASE evictionEmpty(Utest *utest)
+{
+	// the empty string is a value like any other
+	SpaceSaving ss(1);
+	const SpaceSaving::Counter *c;
+	string ev = "none";
+	UT_ASSERT(!ss.add("", c, ev));
+	UT_IS(c->key_, "");
+	UT_ASSERT(ss.add("a", c, ev));
+	UT_IS(ev, "");
+	UT_IS(c->key_, "a");
+	UT_ASSERT(ss.find("") == NULL);
+}
+
+UTESTCASE heavy(Utest *utest)
+{
+	// a few heavy values in a lot of noise
+	SpaceSaving ss(50);
+	srandom(5);
+	const int n = 100000;
+	int64_t real1 = 0;
+	for (int i = 0; i < n; i++) {
+		int r = random() % 100;
+		if (r < 10) {
+			ss.add("heavy1");
+			++real1;
+		} else if (r < 18)
+			ss.add("heavy2");
+		else if (r < 24)
+			ss.add("heavy3");
+		else
+			ss.add(strprintf("noise%d", (int)(random() % 10000)));
+	}
+	UT_IS(ss.size(), 50);
+
+	SpaceSaving::CounterVec top;
+	ss.top(3, top);
+	UT_IS(top.size(), 3);
+	UT_IS(top[0]->key_, "heavy1");
+	UT_IS(top[1]->key_, "heavy2");
+	UT_IS(top[2]->key_, "heavy3");
+	// the real count is within the error
+	UT_ASSERT(top[0]->count_ >= real1);
+	UT_ASSERT(top[0]->count_ - top[0]->error_ <= real1);
+}
@@ -0,0 +1,32 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the TSC clock.
+
+#include <utest/Utest.h>
+#include <time.h>
+
+#include <common/Tsc.h>
+
+UTESTCASE tsc(Utest *utest)
+{
+	uint64_t t0 = Tsc::now();
+	uint64_t t1 = Tsc::now();
+	UT_ASSERT(t1 >= t0);
+
+	double rate = Tsc::ticksPerNs();
+	UT_ASSERT(rate > 0.);
+	UT_IS(Tsc::ticksPerNs(), rate); // cached after the first call
+
+	// a sleep of 20 ms must measure at least approximately right
+	struct timespec delay = { 0, 20 * 1000 * 1000 };
+	t0 = Tsc::now();
+	nanosleep(&delay, NULL);
+	t1 = Tsc::now();
+	double ns = Tsc::toNs(t1 - t0);
+	UT_ASSERT(ns >= 15. * 1000 * 1000);
+	UT_ASSERT(ns < 2000. * 1000 * 1000);
+}
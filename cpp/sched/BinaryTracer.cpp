@@ -0,0 +1,307 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A low-overhead tracer that records the events into a binary ring buffer.
+
+#include <string.h>
+#include <sched/BinaryTracer.h>
+#include <common/Tsc.h>
+#include <common/StringUtil.h>
+
+namespace TRICEPS_NS {
+
+// the name used when a label or unit is not found in the dictionary
+static string placeholderName = "[unknown]";
+
+BinaryTracer::BinaryTracer(size_t capacity, bool verbose, bool addresses) :
+	next_(0),
+	start_(0),
+	sampling_(1),
+	sampleCount_(0),
+	verbose_(verbose),
+	addresses_(addresses),
+	filtering_(false)
+{
+	size_t sz = MIN_CAPACITY;
+	while (sz < capacity)
+		sz *= 2;
+	ring_.resize(sz);
+	memset(&ring_[0], 0, sz * sizeof(Record));
+	mask_ = sz - 1;
+	memset(&lastSample_, 0, sizeof(lastSample_));
+}
+
+BinaryTracer::~BinaryTracer()
+{ }
+
+void BinaryTracer::execute(Unit *unit, const Label *label, const Label *fromLabel, Rowop *rop, Unit::TracerWhen when)
+{
+	if (!verbose_ && when != Unit::TW_BEFORE)
+		return;
+	if (sampling_ > 1 && !sample(unit, fromLabel, rop, when))
+		return;
+
+	uint8_t flags = knowLabel(label);
+	if (filtering_ && !(flags & LF_TRACED))
+		return;
+	if (fromLabel != NULL)
+		knowLabel(fromLabel);
+	knowUnit(unit);
+
+	uint64_t seq = next_;
+	Record &r = ring_[seq & mask_];
+	// invalidate the record while it's being written
+	__atomic_store_n(&r.seq_, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	r.time_ = Tsc::now();
+	r.rop_ = rop;
+	r.unitId_ = unit->getId();
+	r.labelId_ = label->getId();
+	r.fromLabelId_ = (fromLabel == NULL? 0 : fromLabel->getId());
+	r.opcode_ = rop->getOpcode();
+	r.when_ = when;
+	__atomic_store_n(&r.seq_, seq + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&next_, seq + 1, __ATOMIC_RELEASE);
+}
+
+bool BinaryTracer::sample(Unit *unit, const Label *fromLabel, Rowop *rop, Unit::TracerWhen when)
+{
+	if (fromLabel != NULL) // a chained label, same as its parent
+		return samples_.empty()? lastSample_.on_ : samples_.back().on_;
+
+	int depth = unit->getStackDepth();
+	switch (when) {
+	case Unit::TW_BEFORE:
+		{
+			// Forget the rowops left over from the exceptions. A rowop at
+			// the same depth may be the parent only when it drains its
+			// forked rowops.
+			while (!samples_.empty() && (samples_.back().depth_ > depth
+					|| (samples_.back().depth_ == depth && !samples_.back().drain_)))
+				samples_.pop_back();
+			Sample s;
+			s.rop_ = rop;
+			s.depth_ = depth;
+			s.drain_ = false;
+			if (samples_.empty())
+				s.on_ = (sampleCount_++ % sampling_ == 0);
+			else
+				s.on_ = samples_.back().on_; // a part of the parent's execution
+			samples_.push_back(s);
+			return s.on_;
+		}
+	case Unit::TW_AFTER:
+	case Unit::TW_AFTER_DRAIN:
+		if (samples_.empty())
+			return lastSample_.on_;
+		lastSample_ = samples_.back();
+		samples_.pop_back();
+		return lastSample_.on_;
+	case Unit::TW_BEFORE_DRAIN:
+		{
+			// the draining follows right after the call of the same rowop
+			Sample s = lastSample_;
+			s.drain_ = true;
+			samples_.push_back(s);
+			return s.on_;
+		}
+	default:
+		return samples_.empty()? lastSample_.on_ : samples_.back().on_;
+	}
+}
+
+void BinaryTracer::addLabel(const Label *lab)
+{
+	uint32_t id = lab->getId();
+	if (id >= knownLabels_.size()) {
+		KnownLabel none;
+		none.serial_ = 0;
+		none.flags_ = 0;
+		knownLabels_.resize(id * 2 + 1, none);
+	}
+
+	pw::lockmutex lm(mutex_);
+	LabelVersions &lv = labels_[id];
+	if (!lv.empty()) {
+		// the old label is gone and its id got reused
+		Superseded sup;
+		sup.seq_ = next_;
+		sup.id_ = id;
+		superseded_.push_back(sup);
+	}
+	lv.push_back(LabelInfo());
+	LabelInfo &li = lv.back();
+	li.since_ = next_;
+	li.label_ = lab;
+	li.name_ = lab->getName();
+
+	KnownLabel &kl = knownLabels_[id];
+	kl.serial_ = lab->getSerial();
+	kl.flags_ = 0; // a new label doesn't inherit the filter
+
+	// The old versions can be dropped when all their records
+	// have been overwritten in the ring.
+	uint64_t cap = ring_.size();
+	while (!superseded_.empty() && superseded_.front().seq_ + cap <= next_) {
+		labels_[superseded_.front().id_].pop_front();
+		superseded_.pop_front();
+	}
+}
+
+void BinaryTracer::addUnit(const Unit *unit)
+{
+	uint32_t id = unit->getId();
+	if (id >= unitKnown_.size())
+		unitKnown_.resize(id * 2 + 1, 0);
+
+	pw::lockmutex lm(mutex_);
+	UnitInfo &ui = units_[id];
+	ui.unit_ = unit;
+	ui.name_ = unit->getName();
+	unitKnown_[id] = 1;
+}
+
+void BinaryTracer::addFilterLabel(Onceref<Label> lab)
+{
+	Autoref<Label> lref = lab;
+	knowLabel(lref);
+	knownLabels_[lref->getId()].flags_ |= LF_TRACED;
+	filtering_ = true;
+}
+
+void BinaryTracer::clearFilter()
+{
+	for (KnownLabelVec::iterator it = knownLabels_.begin(); it != knownLabels_.end(); ++it)
+		it->flags_ &= ~LF_TRACED;
+	filtering_ = false;
+}
+
+void BinaryTracer::clearBuffer()
+{
+	// the records stay in the ring but get excluded from the snapshots
+	__atomic_store_n(&start_, next_, __ATOMIC_RELEASE);
+
+	knownLabels_.clear();
+	unitKnown_.clear();
+	filtering_ = false;
+	sampleCount_ = 0;
+	samples_.clear();
+	memset(&lastSample_, 0, sizeof(lastSample_));
+
+	pw::lockmutex lm(mutex_);
+	labels_.clear();
+	superseded_.clear();
+	units_.clear();
+}
+
+const BinaryTracer::LabelInfo *BinaryTracer::findLabel(uint32_t id, uint64_t seq) const
+{
+	LabelMap::const_iterator it = labels_.find(id);
+	if (it == labels_.end())
+		return NULL;
+	const LabelVersions &lv = it->second;
+	for (LabelVersions::const_reverse_iterator vit = lv.rbegin(); vit != lv.rend(); ++vit) {
+		if (vit->since_ <= seq)
+			return &*vit;
+	}
+	return NULL; // the version has been already dropped
+}
+
+void BinaryTracer::snapshot(RecordVec &recs) const
+{
+	recs.clear();
+	uint64_t start = __atomic_load_n(&start_, __ATOMIC_ACQUIRE);
+	uint64_t end = __atomic_load_n(&next_, __ATOMIC_ACQUIRE);
+	uint64_t cap = ring_.size();
+	if (end - start > cap)
+		start = end - cap;
+	recs.reserve(end - start);
+
+	for (uint64_t seq = start; seq < end; seq++) {
+		const Record &r = ring_[seq & mask_];
+		if (__atomic_load_n(&r.seq_, __ATOMIC_ACQUIRE) != seq + 1)
+			continue; // already overwritten
+		Record copy = r;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&r.seq_, __ATOMIC_RELAXED) != seq + 1)
+			continue; // got overwritten while copying
+		copy.seq_ = seq + 1;
+		recs.push_back(copy);
+	}
+}
+
+void BinaryTracer::decode(const RecordVec &recs, Erref dest, bool addresses) const
+{
+	pw::lockmutex lm(mutex_);
+	for (RecordVec::const_iterator it = recs.begin(); it != recs.end(); ++it) {
+		const Record &r = *it;
+
+		const string *uname = &placeholderName;
+		const Unit *uaddr = NULL;
+		UnitMap::const_iterator uit = units_.find(r.unitId_);
+		if (uit != units_.end()) {
+			uname = &uit->second.name_;
+			uaddr = uit->second.unit_;
+		}
+		uint64_t seq = r.seq_ - 1;
+		const string *lname = &placeholderName;
+		const Label *laddr = NULL;
+		const LabelInfo *li = findLabel(r.labelId_, seq);
+		if (li != NULL) {
+			lname = &li->name_;
+			laddr = li->label_;
+		}
+		const char *when = Unit::tracerWhenHumanString(r.when_);
+
+		string res;
+		if (addresses) {
+			res = strprintf("unit %p '%s' %s label %p '%s' ",
+				uaddr, uname->c_str(), when, laddr, lname->c_str());
+		} else {
+			res = strprintf("unit '%s' %s label '%s' ",
+				uname->c_str(), when, lname->c_str());
+		}
+
+		if (r.fromLabelId_ != 0) {
+			const string *fname = &placeholderName;
+			const Label *faddr = NULL;
+			li = findLabel(r.fromLabelId_, seq);
+			if (li != NULL) {
+				fname = &li->name_;
+				faddr = li->label_;
+			}
+			if (addresses)
+				res.append(strprintf("(chain %p '%s') ", faddr, fname->c_str()));
+			else
+				res.append(strprintf("(chain '%s') ", fname->c_str()));
+		}
+
+		if (addresses)
+			res.append(strprintf("op %p %s", r.rop_, Rowop::opcodeString(r.opcode_)));
+		else
+			res.append(strprintf("op %s", Rowop::opcodeString(r.opcode_)));
+
+		if (verbose_) {
+			if (Unit::tracerWhenIsBefore(r.when_))
+				res.append(" {");
+			else if (Unit::tracerWhenIsAfter(r.when_))
+				res.append(" }");
+		}
+
+		dest->appendMsg(false, res);
+	}
+}
+
+Erref BinaryTracer::getBuffer()
+{
+	RecordVec recs;
+	snapshot(recs);
+	Erref buf = new Errors;
+	decode(recs, buf, addresses_);
+	return buf;
+}
+
+}; // TRICEPS_NS
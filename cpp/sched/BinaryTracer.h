@@ -0,0 +1,278 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A low-overhead tracer that records the events into a binary ring buffer.
+
+#ifndef __Triceps_BinaryTracer_h__
+#define __Triceps_BinaryTracer_h__
+
+#include <map>
+#include <deque>
+#include <pw/ptwrap.h>
+#include <sched/Unit.h>
+
+namespace TRICEPS_NS {
+
+// The StringTracer formats a string for every event, which is way too
+// slow for the production. The BinaryTracer records only the binary
+// data of the events into a fixed-size ring buffer, without any memory
+// allocation in the common path. When the buffer fills up, the new
+// records overwrite the oldest ones, so the buffer always contains the
+// latest history.
+//
+// A record contains the ids of the unit, label and chaining parent label
+// (see Unit::getId() and Label::getId()), the address of the rowop, the
+// opcode, the timestamp from the Tsc clock, and the TracerWhen value.
+// The names and addresses of the units and labels get remembered in a
+// dictionary when they are first seen. Only this first sighting takes
+// a lock, after that the tracer finds that it knows a unit or label
+// by its id in the vectors that only the writer uses. The labels are
+// not held by the dictionary, and the id of a destroyed label may get
+// reused by a new label (the tracer tells them apart by
+// Label::getSerial()). Then the dictionary keeps the name of the old
+// label only as long as its records may still be in the ring buffer,
+// so its size is limited by the number of the live labels and the
+// capacity of the buffer. The contents of the rows are not recorded.
+//
+// The records can be decoded, at any later time, into the same text
+// as produced by the StringTracer (with the addresses) or StringNameTracer
+// (without them). getBuffer() returns the decoded text, so the
+// BinaryTracer can be used as a drop-in replacement for these tracers.
+//
+// The recording may be limited by sampling and by the label filter.
+// The sampling selects 1 in N of the top-level rowops (the ones not
+// called from inside another rowop), and records all the events of
+// each selected rowop, including the ones of its chained labels, of the
+// rowops it forks and of the rowops called from it. If an Exception
+// interrupts the execution, the sampling may go off for a short while
+// until the tracer sees the next rowop at the same or higher level of the
+// stack.
+//
+// The ring buffer has one writer: the tracer must be used only by the
+// units of the same thread. But it can be read (by snapshot(), decode()
+// and getBuffer()) from any thread, without stopping the writer: the
+// records are protected by the sequence numbers, and the records that
+// get overwritten while being read are skipped.
+class BinaryTracer : public Unit::Tracer
+{
+public:
+	enum {
+		DEFAULT_CAPACITY = 64 * 1024, // default number of records in the buffer
+		MIN_CAPACITY = 16,
+	};
+
+	// One recorded event.
+	struct Record
+	{
+		uint64_t seq_; // the sequence number of the record plus 1, 0 while being written
+		uint64_t time_; // the timestamp, in Tsc ticks
+		const Rowop *rop_; // for the identification only, never dereferenced
+		uint32_t unitId_;
+		uint32_t labelId_;
+		uint32_t fromLabelId_; // the chaining parent's id or 0
+		int32_t opcode_; // Rowop::Opcode
+		int32_t when_; // Unit::TracerWhen
+	};
+	typedef vector<Record> RecordVec;
+
+	// @param capacity - number of records in the ring buffer, gets rounded
+	//        up to a power of 2, no less than MIN_CAPACITY
+	// @param verbose - if true, record all the events, otherwise only the TW_BEFORE records
+	// @param addresses - if true, the text from getBuffer() is in the
+	//        format of the StringTracer, otherwise in the format of the
+	//        StringNameTracer
+	BinaryTracer(size_t capacity = DEFAULT_CAPACITY, bool verbose = false, bool addresses = false);
+	~BinaryTracer();
+
+	// from Tracer
+	virtual void execute(Unit *unit, const Label *label, const Label *fromLabel, Rowop *rop, Unit::TracerWhen when);
+
+	// Decodes all the records in the buffer.
+	// from Tracer
+	virtual Erref getBuffer();
+
+	// Drops all the records, the dictionary, the filter, and restarts
+	// the sampling. Must be called only
+	// from the writer's thread. The records snapshotted before can't be
+	// decoded any more after that.
+	// from Tracer
+	virtual void clearBuffer();
+
+	// Get the number of records in the ring buffer.
+	size_t getCapacity() const
+	{
+		return ring_.size();
+	}
+
+	// Get the number of records written since the creation or the last
+	// clearBuffer(), including the ones overwritten since.
+	uint64_t getCount() const
+	{
+		return __atomic_load_n(&next_, __ATOMIC_ACQUIRE) - __atomic_load_n(&start_, __ATOMIC_ACQUIRE);
+	}
+
+	// Set the sampling: record only 1 in n top-level rowops. Must be called only
+	// from the writer's thread.
+	// @param n - the sampling rate, 1 or less to record all the rowops
+	void setSampling(int n)
+	{
+		sampling_ = n < 1? 1 : n;
+	}
+
+	int getSampling() const
+	{
+		return sampling_;
+	}
+
+	// Add a label to the filter. As long as the filter contains any
+	// labels, only the events of these labels are recorded. The events
+	// where the label is the chaining parent don't count. The filter
+	// doesn't hold the label, when it gets destroyed, it drops out of
+	// the filter.
+	// Must be called only from the writer's thread.
+	// @param lab - the label to record
+	void addFilterLabel(Onceref<Label> lab);
+
+	// Clear the filter, starting to record all the labels again.
+	// Must be called only from the writer's thread.
+	void clearFilter();
+
+	// Check whether the filter is in effect.
+	bool isFiltering() const
+	{
+		return filtering_;
+	}
+
+	// Copy the records from the buffer, in the order of their writing.
+	// May be called from any thread.
+	// @param recs - vector to put the records into, its old contents
+	//        gets replaced
+	void snapshot(RecordVec &recs) const;
+
+	// Decode the records into the text lines in the format of
+	// StringTracer or StringNameTracer, appending them to the errors
+	// buffer. The units and labels get found in this tracer's dictionary,
+	// so these must be the records from this tracer, not preceding the
+	// last clearBuffer(). May be called from any thread.
+	// @param recs - the records to decode
+	// @param dest - the buffer to append the text to
+	// @param addresses - if true, use the format of the StringTracer,
+	//        otherwise of StringNameTracer
+	void decode(const RecordVec &recs, Erref dest, bool addresses) const;
+
+protected:
+	// The information about a label in the dictionary.
+	struct LabelInfo
+	{
+		uint64_t since_; // sequence number of the first record that may refer to it
+		const Label *label_; // for printing only
+		string name_;
+	};
+	// The labels that had the same id, oldest first.
+	typedef deque<LabelInfo> LabelVersions;
+	typedef map<uint32_t, LabelVersions> LabelMap;
+
+	// A label version that has been replaced by a newer one.
+	struct Superseded
+	{
+		uint64_t seq_; // sequence number of the first record after it got replaced
+		uint32_t id_;
+	};
+	typedef deque<Superseded> SupersededDeque;
+
+	// The information about a unit in the dictionary.
+	struct UnitInfo
+	{
+		const Unit *unit_; // for printing only
+		string name_;
+	};
+	typedef map<uint32_t, UnitInfo> UnitMap;
+
+	// The flags of the labels known to the writer.
+	enum {
+		LF_TRACED = 0x01, // the label is in the filter
+	};
+
+	// The writer's knowledge of a label id.
+	struct KnownLabel
+	{
+		uint64_t serial_; // serial of the label in the dictionary, 0 if none
+		uint8_t flags_;
+	};
+	typedef vector<KnownLabel> KnownLabelVec;
+	typedef vector<uint8_t> FlagVec;
+
+	// Make sure that the label is in the dictionary.
+	// @param lab - label to find
+	// @return - its flags
+	uint8_t knowLabel(const Label *lab)
+	{
+		uint32_t id = lab->getId();
+		if (id >= knownLabels_.size() || knownLabels_[id].serial_ != lab->getSerial())
+			addLabel(lab);
+		return knownLabels_[id].flags_;
+	}
+
+	// The slow path of knowLabel() that adds the label to the dictionary.
+	void addLabel(const Label *lab);
+
+	// Make sure that the unit is in the dictionary.
+	void knowUnit(const Unit *unit)
+	{
+		uint32_t id = unit->getId();
+		if (id >= unitKnown_.size() || !unitKnown_[id])
+			addUnit(unit);
+	}
+
+	// The slow path of knowUnit() that adds the unit to the dictionary.
+	void addUnit(const Unit *unit);
+
+	// Find the label that a record refers to. The caller must hold mutex_.
+	// @param id - id of the label
+	// @param seq - sequence number of the record
+	// @return - the label information, or NULL if not known any more
+	const LabelInfo *findLabel(uint32_t id, uint64_t seq) const;
+
+	// Track the nesting of the rowops for the sampling.
+	// @return - true if the event has to be recorded
+	bool sample(Unit *unit, const Label *fromLabel, Rowop *rop, Unit::TracerWhen when);
+
+	// The sampling decision for a rowop in execution.
+	struct Sample
+	{
+		const Rowop *rop_;
+		int depth_; // the stack depth of the unit at the start
+		bool drain_; // flag: this is the draining of the rowop's frame
+		bool on_; // flag: the rowop is recorded
+	};
+	typedef vector<Sample> SampleVec;
+
+	RecordVec ring_; // the ring buffer, the size is a power of 2
+	size_t mask_; // size of ring_ minus 1
+	uint64_t next_; // sequence number of the next record to write
+	uint64_t start_; // sequence number of the first record after clearBuffer()
+	int sampling_; // record 1 in sampling_ rowops
+	uint64_t sampleCount_; // the count of the top-level rowops for sampling
+	SampleVec samples_; // the stack of the rowops in execution
+	Sample lastSample_; // the last rowop that has completed its call
+	bool verbose_; // flag: record all the events, not only TW_BEFORE
+	bool addresses_; // flag: getBuffer() uses the format of the StringTracer
+	bool filtering_; // flag: record only the labels with LF_TRACED set
+	KnownLabelVec knownLabels_; // the labels in the dictionary by id, used only by the writer
+	FlagVec unitKnown_; // the flags of the units in the dictionary by id, used only by the writer
+	mutable pw::pmutex mutex_; // protects the dictionaries between the writer and readers
+	LabelMap labels_;
+	SupersededDeque superseded_; // the replaced label versions, in the order of replacement
+	UnitMap units_;
+
+private:
+	BinaryTracer(const BinaryTracer &);
+	void operator=(const BinaryTracer &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_BinaryTracer_h__
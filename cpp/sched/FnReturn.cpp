@@ -261,7 +261,7 @@ void FnReturn::RetLabel::execute(Rowop *arg) const
 					fnret_->facet_->flushWriter();
 				}
 			} else {
-				xtray->push_back(idx_, arg->getRow(), arg->getOpcode());
+				xtray->push_back(idx_, arg->getRow(), arg->getOpcode(), arg->getOldRow());
 			}
 		}
 	}
@@ -293,6 +293,29 @@ done_xtray:
 	}
 }
 
+void FnReturn::RetLabel::executeBatch(Rowop *const *rops, size_t n) const
+{
+	// the writing to a Nexus is done one by one
+	if (!fnret_->xtray_.isNull() || fnret_->stack_.empty()) {
+		Label::executeBatch(rops, n);
+		return;
+	}
+	FnBinding *top = fnret_->stack_.back();
+	Label *lab = top->getLabel(idx_);
+	if (lab == NULL)
+		return; // not bound here
+	if (!lab->isBatching() || lab->getUnitPtr() != unit_ || top->getTray() != NULL) {
+		Label::executeBatch(rops, n); // also reports the errors
+		return;
+	}
+
+	vector<Autoref<Rowop> > adrops(n);
+	vector<Rowop *> ptrs(n);
+	for (size_t i = 0; i < n; i++)
+		ptrs[i] = adrops[i] = new Rowop(lab, rops[i]);
+	unit_->callBatchAsChained(lab, &ptrs[0], n, this);
+}
+
 void FnReturn::RetLabel::clearSubclass()
 {
 	fnret_->clear();
@@ -93,6 +93,10 @@ protected:
 		// Throws an Exception if the label in the binding is cleared.
 		virtual void execute(Rowop *arg) const;
 		// from Label
+		// If the label in the binding is batching too, forwards the whole
+		// batch to it, otherwise falls back to execute() for each rowop.
+		virtual void executeBatch(Rowop *const *rops, size_t n) const;
+		// from Label
 		// Clears the FnReturn.
 		virtual void clearSubclass();
 
@@ -42,19 +42,37 @@ void Gadget::send(const Row *row, Rowop::Opcode opcode) const
 
 	if (mode_ != EM_IGNORE) {
 		Autoref<Rowop> rop = new Rowop(label_, opcode, row);
-		switch(mode_) {
-		case EM_SCHEDULE:
-			unit_->schedule(rop);
-			break;
-		case EM_FORK:
-			unit_->fork(rop);
-			break;
-		case EM_CALL:
-			unit_->call(rop);
-			break;
-		default:
-			break; // shut up the compiler
-		}
+		enqueue(rop);
+	}
+}
+
+void Gadget::sendUpdate(const Row *row, const Row *oldRow) const
+{
+	assert(!label_.isNull());
+
+	if (row == NULL)
+		return; // nothing to do
+
+	if (mode_ != EM_IGNORE) {
+		Autoref<Rowop> rop = Rowop::makeUpdate(label_, row, oldRow);
+		enqueue(rop);
+	}
+}
+
+void Gadget::enqueue(Rowop *rop) const
+{
+	switch(mode_) {
+	case EM_SCHEDULE:
+		unit_->schedule(rop);
+		break;
+	case EM_FORK:
+		unit_->fork(rop);
+		break;
+	case EM_CALL:
+		unit_->call(rop);
+		break;
+	default:
+		break; // shut up the compiler
 	}
 }
 
@@ -99,6 +99,13 @@ protected:
 	// XXX later will add timestamp and sequence
 	void send(const Row *row, Rowop::Opcode opcode) const;
 
+	// Send an OP_UPDATE that replaces the old row with the new one.
+	// All the caveats from send() apply.
+	//
+	// @param row - the new row, may be NULL which will be ignored and produce nothing
+	// @param oldRow - the old row being replaced
+	void sendUpdate(const Row *row, const Row *oldRow) const;
+
 	// Collect a row in the delayed tray, with the right enqueueing mode, to be
 	// sent later. All the caveats from send() apply.
 	//
@@ -108,6 +115,9 @@ protected:
 	void sendDelayed(Tray *dest, const Row *row, Rowop::Opcode opcode) const;
 
 protected:
+	// Enqueue a constructed rowop according to the mode.
+	void enqueue(Rowop *rop) const;
+
 	Autoref<Unit> unit_; // unit where it belongs (and Unit must not autoref gadgets, to avoid loops)
 	Autoref<Label> label_; // this gadget's label
 	const_Autoref<RowType> type_; // type of rows
@@ -6,23 +6,148 @@
 //
 // CEP code label.
 
+#include <typeinfo>
+#include <algorithm>
+#include <string.h>
+#include <pthread.h>
 #include <sched/Rowop.h>
 #include <sched/Label.h>
 #include <sched/Unit.h>
 #include <common/Exception.h>
 #include <common/BusyMark.h>
+#include <common/Tsc.h>
 
 namespace TRICEPS_NS {
 
+////////////////////////////////////// LabelStats /////////////////////////////////
+
+LabelStats::LabelStats()
+{
+	clear();
+}
+
+void LabelStats::clear()
+{
+	calls_ = 0;
+	rows_ = 0;
+	totalTicks_ = 0;
+	selfTicks_ = 0;
+	exceptions_ = 0;
+	rejects_ = 0;
+	maxRecursion_ = 0;
+	memset(histogram_, 0, sizeof(histogram_));
+}
+
+// Measures the time of one call of a label and updates its statistics.
+// The statistics get updated and the caller's accumulator of the nested
+// time gets restored in the destructor, so that it happens on any exit
+// from the call. The call is counted as thrown unless finished() was
+// called before the destruction.
+class LabelStatsMeter
+{
+public:
+	// @param unit - unit where the label is called
+	// @param stats - statistics of the label
+	// @param recursion - the recursion depth of the label in this call
+	// @param rows - number of rowops processed in the call
+	LabelStatsMeter(Unit *unit, LabelStats *stats, int recursion, size_t rows) :
+		nested_(unit->statsNestedTicks()),
+		stats_(stats),
+		rows_(rows),
+		histogram_(unit->isLabelHistograms()),
+		exception_(true)
+	{
+		if (recursion > stats_->maxRecursion_)
+			stats_->maxRecursion_ = recursion;
+		saved_ = nested_;
+		nested_ = 0;
+		start_ = Tsc::now();
+	}
+
+	// Update the statistics at the end of the call.
+	~LabelStatsMeter()
+	{
+		uint64_t ticks = Tsc::now() - start_;
+		uint64_t self = ticks > nested_? ticks - nested_ : 0;
+		nested_ = saved_ + ticks; // all of this is nested for the caller
+
+		stats_->calls_++;
+		stats_->rows_ += rows_;
+		stats_->totalTicks_ += ticks;
+		stats_->selfTicks_ += self;
+		if (exception_)
+			stats_->exceptions_++;
+		if (histogram_) {
+			int b = 0;
+			for (uint64_t t = ticks; t != 0; t >>= 1)
+				++b;
+			stats_->histogram_[b < LabelStats::HISTOGRAM_SIZE? b : LabelStats::HISTOGRAM_SIZE - 1]++;
+		}
+	}
+
+	// Mark that the call has returned normally.
+	void finished()
+	{
+		exception_ = false;
+	}
+
+protected:
+	uint64_t &nested_; // the unit's accumulator of the nested time
+	uint64_t saved_; // the caller's nested time
+	uint64_t start_; // the start time of the call
+	LabelStats *stats_;
+	size_t rows_;
+	bool histogram_;
+	bool exception_; // flag: the call has not returned normally
+};
+
 ////////////////////////////////////// Label /////////////////////////////////
 
+// The ids of the labels. The freed ids get reused, so that the ids stay
+// small even if the labels keep getting created and destroyed.
+static pthread_mutex_t labelIdMutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t lastLabelId = 0;
+// allocated on demand and never destroyed, to be safe from the order
+// of the static destruction
+static vector<uint32_t> *freeLabelIds = NULL;
+
+static uint32_t allocLabelId()
+{
+	uint32_t id;
+	pthread_mutex_lock(&labelIdMutex);
+	if (freeLabelIds == NULL || freeLabelIds->empty()) {
+		id = ++lastLabelId;
+	} else {
+		id = freeLabelIds->back();
+		freeLabelIds->pop_back();
+	}
+	pthread_mutex_unlock(&labelIdMutex);
+	return id;
+}
+
+// the last serial number assigned to a label
+static uint64_t lastLabelSerial = 0;
+
+static void freeLabelId(uint32_t id)
+{
+	pthread_mutex_lock(&labelIdMutex);
+	if (freeLabelIds == NULL)
+		freeLabelIds = new vector<uint32_t>;
+	freeLabelIds->push_back(id);
+	pthread_mutex_unlock(&labelIdMutex);
+}
+
 Label::Label(Unit *unit, const_Onceref<RowType> rtype, const string &name) :
 	type_(rtype),
 	unit_(unit),
 	name_(name),
+	id_(allocLabelId()),
+	serial_(__atomic_add_fetch(&lastLabelSerial, 1, __ATOMIC_RELAXED)),
 	recursion_(0),
 	cleared_(false),
-	nonReentrant_(false)
+	nonReentrant_(false),
+	batching_(false),
+	stats_(NULL)
 {
 	assert(unit);
 	assert(!type_.isNull());
@@ -30,7 +155,10 @@ Label::Label(Unit *unit, const_Onceref<RowType> rtype, const string &name) :
 }
 
 Label::~Label()
-{ }
+{
+	delete stats_;
+	freeLabelId(id_);
+}
 
 // not inside the function, or it will be initialized in screwed-up order
 static string placeholderUnitName = "[label cleared]";
@@ -76,17 +204,23 @@ Erref Label::chain(Onceref<Label> lab, bool front)
 	} else {
 		chained_.push_back(lab);
 	}
+	if (!cleared_) // the unit might be gone already
+		unit_->chainChanged();
 	return NULL;
 }
 
 void Label::clearChained()
 {
 	chained_.clear();
+	flat_ = NULL;
+	if (!cleared_)
+		unit_->chainChanged();
 }
 
 void Label::clear()
 {
 	if (!cleared_) {
+		unit_->chainChanged();
 		cleared_ = true;
 		Erref err;
 		try {
@@ -104,6 +238,28 @@ void Label::clearSubclass()
 { }
 
 void Label::call(Unit *unit, Rowop *arg, const Label *chainedFrom) const
+{
+	// the common case checks only one setting
+	Unit::CallMode mode = unit->getCallMode();
+	if (mode == Unit::CM_RECURSIVE)
+		callRecursive(unit, arg, chainedFrom);
+	else if (mode == Unit::CM_FLAT)
+		callFlat(unit, arg);
+	else
+		callStats(unit, arg, chainedFrom);
+}
+
+void Label::callStats(Unit *unit, Rowop *arg, const Label *chainedFrom) const
+{
+	if (cleared_) // don't count the skipped calls
+		return;
+
+	LabelStatsMeter meter(unit, makeStats(), recursion_ + 1, 1);
+	callRecursive(unit, arg, chainedFrom);
+	meter.finished();
+}
+
+void Label::callRecursive(Unit *unit, Rowop *arg, const Label *chainedFrom) const
 {
 	if (cleared_) // don't try to execute a cleared label
 		return;
@@ -132,14 +288,15 @@ void Label::call(Unit *unit, Rowop *arg, const Label *chainedFrom) const
 	} catch (Exception e) {
 		throw Exception::f(e, "Error when tracing before the label '%s':", getName().c_str());
 	}
+	Unit::RejectMark rm(unit);
 	try {
 		execute(arg);
 	} catch (Exception e) {
-		Erref err = e.getErrors();
+		Erref err = e.peekErrors();
 		err.f("Called through the label '%s'.", getName().c_str());
 		throw; // the errors buffer got changed in place!
 	}
-	if (!chained_.empty()) {
+	if (!chained_.empty() && !rm.isRejected(arg)) {
 		try {
 			unit->trace(this, chainedFrom, arg, Unit::TW_BEFORE_CHAINED);
 		} catch (Exception e) {
@@ -149,7 +306,7 @@ void Label::call(Unit *unit, Rowop *arg, const Label *chainedFrom) const
 			try {
 				(*it)->call(unit, arg, this); // each of them can do their own chaining....
 			} catch (Exception e) {
-				Erref err = e.getErrors();
+				Erref err = e.peekErrors();
 				err.f("Called chained from the label '%s'.", getName().c_str());
 				throw; // the errors buffer got changed in place!
 			}
@@ -169,6 +326,195 @@ void Label::call(Unit *unit, Rowop *arg, const Label *chainedFrom) const
 	// The tracing for TW_BEFORE_DRAIN and TW_AFTER_DRAIN happens in Unit.cpp.
 }
 
+void Label::reject(Rowop *arg, const string &msg) const
+{
+	unit_->reject(this, arg, msg);
+}
+
+void Label::executeBatch(Rowop *const *rops, size_t n) const
+{
+	for (size_t i = 0; i < n; i++)
+		execute(rops[i]);
+}
+
+void Label::callBatch(Unit *unit, Rowop *const *rops, size_t n) const
+{
+	if (unit->isLabelStats()) {
+		if (cleared_) // don't count the skipped calls
+			return;
+
+		LabelStatsMeter meter(unit, makeStats(), recursion_ + 1, n);
+		callBatchGuts(unit, rops, n);
+		meter.finished();
+		return;
+	}
+
+	callBatchGuts(unit, rops, n);
+}
+
+void Label::callBatchGuts(Unit *unit, Rowop *const *rops, size_t n) const
+{
+	if (cleared_) // don't try to execute a cleared label
+		return;
+
+	if (unit != unit_) {
+		throw Exception::fTrace("Triceps API violation: call() attempt with unit '%s' of label '%s' belonging to unit '%s'.\n", 
+			unit->getName().c_str(), getName().c_str(), unit_->getName().c_str());
+	}
+
+	if (nonReentrant_ && recursion_ >= 1)
+		throw Exception::fTrace("Detected a recursive call of the non-reentrant label '%s'.", getName().c_str());
+
+	{
+		int rec = unit->maxRecursionDepth();
+		if (rec > 0 && recursion_ >= rec)
+			throw Exception::fTrace("Exceeded the unit recursion depth limit %d (attempted %d) on the label '%s'.",
+				rec, recursion_ + 1,
+				getName().c_str());
+	}
+
+	BusyCounter bm(recursion_);
+
+	Unit::RejectMark rm(unit);
+	try {
+		executeBatch(rops, n);
+	} catch (Exception e) {
+		Erref err = e.peekErrors();
+		err.f("Called through the label '%s'.", getName().c_str());
+		throw; // the errors buffer got changed in place!
+	}
+	if (chained_.empty())
+		return;
+
+	// the rejected rowops don't go to the chain
+	vector<Rowop *> accepted;
+	if (!rm.empty()) {
+		Unit::RejectMark::RopVec &rej = rm.rops_;
+		sort(rej.begin(), rej.end());
+		for (size_t i = 0; i < n; i++)
+			if (!binary_search(rej.begin(), rej.end(), (const Rowop *)rops[i]))
+				accepted.push_back(rops[i]);
+		if (accepted.empty())
+			return;
+		rops = &accepted[0];
+		n = accepted.size();
+	}
+
+	for (ChainedVec::const_iterator it = chained_.begin(); it != chained_.end(); ++it) {
+		try {
+			if ((*it)->batching_) {
+				(*it)->callBatch(unit, rops, n);
+			} else {
+				for (size_t i = 0; i < n; i++)
+					(*it)->call(unit, rops[i], this);
+			}
+		} catch (Exception e) {
+			Erref err = e.peekErrors();
+			err.f("Called chained from the label '%s'.", getName().c_str());
+			throw; // the errors buffer got changed in place!
+		}
+	}
+}
+
+void Label::flattenChain(FlatChain *fc, int parent) const
+{
+	int idx = fc->entries_.size();
+	FlatChain::Entry e;
+	e.label_ = this;
+	e.parent_ = parent;
+	e.end_ = idx + 1;
+	e.exec_ = (typeid(*this) != typeid(DummyLabel));
+	fc->entries_.push_back(e);
+
+	for (ChainedVec::const_iterator it = chained_.begin(); it != chained_.end(); ++it) {
+		const Label *lab = *it;
+		// a DummyLabel without a chain has nothing to do
+		// and can never be found on the call stack
+		// (but a wrong unit must still be detected)
+		if (lab->chained_.empty() && lab->unit_ == unit_ && typeid(*lab) == typeid(DummyLabel))
+			continue;
+		fc->refs_.push_back(*it);
+		lab->flattenChain(fc, idx);
+	}
+	fc->entries_[idx].end_ = fc->entries_.size();
+}
+
+void Label::callFlat(Unit *unit, Rowop *arg) const
+{
+	if (cleared_) // don't try to execute a cleared label
+		return;
+
+	if (unit != unit_) {
+		throw Exception::fTrace("Triceps API violation: call() attempt with unit '%s' of label '%s' belonging to unit '%s'.\n", 
+			unit->getName().c_str(), getName().c_str(), unit_->getName().c_str());
+	}
+
+	if (flat_.isNull() || flat_->gen_ != unit->getChainGen()) {
+		flat_ = new FlatChain;
+		flat_->gen_ = unit->getChainGen();
+		flattenChain(flat_, -1);
+	}
+	Autoref<FlatChain> fc = flat_; // in case if the chains get changed during the call
+	const FlatChain::EntryVec &ev = fc->entries_;
+	int n = ev.size();
+	int rec = unit->maxRecursionDepth();
+
+	// The recursion counts of the labels in the current path from the root
+	// stay incremented like on the recursive call stack. The top is the
+	// last entry whose count has been incremented.
+	int top = -1;
+	int i = 0;
+	try {
+		while (i < n) {
+			const FlatChain::Entry &e = ev[i];
+			for (; top != e.parent_; top = ev[top].parent_)
+				--ev[top].label_->recursion_;
+
+			const Label *lab = e.label_;
+			if (lab->cleared_) {
+				i = e.end_; // cleared while in the chain, skip it with all its chain
+				continue;
+			}
+			if (lab->unit_ != unit) {
+				throw Exception::fTrace("Triceps API violation: call() attempt with unit '%s' of label '%s' belonging to unit '%s'.\n", 
+					unit->getName().c_str(), lab->getName().c_str(), lab->unit_->getName().c_str());
+			}
+			if (lab->nonReentrant_ && lab->recursion_ >= 1)
+				throw Exception::fTrace("Detected a recursive call of the non-reentrant label '%s'.", lab->getName().c_str());
+			if (rec > 0 && lab->recursion_ >= rec)
+				throw Exception::fTrace("Exceeded the unit recursion depth limit %d (attempted %d) on the label '%s'.",
+					rec, lab->recursion_ + 1,
+					lab->getName().c_str());
+
+			++lab->recursion_;
+			top = i;
+			if (e.exec_) {
+				Unit::RejectMark rm(unit);
+				lab->execute(arg);
+				if (rm.isRejected(arg)) {
+					i = e.end_; // the rejected rowop doesn't go to the chain
+					continue;
+				}
+			}
+			++i;
+		}
+	} catch (Exception e) {
+		// same messages as from the recursive calls
+		Erref err = e.peekErrors();
+		if (top == i) // thrown from execute()
+			err.f("Called through the label '%s'.", ev[i].label_->getName().c_str());
+		for (int p = ev[i].parent_; p >= 0; p = ev[p].parent_)
+			err.f("Called chained from the label '%s'.", ev[p].label_->getName().c_str());
+		for (; top >= 0; top = ev[top].parent_)
+			--ev[top].label_->recursion_;
+		throw; // the errors buffer got changed in place!
+	}
+	for (; top >= 0; top = ev[top].parent_)
+		--ev[top].label_->recursion_;
+
+	// The tracing for TW_BEFORE_DRAIN and TW_AFTER_DRAIN happens in Unit.cpp.
+}
+
 bool Label::findChained(const Label *target, ChainedVec &path) const
 {
 	for (ChainedVec::const_iterator it = chained_.begin(); it != chained_.end(); ++it) {
@@ -185,5 +531,23 @@ bool Label::findChained(const Label *target, ChainedVec &path) const
 void DummyLabel::execute(Rowop *arg) const
 { }
 
+////////////////////////////////////// UpdateSplitLabel /////////////////////////////////
+
+UpdateSplitLabel::UpdateSplitLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name) :
+	Label(unit, rtype, name),
+	outLabel_(new DummyLabel(unit, rtype, name + ".out"))
+{ }
+
+void UpdateSplitLabel::execute(Rowop *arg) const
+{
+	if (arg->getOpcode() == Rowop::OP_UPDATE) {
+		if (arg->getOldRow() != NULL)
+			unit_->call(new Rowop(outLabel_, Rowop::OP_DELETE, arg->getOldRow()));
+		unit_->call(new Rowop(outLabel_, Rowop::OP_INSERT, arg->getRow()));
+	} else {
+		unit_->call(new Rowop(outLabel_, arg));
+	}
+}
+
 
 }; // TRICEPS_NS
@@ -19,6 +19,34 @@ class Rowop;
 class Unit;
 class RowType;
 
+// The execution statistics of a label, collected when enabled in the
+// Unit (see Unit::setLabelStats()). The times are measured in the ticks of
+// the Tsc clock, use Tsc::toNs() to convert them to nanoseconds.
+struct LabelStats
+{
+	enum {
+		HISTOGRAM_SIZE = 64, // number of buckets in the histogram
+	};
+
+	LabelStats();
+
+	// Reset all the values to 0.
+	void clear();
+
+	uint64_t calls_; // number of calls (a batch counts as one call)
+	uint64_t rows_; // number of rowops processed
+	uint64_t totalTicks_; // total time of the calls, including the chained and nested labels
+	uint64_t selfTicks_; // the time of the calls without the other labels
+	uint64_t exceptions_; // number of calls that ended with an exception
+	uint64_t rejects_; // number of rowops rejected by the label (see Label::reject())
+	int maxRecursion_; // the maximal depth of recursion attempted, 1 means no recursion
+	// The histogram of the call times (the total ones), collected only
+	// if enabled with Unit::setLabelHistograms(). The bucket i counts
+	// the calls that took from 2^(i-1) to 2^i-1 ticks, the bucket 0 counts
+	// the calls that took 0 ticks.
+	uint64_t histogram_[HISTOGRAM_SIZE];
+};
+
 // A label provides a way to call some user-defined code to handle an event.
 // This works by subclassing: define your own subclass and define the method 
 // execute() in it that does what you need. It's a functor object.
@@ -96,6 +124,23 @@ public:
 		return name_;
 	}
 
+	// Get the numeric id of the label. The ids are small numbers, unique
+	// among the live labels in the process, starting from 1. The id of a
+	// destroyed label may get reused by a new label. They allow the
+	// tracers to keep the per-label information in the vectors.
+	uint32_t getId() const
+	{
+		return id_;
+	}
+
+	// Get the serial number of the label. Unlike the id, it never gets
+	// reused, so it tells apart the labels that had the same id at
+	// different times. The serials start from 1.
+	uint64_t getSerial() const
+	{
+		return serial_;
+	}
+
 	// Mark the label as non-reentrant. This is essentially setting its
 	// little private recursion depth limit to 1 (i.e. it can occur only
 	// once on the call stack, never nested).
@@ -111,6 +156,53 @@ public:
 		return nonReentrant_;
 	}
 
+	// Enable or disable the batch execution of this label.
+	//
+	// When a frame of the Unit has several consecutive rowops for a batching
+	// label, the Unit passes them all at once to executeBatch(), up to
+	// Unit::BATCH_SIZE at a time. This happens when draining the frames,
+	// including the frame of callTray(), but not in the direct call() and
+	// callNext(). The batching gets skipped when the unit has a tracer.
+	//
+	// The batching changes the order of execution in a few ways, and by
+	// enabling it the label agrees to that:
+	// * The chained labels get called after the whole batch has been
+	//   executed. The batching chained labels get the whole batch in
+	//   their executeBatch(), the other ones get the rowops one by one,
+	//   in their original order.
+	// * The rowops forked by the label or its chain get executed after the
+	//   whole batch, not after each rowop.
+	// * On an Exception the rest of the batch gets thrown away, the same
+	//   as the rest of the frame normally does.
+	//
+	// When the label is constructed, the batching is disabled.
+	//
+	// @param on - true to enable, false to disable
+	void setBatching(bool on)
+	{
+		batching_ = on;
+	}
+
+	// Check whether the label executes the rowops in batches.
+	bool isBatching() const
+	{
+		return batching_;
+	}
+
+	// Get the execution statistics of the label (see Unit::setLabelStats()).
+	// @return - the statistics, or NULL if they have never been collected
+	const LabelStats *getStats() const
+	{
+		return stats_;
+	}
+
+	// Reset the execution statistics of the label to 0.
+	void clearStats()
+	{
+		if (stats_ != NULL)
+			stats_->clear();
+	}
+
 	// Clear this label's references. 
 	// Once cleared, the label can not be called any more.
 	// The topology of inter-label connections may include loops
@@ -156,6 +248,26 @@ protected:
 	// arg - operation to perform; the caller holds a reference on it.
 	virtual void execute(Rowop *arg) const = 0;
 
+	// The batching subclasses (see setBatching()) may re-define this method
+	// to handle many rowops in one go. The default implementation calls
+	// execute() for each rowop in order.
+	// May throw an Exception.
+	//
+	// @param rops - the rowops to perform, all for this label; the caller
+	//        holds the references on them
+	// @param n - number of rowops, > 0
+	virtual void executeBatch(Rowop *const *rops, size_t n) const;
+
+	// Reject a rowop with an expected error, such as incorrect data,
+	// instead of throwing an Exception (see Unit::reject()). Normally
+	// called from execute(), which then returns without processing
+	// the rowop. The rejected rowop doesn't get passed to the chained
+	// labels.
+	//
+	// @param arg - the rowop being rejected
+	// @param msg - the reason of the rejection
+	void reject(Rowop *arg, const string &msg) const;
+
 protected:
 	friend class Unit;
 
@@ -173,6 +285,37 @@ protected:
 	// chainedFrom - if this call is a result of chaining, the chain parent
 	void call(Unit *unit, Rowop *arg, const Label *chainedFrom = NULL) const;
 
+	// The implementation of call() in the normal recursive way.
+	// Same arguments as call().
+	void callRecursive(Unit *unit, Rowop *arg, const Label *chainedFrom) const;
+
+	// The implementation of call() that collects the statistics.
+	// Same arguments as call().
+	void callStats(Unit *unit, Rowop *arg, const Label *chainedFrom) const;
+
+	// The batch version of call(), calls executeBatch() and then the
+	// chained labels (see setBatching()). It's used only when the unit
+	// has no tracer, so it does no tracing.
+	//
+	// May throw an Exception.
+	//
+	// unit - unit from where called (should be the same as in constructor)
+	// rops - operations to perform; the caller holds the references on them
+	// n - number of rowops, > 0
+	void callBatch(Unit *unit, Rowop *const *rops, size_t n) const;
+
+	// The guts of callBatch(), without the statistics.
+	// Same arguments as callBatch().
+	void callBatchGuts(Unit *unit, Rowop *const *rops, size_t n) const;
+
+	// Get the statistics object, creating it if needed.
+	LabelStats *makeStats() const
+	{
+		if (stats_ == NULL)
+			stats_ = new LabelStats;
+		return stats_;
+	}
+
 	// Check for circular dependencies when adding a label.
 	// Goes recursively through all the chained labels reachable from
 	// here and looks for the target label. If found, builds a path
@@ -186,15 +329,54 @@ protected:
 	//        (so normally should be passed as an empty list to the outermost call)
 	// @return - true if found
 	bool findChained(const Label *target, ChainedVec &path) const;
+
+	// The transitive chain of a label, flattened for the dispatch
+	// without recursion (see Unit::setFlatChaining()).
+	// The entries go in the order of the recursive calls, each
+	// chained label following its parent. The DummyLabels that
+	// have nothing chained to them are dropped altogether.
+	// The DummyLabels with a chain stay, since they still count in
+	// the recursion limits and the error messages, but their
+	// execute() gets skipped.
+	class FlatChain : public Starget
+	{
+	public:
+		struct Entry
+		{
+			const Label *label_;
+			int parent_; // index of the entry of the parent label, -1 for the root
+			int end_; // index after the last entry of this label's chain
+			bool exec_; // flag: the label has something to execute
+		};
+		typedef vector<Entry> EntryVec;
+
+		EntryVec entries_;
+		ChainedVec refs_; // keeps the labels alive while the chain is in use
+		uint64_t gen_; // generation of the chains in the unit, when built
+	};
+
+	// Build the flat chain (the recursive part).
+	// @param fc - the chain to append the entries to
+	// @param parent - index of the parent entry
+	void flattenChain(FlatChain *fc, int parent) const;
+
+	// The implementation of call() in the flat chaining mode.
+	// Same arguments as call().
+	void callFlat(Unit *unit, Rowop *arg) const;
 	
 protected:
 	ChainedVec chained_; // the chained labels
 	const_Autoref<RowType> type_; // type of the row handled here
 	Unit *unit_; // not a reference, but more of a token
 	string name_; // human-readable name for tracing
+	uint32_t id_; // the unique id among the live labels
+	uint64_t serial_; // the unique serial number, never reused
 	mutable int recursion_; // the current recursion depth of this label
 	bool cleared_; // flag: clear() was called, and the label should stop working
 	bool nonReentrant_; // flag: this label is not reentrant
+	bool batching_; // flag: the rowops may be passed to executeBatch()
+	mutable Autoref<FlatChain> flat_; // the flattened chain, built on demand
+	mutable LabelStats *stats_; // the execution statistics, created on demand
 };
 
 // A label that does nothing: typically used as an endpoint for chaining in the 
@@ -211,6 +393,36 @@ protected:
 	virtual void execute(Rowop *arg) const;
 };
 
+// An adapter for the labels that don't understand the OP_UPDATE:
+// it passes through all the rowops to its output label, except that
+// each OP_UPDATE with an old row gets split into an OP_DELETE of the
+// old row followed by an OP_INSERT of the new row. An OP_UPDATE without
+// an old row becomes a plain OP_INSERT.
+//
+// Chain this label from the source of updates, and the legacy
+// labels from its output label.
+class UpdateSplitLabel : public Label
+{
+public:
+	// @param unit - the unit where this label belongs
+	// @param rtype - type of row to be handled by this label
+	// @param name - name of this label, the output label gets the
+	//        suffix ".out" added to it
+	UpdateSplitLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name);
+
+	// Get the label where the split rowops come out.
+	Label *getOutputLabel() const
+	{
+		return outLabel_;
+	}
+
+protected:
+	// from Label
+	virtual void execute(Rowop *arg) const;
+
+	Autoref<Label> outLabel_;
+};
+
 }; // TRICEPS_NS
 
 #endif // __Triceps_Label_h__
@@ -16,6 +16,7 @@ namespace TRICEPS_NS {
 Rowop::Rowop(const Label *label, Opcode op, const Row *row) :
 	label_(label),
 	row_(row),
+	oldRow_(NULL),
 	opcode_(op),
 	enqMode_(Gadget::EM_FORK)
 {
@@ -27,6 +28,7 @@ Rowop::Rowop(const Label *label, Opcode op, const Row *row) :
 Rowop::Rowop(const Label *label, Opcode op, const Rowref &row) :
 	label_(label),
 	row_(row),
+	oldRow_(NULL),
 	opcode_(op),
 	enqMode_(Gadget::EM_FORK)
 {
@@ -38,6 +40,7 @@ Rowop::Rowop(const Label *label, Opcode op, const Rowref &row) :
 Rowop::Rowop(const Label *label, Opcode op, const Row *row, int enqMode) :
 	label_(label),
 	row_(row),
+	oldRow_(NULL),
 	opcode_(op),
 	enqMode_(enqMode)
 {
@@ -49,6 +52,7 @@ Rowop::Rowop(const Label *label, Opcode op, const Row *row, int enqMode) :
 Rowop::Rowop(const Label *label, Opcode op, const Rowref &row, int enqMode) :
 	label_(label),
 	row_(row),
+	oldRow_(NULL),
 	opcode_(op),
 	enqMode_(enqMode)
 {
@@ -57,24 +61,49 @@ Rowop::Rowop(const Label *label, Opcode op, const Rowref &row, int enqMode) :
 		row_->incref(); // manual reference keeping
 }
 
+Rowop::Rowop(const Label *label, Opcode op, const Row *row, const Row *oldRow) :
+	label_(label),
+	row_(row),
+	oldRow_(oldRow),
+	opcode_(op),
+	enqMode_(Gadget::EM_FORK)
+{
+	assert(label);
+	if (row_)
+		row_->incref(); // manual reference keeping
+	if (oldRow_)
+		oldRow_->incref();
+}
+
+Rowop *Rowop::makeWithOldRow(const Label *label, Opcode op, const Row *row, const Row *oldRow)
+{
+	return new Rowop(label, op, row, oldRow);
+}
+
 Rowop::Rowop(const Rowop &orig) :
 	label_(orig.getLabel()),
 	row_(orig.getRow()),
+	oldRow_(orig.getOldRow()),
 	opcode_(orig.getOpcode()),
 	enqMode_(orig.getEnqMode())
 {
 	if (row_)
 		row_->incref(); // manual reference keeping
+	if (oldRow_)
+		oldRow_->incref();
 }
 
 Rowop::Rowop(const Label *label, const Rowop *orig) :
 	label_(label),
 	row_(orig->getRow()),
+	oldRow_(orig->getOldRow()),
 	opcode_(orig->getOpcode()),
 	enqMode_(orig->getEnqMode())
 {
 	if (row_)
 		row_->incref(); // manual reference keeping
+	if (oldRow_)
+		oldRow_->incref();
 }
 
 Rowop::~Rowop()
@@ -83,12 +112,17 @@ Rowop::~Rowop()
 		if (row_->decref() <= 0)
 			label_->getType()->destroyRow(const_cast<Row *>(row_));
 	}
+	if (oldRow_) {
+		if (oldRow_->decref() <= 0)
+			label_->getType()->destroyRow(const_cast<Row *>(oldRow_));
+	}
 }
 
 Valname opcodes[] = {
 	{ Rowop::OP_NOP, "OP_NOP" },
 	{ Rowop::OP_INSERT, "OP_INSERT" },
 	{ Rowop::OP_DELETE, "OP_DELETE" },
+	{ Rowop::OP_UPDATE, "OP_UPDATE" },
 	{ -1, NULL }
 };
 
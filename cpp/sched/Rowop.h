@@ -41,7 +41,9 @@ public:
 		//   0 - a NOP
 		//   INSERT - insert a row, also used for generally passing the rows around
 		//   DELETE - delete a row, generally undoing a previous action
-		//   (INSERT|DELETE) - currently not defined and may cause random effects
+		//   (INSERT|DELETE) - UPDATE, replace an old row with a new one; the
+		//       labels that look only at the INSERT flag see it as the insert
+		//       of the new row, and the old row is carried separately
 		OCF_INSERT = 0x01,
 		OCF_DELETE = 0x02
 	};
@@ -50,6 +52,7 @@ public:
 		OP_NOP = 0,
 		OP_INSERT = OCF_INSERT,
 		OP_DELETE = OCF_DELETE,
+		OP_UPDATE = (OCF_INSERT|OCF_DELETE), // the row is the new one, see getOldRow()
 		OP_BAD = (~3), // a NOP opcode returned in bad conversions from string
 	};
 
@@ -67,6 +70,22 @@ public:
 	Rowop(const Label *label, Opcode op, const Row *row, int enqMode);
 	Rowop(const Label *label, Opcode op, const Rowref &row, int enqMode);
 
+	// Make a rowop that carries also the old row, normally an OP_UPDATE.
+	// Since the UPDATE has both the INSERT and DELETE flags set, the code
+	// that does not know about it will see it as an insert of the new row.
+	// The enqMode is EM_FORK, as in the constructors without it.
+	// @param label - the label to send the rowop to
+	// @param op - the opcode
+	// @param row - the new row
+	// @param oldRow - the old row that gets replaced, may be NULL
+	static Rowop *makeWithOldRow(const Label *label, Opcode op, const Row *row, const Row *oldRow);
+
+	// The common case of makeWithOldRow(), an OP_UPDATE.
+	static Rowop *makeUpdate(const Label *label, const Row *row, const Row *oldRow)
+	{
+		return makeWithOldRow(label, OP_UPDATE, row, oldRow);
+	}
+
 	Rowop(const Rowop &orig);
 	// Adoption: use the same opcode etc. with another label
 	Rowop(const Label *label, const Rowop *orig);
@@ -114,6 +133,22 @@ public:
 		return row_;
 	}
 
+	// The old row of an UPDATE, NULL for the other rowops.
+	const Row *getOldRow() const
+	{
+		return oldRow_;
+	}
+
+	// Check if this is an update with the old row present.
+	static bool isUpdate(int op)
+	{
+		return (op & (OCF_INSERT|OCF_DELETE)) == (OCF_INSERT|OCF_DELETE);
+	}
+	bool isUpdate() const
+	{
+		return isUpdate(opcode_);
+	}
+
 	int getEnqMode() const
 	{
 		return enqMode_;
@@ -129,8 +164,13 @@ public:
 	static int stringOcf(const char *flag);
 
 protected:
+	// Used by makeWithOldRow(). With a public constructor, passing the old
+	// row as NULL would be ambiguous with the enqMode.
+	Rowop(const Label *label, Opcode op, const Row *row, const Row *oldRow);
+
 	const_Autoref<Label> label_;
 	const Row *row_; // a manual reference, the type from Label will be used for deletion
+	const Row *oldRow_; // the old row of an UPDATE, a manual reference like row_
 	// no timestamp nor sequence now, these will come later
 	Opcode opcode_;
 	int enqMode_; // enqueueing mode, as in Gadget::EnqMode
@@ -16,6 +16,13 @@ namespace TRICEPS_NS {
 
 ///////////////////////////// UnitFrame //////////////////////////////////
 
+UnitFrame::UnitFrame() :
+	ring_(INITIAL_CAPACITY),
+	mask_(INITIAL_CAPACITY - 1),
+	head_(0),
+	count_(0)
+{ }
+
 UnitFrame::~UnitFrame()
 {
 	clear();
@@ -27,8 +34,33 @@ void UnitFrame::clear()
 		markList_->clear();
 		markList_ = NULL;
 	}
-	if (!empty())
-		Tray::clear();
+	for (; count_ > 0; --count_) {
+		ring_[head_] = NULL;
+		head_ = (head_ + 1) & mask_;
+	}
+	head_ = 0;
+}
+
+void UnitFrame::grow()
+{
+	RingVec nring(ring_.size() * 2);
+	for (size_t i = 0; i < count_; i++)
+		nring[i].swap(ring_[(head_ + i) & mask_]);
+	ring_.swap(nring);
+	mask_ = ring_.size() - 1;
+	head_ = 0;
+}
+
+size_t UnitFrame::pop_batch(Autoref<Rowop> *refs, Rowop **rops, size_t max)
+{
+	const Label *lab = front()->getLabel();
+	size_t n = 0;
+	do {
+		rops[n] = ring_[head_];
+		pop_front(refs[n]);
+		++n;
+	} while (n < max && count_ != 0 && ring_[head_]->getLabel() == lab);
+	return n;
 }
 
 void UnitFrame::mark(Unit *unit, Onceref<FrameMark> mk)
@@ -149,14 +181,21 @@ void Unit::StringNameTracer::execute(Unit *unit, const Label *label, const Label
 
 ///////////////////////////// Unit //////////////////////////////////
 
+// the last id assigned to a unit
+static uint32_t lastUnitId = 0;
+
 Unit::Unit(const string &name) :
-	name_(name), stackDepth_(1),
+	name_(name), id_(__atomic_add_fetch(&lastUnitId, 1, __ATOMIC_RELAXED)), stackDepth_(1),
 	maxStackDepth_(0), maxRecursionDepth_(1),
-	clearing_(false)
+	clearing_(false), flatChaining_(false), chainGen_(0),
+	labelStats_(false), callMode_(CM_RECURSIVE), labelHistograms_(false), statsNestedTicks_(0),
+	rejectCount_(0), maxRejects_(DEFAULT_MAX_REJECTS), rejectMark_(NULL)
 {
 	// the outermost frame is always present
-	innerFrame_ = outerFrame_ = new UnitFrame;
-	queue_.push_front(outerFrame_);
+	frames_.reserve(PREALLOC_FRAMES);
+	for (int i = 0; i < PREALLOC_FRAMES; i++)
+		frames_.push_back(new UnitFrame);
+	innerFrame_ = outerFrame_ = frames_[0];
 
 	// create the empty row type instance
 	RowType::FieldVec fv; // empty!
@@ -167,6 +206,9 @@ Unit::Unit(const string &name) :
 Unit::~Unit()
 {
 	clearLabels();
+
+	for (FrameVec::iterator it = frames_.begin(); it != frames_.end(); ++it)
+		delete *it;
 }
 
 void Unit::schedule(Onceref<Rowop> rop)
@@ -222,6 +264,16 @@ void Unit::callGuts(Rowop *rop)
 	popFrame();
 }
 
+void Unit::callBatchAsChained(const Label *label, Rowop *const *rops, size_t n, const Label *chainedFrom)
+{
+	if (label->isBatching() && tracer_.isNull()) {
+		label->callBatch(this, rops, n);
+	} else {
+		for (size_t i = 0; i < n; i++)
+			label->call(this, rops[i], chainedFrom);
+	}
+}
+
 void Unit::callTray(const_Onceref<Tray> tray)
 {
 	pushFrame();
@@ -335,17 +387,50 @@ void Unit::loopTrayAt(FrameMark *mark, const_Onceref<Tray> tray)
 void Unit::callNext()
 {
 	if (!innerFrame_->empty()) {
-		Autoref<Rowop> rop = innerFrame_->front();
-		innerFrame_->pop_front();
+		Autoref<Rowop> rop;
+		innerFrame_->pop_front(rop);
 		callGuts(rop);
 	}
 }
 
+void Unit::callNextBatch()
+{
+	Autoref<Rowop> refs[BATCH_SIZE];
+	Rowop *rops[BATCH_SIZE];
+	size_t n = innerFrame_->pop_batch(refs, rops, BATCH_SIZE);
+	if (n == 1) {
+		callGuts(rops[0]);
+		return;
+	}
+
+	const Label *lab = rops[0]->getLabel();
+	if (maxStackDepth_ > 0 && stackDepth_ >= maxStackDepth_) {
+		throw Exception::fTrace("Unit '%s' exceeded the stack depth limit %d, current depth %d, when calling the label '%s'.",
+			name_.c_str(), maxStackDepth_, stackDepth_+1, lab->getName().c_str());
+	}
+
+	pushFrame();
+
+	try {
+		lab->callBatch(this, rops, n); // may throw
+		drainForkedFrame(lab, rops[n-1]);
+	} catch (Exception e) {
+		popFrame();
+		throw;
+	}
+
+	popFrame();
+}
+
 void Unit::drainFrame()
 {
 	try {
-		while (!innerFrame_->empty())
-			callNext(); // may throw
+		while (!innerFrame_->empty()) {
+			if (isBatchNext())
+				callNextBatch(); // may throw
+			else
+				callNext(); // may throw
+		}
 	} catch (Exception e) {
 		innerFrame_->clear(); // the frame gets cleared anyway, by throwing things out
 		throw;
@@ -355,8 +440,8 @@ void Unit::drainFrame()
 void Unit::callNextForked()
 {
 	if (!innerFrame_->empty()) {
-		Autoref<Rowop> rop = innerFrame_->front();
-		innerFrame_->pop_front();
+		Autoref<Rowop> rop;
+		innerFrame_->pop_front(rop);
 
 		// Runs in the parent's inherited frame.
 		rop->getLabel()->call(this, rop); // may throw
@@ -364,6 +449,19 @@ void Unit::callNextForked()
 	}
 }
 
+void Unit::callNextForkedBatch()
+{
+	Autoref<Rowop> refs[BATCH_SIZE];
+	Rowop *rops[BATCH_SIZE];
+	size_t n = innerFrame_->pop_batch(refs, rops, BATCH_SIZE);
+
+	// Runs in the parent's inherited frame.
+	if (n == 1)
+		rops[0]->getLabel()->call(this, rops[0]); // may throw
+	else
+		rops[0]->getLabel()->callBatch(this, rops, n); // may throw
+}
+
 void Unit::drainForkedFrame(const Label *lab, Rowop *rop)
 {
 	if (innerFrame_->empty())
@@ -376,8 +474,12 @@ void Unit::drainForkedFrame(const Label *lab, Rowop *rop)
 			lab->getName().c_str());
 	}
 	try {
-		while (!innerFrame_->empty())
-			callNextForked(); // may throw
+		while (!innerFrame_->empty()) {
+			if (isBatchNext())
+				callNextForkedBatch(); // may throw
+			else
+				callNextForked(); // may throw
+		}
 	} catch (Exception e) {
 		innerFrame_->clear(); // the frame gets cleared anyway, by throwing things out
 		// this might not be the exact parent label, since the forking might have
@@ -401,32 +503,21 @@ bool Unit::empty() const
 
 void Unit::pushFrame()
 {
-	if (freePool_.empty()) {
-		innerFrame_ = new UnitFrame;
-		queue_.push_front(innerFrame_);
-	} else {
-		innerFrame_ = freePool_.front();
-		queue_.push_front(innerFrame_);
-		freePool_.pop_front(); // only after it has been pushed onto queue
-	}
+	if ((size_t)stackDepth_ == frames_.size())
+		frames_.push_back(new UnitFrame);
+	innerFrame_ = frames_[stackDepth_];
 	stackDepth_++;
-	// fprintf(stderr, "DEBUG Unit::pushFrame (%d) new %p\n", (int)queue_.size(), innerFrame_);
 }
 
 void Unit::popFrame()
 {
-	// fprintf(stderr, "DEBUG Unit::popFrame (%d) was %p\n", (int)queue_.size(), innerFrame_);
-	
 	// make sure that there are no stray rowops left (such as after an exception)
 	innerFrame_->clear(); 
 
 	if (innerFrame_ != outerFrame_) { // never pop the outermost frame
-		freePool_.push_front(innerFrame_); // save for later
-		queue_.pop_front();
-		innerFrame_ = queue_.front();
 		stackDepth_--;
+		innerFrame_ = frames_[stackDepth_ - 1];
 	}
-	// fprintf(stderr, "DEBUG Unit::popFrame (%d) now %p\n", (int)queue_.size(), innerFrame_);
 }
 
 Valname twhens[] = {
@@ -472,6 +563,7 @@ int Unit::humanStringTracerWhen(const char *when)
 void Unit::setTracer(Onceref<Tracer> tracer)
 {
 	tracer_ = tracer;
+	updateCallMode();
 }
 
 void Unit::trace(const Label *label, const Label *fromLabel, Rowop *rop, TracerWhen when)
@@ -481,11 +573,62 @@ void Unit::trace(const Label *label, const Label *fromLabel, Rowop *rop, TracerW
 	}
 }
 
+void Unit::getLabelStats(LabelStatsVec &res) const
+{
+	res.clear();
+	for (LabelMap::const_iterator it = labelMap_.begin(); it != labelMap_.end(); ++it) {
+		const LabelStats *st = it->first->getStats();
+		if (st == NULL || st->calls_ == 0)
+			continue;
+		res.resize(res.size() + 1);
+		res.back().label_ = it->second;
+		res.back().stats_ = *st;
+	}
+}
+
+void Unit::clearLabelStats()
+{
+	for (LabelMap::iterator it = labelMap_.begin(); it != labelMap_.end(); ++it)
+		it->first->clearStats();
+}
+
+void Unit::reject(const Label *label, Rowop *rop, const string &msg)
+{
+	++rejectCount_;
+	if (labelStats_)
+		label->makeStats()->rejects_++;
+	if (rejectMark_ != NULL)
+		rejectMark_->rops_.push_back(rop);
+	if (maxRejects_ <= 0)
+		return;
+	if (rejects_.size() >= (size_t)maxRejects_)
+		rejects_.pop_front();
+	rejects_.push_back(Rejection());
+	Rejection &rj = rejects_.back();
+	rj.label_ = label;
+	rj.rop_ = rop;
+	rj.msg_ = msg;
+}
+
+void Unit::clearRejects()
+{
+	rejects_.clear();
+	rejectCount_ = 0;
+}
+
+void Unit::setMaxRejects(int n)
+{
+	maxRejects_ = (n < 0? 0 : n);
+	while (rejects_.size() > (size_t)maxRejects_)
+		rejects_.pop_front();
+}
+
 void Unit::clearLabels()
 {
 	if (clearing_)
 		return; // avoid the recursive calls
 	clearing_ = true;
+	rejects_.clear(); // they hold the references to the labels
 	for(LabelMap::iterator it = labelMap_.begin(); it != labelMap_.end(); ++it) {
 		try {
 			it->first->clear();
@@ -14,6 +14,7 @@
 #include <sched/Label.h>
 #include <sched/FrameMark.h>
 #include <list>
+#include <deque>
 #include <map>
 
 namespace TRICEPS_NS {
@@ -22,10 +23,22 @@ class Unit;
 class RowType;
 
 // One frame of the Unit's scheduling queue.
-class UnitFrame : public Tray
+//
+// The rowops are kept in a ring buffer that grows by doubling and never
+// shrinks, so after the warm-up the frames don't allocate any memory.
+// The references to the rowops get moved in and out of the buffer by
+// swapping, without touching the reference counters more than once per rowop.
+// The same rowop may be queued any number of times, in one or multiple
+// frames.
+class UnitFrame
 {
 	friend class Unit;
 public:
+	enum {
+		INITIAL_CAPACITY = 16, // must be a power of 2
+	};
+
+	UnitFrame();
 	// clears the marks as well
 	~UnitFrame();
 
@@ -45,12 +58,74 @@ public:
 	// into the free pool
 	void clear();
 
+	// Check whether there are any rowops in the frame.
+	bool empty() const
+	{
+		return count_ == 0;
+	}
+
+	// Get the number of rowops in the frame.
+	size_t size() const
+	{
+		return count_;
+	}
+
+	// Append a rowop at the back.
+	// @param rop - rowop to append
+	void push_back(Rowop *rop)
+	{
+		if (count_ > mask_)
+			grow();
+		Autoref<Rowop> ref(rop);
+		ring_[(head_ + count_) & mask_].swap(ref); // the slot was empty
+		++count_;
+	}
+
+	// Extract the rowop from the front. The frame must not be empty.
+	// @param rop - place to move the reference to, the old contents
+	//        gets dropped
+	void pop_front(Autoref<Rowop> &rop)
+	{
+		rop.swap(ring_[head_]);
+		ring_[head_] = NULL; // drops the old contents of rop, if any
+		head_ = (head_ + 1) & mask_;
+		--count_;
+	}
+
+	// Get the rowop at the front without extracting it. The frame must not be empty.
+	Rowop *front() const
+	{
+		return ring_[head_];
+	}
+
+	// Extract from the front a batch of consecutive rowops with the
+	// same label. The frame must not be empty.
+	// @param refs - array where to move the references to the rowops
+	//        (must contain the NULL references on the call)
+	// @param rops - array where to put the pointers to the same rowops
+	// @param max - the size of the arrays, the maximal number of rowops to extract
+	// @return - the number of rowops extracted, at least 1
+	size_t pop_batch(Autoref<Rowop> *refs, Rowop **rops, size_t max);
+
 protected:
+	typedef vector<Autoref<Rowop> > RingVec;
+
+	// Double the capacity of the ring buffer.
+	void grow();
+
 	Autoref <FrameMark> markList_; // head of the single-linked list of marks at this frame
+	RingVec ring_; // the ring buffer, the size is a power of 2
+	size_t mask_; // the size of the ring minus 1
+	size_t head_; // index of the first rowop
+	size_t count_; // number of the rowops in the ring
 
 	// A mark that is being reassigned points to this frame.
 	// Free it up for reassignment by dropping from this frame's list.
 	void dropFromList(FrameMark *what);
+
+private:
+	UnitFrame(const UnitFrame &);
+	void operator=(const UnitFrame &);
 };
 
 // The basic execution unit ties together a buch of tables, code and scheduling.
@@ -89,6 +164,10 @@ protected:
 class Unit : public Mtarget
 {
 public:
+	enum {
+		BATCH_SIZE = 64, // the maximal number of rowops passed to Label::executeBatch()
+	};
+
 	// @param name - a human-readable name of this unit, for tracing
 	Unit(const string &name);
 	~Unit();
@@ -134,6 +213,17 @@ public:
 		label->call(this, rop, chainedFrom);
 	}
 
+	// The batch version of callAsChained(), with the same dangers.
+	// If the label is not batching (see Label::setBatching()) or if
+	// the unit has a tracer, calls the label for each rowop, one by one.
+	//
+	// @param label - label to call
+	// @param rops - rowops to execute, the labels from them will be ignored
+	// @param n - number of rowops
+	// @param chainedFrom - the label from which the called one has been virtually
+	//        chained; may be NULL
+	void callBatchAsChained(const Label *label, Rowop *const *rops, size_t n, const Label *chainedFrom);
+
 	// Enqueue the rowop with the chosen mode. This is mostly for convenience
 	// of Perl code but can be used in other places too, performs a switch
 	// and calls one of the actula methods.
@@ -188,6 +278,8 @@ public:
 	// May throw an Exception on fatal error.
 	void callNext();
 	// Execute callNext() until the current stack frame drains.
+	// The consecutive rowops for a batching label get executed as a
+	// batch (see Label::setBatching()).
 	// Normally used only on the outermost frame.
 	// May throw an Exception on fatal error.
 	void drainFrame();
@@ -217,6 +309,14 @@ public:
 		return name_;
 	}
 
+	// Get the numeric id of the unit. The ids are the small numbers,
+	// unique in the process, starting from 1 and never reused. They allow
+	// the tracers to keep the per-unit information in the vectors.
+	uint32_t getId() const
+	{
+		return id_;
+	}
+
 	// Get the depth of the frame stack in the queue.
 	// Very useful for debugging of the stack growtn.
 	int getStackDepth() const
@@ -470,6 +570,258 @@ public:
 		return maxRecursionDepth_;
 	}
 	// } Recursion control
+
+	// The flat chaining: a faster way to call the labels with the deep chains.
+	// {
+
+	// Enable or disable the flat chaining in this unit.
+	//
+	// Normally a label calls its chained labels recursively, with the tracing
+	// and the checks done at each level. With the flat chaining, the whole
+	// transitive chain of a label gets precomputed into a vector on the first
+	// call, and then the labels are executed from it in a loop, in the same
+	// order. The DummyLabels with nothing chained to them get dropped from the
+	// vector, and the DummyLabels in the middle of the chains don't get
+	// their execute() called. The recursion limits and the error messages stay
+	// the same as with the recursive chaining.
+	//
+	// The vectors get rebuilt after any chain in the unit changes. The changes
+	// made while a chain is executing take effect on the next call.
+	//
+	// Since the tracing reports the nesting of the chains, the flat chaining
+	// is used only when no tracer is set, otherwise the calls fall back to
+	// the recursive way.
+	//
+	// When the unit is constructed, the flat chaining is disabled.
+	//
+	// @param on - true to enable, false to disable
+	void setFlatChaining(bool on)
+	{
+		flatChaining_ = on;
+		updateCallMode();
+	}
+
+	bool isFlatChaining() const
+	{
+		return flatChaining_;
+	}
+
+	// Check whether a tracer is set.
+	bool hasTracer() const
+	{
+		return !tracer_.isNull();
+	}
+
+	// The way the labels execute their calls, combining all the settings
+	// that affect it, so that the common case takes one check.
+	enum CallMode {
+		CM_RECURSIVE, // the plain recursive calls
+		CM_FLAT, // the flat chaining
+		CM_STATS, // the recursive calls with the statistics
+	};
+
+	// Get the way the labels execute their calls.
+	// Called from the Label, not intended to be called directly by the user.
+	CallMode getCallMode() const
+	{
+		return callMode_;
+	}
+
+	// Mark that a chain of some label in this unit has changed.
+	// Called from the Label, not intended to be called directly by the user.
+	void chainChanged()
+	{
+		++chainGen_;
+	}
+
+	// Get the generation of the chains, it changes on every chainChanged().
+	uint64_t getChainGen() const
+	{
+		return chainGen_;
+	}
+	// } Flat chaining
+
+	// The execution statistics of the labels.
+	// {
+
+	// Enable or disable the collection of the execution statistics by
+	// the labels of this unit (see LabelStats). Each label keeps its own
+	// statistics, created on its first call after the collection gets enabled.
+	// Disabling the collection keeps the collected data, it can still be read.
+	//
+	// The self time of a label excludes the time of its chained labels and
+	// of the labels it calls in this unit, but includes the time of the
+	// calls to the other units. The draining of the forked rowops after a
+	// call is not included in the time of the label.
+	//
+	// While the collection is enabled, the flat chaining (see
+	// setFlatChaining()) is not used.
+	//
+	// When the unit is constructed, the collection is disabled.
+	//
+	// @param on - true to enable, false to disable
+	void setLabelStats(bool on)
+	{
+		labelStats_ = on;
+		updateCallMode();
+	}
+
+	bool isLabelStats() const
+	{
+		return labelStats_;
+	}
+
+	// Enable or disable the collection of the histograms of the call times
+	// of the labels. This works only together with setLabelStats(), and
+	// adds a little overhead to it.
+	//
+	// When the unit is constructed, the histograms are disabled.
+	//
+	// @param on - true to enable, false to disable
+	void setLabelHistograms(bool on)
+	{
+		labelHistograms_ = on;
+	}
+
+	bool isLabelHistograms() const
+	{
+		return labelHistograms_;
+	}
+
+	// The statistics of one label.
+	struct LabelStatsEntry
+	{
+		Autoref<Label> label_;
+		LabelStats stats_;
+	};
+	typedef vector<LabelStatsEntry> LabelStatsVec;
+
+	// Get a snapshot of the statistics of all the labels in the unit that
+	// have been called while the collection was enabled, in no particular order.
+	// Must be called from the thread of the unit.
+	// @param res - vector to put the statistics into, its old contents
+	//        gets replaced
+	void getLabelStats(LabelStatsVec &res) const;
+
+	// Reset the statistics of all the labels in the unit to 0.
+	void clearLabelStats();
+
+	// The accumulator of the time of the nested calls, used by the Label
+	// to compute the self time. Not intended to be used directly by the user.
+	uint64_t &statsNestedTicks()
+	{
+		return statsNestedTicks_;
+	}
+	// } Label statistics
+
+	// The rejection of the rowops.
+	// {
+
+	// Some errors are expected in the normal course of the processing,
+	// such as a label finding that an input row has incorrect data.
+	// Reporting them with an Exception is expensive: the Exception
+	// unwinds through every nested Label call, collecting the
+	// messages on the way, and aborts the rest of the processing of the
+	// rowop. Instead, the label may reject the rowop by calling reject()
+	// and return normally. The rejection gets counted and remembered
+	// in the unit, and the processing continues with the next rowop.
+	// The rejected rowop doesn't get passed to the labels chained from
+	// the rejecting label.
+	//
+	// The unit remembers up to getMaxRejects() latest rejections; when
+	// more rejections come, the oldest ones get discarded. The count
+	// includes all the rejections.
+
+	enum {
+		DEFAULT_MAX_REJECTS = 100, // default number of the rejections to remember
+	};
+
+	// The information about one rejected rowop.
+	struct Rejection
+	{
+		const_Autoref<Label> label_; // the label that has rejected the rowop
+		Autoref<Rowop> rop_; // the rowop
+		string msg_; // the reason of the rejection
+	};
+	typedef deque<Rejection> RejectionDeque;
+
+	// Collects the rowops rejected during the execution of a label,
+	// so that the label won't pass them to its chain. Created on the
+	// stack around the call of execute(); the marks nest along with
+	// the label calls, and the rejections go to the innermost one.
+	class RejectMark
+	{
+	public:
+		RejectMark(Unit *unit) :
+			unit_(unit),
+			prev_(unit->rejectMark_)
+		{
+			unit_->rejectMark_ = this;
+		}
+		~RejectMark()
+		{
+			unit_->rejectMark_ = prev_;
+		}
+
+		// Check whether any rowops have been rejected.
+		bool empty() const
+		{
+			return rops_.empty();
+		}
+
+		// Check whether a rowop has been rejected.
+		bool isRejected(const Rowop *rop) const
+		{
+			for (RopVec::const_iterator it = rops_.begin(); it != rops_.end(); ++it)
+				if (*it == rop)
+					return true;
+			return false;
+		}
+
+		typedef vector<const Rowop *> RopVec;
+		RopVec rops_; // the rejected rowops
+
+	protected:
+		Unit *unit_;
+		RejectMark *prev_; // the mark of the outer call
+	};
+
+	// Reject a rowop. If the label statistics are enabled, the rejection
+	// also gets counted in the statistics of the label. If called from
+	// the execution of a label, the rowop gets recorded in its RejectMark.
+	// @param label - the label that rejects the rowop (usually the
+	//        one currently executing)
+	// @param rop - the rowop being rejected
+	// @param msg - the reason of the rejection
+	void reject(const Label *label, Rowop *rop, const string &msg);
+
+	// Get the number of the rowops rejected since the unit creation
+	// or the last clearRejects().
+	uint64_t getRejectCount() const
+	{
+		return rejectCount_;
+	}
+
+	// Get the latest rejections, in the order they happened.
+	const RejectionDeque &getRejects() const
+	{
+		return rejects_;
+	}
+
+	// Forget all the rejections and reset the count.
+	void clearRejects();
+
+	// Set the number of the latest rejections to remember. 0 means
+	// to only count them. Reducing the number discards the oldest
+	// remembered rejections if there are too many.
+	// @param n - the number of rejections, negative values are treated as 0
+	void setMaxRejects(int n);
+
+	int getMaxRejects() const
+	{
+		return maxRejects_;
+	}
+	// } Rejection
 	
 protected:
 	// Push a new frame onto the stack.
@@ -482,6 +834,19 @@ protected:
 	// @param rop - rowop to call. It must be held by the caller until returned.
 	void callGuts(Rowop *rop);
 
+	// Check whether the next rowops in the innermost frame may be
+	// executed as a batch.
+	bool isBatchNext() const
+	{
+		return innerFrame_->size() > 1 && tracer_.isNull()
+			&& innerFrame_->front()->getLabel()->isBatching();
+	}
+
+	// Extract and execute the batch of rowops for the same label from the
+	// innermost frame, the batch version of callNext().
+	// May throw an Exception on fatal error.
+	void callNextBatch();
+
 	// API for the Label execution machinery. Not intended to be called
 	// directly by the user.
 	// {
@@ -490,6 +855,9 @@ protected:
 	// Does not push a new frame, executes directly in the parent's frame
 	// May throw an Exception on fatal error.
 	void callNextForked();
+	// The batch version of callNextForked().
+	// May throw an Exception on fatal error.
+	void callNextForkedBatch();
 	// Execute callNextForked() the current stack frame drains.
 	// Calls the tracing notifications around it.
 	// Normally used to process the forked records after a label call returns.
@@ -503,23 +871,50 @@ protected:
 	// } Label execution.
 
 protected:
-	// the scheduling queue, trays work as stack frames on it
-	// (there might be a more efficient way to do it, but for now it's good enough)
-	typedef list< Autoref<UnitFrame> > FrameList;
-	FrameList queue_;
-	FrameList freePool_; // when frames are popped from queue, they're cached here
+	enum {
+		PREALLOC_FRAMES = 8, // number of the frames allocated in advance
+	};
+
+	// Recompute callMode_ after a change of the settings.
+	void updateCallMode()
+	{
+		if (labelStats_)
+			callMode_ = CM_STATS;
+		else if (flatChaining_ && tracer_.isNull())
+			callMode_ = CM_FLAT;
+		else
+			callMode_ = CM_RECURSIVE;
+	}
+
+
+	// The scheduling queue is the stack of frames. The frames up to
+	// stackDepth_ are in use, the rest are kept for reuse, so that
+	// the calls don't allocate any memory for the frames.
+	typedef vector<UnitFrame *> FrameVec;
+	FrameVec frames_; // the unit owns all the frames, the outermost one is at index 0
 	UnitFrame *outerFrame_; // the outermost frame
 	UnitFrame *innerFrame_; // the current innermost frame (may happen to be the same as outermost)
 	Autoref<Tracer> tracer_; // the tracer object
 	string name_; // human-readable name for tracing and messages
+	uint32_t id_; // the unique id of the unit
 	Autoref <RowType> emptyRowType_; // a convenience copy of row type with no fields
-	int stackDepth_; // number of frames in the queue
+	int stackDepth_; // number of frames in use in the queue
 	// Keeping track of labels
 	typedef map<Label *, Autoref<Label> > LabelMap;
 	LabelMap labelMap_;
 	int maxStackDepth_; // limit on the call stack depth, <= 0 means unlimited
 	int maxRecursionDepth_; // limit on the recursive calls of the same label, <= 0 means unlimited
 	bool clearing_; // prevents the recursive calls to clearLabels & friends
+	bool flatChaining_; // flag: the labels call their chains through the flat vectors
+	uint64_t chainGen_; // generation of the chains, for the invalidation of the flat vectors
+	bool labelStats_; // flag: the labels collect the statistics
+	CallMode callMode_; // computed from flatChaining_, labelStats_ and tracer_
+	bool labelHistograms_; // flag: the labels collect the histograms of the call times
+	uint64_t statsNestedTicks_; // the time of the nested label calls, for the self time
+	RejectionDeque rejects_; // the latest rejections
+	uint64_t rejectCount_; // count of all the rejections
+	int maxRejects_; // limit on the size of rejects_
+	RejectMark *rejectMark_; // mark of the label currently executing, or NULL
 
 private:
 	Unit(const Unit &);
@@ -0,0 +1,25 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase same_text;
+	driver.addcase(same_text, "same_text");
+
+	extern Utest::Testcase overflow;
+	driver.addcase(overflow, "overflow");
+
+	extern Utest::Testcase filter;
+	driver.addcase(filter, "filter");
+
+	extern Utest::Testcase sampling;
+	driver.addcase(sampling, "sampling");
+
+	extern Utest::Testcase recycle;
+	driver.addcase(recycle, "recycle");
+
+	return driver.run();
+}
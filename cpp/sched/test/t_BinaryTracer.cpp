@@ -0,0 +1,384 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the binary tracer.
+
+#include <utest/Utest.h>
+
+#include <type/CompactRowType.h>
+#include <common/Exception.h>
+#include <common/StringUtil.h>
+#include <sched/BinaryTracer.h>
+
+// forks its rowop to the next label
+class ForkLabel : public Label
+{
+public:
+	ForkLabel(Unit *unit, Onceref<RowType> rtype, const string &name,
+			Onceref<Label> next) :
+		Label(unit, rtype, name),
+		next_(next)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		unit_->fork(next_->adopt(arg));
+	}
+
+	virtual void clearSubclass()
+	{
+		next_ = NULL;
+	}
+
+	Autoref<Label> next_;
+};
+
+// calls the next label
+class CallLabel : public Label
+{
+public:
+	CallLabel(Unit *unit, Onceref<RowType> rtype, const string &name,
+			Onceref<Label> next) :
+		Label(unit, rtype, name),
+		next_(next)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		unit_->call(next_->adopt(arg));
+	}
+
+	virtual void clearSubclass()
+	{
+		next_ = NULL;
+	}
+
+	Autoref<Label> next_;
+};
+
+// throws an exception
+class ThrowLabel : public Label
+{
+public:
+	ThrowLabel(Unit *unit, Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		throw Exception("Test throw", false);
+	}
+};
+
+// counts its destructions
+class CountedLabel : public DummyLabel
+{
+public:
+	CountedLabel(Unit *unit, Onceref<RowType> rtype, const string &name, int *count) :
+		DummyLabel(unit, rtype, name),
+		count_(count)
+	{ }
+
+	~CountedLabel()
+	{
+		++*count_;
+	}
+
+	int *count_;
+};
+
+// the labels and rowops for the tests
+class Workload
+{
+public:
+	// @param fork - flag: fork a rowop from the chain; since the forked
+	//        rowops get created anew, their addresses are unpredictable
+	Workload(bool fork = true)
+	{
+		RowType::FieldVec fld;
+		fld.push_back(RowType::Field("a", Type::r_int64));
+		rt1_ = new CompactRowType(fld);
+		FdataVec dv(1);
+		int64_t v = 1;
+		dv[0].setPtr(true, &v, sizeof(v));
+		Rowref r1(rt1_, rt1_->makeRow(dv));
+
+		unit_ = new Unit("u");
+		lab1_ = new DummyLabel(unit_, rt1_, "lab1");
+		lab2_ = new DummyLabel(unit_, rt1_, "lab2");
+		lab3_ = new DummyLabel(unit_, rt1_, "lab3");
+		labf_ = new ForkLabel(unit_, rt1_, "labf", lab3_);
+		lab1_->chain(lab2_);
+		if (fork)
+			lab2_->chain(labf_);
+
+		op1_ = new Rowop(lab1_, Rowop::OP_INSERT, r1);
+		op2_ = new Rowop(lab1_, Rowop::OP_DELETE, r1);
+	}
+
+	~Workload()
+	{
+		unit_->clearLabels();
+	}
+
+	// run the rowops with a tracer
+	// @return - the trace text
+	string run(Onceref<Unit::Tracer> tracer)
+	{
+		Autoref<Unit::Tracer> t = tracer;
+		unit_->setTracer(t);
+		unit_->schedule(op1_);
+		unit_->schedule(op2_);
+		unit_->drainFrame();
+		unit_->setTracer(NULL);
+		return t->getBuffer()->print();
+	}
+
+	Autoref<RowType> rt1_;
+	Autoref<Unit> unit_;
+	Autoref<Label> lab1_, lab2_, lab3_, labf_;
+	Autoref<Rowop> op1_, op2_;
+};
+
+UTESTCASE same_text(Utest *utest)
+{
+	Workload w;
+
+	string s = w.run(new Unit::StringNameTracer(false));
+	string bs = w.run(new BinaryTracer(BinaryTracer::DEFAULT_CAPACITY, false, false));
+	UT_IS(bs, s);
+	UT_IS(s,
+		"unit 'u' before label 'lab1' op OP_INSERT\n"
+		"unit 'u' before label 'lab2' (chain 'lab1') op OP_INSERT\n"
+		"unit 'u' before label 'labf' (chain 'lab2') op OP_INSERT\n"
+		"unit 'u' before label 'lab3' op OP_INSERT\n"
+		"unit 'u' before label 'lab1' op OP_DELETE\n"
+		"unit 'u' before label 'lab2' (chain 'lab1') op OP_DELETE\n"
+		"unit 'u' before label 'labf' (chain 'lab2') op OP_DELETE\n"
+		"unit 'u' before label 'lab3' op OP_DELETE\n"
+	);
+
+	// the verbose versions
+	s = w.run(new Unit::StringNameTracer(true));
+	bs = w.run(new BinaryTracer(BinaryTracer::DEFAULT_CAPACITY, true, false));
+	UT_IS(bs, s);
+
+	// the addresses
+	Workload wa(false);
+	s = wa.run(new Unit::StringTracer(true));
+	bs = wa.run(new BinaryTracer(BinaryTracer::DEFAULT_CAPACITY, true, true));
+	UT_IS(bs, s);
+	s = wa.run(new Unit::StringTracer(false));
+	bs = wa.run(new BinaryTracer(BinaryTracer::DEFAULT_CAPACITY, false, true));
+	UT_IS(bs, s);
+
+	// decode() can produce either format
+	Autoref<BinaryTracer> bt = new BinaryTracer;
+	wa.run(bt);
+	BinaryTracer::RecordVec recs;
+	bt->snapshot(recs);
+	Erref buf = new Errors;
+	bt->decode(recs, buf, true);
+	UT_IS(buf->print(), s);
+	buf = new Errors;
+	bt->decode(recs, buf, false);
+	s = wa.run(new Unit::StringNameTracer(false));
+	UT_IS(buf->print(), s);
+
+	bt = new BinaryTracer;
+	w.run(bt);
+	bt->snapshot(recs);
+	UT_IS(recs.size(), 8);
+	UT_IS(bt->getCount(), 8);
+
+	// the record contents
+	UT_IS(recs[0].seq_, 1);
+	UT_IS(recs[0].unitId_, w.unit_->getId());
+	UT_IS(recs[0].labelId_, w.lab1_->getId());
+	UT_IS(recs[0].fromLabelId_, 0);
+	UT_IS(recs[0].rop_, w.op1_.get());
+	UT_IS(recs[0].opcode_, (int)Rowop::OP_INSERT);
+	UT_IS(recs[0].when_, (int)Unit::TW_BEFORE);
+	UT_IS(recs[1].fromLabelId_, w.lab1_->getId());
+	UT_IS(recs[7].seq_, 8);
+	UT_IS(recs[7].opcode_, (int)Rowop::OP_DELETE);
+	for (size_t i = 1; i < recs.size(); i++)
+		UT_ASSERT(recs[i].time_ >= recs[i-1].time_);
+
+	// clearing
+	bt->clearBuffer();
+	UT_IS(bt->getCount(), 0);
+	UT_IS(bt->getBuffer()->print(), "");
+	bt->snapshot(recs);
+	UT_IS(recs.size(), 0);
+}
+
+UTESTCASE overflow(Utest *utest)
+{
+	Workload w;
+
+	Autoref<BinaryTracer> bt = new BinaryTracer(1, true, false);
+	UT_IS(bt->getCapacity(), (size_t)BinaryTracer::MIN_CAPACITY);
+	Autoref<BinaryTracer> bt2 = new BinaryTracer(1000);
+	UT_IS(bt2->getCapacity(), 1024);
+
+	string s = w.run(new Unit::StringNameTracer(true));
+	for (int i = 0; i < 11; i++)
+		w.run(bt);
+	UT_IS(bt->getCount(), 11 * 28);
+
+	// only the tail of the trace is left
+	BinaryTracer::RecordVec recs;
+	bt->snapshot(recs);
+	UT_IS(recs.size(), (size_t)BinaryTracer::MIN_CAPACITY);
+	UT_IS(recs.back().seq_, 11 * 28);
+	UT_IS(recs.front().seq_, 11 * 28 - BinaryTracer::MIN_CAPACITY + 1);
+
+	size_t pos = s.size() - 1;
+	for (int i = 0; i < BinaryTracer::MIN_CAPACITY; i++)
+		pos = s.rfind('\n', pos - 1);
+	string tail = s.substr(pos + 1);
+	string bs = bt->getBuffer()->print();
+	UT_IS(bs, tail);
+}
+
+UTESTCASE filter(Utest *utest)
+{
+	Workload w;
+
+	Autoref<BinaryTracer> bt = new BinaryTracer;
+	UT_ASSERT(!bt->isFiltering());
+	bt->addFilterLabel(w.lab2_);
+	bt->addFilterLabel(w.lab3_);
+	UT_ASSERT(bt->isFiltering());
+	string s = w.run(bt);
+	UT_IS(s,
+		"unit 'u' before label 'lab2' (chain 'lab1') op OP_INSERT\n"
+		"unit 'u' before label 'lab3' op OP_INSERT\n"
+		"unit 'u' before label 'lab2' (chain 'lab1') op OP_DELETE\n"
+		"unit 'u' before label 'lab3' op OP_DELETE\n"
+	);
+
+	bt->clearBuffer();
+	bt->addFilterLabel(w.lab2_);
+	bt->clearFilter();
+	UT_ASSERT(!bt->isFiltering());
+	s = w.run(bt);
+	UT_IS(s, w.run(new Unit::StringNameTracer(false)));
+}
+
+UTESTCASE sampling(Utest *utest)
+{
+	Workload w;
+
+	Autoref<BinaryTracer> bt = new BinaryTracer(BinaryTracer::DEFAULT_CAPACITY, true, false);
+	UT_IS(bt->getSampling(), 1);
+	bt->setSampling(0);
+	UT_IS(bt->getSampling(), 1);
+	bt->setSampling(4);
+	UT_IS(bt->getSampling(), 4);
+
+	const int n = 1000;
+	for (int i = 0; i < n; i++)
+		w.run(bt);
+
+	// 1 in 4 of the 2*n rowops; op1 and op2 alternate, so only op1 gets selected;
+	// all the events of a selected rowop get recorded together,
+	// including the forked lab3
+	BinaryTracer::RecordVec recs;
+	bt->snapshot(recs);
+	UT_IS(recs.size(), n / 2 * 14);
+	for (size_t i = 0; i < recs.size(); i++) {
+		UT_IS(recs[i].opcode_, (int)Rowop::OP_INSERT);
+		if (i % 14 == 0) {
+			UT_IS(recs[i].labelId_, w.lab1_->getId());
+			UT_IS(recs[i].when_, (int)Unit::TW_BEFORE);
+		}
+	}
+
+	// the calls from inside a rowop belong to it
+	bt->clearBuffer();
+	bt->setSampling(2);
+	Autoref<Label> labc = new CallLabel(w.unit_, w.rt1_, "labc", w.lab1_);
+	Autoref<Rowop> opc = new Rowop(labc, Rowop::OP_INSERT, w.op1_->getRow());
+	w.unit_->setTracer(bt);
+	for (int i = 0; i < 4; i++)
+		w.unit_->call(opc);
+	w.unit_->setTracer(NULL);
+	bt->snapshot(recs);
+	UT_IS(recs.size(), 2 * 16);
+	UT_IS(recs[0].labelId_, labc->getId());
+	UT_IS(recs[15].labelId_, labc->getId());
+	UT_IS(recs[16].labelId_, labc->getId());
+
+	// the stack gets resynchronized after an exception
+	Exception::abort_ = false; // make them catchable
+	Exception::enableBacktrace_ = false; // make the error messages predictable
+	bt->clearBuffer();
+	bt->setSampling(2);
+	Autoref<Label> labt = new ThrowLabel(w.unit_, w.rt1_, "labt");
+	Autoref<Rowop> opt = new Rowop(labt, Rowop::OP_INSERT, w.op1_->getRow());
+	w.unit_->setTracer(bt);
+	for (int i = 0; i < 3; i++) {
+		try {
+			w.unit_->call(opt);
+		} catch (Exception e) {
+		}
+	}
+	for (int i = 0; i < 4; i++)
+		w.unit_->call(opc);
+	w.unit_->setTracer(NULL);
+	bt->snapshot(recs);
+	// labt 1st and 3rd, labc 2nd and 4th
+	UT_IS(recs.size(), 2 + 2 * 16);
+	UT_IS(recs[0].labelId_, labt->getId());
+	UT_IS(recs[1].labelId_, labt->getId());
+	UT_IS(recs[2].labelId_, labc->getId());
+
+	Exception::abort_ = true; // restore back
+	Exception::enableBacktrace_ = true; // restore back
+}
+
+UTESTCASE recycle(Utest *utest)
+{
+	Workload w(false);
+
+	// the dictionary doesn't hold the labels, and when their ids get
+	// reused, the records still get decoded with the right names
+	Autoref<BinaryTracer> bt = new BinaryTracer(BinaryTracer::MIN_CAPACITY);
+	w.unit_->setTracer(bt);
+	int destroyed = 0;
+	const int n = 100;
+	for (int i = 0; i < n; i++) {
+		Autoref<Label> lab = new CountedLabel(w.unit_, w.rt1_, strprintf("dyn%d", i), &destroyed);
+		w.unit_->call(new Rowop(lab, Rowop::OP_INSERT, w.op1_->getRow()));
+		w.unit_->forgetLabel(lab);
+	}
+	w.unit_->setTracer(NULL);
+	UT_IS(destroyed, n);
+
+	BinaryTracer::RecordVec recs;
+	bt->snapshot(recs);
+	UT_IS(recs.size(), (size_t)BinaryTracer::MIN_CAPACITY);
+	UT_IS(recs.front().labelId_, recs.back().labelId_); // reused
+
+	string expect;
+	for (int i = n - BinaryTracer::MIN_CAPACITY; i < n; i++)
+		expect += strprintf("unit 'u' before label 'dyn%d' op OP_INSERT\n", i);
+	UT_IS(bt->getBuffer()->print(), expect);
+
+	// a destroyed label drops out of the filter, its id doesn't carry it over
+	bt->clearBuffer();
+	Autoref<Label> labf = new DummyLabel(w.unit_, w.rt1_, "labf");
+	bt->addFilterLabel(labf);
+	w.unit_->forgetLabel(labf);
+	labf = NULL;
+	Autoref<Label> labn = new DummyLabel(w.unit_, w.rt1_, "labn");
+	w.unit_->setTracer(bt);
+	w.unit_->call(new Rowop(labn, Rowop::OP_INSERT, w.op1_->getRow()));
+	w.unit_->setTracer(NULL);
+	UT_IS(bt->getBuffer()->print(), "");
+}
@@ -14,6 +14,8 @@
 #include <common/Exception.h>
 #include <sched/Unit.h>
 #include <sched/Gadget.h>
+#include <sched/FnReturn.h>
+#include <sched/FnBinding.h>
 
 // Make fields of all simple types
 void mkfields(RowType::FieldVec &fields)
@@ -70,6 +72,12 @@ UTESTCASE mkunit(Utest *utest)
 
 	UT_ASSERT(unit1->empty());
 	UT_ASSERT(unit1->getEmptyRowType() != NULL);
+
+	// the ids are unique
+	Autoref<Unit> unit2 = new Unit("my unit");
+	UT_ASSERT(unit1->getId() != 0);
+	UT_ASSERT(unit2->getId() != 0);
+	UT_ASSERT(unit1->getId() != unit2->getId());
 }
 
 UTESTCASE mklabel(Utest *utest)
@@ -106,6 +114,18 @@ UTESTCASE mklabel(Utest *utest)
 	Autoref<Label> lab12 = new DummyLabel(unit1, rt1, "lab12");
 	Autoref<Label> lab13 = new DummyLabel(unit1, rt1, "lab13");
 
+	// the ids are unique among the live labels, and get reused
+	UT_ASSERT(lab1->getId() != 0);
+	UT_ASSERT(lab1->getId() != lab2->getId());
+	UT_ASSERT(lab12->getId() != lab13->getId());
+	{
+		uint32_t id = lab13->getId();
+		unit1->forgetLabel(lab13);
+		lab13 = NULL;
+		lab13 = new DummyLabel(unit1, rt1, "lab13");
+		UT_IS(lab13->getId(), id);
+	}
+
 	UT_IS(lab1->getType(), rt1.get());
 	UT_IS(lab2->getType(), rt2.get());
 	UT_IS(lab3->getType(), rt3.get());
@@ -244,6 +264,7 @@ UTESTCASE rowop(Utest *utest)
 	UT_IS(string(Rowop::opcodeString(Rowop::OP_NOP)), "OP_NOP");
 	UT_IS(string(Rowop::opcodeString(Rowop::OP_INSERT)), "OP_INSERT");
 	UT_IS(string(Rowop::opcodeString(Rowop::OP_DELETE)), "OP_DELETE");
+	UT_IS(string(Rowop::opcodeString(Rowop::OP_UPDATE)), "OP_UPDATE");
 	UT_IS(string(Rowop::opcodeString((Rowop::Opcode)0x330)), "[NOP]");
 	UT_IS(string(Rowop::opcodeString((Rowop::Opcode)0x331)), "[I]");
 	UT_IS(string(Rowop::opcodeString((Rowop::Opcode)0x332)), "[D]");
@@ -252,6 +273,7 @@ UTESTCASE rowop(Utest *utest)
 	UT_IS(Rowop::stringOpcode("OP_NOP"), Rowop::OP_NOP);
 	UT_IS(Rowop::stringOpcode("OP_INSERT"), Rowop::OP_INSERT);
 	UT_IS(Rowop::stringOpcode("OP_DELETE"), Rowop::OP_DELETE);
+	UT_IS(Rowop::stringOpcode("OP_UPDATE"), Rowop::OP_UPDATE);
 	UT_IS(Rowop::stringOpcode("[I]"), Rowop::OP_BAD);
 
 	UT_IS(string(Rowop::ocfString(Rowop::OCF_INSERT)), "OCF_INSERT");
@@ -762,6 +784,26 @@ UTESTCASE clearing2(Utest *utest)
 	UT_IS(lab1->getUnitName(), "[label cleared]");
 }
 
+// the labels that outlive their unit can still be chained
+UTESTCASE clearing3(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Label> lab1 = new DummyLabel(unit, rt1, "lab1");
+	Autoref<Label> lab2 = new DummyLabel(unit, rt1, "lab2");
+	Autoref<Label> lab3 = new DummyLabel(unit, rt1, "lab3");
+	UT_ASSERT(!lab1->chain(lab2)->hasError());
+
+	unit = NULL; // clears the labels
+	UT_ASSERT(lab1->isCleared());
+	UT_ASSERT(!lab1->chain(lab3)->hasError());
+	UT_ASSERT(!lab2->chain(lab3, true)->hasError());
+}
+
 class TestFrameMark: public FrameMark
 {
 public:
@@ -1455,3 +1497,864 @@ Called through the label 'labrec'.\n");
 	Exception::abort_ = true; // restore back
 	Exception::enableBacktrace_ = true; // restore back
 }
+
+UTESTCASE update_split(Utest *utest)
+{
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+	Rowref r2(rt1,  rt1->makeRow(dv));
+
+	Autoref<UpdateSplitLabel> split = new UpdateSplitLabel(unit, rt1, "split");
+	Autoref<Label> out = new DummyLabel(unit, rt1, "out");
+	UT_IS(split->getOutputLabel()->getName(), "split.out");
+	UT_ASSERT(!split->getOutputLabel()->chain(out)->hasError());
+
+	// the update rowop keeps a reference to both rows
+	Autoref<Rowop> op1 = Rowop::makeUpdate(split, r2, r1);
+	UT_IS(r1->getref(), 2);
+	UT_IS(r2->getref(), 2);
+	UT_ASSERT(op1->isUpdate());
+	UT_ASSERT(op1->isInsert());
+	UT_ASSERT(op1->isDelete());
+	UT_IS(op1->getRow(), r2.get());
+	UT_IS(op1->getOldRow(), r1.get());
+
+	{
+		Autoref<Rowop> op1a = new Rowop(out, op1);
+		UT_IS(op1a->getOldRow(), r1.get());
+		UT_IS(r1->getref(), 3);
+		Autoref<Rowop> op1b = new Rowop(*op1);
+		UT_IS(op1b->getOldRow(), r1.get());
+		UT_IS(r1->getref(), 4);
+	}
+	UT_IS(r1->getref(), 2);
+
+	Autoref<Rowop> op2 = new Rowop(split, Rowop::OP_INSERT, r1);
+	UT_IS(op2->getOldRow(), NULL);
+	UT_ASSERT(!op2->isUpdate());
+	Autoref<Rowop> op3 = Rowop::makeUpdate(split, r2, NULL);
+
+	unit->call(op1);
+	unit->call(op2);
+	unit->call(op3);
+
+	string expect = 
+		"unit 'u' before label 'split' op OP_UPDATE\n"
+		"unit 'u' before label 'split.out' op OP_DELETE\n"
+		"unit 'u' before label 'out' (chain 'split.out') op OP_DELETE\n"
+		"unit 'u' before label 'split.out' op OP_INSERT\n"
+		"unit 'u' before label 'out' (chain 'split.out') op OP_INSERT\n"
+		"unit 'u' before label 'split' op OP_INSERT\n"
+		"unit 'u' before label 'split.out' op OP_INSERT\n"
+		"unit 'u' before label 'out' (chain 'split.out') op OP_INSERT\n"
+		"unit 'u' before label 'split' op OP_UPDATE\n"
+		"unit 'u' before label 'split.out' op OP_INSERT\n"
+		"unit 'u' before label 'out' (chain 'split.out') op OP_INSERT\n"
+	;
+	UT_IS(trace->getBuffer()->print(), expect);
+
+	op1 = NULL;
+	UT_IS(r1->getref(), 2); // op2 still holds it
+	op2 = NULL;
+	UT_IS(r1->getref(), 1);
+
+	unit->clearLabels();
+}
+
+// records the names of the labels as they get executed
+class LogLabel : public Label
+{
+public:
+	LogLabel(Unit *unit, Onceref<RowType> rtype, const string &name, string *log) :
+		Label(unit, rtype, name),
+		log_(log)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		log_->append(getName());
+		log_->append(" ");
+	}
+
+	string *log_;
+};
+
+// chains another label to its parent when executed
+class ChainOnCallLabel : public LogLabel
+{
+public:
+	ChainOnCallLabel(Unit *unit, Onceref<RowType> rtype, const string &name, string *log,
+			Onceref<Label> parent, Onceref<Label> add) :
+		LogLabel(unit, rtype, name, log),
+		parent_(parent),
+		add_(add)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		LogLabel::execute(arg);
+		if (!add_.isNull()) {
+			parent_->chain(add_);
+			add_ = NULL;
+		}
+	}
+
+	virtual void clearSubclass()
+	{
+		parent_ = NULL;
+		add_ = NULL;
+	}
+
+	Autoref<Label> parent_;
+	mutable Autoref<Label> add_;
+};
+
+UTESTCASE flat_chaining(Utest *utest)
+{
+	string msg;
+
+	Exception::abort_ = false; // make them catchable
+	Exception::enableBacktrace_ = false; // make the error messages predictable
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	Autoref<Unit> unit1 = new Unit("u1");
+	UT_ASSERT(!unit1->isFlatChaining());
+	UT_ASSERT(!unit1->hasTracer());
+
+	string log;
+	Autoref<Label> lab1 = new DummyLabel(unit1, rt1, "lab1");
+	Autoref<Label> lab2 = new DummyLabel(unit1, rt1, "lab2");
+	Autoref<Label> lab3 = new DummyLabel(unit1, rt1, "lab3");
+	Autoref<Label> loga = new LogLabel(unit1, rt1, "a", &log);
+	Autoref<Label> logb = new LogLabel(unit1, rt1, "b", &log);
+	Autoref<Label> logc = new LogLabel(unit1, rt1, "c", &log);
+
+	UT_ASSERT(!lab1->chain(loga)->hasError());
+	UT_ASSERT(!lab1->chain(lab2)->hasError());
+	UT_ASSERT(!lab1->chain(lab3)->hasError()); // stays at the end of the chain
+	UT_ASSERT(!lab2->chain(logb)->hasError());
+	UT_ASSERT(!loga->chain(logc)->hasError());
+	UT_ASSERT(!lab2->chain(logc)->hasError());
+
+	Autoref<Rowop> op1 = new Rowop(lab1, Rowop::OP_INSERT, r1);
+
+	unit1->call(op1);
+	string expect = log;
+	UT_IS(expect, "a c b c ");
+
+	// the same order with the flat chaining
+	unit1->setFlatChaining(true);
+	UT_ASSERT(unit1->isFlatChaining());
+	log.clear();
+	unit1->call(op1);
+	UT_IS(log, expect);
+
+	// the changes in the chains get picked up
+	UT_ASSERT(!lab3->chain(loga)->hasError());
+	log.clear();
+	unit1->call(op1);
+	UT_IS(log, "a c b c a c ");
+
+	lab2->clearChained();
+	log.clear();
+	unit1->call(op1);
+	UT_IS(log, "a c a c ");
+
+	// the change made during the call takes effect on the next call
+	Autoref<Label> lab4 = new DummyLabel(unit1, rt1, "lab4");
+	Autoref<Label> chc = new ChainOnCallLabel(unit1, rt1, "chc", &log, lab4, logb);
+	UT_ASSERT(!lab4->chain(chc)->hasError());
+	Autoref<Rowop> op4 = new Rowop(lab4, Rowop::OP_INSERT, r1);
+	log.clear();
+	unit1->call(op4);
+	UT_IS(log, "chc ");
+	log.clear();
+	unit1->call(op4);
+	UT_IS(log, "chc b ");
+
+	// with a tracer, falls back to the recursive calls
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit1->setTracer(trace);
+	UT_ASSERT(unit1->hasTracer());
+	log.clear();
+	unit1->call(op1);
+	UT_IS(log, "a c a c ");
+	UT_IS(trace->getBuffer()->print(),
+		"unit 'u1' before label 'lab1' op OP_INSERT\n"
+		"unit 'u1' before label 'a' (chain 'lab1') op OP_INSERT\n"
+		"unit 'u1' before label 'c' (chain 'a') op OP_INSERT\n"
+		"unit 'u1' before label 'lab2' (chain 'lab1') op OP_INSERT\n"
+		"unit 'u1' before label 'lab3' (chain 'lab1') op OP_INSERT\n"
+		"unit 'u1' before label 'a' (chain 'lab3') op OP_INSERT\n"
+		"unit 'u1' before label 'c' (chain 'a') op OP_INSERT\n"
+	);
+	unit1->setTracer(NULL);
+
+	// the errors are reported the same way as with the recursive calls
+	msg.clear();
+	try {
+		Autoref<Label> labrec = new LabelRecursive(unit1, rt1, "labrec");
+		Autoref<Label> lab1 = new DummyLabel(unit1, rt1, "lab1");
+		Autoref<Label> lab2 = new DummyLabel(unit1, rt1, "lab2");
+
+		lab1->chain(lab2);
+		lab2->chain(labrec);
+
+		Autoref<Rowop> oprec = new Rowop(lab1, Rowop::OP_DELETE, r1);
+		unit1->call(oprec);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "Exceeded the unit recursion depth limit 1 (attempted 2) on the label 'lab1'.\n\
+Called through the label 'labrec'.\n\
+Called chained from the label 'lab2'.\n\
+Called chained from the label 'lab1'.\n");
+
+	unit1->setMaxRecursionDepth(3);
+	msg.clear();
+	try {
+		Autoref<Label> labrec = new LabelRecursive(unit1, rt1, "labrec");
+		Autoref<Label> lab1 = new DummyLabel(unit1, rt1, "lab1");
+		labrec->setNonReentrant();
+		lab1->chain(labrec);
+
+		Autoref<Rowop> oprec = new Rowop(lab1, Rowop::OP_DELETE, r1);
+		unit1->call(oprec);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	unit1->setMaxRecursionDepth(1);
+	UT_IS(msg, "Detected a recursive call of the non-reentrant label 'labrec'.\n\
+Called chained from the label 'lab1'.\n\
+Called through the label 'labrec'.\n\
+Called chained from the label 'lab1'.\n");
+
+	msg.clear();
+	try {
+		Autoref<Label> labt = new LabelThrowOnCall(unit1, rt1, "labt");
+		Autoref<Label> lab1 = new DummyLabel(unit1, rt1, "lab1");
+		Autoref<Label> lab2 = new DummyLabel(unit1, rt1, "lab2");
+		lab1->chain(lab2);
+		lab2->chain(labt);
+
+		Autoref<Rowop> opt = new Rowop(lab1, Rowop::OP_INSERT, r1);
+		unit1->call(opt);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "Test throw on call\n\
+Called through the label 'labt'.\n\
+Called chained from the label 'lab2'.\n\
+Called chained from the label 'lab1'.\n");
+
+	msg.clear();
+	try {
+		Autoref<Unit> unit2 = new Unit("u2");
+		Autoref<Label> labwu = new DummyLabel(unit2, rt1, "labwu");
+		Autoref<Label> lab1 = new DummyLabel(unit1, rt1, "lab1");
+		Autoref<Label> lab2 = new LogLabel(unit1, rt1, "lab2", &log);
+		lab1->chain(lab2);
+		lab2->chain(labwu);
+
+		Autoref<Rowop> opwu = new Rowop(lab1, Rowop::OP_DELETE, r1);
+		unit1->call(opwu);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "Triceps API violation: call() attempt with unit 'u1' of label 'labwu' belonging to unit 'u2'.\n\
+Called chained from the label 'lab2'.\n\
+Called chained from the label 'lab1'.\n");
+
+	// the recursion counters are back after the exceptions
+	log.clear();
+	unit1->call(op1);
+	UT_IS(log, "a c a c ");
+
+	Exception::abort_ = true; // restore back
+	Exception::enableBacktrace_ = true; // restore back
+}
+
+// logs the batches
+class BatchLogLabel : public LogLabel
+{
+public:
+	BatchLogLabel(Unit *unit, Onceref<RowType> rtype, const string &name, string *log) :
+		LogLabel(unit, rtype, name, log)
+	{
+		setBatching(true);
+	}
+
+	virtual void executeBatch(Rowop *const *rops, size_t n) const
+	{
+		log_->append(strprintf("%s*%d ", getName().c_str(), (int)n));
+		if (getName() == "t")
+			throw Exception("Test throw on batch", true);
+	}
+};
+
+// forks a number of rowops to the next label
+class ForkManyLabel : public LogLabel
+{
+public:
+	ForkManyLabel(Unit *unit, Onceref<RowType> rtype, const string &name, string *log,
+			Onceref<Label> next, int n) :
+		LogLabel(unit, rtype, name, log),
+		next_(next),
+		n_(n)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		LogLabel::execute(arg);
+		Autoref<Rowop> rop = next_->adopt(arg);
+		for (int i = 0; i < n_; i++)
+			unit_->fork(rop);
+	}
+
+	virtual void clearSubclass()
+	{
+		next_ = NULL;
+	}
+
+	Autoref<Label> next_;
+	int n_;
+};
+
+UTESTCASE batching(Utest *utest)
+{
+	string msg;
+
+	Exception::abort_ = false; // make them catchable
+	Exception::enableBacktrace_ = false; // make the error messages predictable
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	Autoref<Unit> unit1 = new Unit("u1");
+
+	string log;
+	Autoref<Label> labb = new BatchLogLabel(unit1, rt1, "b", &log);
+	Autoref<Label> labx = new LogLabel(unit1, rt1, "x", &log);
+	UT_ASSERT(labb->isBatching());
+	UT_ASSERT(!labx->isBatching());
+
+	Autoref<Rowop> opb = new Rowop(labb, Rowop::OP_INSERT, r1);
+	Autoref<Rowop> opx = new Rowop(labx, Rowop::OP_INSERT, r1);
+
+	// the consecutive rowops get batched when draining
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->schedule(opx);
+	unit1->schedule(opx);
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->drainFrame();
+	UT_IS(log, "b*3 x x b*2 ");
+
+	// a single rowop is called as usual
+	log.clear();
+	unit1->schedule(opb);
+	unit1->schedule(opx);
+	unit1->schedule(opb);
+	unit1->drainFrame();
+	UT_IS(log, "b x b ");
+
+	// callNext() executes one rowop at a time
+	log.clear();
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->callNext();
+	UT_IS(log, "b ");
+	unit1->callNext();
+	UT_IS(log, "b b ");
+
+	// the batches are limited in size
+	log.clear();
+	for (int i = 0; i < Unit::BATCH_SIZE + 2; i++)
+		unit1->schedule(opb);
+	unit1->drainFrame();
+	UT_IS(log, strprintf("b*%d b*2 ", Unit::BATCH_SIZE));
+
+	// callTray()
+	log.clear();
+	{
+		Autoref<Tray> tray = new Tray;
+		tray->push_back(opb);
+		tray->push_back(opb);
+		tray->push_back(opx);
+		unit1->callTray(tray);
+	}
+	UT_IS(log, "b*2 x ");
+
+	// the forked rowops
+	log.clear();
+	Autoref<Label> labf = new ForkManyLabel(unit1, rt1, "f", &log, labb, 3);
+	unit1->call(new Rowop(labf, Rowop::OP_INSERT, r1));
+	UT_IS(log, "f b*3 ");
+
+	// the chaining: the batching labels get the whole batch,
+	// the others get the rowops one by one
+	log.clear();
+	Autoref<Label> labc = new BatchLogLabel(unit1, rt1, "c", &log);
+	Autoref<Label> labd = new LogLabel(unit1, rt1, "d", &log);
+	UT_ASSERT(!labb->chain(labd)->hasError());
+	UT_ASSERT(!labb->chain(labc)->hasError());
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->drainFrame();
+	UT_IS(log, "b*2 d d c*2 ");
+
+	// no batching with a tracer
+	log.clear();
+	unit1->setTracer(new Unit::StringNameTracer);
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->drainFrame();
+	UT_IS(log, "b d c b d c ");
+	unit1->setTracer(NULL);
+	labb->clearChained();
+
+	// disabling the batching
+	log.clear();
+	labb->setBatching(false);
+	unit1->schedule(opb);
+	unit1->schedule(opb);
+	unit1->drainFrame();
+	UT_IS(log, "b b ");
+	labb->setBatching(true);
+
+	// the forwarding through a FnReturn to a batching label in the binding
+	log.clear();
+	{
+		Autoref<FnReturn> fret = initializeOrThrow(FnReturn::make(unit1, "fret")
+			->addLabel("one", rt1)
+		);
+		Autoref<FnBinding> bind = FnBinding::make("bind", fret)
+			->addLabel("one", labb, false);
+		ScopeFnBind sb(fret, bind);
+
+		Autoref<Rowop> opr = new Rowop(fret->getLabel("one"), Rowop::OP_INSERT, r1);
+		unit1->schedule(opr);
+		unit1->schedule(opr);
+		unit1->drainFrame();
+		UT_IS(log, "b b "); // the FnReturn label is not batching by default
+
+		log.clear();
+		fret->getLabel("one")->setBatching(true);
+		unit1->schedule(opr);
+		unit1->schedule(opr);
+		unit1->drainFrame();
+		UT_IS(log, "b*2 ");
+	}
+
+	// the errors
+	Autoref<Label> labt = new BatchLogLabel(unit1, rt1, "t", &log);
+	Autoref<Rowop> opt = new Rowop(labt, Rowop::OP_INSERT, r1);
+	Autoref<Label> lab1 = new BatchLogLabel(unit1, rt1, "lab1", &log);
+	Autoref<Rowop> op1 = new Rowop(lab1, Rowop::OP_INSERT, r1);
+	UT_ASSERT(!lab1->chain(labt)->hasError());
+
+	log.clear();
+	msg.clear();
+	try {
+		unit1->schedule(op1);
+		unit1->schedule(op1);
+		unit1->schedule(op1);
+		unit1->drainFrame();
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(log, "lab1*3 t*3 ");
+	UT_IS(msg, "Test throw on batch\n\
+Called through the label 't'.\n\
+Called chained from the label 'lab1'.\n");
+	UT_ASSERT(unit1->empty());
+
+	// the cleared labels are skipped
+	log.clear();
+	lab1->clear();
+	unit1->schedule(op1);
+	unit1->schedule(op1);
+	unit1->drainFrame();
+	UT_IS(log, "");
+
+	Exception::abort_ = true; // restore back
+	Exception::enableBacktrace_ = true; // restore back
+}
+
+// calls the next label, or throws if there is none
+class CallOrThrowLabel : public Label
+{
+public:
+	CallOrThrowLabel(Unit *unit, Onceref<RowType> rtype, const string &name,
+			Onceref<Label> next) :
+		Label(unit, rtype, name),
+		next_(next)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		if (next_.isNull())
+			throw Exception("Test throw on call", true);
+		unit_->call(next_->adopt(arg));
+	}
+
+	virtual void clearSubclass()
+	{
+		next_ = NULL;
+	}
+
+	Autoref<Label> next_;
+};
+
+// find the statistics of a label
+static const LabelStats *findStats(const Unit::LabelStatsVec &v, const Label *lab)
+{
+	for (size_t i = 0; i < v.size(); i++)
+		if (v[i].label_ == lab)
+			return &v[i].stats_;
+	return NULL;
+}
+
+UTESTCASE label_stats(Utest *utest)
+{
+	Exception::abort_ = false; // make them catchable
+	Exception::enableBacktrace_ = false; // make the error messages predictable
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	Autoref<Unit> unit1 = new Unit("u1");
+	UT_ASSERT(!unit1->isLabelStats());
+	UT_ASSERT(!unit1->isLabelHistograms());
+
+	string log;
+	Autoref<Label> labb = new BatchLogLabel(unit1, rt1, "b", &log);
+	Autoref<Label> labc = new CallOrThrowLabel(unit1, rt1, "c", labb);
+	Autoref<Label> labd = new DummyLabel(unit1, rt1, "d");
+	UT_ASSERT(!labd->chain(labc)->hasError());
+	Autoref<Label> labt = new CallOrThrowLabel(unit1, rt1, "t", NULL);
+
+	Autoref<Rowop> opd = new Rowop(labd, Rowop::OP_INSERT, r1);
+	Autoref<Rowop> opb = new Rowop(labb, Rowop::OP_INSERT, r1);
+	Autoref<Rowop> opt = new Rowop(labt, Rowop::OP_INSERT, r1);
+
+	// disabled by default
+	unit1->call(opd);
+	UT_ASSERT(labd->getStats() == NULL);
+	Unit::LabelStatsVec sv;
+	unit1->getLabelStats(sv);
+	UT_IS(sv.size(), 0);
+
+	unit1->setLabelStats(true);
+	UT_ASSERT(unit1->isLabelStats());
+	unit1->setFlatChaining(true); // gets overridden
+	for (int i = 0; i < 3; i++)
+		unit1->call(opd);
+	for (int i = 0; i < 4; i++)
+		unit1->schedule(opb);
+	unit1->drainFrame(); // one batch
+	try {
+		unit1->call(opt);
+	} catch (Exception e) {
+	}
+
+	unit1->getLabelStats(sv);
+	UT_IS(sv.size(), 4);
+
+	const LabelStats *std = findStats(sv, labd);
+	const LabelStats *stc = findStats(sv, labc);
+	const LabelStats *stb = findStats(sv, labb);
+	const LabelStats *stt = findStats(sv, labt);
+	if (UT_ASSERT(std && stc && stb && stt)) return;
+
+	UT_IS(std->calls_, 3);
+	UT_IS(std->rows_, 3);
+	UT_IS(std->exceptions_, 0);
+	UT_IS(std->maxRecursion_, 1);
+	UT_IS(stc->calls_, 3);
+	UT_IS(stb->calls_, 3 + 1);
+	UT_IS(stb->rows_, 3 + 4);
+	UT_IS(stt->calls_, 1);
+	UT_IS(stt->exceptions_, 1);
+
+	// the self time excludes exactly the nested labels
+	UT_IS(std->selfTicks_ + stc->totalTicks_, std->totalTicks_);
+	UT_ASSERT(stc->selfTicks_ <= stc->totalTicks_);
+	UT_IS(stb->selfTicks_, stb->totalTicks_); // calls nothing
+
+	// no histograms yet
+	uint64_t hsum = 0;
+	for (int i = 0; i < LabelStats::HISTOGRAM_SIZE; i++)
+		hsum += std->histogram_[i];
+	UT_IS(hsum, 0);
+
+	// the recursion
+	unit1->setMaxRecursionDepth(3);
+	Autoref<CallOrThrowLabel> labr = new CallOrThrowLabel(unit1, rt1, "r", NULL);
+	labr->next_ = labr;
+	try {
+		unit1->call(new Rowop(labr, Rowop::OP_INSERT, r1));
+	} catch (Exception e) {
+	}
+	labr->next_ = NULL;
+	unit1->setMaxRecursionDepth(1);
+	UT_ASSERT(labr->getStats() != NULL);
+	UT_IS(labr->getStats()->calls_, 4); // the attempt to call at depth 4 counts too
+	UT_IS(labr->getStats()->exceptions_, 4);
+	UT_IS(labr->getStats()->maxRecursion_, 4);
+
+	// the histograms
+	unit1->clearLabelStats();
+	unit1->getLabelStats(sv);
+	UT_IS(sv.size(), 0);
+	UT_IS(labd->getStats()->calls_, 0);
+
+	unit1->setLabelHistograms(true);
+	for (int i = 0; i < 10; i++)
+		unit1->call(opd);
+	UT_IS(labd->getStats()->calls_, 10);
+	hsum = 0;
+	for (int i = 0; i < LabelStats::HISTOGRAM_SIZE; i++)
+		hsum += labd->getStats()->histogram_[i];
+	UT_IS(hsum, 10);
+
+	// disabling keeps the collected data
+	unit1->setLabelStats(false);
+	unit1->call(opd);
+	UT_IS(labd->getStats()->calls_, 10);
+	UT_IS(log, "b b b b b*4 b b b b b b b b b b b ");
+
+	Exception::abort_ = true; // restore back
+	Exception::enableBacktrace_ = true; // restore back
+}
+
+// rejects the deletes
+class RejectLabel : public Label
+{
+public:
+	RejectLabel(Unit *unit, Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		if (arg->isDelete())
+			reject(arg, "deletes are not accepted");
+	}
+};
+
+// calls the next label and swallows any exception from it
+class CatchingLabel : public Label
+{
+public:
+	CatchingLabel(Unit *unit, Onceref<RowType> rtype, const string &name,
+			Onceref<Label> next) :
+		Label(unit, rtype, name),
+		next_(next)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		try {
+			unit_->call(next_->adopt(arg));
+		} catch (...) {
+		}
+	}
+
+	virtual void clearSubclass()
+	{
+		next_ = NULL;
+	}
+
+	Autoref<Label> next_;
+};
+
+// throws an exception that is not a Triceps Exception
+class ForeignThrowLabel : public Label
+{
+public:
+	ForeignThrowLabel(Unit *unit, Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		throw std::bad_alloc();
+	}
+};
+
+UTESTCASE label_stats_foreign(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	// the unit is not usable after the foreign exception, so it's a separate one
+	Autoref<Unit> unit1 = new Unit("u1");
+	unit1->setLabelStats(true);
+
+	Autoref<Label> labf = new ForeignThrowLabel(unit1, rt1, "f");
+	Autoref<Label> labo = new CatchingLabel(unit1, rt1, "o", labf);
+	unit1->call(new Rowop(labo, Rowop::OP_INSERT, r1));
+
+	// the thrown call still gets counted, and its time is nested in the caller
+	const LabelStats *stf = labf->getStats();
+	const LabelStats *sto = labo->getStats();
+	if (UT_ASSERT(stf && sto)) return;
+	UT_IS(stf->calls_, 1);
+	UT_IS(stf->exceptions_, 1);
+	UT_IS(sto->calls_, 1);
+	UT_IS(sto->exceptions_, 0);
+	UT_IS(sto->selfTicks_ + stf->totalTicks_, sto->totalTicks_);
+	UT_IS(unit1->statsNestedTicks(), sto->totalTicks_);
+
+	unit1->clearLabels();
+}
+
+UTESTCASE reject(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	Autoref<Unit> unit1 = new Unit("u1");
+	UT_IS(unit1->getRejectCount(), 0);
+	UT_IS(unit1->getMaxRejects(), Unit::DEFAULT_MAX_REJECTS);
+
+	string log;
+	Autoref<Label> labr = new RejectLabel(unit1, rt1, "r");
+	Autoref<Label> labb = new BatchLogLabel(unit1, rt1, "b", &log);
+	UT_ASSERT(!labr->chain(labb)->hasError());
+
+	Autoref<Rowop> opi = new Rowop(labr, Rowop::OP_INSERT, r1);
+	Autoref<Rowop> opd = new Rowop(labr, Rowop::OP_DELETE, r1);
+
+	// the rejection doesn't stop the processing of the following rowops,
+	// but the rejected ones don't go to the chain of the rejecting label
+	unit1->setLabelStats(true);
+	unit1->schedule(opd);
+	unit1->schedule(opi);
+	unit1->schedule(opd);
+	unit1->drainFrame();
+	UT_IS(log, "b ");
+	UT_IS(unit1->getRejectCount(), 2);
+	const Unit::RejectionDeque &rj = unit1->getRejects();
+	UT_IS(rj.size(), 2);
+	UT_IS(rj[0].label_.get(), labr.get());
+	UT_IS(rj[0].rop_.get(), opd.get());
+	UT_IS(rj[0].msg_, "deletes are not accepted");
+	UT_IS(labr->getStats()->calls_, 3);
+	UT_IS(labr->getStats()->rejects_, 2);
+	UT_IS(labr->getStats()->exceptions_, 0);
+	UT_IS(labb->getStats()->rejects_, 0);
+	unit1->setLabelStats(false);
+
+	// same with the recursive and flat chaining
+	log.clear();
+	unit1->call(opd);
+	unit1->call(opi);
+	UT_IS(log, "b ");
+	unit1->setFlatChaining(true);
+	log.clear();
+	unit1->call(opd);
+	unit1->call(opi);
+	UT_IS(log, "b ");
+	unit1->setFlatChaining(false);
+
+	// in a batch only the accepted rowops go to the chain
+	Autoref<Label> labrb = new RejectLabel(unit1, rt1, "rb");
+	labrb->setBatching(true);
+	UT_ASSERT(!labrb->chain(labb)->hasError());
+	Autoref<Rowop> opib = new Rowop(labrb, Rowop::OP_INSERT, r1);
+	Autoref<Rowop> opdb = new Rowop(labrb, Rowop::OP_DELETE, r1);
+	log.clear();
+	unit1->schedule(opdb);
+	unit1->schedule(opib);
+	unit1->schedule(opdb);
+	unit1->schedule(opib);
+	unit1->drainFrame();
+	UT_IS(log, "b*2 ");
+	log.clear();
+	unit1->schedule(opdb);
+	unit1->schedule(opdb);
+	unit1->drainFrame();
+	UT_IS(log, "");
+
+	UT_IS(unit1->getRejectCount(), 8);
+	unit1->clearRejects();
+
+	// only the latest ones are kept
+	unit1->setMaxRejects(3);
+	for (int i = 0; i < 5; i++)
+		unit1->call(opd);
+	UT_IS(log, ""); // none of them goes to the chain
+	UT_IS(unit1->getRejectCount(), 5);
+	UT_IS(rj.size(), 3);
+	unit1->setMaxRejects(1);
+	UT_IS(rj.size(), 1);
+
+	// only counting
+	unit1->setMaxRejects(-1);
+	UT_IS(unit1->getMaxRejects(), 0);
+	UT_IS(rj.size(), 0);
+	unit1->call(opd);
+	UT_IS(unit1->getRejectCount(), 6);
+	UT_IS(rj.size(), 0);
+
+	unit1->setMaxRejects(Unit::DEFAULT_MAX_REJECTS);
+	unit1->call(opd);
+	UT_IS(rj.size(), 1);
+	unit1->clearRejects();
+	UT_IS(unit1->getRejectCount(), 0);
+	UT_IS(rj.size(), 0);
+
+	// clearing the labels drops the references to them
+	unit1->call(opd);
+	UT_IS(rj.size(), 1);
+	unit1->clearLabels();
+	UT_IS(rj.size(), 0);
+	UT_IS(unit1->getRejectCount(), 1);
+}
@@ -0,0 +1,272 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A basic test of the Unit scheduling performance. By default it's
+// configured to run fast at the cost of precision. To increase the
+// precision increase the number of iterations by setting the environment
+// variable:
+//  TRICEPS_PERF_COUNT=10000000 ./test/build/t_perf
+
+#include <utest/Utest.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <type/CompactRowType.h>
+#include <common/Exception.h>
+#include <sched/Unit.h>
+#include <sched/BinaryTracer.h>
+
+static int perfCount()
+{
+	const char *s = getenv("TRICEPS_PERF_COUNT");
+	int n = (s == NULL? 0 : atoi(s));
+	return n > 0? n : 100000; // the default for the fast run
+}
+
+static double now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *what, int n, double df)
+{
+	printf("%s %f s, %.02f per second.\n", what, df, (df > 0.? n / df : 0.));
+}
+
+// counts the executions
+class CountLabel : public Label
+{
+public:
+	CountLabel(Unit *unit, Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name),
+		count_(0)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		++count_;
+	}
+
+	mutable int count_;
+};
+
+// counts the executions in batches
+class BatchCountLabel : public CountLabel
+{
+public:
+	BatchCountLabel(Unit *unit, Onceref<RowType> rtype, const string &name) :
+		CountLabel(unit, rtype, name)
+	{
+		setBatching(true);
+	}
+
+	virtual void executeBatch(Rowop *const *rops, size_t n) const
+	{
+		count_ += n;
+	}
+};
+
+// forks a number of rowops to the next label
+class ForkManyLabel : public Label
+{
+public:
+	ForkManyLabel(Unit *unit, Onceref<RowType> rtype, const string &name,
+			Onceref<Label> next, int n) :
+		Label(unit, rtype, name),
+		next_(next),
+		n_(n)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		Autoref<Rowop> rop = next_->adopt(arg);
+		for (int i = 0; i < n_; i++)
+			unit_->fork(rop);
+	}
+
+	Autoref<Label> next_;
+	int n_;
+};
+
+// calls the next label
+class CallLabel : public Label
+{
+public:
+	CallLabel(Unit *unit, Onceref<RowType> rtype, const string &name,
+			Onceref<Label> next) :
+		Label(unit, rtype, name),
+		next_(next)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		unit_->call(next_->adopt(arg));
+	}
+
+	Autoref<Label> next_;
+};
+
+// rejects every rowop, either by throwing or through the rejection channel
+class RejectLabel : public Label
+{
+public:
+	RejectLabel(Unit *unit, Onceref<RowType> rtype, const string &name, bool doThrow) :
+		Label(unit, rtype, name),
+		throw_(doThrow)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		if (throw_)
+			throw Exception::fTrace("bad row");
+		reject(arg, "bad row");
+	}
+
+	bool throw_;
+};
+
+UTESTCASE scheduling(Utest *utest)
+{
+	int n = perfCount();
+
+	RowType::FieldVec fld;
+	fld.push_back(RowType::Field("a", Type::r_int64));
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	FdataVec dv(1);
+	int64_t v = 1;
+	dv[0].setPtr(true, &v, sizeof(v));
+	Rowref r1(rt1, rt1->makeRow(dv));
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<CountLabel> lab = new CountLabel(unit, rt1, "lab");
+	Autoref<Rowop> op = new Rowop(lab, Rowop::OP_INSERT, r1);
+
+	printf("Performance test, %d iterations, real time.\n", n);
+
+	double start = now();
+	for (int i = 0; i < n; i++)
+		unit->schedule(op);
+	unit->drainFrame();
+	report("Schedule and drain", n, now() - start);
+	UT_IS(lab->count_, n);
+
+	// the queue interleaved with the execution
+	lab->count_ = 0;
+	start = now();
+	for (int i = 0; i < n; i++) {
+		unit->schedule(op);
+		unit->callNext();
+	}
+	report("Schedule and callNext", n, now() - start);
+	UT_IS(lab->count_, n);
+	UT_ASSERT(unit->empty());
+
+	// fork a batch from each call
+	lab->count_ = 0;
+	const int batch = 100;
+	Autoref<Label> forker = new ForkManyLabel(unit, rt1, "forker", lab, batch);
+	Autoref<Rowop> opf = new Rowop(forker, Rowop::OP_INSERT, r1);
+	int nf = n / batch;
+	start = now();
+	for (int i = 0; i < nf; i++)
+		unit->call(opf);
+	report("Fork and drain", nf * batch, now() - start);
+	UT_IS(lab->count_, nf * batch);
+
+	// the nested calls push and pop the frames
+	lab->count_ = 0;
+	Autoref<Label> caller = new CallLabel(unit, rt1, "caller", lab);
+	Autoref<Rowop> opc = new Rowop(caller, Rowop::OP_INSERT, r1);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->call(opc);
+	report("Nested call", n, now() - start);
+	UT_IS(lab->count_, n);
+	UT_ASSERT(unit->empty());
+
+	// the same label executed in batches
+	Autoref<CountLabel> blab = new BatchCountLabel(unit, rt1, "blab");
+	Autoref<Rowop> opb = new Rowop(blab, Rowop::OP_INSERT, r1);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->schedule(opb);
+	unit->drainFrame();
+	report("Schedule and drain batched", n, now() - start);
+	UT_IS(blab->count_, n);
+
+	// the tracing
+	lab->count_ = 0;
+	unit->setTracer(new Unit::StringNameTracer);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->call(op);
+	report("Call with StringNameTracer", n, now() - start);
+
+	unit->setTracer(new BinaryTracer);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->call(op);
+	report("Call with BinaryTracer", n, now() - start);
+
+	Autoref<BinaryTracer> bt = new BinaryTracer;
+	bt->setSampling(100);
+	unit->setTracer(bt);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->call(op);
+	report("Call with BinaryTracer sampling 1/100", n, now() - start);
+	unit->setTracer(NULL);
+	UT_IS(lab->count_, 3 * n);
+
+	// the label statistics
+	lab->count_ = 0;
+	unit->setLabelStats(true);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->call(op);
+	report("Call with label stats", n, now() - start);
+
+	unit->setLabelHistograms(true);
+	start = now();
+	for (int i = 0; i < n; i++)
+		unit->call(op);
+	report("Call with label stats and histograms", n, now() - start);
+	unit->setLabelHistograms(false);
+	unit->setLabelStats(false);
+	UT_IS(lab->count_, 2 * n);
+
+	// the error handling, through a chain
+	Exception::abort_ = false; // make them catchable
+	int ne = n / 10;
+	Autoref<Label> thrower = new RejectLabel(unit, rt1, "thrower", true);
+	Autoref<Label> ethrow = new DummyLabel(unit, rt1, "ethrow");
+	ethrow->chain(thrower);
+	Autoref<Rowop> opt = new Rowop(ethrow, Rowop::OP_INSERT, r1);
+	int caught = 0;
+	start = now();
+	for (int i = 0; i < ne; i++) {
+		try {
+			unit->call(opt);
+		} catch (Exception e) {
+			++caught;
+		}
+	}
+	report("Call with an Exception", ne, now() - start);
+	UT_IS(caught, ne);
+
+	Autoref<Label> rejecter = new RejectLabel(unit, rt1, "rejecter", false);
+	Autoref<Label> ereject = new DummyLabel(unit, rt1, "ereject");
+	ereject->chain(rejecter);
+	Autoref<Rowop> opr = new Rowop(ereject, Rowop::OP_INSERT, r1);
+	start = now();
+	for (int i = 0; i < ne; i++)
+		unit->call(opr);
+	report("Call with a rejection", ne, now() - start);
+	UT_IS(unit->getRejectCount(), (uint64_t)ne);
+	Exception::abort_ = true; // restore back
+}
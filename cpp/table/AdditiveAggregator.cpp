@@ -0,0 +1,524 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps the additive state of SQL-like functions.
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <type/AdditiveAggregatorType.h>
+#include <table/AdditiveAggregator.h>
+#include <table/Table.h>
+#include <sched/AggregatorGadget.h>
+
+namespace TRICEPS_NS {
+
+AdditiveAggregator::AdditiveAggregator(const AdditiveAggregatorType *type) :
+	slots_(type->getFields().size()),
+	rows_(0),
+	oldest_(NULL)
+{
+	const AdditiveAggregatorType::FieldDefVec &fields = type->fields_;
+	for (size_t i = 0; i < fields.size(); i++) {
+		Slot &sl = slots_[i];
+		sl.count_ = 0;
+		sl.val_.i_ = 0; // all-zero bits are also 0. in float64
+		sl.dirty_ = false;
+		sl.win_ = NULL;
+		sl.sketch_ = NULL;
+		sl.delSketch_ = NULL;
+		sl.hll_ = NULL;
+		if (type->windowed_ && (fields[i].func_ == AdditiveAggregatorType::FN_MIN
+		|| fields[i].func_ == AdditiveAggregatorType::FN_MAX))
+			sl.win_ = new WinDeque;
+		if (fields[i].func_ == AdditiveAggregatorType::FN_QUANTILE)
+			sl.sketch_ = new QuantileSketch(fields[i].k_);
+		else if (fields[i].func_ == AdditiveAggregatorType::FN_COUNT_DISTINCT)
+			sl.hll_ = new HyperLogLog(fields[i].precision_);
+	}
+}
+
+AdditiveAggregator::~AdditiveAggregator()
+{
+	for (SlotVec::iterator it = slots_.begin(); it != slots_.end(); ++it) {
+		delete it->win_;
+		delete it->sketch_;
+		delete it->delSketch_;
+		delete it->hll_;
+	}
+}
+
+bool AdditiveAggregator::readValue(const RowType *rt, const Row *row, int idx, int argType, Value &v)
+{
+	const char *ptr;
+	intptr_t len;
+	if (!rt->getField(row, idx, ptr, len))
+		return false;
+
+	switch (argType) {
+	case Type::TT_UINT8:
+		v.i_ = *(const uint8_t *)ptr;
+		break;
+	case Type::TT_INT32:
+		{
+			int32_t x;
+			memcpy(&x, ptr, sizeof(x));
+			v.i_ = x;
+		}
+		break;
+	case Type::TT_INT64:
+		memcpy(&v.i_, ptr, sizeof(v.i_));
+		break;
+	case Type::TT_FLOAT64:
+		memcpy(&v.f_, ptr, sizeof(v.f_));
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+bool AdditiveAggregator::notWorse(const AdditiveAggregatorType::FieldDef &fd, const Value &v, const Value &than)
+{
+	if (fd.func_ == AdditiveAggregatorType::FN_MIN) {
+		if (fd.argType_ == Type::TT_FLOAT64)
+			return v.f_ <= than.f_;
+		else
+			return v.i_ <= than.i_;
+	} else {
+		if (fd.argType_ == Type::TT_FLOAT64)
+			return v.f_ >= than.f_;
+		else
+			return v.i_ >= than.i_;
+	}
+}
+
+void AdditiveAggregator::pushWindow(const AdditiveAggregatorType::FieldDef &fd, Slot &sl, const Value &v, const RowHandle *rh)
+{
+	WinDeque &win = *sl.win_;
+	// the older values that are not better can never become the extreme
+	// while this one is in the window
+	while (!win.empty() && notWorse(fd, v, win.back().val_))
+		win.pop_back();
+	WinEntry e;
+	e.val_ = v;
+	e.rh_ = rh;
+	win.push_back(e);
+	sl.val_ = win.front().val_;
+}
+
+void AdditiveAggregator::addRow(const AdditiveAggregatorType *type, const RowType *rt, const Row *row,
+	const RowHandle *rh)
+{
+	const AdditiveAggregatorType::FieldDefVec &fields = type->fields_;
+	if (rows_++ == 0 && type->windowed_)
+		oldest_ = rh;
+	for (size_t i = 0; i < fields.size(); i++) {
+		const AdditiveAggregatorType::FieldDef &fd = fields[i];
+		Slot &sl = slots_[i];
+		Value v;
+
+		switch (fd.func_) {
+		case AdditiveAggregatorType::FN_COUNT:
+			if (!rt->isFieldNull(row, fd.argIdx_))
+				++sl.count_;
+			break;
+		case AdditiveAggregatorType::FN_SUM:
+		case AdditiveAggregatorType::FN_AVG:
+			if (readValue(rt, row, fd.argIdx_, fd.argType_, v)) {
+				++sl.count_;
+				if (fd.argType_ == Type::TT_FLOAT64)
+					sl.val_.f_ += v.f_;
+				else
+					sl.val_.i_ += v.i_;
+			}
+			break;
+		case AdditiveAggregatorType::FN_MIN:
+		case AdditiveAggregatorType::FN_MAX:
+			if (readValue(rt, row, fd.argIdx_, fd.argType_, v)) {
+				if (sl.win_ != NULL && rh != NULL) {
+					if (sl.count_++ == 0) {
+						sl.win_->clear();
+						sl.dirty_ = false;
+					}
+					if (!sl.dirty_)
+						pushWindow(fd, sl, v, rh);
+				} else if (sl.count_++ == 0) {
+					sl.val_ = v;
+					sl.dirty_ = false;
+				} else if (!sl.dirty_) {
+					bool isMin = (fd.func_ == AdditiveAggregatorType::FN_MIN);
+					if (fd.argType_ == Type::TT_FLOAT64) {
+						if (isMin? (v.f_ < sl.val_.f_) : (v.f_ > sl.val_.f_))
+							sl.val_ = v;
+					} else {
+						if (isMin? (v.i_ < sl.val_.i_) : (v.i_ > sl.val_.i_))
+							sl.val_ = v;
+					}
+				}
+			}
+			break;
+		case AdditiveAggregatorType::FN_QUANTILE:
+			if (readValue(rt, row, fd.argIdx_, fd.argType_, v)) {
+				++sl.count_;
+				sl.sketch_->add(fd.argType_ == Type::TT_FLOAT64? v.f_ : (double)v.i_);
+			}
+			break;
+		case AdditiveAggregatorType::FN_COUNT_DISTINCT:
+			{
+				const char *ptr;
+				intptr_t len;
+				if (rt->getField(row, fd.argIdx_, ptr, len)) {
+					++sl.count_;
+					if (!sl.dirty_)
+						sl.hll_->addBytes(ptr, len);
+				}
+			}
+			break;
+		default: // first, last and count_star need no state
+			break;
+		}
+	}
+}
+
+void AdditiveAggregator::removeRow(const AdditiveAggregatorType *type, const RowType *rt, const Row *row,
+	const RowHandle *rh)
+{
+	const AdditiveAggregatorType::FieldDefVec &fields = type->fields_;
+	// in a window, a push-out removes the oldest row
+	bool front = (type->windowed_ && rh != NULL && rh == oldest_);
+	if (front)
+		oldest_ = NULL; // the caller finds the next one
+	--rows_;
+	for (size_t i = 0; i < fields.size(); i++) {
+		const AdditiveAggregatorType::FieldDef &fd = fields[i];
+		Slot &sl = slots_[i];
+		Value v;
+
+		switch (fd.func_) {
+		case AdditiveAggregatorType::FN_COUNT:
+			if (!rt->isFieldNull(row, fd.argIdx_))
+				--sl.count_;
+			break;
+		case AdditiveAggregatorType::FN_SUM:
+		case AdditiveAggregatorType::FN_AVG:
+			if (readValue(rt, row, fd.argIdx_, fd.argType_, v)) {
+				if (--sl.count_ == 0) {
+					// also avoids the accumulation of the float rounding errors
+					sl.val_.i_ = 0;
+				} else if (fd.argType_ == Type::TT_FLOAT64)
+					sl.val_.f_ -= v.f_;
+				else
+					sl.val_.i_ -= v.i_;
+			}
+			break;
+		case AdditiveAggregatorType::FN_MIN:
+		case AdditiveAggregatorType::FN_MAX:
+			if (readValue(rt, row, fd.argIdx_, fd.argType_, v)) {
+				if (--sl.count_ == 0) {
+					sl.dirty_ = false;
+					if (sl.win_ != NULL)
+						sl.win_->clear();
+				} else if (sl.win_ != NULL && rh != NULL) {
+					if (!front) {
+						// the deque can't find a row in the middle
+						sl.dirty_ = true;
+					} else if (!sl.dirty_) {
+						if (sl.win_->front().rh_ == rh)
+							sl.win_->pop_front();
+						sl.val_ = sl.win_->front().val_;
+					}
+				} else if (!sl.dirty_) {
+					// only the deletion of the extreme itself makes it unknown
+					if (fd.argType_ == Type::TT_FLOAT64) {
+						if (v.f_ == sl.val_.f_)
+							sl.dirty_ = true;
+					} else {
+						if (v.i_ == sl.val_.i_)
+							sl.dirty_ = true;
+					}
+				}
+			}
+			break;
+		case AdditiveAggregatorType::FN_QUANTILE:
+			if (readValue(rt, row, fd.argIdx_, fd.argType_, v)) {
+				if (--sl.count_ == 0) {
+					sl.sketch_->clear();
+					delete sl.delSketch_;
+					sl.delSketch_ = NULL;
+					sl.dirty_ = false;
+				} else {
+					if (sl.delSketch_ == NULL)
+						sl.delSketch_ = new QuantileSketch(fd.k_);
+					sl.delSketch_->add(fd.argType_ == Type::TT_FLOAT64? v.f_ : (double)v.i_);
+					// when the removed values outnumber the rest, the error of the
+					// subtraction gets too large, so rebuild if the rows are available
+					if (sl.delSketch_->getCount() > (uint64_t)sl.count_)
+						sl.dirty_ = true;
+				}
+			}
+			break;
+		case AdditiveAggregatorType::FN_COUNT_DISTINCT:
+			if (!rt->isFieldNull(row, fd.argIdx_)) {
+				if (--sl.count_ == 0) {
+					sl.hll_->clear();
+					sl.dirty_ = false;
+				} else {
+					// the values can't be removed from the sketch
+					sl.dirty_ = true;
+				}
+			}
+			break;
+		default: // first, last and count_star need no state
+			break;
+		}
+	}
+}
+
+void AdditiveAggregator::rebuildSketch(const AdditiveAggregatorType *type, const RowType *rt, Index *index, int fidx)
+{
+	const AdditiveAggregatorType::FieldDef &fd = type->fields_[fidx];
+	Slot &sl = slots_[fidx];
+
+	if (sl.hll_ != NULL) {
+		sl.hll_->clear();
+		for (RowHandle *rhi = index->begin(); rhi != NULL; rhi = index->next(rhi)) {
+			const char *ptr;
+			intptr_t len;
+			if (rt->getField(rhi->getRow(), fd.argIdx_, ptr, len))
+				sl.hll_->addBytes(ptr, len);
+		}
+		sl.dirty_ = false;
+		return;
+	}
+
+	sl.sketch_->clear();
+	delete sl.delSketch_;
+	sl.delSketch_ = NULL;
+	for (RowHandle *rhi = index->begin(); rhi != NULL; rhi = index->next(rhi)) {
+		Value v;
+		if (readValue(rt, rhi->getRow(), fd.argIdx_, fd.argType_, v))
+			sl.sketch_->add(fd.argType_ == Type::TT_FLOAT64? v.f_ : (double)v.i_);
+	}
+	sl.dirty_ = false;
+}
+
+void AdditiveAggregator::recompute(const AdditiveAggregatorType *type, const RowType *rt, Index *index, int fidx)
+{
+	const AdditiveAggregatorType::FieldDef &fd = type->fields_[fidx];
+	Slot &sl = slots_[fidx];
+	bool isMin = (fd.func_ == AdditiveAggregatorType::FN_MIN);
+	bool first = true;
+
+	if (sl.win_ != NULL) {
+		// rebuild the deque, going from the oldest row to the newest
+		sl.win_->clear();
+		vector<RowHandle *> rows;
+		for (RowHandle *rhi = index->begin(); rhi != NULL; rhi = index->next(rhi))
+			rows.push_back(rhi);
+		if (type->windowReverse_)
+			reverse(rows.begin(), rows.end());
+		for (vector<RowHandle *>::iterator it = rows.begin(); it != rows.end(); ++it) {
+			Value v;
+			if (readValue(rt, (*it)->getRow(), fd.argIdx_, fd.argType_, v))
+				pushWindow(fd, sl, v, *it);
+		}
+		sl.dirty_ = false;
+		return;
+	}
+
+	for (RowHandle *rhi = index->begin(); rhi != NULL; rhi = index->next(rhi)) {
+		Value v;
+		if (!readValue(rt, rhi->getRow(), fd.argIdx_, fd.argType_, v))
+			continue;
+		if (first) {
+			sl.val_ = v;
+			first = false;
+		} else if (fd.argType_ == Type::TT_FLOAT64) {
+			if (isMin? (v.f_ < sl.val_.f_) : (v.f_ > sl.val_.f_))
+				sl.val_ = v;
+		} else {
+			if (isMin? (v.i_ < sl.val_.i_) : (v.i_ > sl.val_.i_))
+				sl.val_ = v;
+		}
+	}
+	sl.dirty_ = false;
+}
+
+void AdditiveAggregator::makeResult(const AdditiveAggregatorType *type, const RowType *rt, Index *index, Rowref &res,
+	const Row *sample)
+{
+	const AdditiveAggregatorType::FieldDefVec &fields = type->fields_;
+	size_t n = fields.size();
+	FdataVec data(n);
+	// the buffers for the field values, enough for any numeric type
+	vector<Value> buf(n);
+	RowHandle *firstrh = NULL, *lastrh = NULL;
+
+	for (size_t i = 0; i < n; i++) {
+		const AdditiveAggregatorType::FieldDef &fd = fields[i];
+		Slot &sl = slots_[i];
+		Value &b = buf[i];
+
+		switch (fd.func_) {
+		case AdditiveAggregatorType::FN_FIRST:
+			if (index == NULL) {
+				data[i].setFrom(rt, sample, fd.argIdx_);
+				break;
+			}
+			if (firstrh == NULL)
+				firstrh = index->begin();
+			if (firstrh == NULL)
+				data[i].setNull();
+			else
+				data[i].setFrom(rt, firstrh->getRow(), fd.argIdx_);
+			break;
+		case AdditiveAggregatorType::FN_LAST:
+			if (index == NULL) {
+				data[i].setFrom(rt, sample, fd.argIdx_);
+				break;
+			}
+			if (lastrh == NULL)
+				lastrh = index->last();
+			if (lastrh == NULL)
+				data[i].setNull();
+			else
+				data[i].setFrom(rt, lastrh->getRow(), fd.argIdx_);
+			break;
+		case AdditiveAggregatorType::FN_COUNT_STAR:
+			b.i_ = rows_;
+			data[i].setPtr(true, &b.i_, sizeof(b.i_));
+			break;
+		case AdditiveAggregatorType::FN_COUNT:
+			b.i_ = sl.count_;
+			data[i].setPtr(true, &b.i_, sizeof(b.i_));
+			break;
+		case AdditiveAggregatorType::FN_SUM:
+			b = sl.val_;
+			if (fd.argType_ == Type::TT_FLOAT64)
+				data[i].setPtr(true, &b.f_, sizeof(b.f_));
+			else
+				data[i].setPtr(true, &b.i_, sizeof(b.i_));
+			break;
+		case AdditiveAggregatorType::FN_AVG:
+			if (sl.count_ == 0) {
+				data[i].setNull();
+			} else {
+				if (fd.argType_ == Type::TT_FLOAT64)
+					b.f_ = sl.val_.f_ / (double)sl.count_;
+				else
+					b.f_ = (double)sl.val_.i_ / (double)sl.count_;
+				data[i].setPtr(true, &b.f_, sizeof(b.f_));
+			}
+			break;
+		case AdditiveAggregatorType::FN_MIN:
+		case AdditiveAggregatorType::FN_MAX:
+			if (sl.count_ == 0) {
+				data[i].setNull();
+				break;
+			}
+			if (sl.dirty_)
+				recompute(type, rt, index, i);
+			// convert the value back to the field's own width
+			switch (fd.argType_) {
+			case Type::TT_UINT8:
+				{
+					uint8_t x = (uint8_t)sl.val_.i_;
+					memcpy(&b, &x, sizeof(x));
+					data[i].setPtr(true, &b, sizeof(x));
+				}
+				break;
+			case Type::TT_INT32:
+				{
+					int32_t x = (int32_t)sl.val_.i_;
+					memcpy(&b, &x, sizeof(x));
+					data[i].setPtr(true, &b, sizeof(x));
+				}
+				break;
+			default:
+				b = sl.val_;
+				data[i].setPtr(true, &b, sizeof(b));
+				break;
+			}
+			break;
+		case AdditiveAggregatorType::FN_QUANTILE:
+			if (sl.dirty_ && index != NULL)
+				rebuildSketch(type, rt, index, i);
+			if (sl.count_ != 0 && (sl.delSketch_ == NULL?
+				sl.sketch_->quantile(fd.q_, b.f_)
+				: QuantileSketch::netQuantile(*sl.sketch_, *sl.delSketch_, fd.q_, b.f_)))
+				data[i].setPtr(true, &b.f_, sizeof(b.f_));
+			else
+				data[i].setNull();
+			break;
+		case AdditiveAggregatorType::FN_COUNT_DISTINCT:
+			if (sl.dirty_ && index != NULL)
+				rebuildSketch(type, rt, index, i);
+			if (sl.count_ == 0) {
+				b.i_ = 0;
+			} else {
+				b.i_ = (int64_t)floor(sl.hll_->estimate() + 0.5);
+				// the estimate can't be outside of the obvious limits
+				if (b.i_ < 1)
+					b.i_ = 1;
+				else if (b.i_ > sl.count_)
+					b.i_ = sl.count_;
+			}
+			data[i].setPtr(true, &b.i_, sizeof(b.i_));
+			break;
+		default:
+			data[i].setNull();
+			break;
+		}
+	}
+
+	const RowType *resrt = type->getRowType();
+	res = Rowref(resrt, resrt->makeRow(data));
+}
+
+void AdditiveAggregator::handle(Table *table, AggregatorGadget *gadget, Index *index,
+	const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+	AggOp aggop, Rowop::Opcode opcode, RowHandle *rh)
+{
+	const AdditiveAggregatorType *at = gadget->typeAs<AdditiveAggregatorType>();
+	const RowType *rt = table->getRowType();
+
+	// the state gets updated even if nothing is sent
+	if (aggop == AO_AFTER_INSERT) {
+		addRow(at, rt, rh->getRow(), rh);
+	} else if (aggop == AO_AFTER_DELETE) {
+		removeRow(at, rt, rh->getRow(), rh);
+		if (oldest_ == NULL && rows_ > 0 && at->windowed_)
+			oldest_ = (at->windowReverse_? index->last() : index->begin());
+	}
+
+	// don't send the NULL record after the group becomes empty
+	if (opcode == Rowop::OP_NOP || parentIndexType->groupSize(gh) == 0)
+		return;
+
+	Rowref res(at->getRowType());
+	makeResult(at, rt, index, res);
+	gadget->sendDelayed(dest, res, opcode);
+}
+
+void AdditiveAggregator::handleUpdate(Table *table, AggregatorGadget *gadget, Index *index,
+	const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+	RowHandle *oldrh, RowHandle *newrh)
+{
+	const AdditiveAggregatorType *at = gadget->typeAs<AdditiveAggregatorType>();
+	const RowType *rt = table->getRowType();
+
+	removeRow(at, rt, oldrh->getRow(), oldrh);
+	if (oldest_ == NULL && rows_ > 0 && at->windowed_)
+		oldest_ = (at->windowReverse_? index->last() : index->begin());
+	addRow(at, rt, newrh->getRow(), newrh);
+
+	Rowref res(at->getRowType());
+	makeResult(at, rt, index, res);
+	gadget->sendDelayed(dest, res, Rowop::OP_INSERT);
+}
+
+}; // TRICEPS_NS
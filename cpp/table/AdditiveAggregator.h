@@ -0,0 +1,135 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps the additive state of SQL-like functions.
+
+#ifndef __Triceps_AdditiveAggregator_h__
+#define __Triceps_AdditiveAggregator_h__
+
+#include <deque>
+#include <table/Aggregator.h>
+#include <type/AdditiveAggregatorType.h>
+
+namespace TRICEPS_NS {
+
+class RowType;
+
+// The per-group state of AdditiveAggregatorType.
+class AdditiveAggregator : public Aggregator
+{
+public:
+	// @param type - type of this aggregator, used to size the state
+	AdditiveAggregator(const AdditiveAggregatorType *type);
+	~AdditiveAggregator();
+
+	// Update the state with a row added to the group.
+	// @param type - type of this aggregator
+	// @param rt - row type of the table
+	// @param row - the added row
+	// @param rh - handle of the added row, for the sliding window;
+	//        may be NULL if the state is kept without the rows
+	void addRow(const AdditiveAggregatorType *type, const RowType *rt, const Row *row,
+		const RowHandle *rh = NULL);
+
+	// Update the state with a row deleted from the group.
+	// @param type - type of this aggregator
+	// @param rt - row type of the table
+	// @param row - the deleted row
+	// @param rh - handle of the deleted row, for the sliding window;
+	//        may be NULL if the state is kept without the rows
+	void removeRow(const AdditiveAggregatorType *type, const RowType *rt, const Row *row,
+		const RowHandle *rh = NULL);
+
+	// Get the number of rows in the group, as seen by the state.
+	int64_t getRowCount() const
+	{
+		return rows_;
+	}
+
+	// Build the result row from the current state.
+	// If a min or max needs to be recomputed after the deletion
+	// of the extreme value, iterates through the index.
+	//
+	// @param type - type of this aggregator
+	// @param rt - row type of the table
+	// @param index - index of the group, for first, last and the recomputation;
+	//        may be NULL if there are no min, max and count_distinct (then
+	//        the quantile sketches never get rebuilt either)
+	// @param res - place to return the result
+	// @param sample - if index is NULL, the row of the group to take
+	//        the values of first and last from
+	void makeResult(const AdditiveAggregatorType *type, const RowType *rt, Index *index, Rowref &res,
+		const Row *sample = NULL);
+
+	// from Aggregator
+	virtual void handle(Table *table, AggregatorGadget *gadget, Index *index,
+		const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		AggOp aggop, Rowop::Opcode opcode, RowHandle *rh);
+	virtual void handleUpdate(Table *table, AggregatorGadget *gadget, Index *index,
+		const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		RowHandle *oldrh, RowHandle *newrh);
+
+protected:
+	// A numeric value, by the type of the argument.
+	union Value {
+		int64_t i_; // for all the integer types
+		double f_; // for float64
+	};
+
+	// An entry of the monotonic deque for min or max in a sliding window.
+	struct WinEntry {
+		Value val_;
+		const RowHandle *rh_; // the row of this value, only compared, never dereferenced
+	};
+	typedef deque<WinEntry> WinDeque;
+
+	// State of one result field.
+	struct Slot {
+		int64_t count_; // count of the non-null argument values
+		Value val_; // the sum or the extreme, depending on the function
+		bool dirty_; // for min and max: the extreme needs to be recomputed
+		// For min and max in a sliding window: the values that may still become
+		// the extreme, from the oldest to the newest; the front is the extreme.
+		// NULL if not in a window.
+		WinDeque *win_;
+		// For quantile: the sketch of the added values and of the deleted
+		// ones (created on the first deletion); NULL for the other functions.
+		QuantileSketch *sketch_;
+		QuantileSketch *delSketch_;
+		// For count_distinct: the sketch of the values; NULL for the other functions.
+		HyperLogLog *hll_;
+	};
+	typedef vector<Slot> SlotVec;
+
+	// Read a numeric value of a field.
+	// @param argType - type id of the field
+	// @return - false if the value is null
+	static bool readValue(const RowType *rt, const Row *row, int idx, int argType, Value &v);
+
+	// Check whether the value v is the same or better candidate for the
+	// extreme than the value in the slot.
+	static bool notWorse(const AdditiveAggregatorType::FieldDef &fd, const Value &v, const Value &than);
+
+	// Push a value to the back of the monotonic deque of a sliding window,
+	// and update the extreme in the slot.
+	static void pushWindow(const AdditiveAggregatorType::FieldDef &fd, Slot &sl, const Value &v, const RowHandle *rh);
+
+	// Recompute the extreme value by iterating through the group.
+	void recompute(const AdditiveAggregatorType *type, const RowType *rt, Index *index, int fidx);
+
+	// Rebuild the quantile or count_distinct sketch from the rows of the group.
+	void rebuildSketch(const AdditiveAggregatorType *type, const RowType *rt, Index *index, int fidx);
+
+	SlotVec slots_; // state per result field
+	int64_t rows_; // number of rows in the group
+	// In a sliding window: the oldest row of the group, only compared,
+	// never dereferenced; NULL if the group is empty.
+	const RowHandle *oldest_;
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_AdditiveAggregator_h__
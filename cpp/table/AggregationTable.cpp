@@ -0,0 +1,96 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A pseudo-table that keeps only the state of the additive aggregation.
+
+#include <table/AggregationTable.h>
+
+namespace TRICEPS_NS {
+
+////////////////////////////////////// AggregationTable ////////////////////////////////////
+
+AggregationTable::AggregationTable(Unit *unit, const string &name, RowType *rt,
+		Onceref<NameSet> key, Onceref<AdditiveAggregatorType> agg) :
+	Gadget(unit, Gadget::EM_CALL, name + ".out", rt),
+	name_(name),
+	keyed_("aggregation table", name, rt, key, agg), // does all the checking
+	inputLabel_(new InputLabel(unit, rt, name + ".in", this, "aggregation table")),
+	groups_(KeyedAdditiveGroups::KeyLess(&keyed_)),
+	size_(0)
+{
+	const AdditiveAggregatorType *aggType = keyed_.getAggregatorType();
+	aggLabel_ = new DummyLabel(unit, aggType->getRowType(), name + "." + aggType->getName());
+}
+
+AggregationTable::~AggregationTable()
+{
+	inputLabel_->resetTarget(); // prevent it from sending more data
+
+	KeyedAdditiveGroups::clearGroups(groups_);
+}
+
+void AggregationTable::sendResult(Group *g, Rowop::Opcode opcode)
+{
+	Rowref res;
+	keyed_.makeResult(g, res);
+	unit_->call(new Rowop(aggLabel_, opcode, res));
+}
+
+void AggregationTable::insertRow(const Row *row)
+{
+	Group *g;
+	GroupMap::iterator it = groups_.find(row);
+	if (it == groups_.end()) {
+		g = keyed_.makeGroup(row);
+		groups_[g->key_.get()] = g;
+	} else {
+		g = it->second;
+		if (aggLabel_->hasChained())
+			sendResult(g, Rowop::OP_DELETE);
+	}
+
+	keyed_.addRow(g, row);
+	++size_;
+
+	send(row, Rowop::OP_INSERT);
+	if (aggLabel_->hasChained())
+		sendResult(g, Rowop::OP_INSERT);
+}
+
+bool AggregationTable::deleteRow(const Row *row)
+{
+	GroupMap::iterator it = groups_.find(row);
+	if (it == groups_.end())
+		return false;
+
+	Group *g = it->second;
+	if (aggLabel_->hasChained())
+		sendResult(g, Rowop::OP_DELETE);
+
+	keyed_.removeRow(g, row);
+	--size_;
+
+	send(row, Rowop::OP_DELETE);
+	if (g->agg_.getRowCount() > 0) {
+		if (aggLabel_->hasChained())
+			sendResult(g, Rowop::OP_INSERT);
+	} else {
+		groups_.erase(it);
+		delete g;
+	}
+	return true;
+}
+
+bool AggregationTable::findResult(const Row *row, Rowref &res) const
+{
+	GroupMap::const_iterator it = groups_.find(row);
+	if (it == groups_.end())
+		return false;
+	keyed_.makeResult(it->second, res);
+	return true;
+}
+
+}; // TRICEPS_NS
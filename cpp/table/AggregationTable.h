@@ -0,0 +1,152 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A pseudo-table that keeps only the state of the additive aggregation.
+
+#ifndef __Triceps_AggregationTable_h__
+#define __Triceps_AggregationTable_h__
+
+#include <table/KeyedAdditiveGroups.h>
+#include <sched/Gadget.h>
+
+namespace TRICEPS_NS {
+
+// The AggregationTable is a table that keeps no rows, only the state of
+// an AdditiveAggregatorType per group. It's used when the rows exist only
+// to feed the aggregation: each row passes through, updates the state of its
+// group and gets discarded. The memory is then used only for one small
+// key row and the aggregator state per group.
+//
+// The output of the aggregator is the same as would be produced by a real table
+// of the type returned by getTableType(): a hashed index on the key fields,
+// with a FIFO index nested in it, and the aggregator on the FIFO index.
+// The inserts always add a row to the group, and the deletes remove
+// a row that is expected to have been inserted before. Since the rows
+// are not kept, the deletes can not be checked: a delete for a group that
+// doesn't exist gets ignored, but a delete of the row that was never
+// inserted into an existing group would just produce a wrong state.
+//
+// Without the rows only the functions that are computed from the state
+// are available: count_star, count, sum, avg, quantile (whose sketch of the
+// deleted values can't be rebuilt, so its accuracy decreases with the
+// deletions, see AdditiveAggregatorType). The functions first and last
+// are allowed only on the key fields, which are the same for the whole group.
+// The min, max and count_distinct are not allowed since they may need
+// to iterate through the group.
+//
+// The output label (as in a Table, getLabel() is inherited from Gadget)
+// passes through the incoming rows, with their original opcodes.
+// The aggregator results come on the aggregator label, in the same
+// order as from a Table: the deletion of the old result before the
+// change, then the row on the output label, then the insertion of the
+// new result.
+class AggregationTable : public Gadget
+{
+public:
+	// The constructor throws an Exception on errors.
+	//
+	// @param unit - the unit where the table belongs
+	// @param name - name of the table; the input label will be named
+	//        name.in, the output label name.out and the aggregator
+	//        label name.<aggregator name>
+	// @param rt - row type of the incoming rows
+	// @param key - names of the fields that define the group
+	// @param agg - the aggregator type, gets copied, so the original
+	//        may be reused
+	AggregationTable(Unit *unit, const string &name, RowType *rt,
+		Onceref<NameSet> key, Onceref<AdditiveAggregatorType> agg);
+	~AggregationTable();
+
+	// Get back the table name (the gadget name has ".out" added to it).
+	const string &getName() const
+	{
+		return name_;
+	}
+
+	// Get the type of the rows.
+	const RowType *getRowType() const
+	{
+		return keyed_.getRowType();
+	}
+
+	// Get the type of the real table that would produce the same
+	// aggregator output.
+	const TableType *getTableType() const
+	{
+		return keyed_.getTableType();
+	}
+
+	// Get the initialized aggregator type.
+	const AdditiveAggregatorType *getAggregatorType() const
+	{
+		return keyed_.getAggregatorType();
+	}
+
+	// Get the label for sending the rowops into the table.
+	// The opcodes are handled like in the Table, including OP_UPDATE.
+	Label *getInputLabel() const
+	{
+		return inputLabel_.get();
+	}
+
+	// Get the label with the results of the aggregator.
+	Label *getAggregatorLabel() const
+	{
+		return aggLabel_.get();
+	}
+
+	// Get the number of rows that the table would contain.
+	int64_t size() const
+	{
+		return size_;
+	}
+
+	// Get the number of groups.
+	size_t groupCount() const
+	{
+		return groups_.size();
+	}
+
+	// Add a row to its group.
+	// May throw an Exception.
+	// @param row - the row to insert
+	void insertRow(const Row *row);
+
+	// Remove a row from its group.
+	// May throw an Exception.
+	// @param row - the row to delete
+	// @return - true if the group has been found, false if not
+	bool deleteRow(const Row *row);
+
+	// Get the current aggregation result for a group.
+	// @param row - a row with the key fields of the group set
+	// @param res - place to return the result
+	// @return - true if the group has been found, false if not
+	bool findResult(const Row *row, Rowref &res) const;
+
+protected:
+	typedef KeyedAdditiveInputLabel<AggregationTable> InputLabel;
+	typedef KeyedAdditiveGroups::Group Group;
+	typedef KeyedAdditiveGroups::GroupMap GroupMap;
+
+	// Send the current result of a group.
+	void sendResult(Group *g, Rowop::Opcode opcode);
+
+	string name_;
+	KeyedAdditiveGroups keyed_; // the definition of the groups
+	Autoref<InputLabel> inputLabel_;
+	Autoref<Label> aggLabel_;
+	GroupMap groups_;
+	int64_t size_; // number of rows contributed to the groups
+
+private:
+	AggregationTable(const AggregationTable &);
+	void operator=(const AggregationTable &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_AggregationTable_h__
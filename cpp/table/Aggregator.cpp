@@ -16,6 +16,14 @@ namespace TRICEPS_NS {
 Aggregator::~Aggregator()
 { }
 
+void Aggregator::handleUpdate(Table *table, AggregatorGadget *gadget, Index *index,
+	const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+	RowHandle *oldrh, RowHandle *newrh)
+{
+	handle(table, gadget, index, parentIndexType, gh, dest, AO_AFTER_DELETE, Rowop::OP_NOP, oldrh);
+	handle(table, gadget, index, parentIndexType, gh, dest, AO_AFTER_INSERT, Rowop::OP_INSERT, newrh);
+}
+
 Valname aggOpCodes[] = {
 	{ Aggregator::AO_BEFORE_MOD, "AO_BEFORE_MOD" },
 	{ Aggregator::AO_AFTER_DELETE, "AO_AFTER_DELETE" },
@@ -73,6 +73,22 @@ public:
 	virtual void handle(Table *table, AggregatorGadget *gadget, Index *index,
 		const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
 		AggOp aggop, Rowop::Opcode opcode, RowHandle *rh) = 0;
+
+	// Handle a replacement of one row by another one within the same group
+	// in a single step, instead of two handle() calls. The table calls it
+	// only when exactly one row gets replaced and both rows belong to this group.
+	// The AO_BEFORE_MOD gets called before it as usual.
+	// The default implementation does the same as the unoptimized
+	// path: AO_AFTER_DELETE with OP_NOP for the old row, then AO_AFTER_INSERT
+	// with OP_INSERT for the new row. The additive aggregators may
+	// override it to update their state once.
+	//
+	// The arguments are the same as in handle(), except:
+	// @param oldrh - the row that has been removed, already not in the table
+	// @param newrh - the row that has been inserted
+	virtual void handleUpdate(Table *table, AggregatorGadget *gadget, Index *index,
+		const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		RowHandle *oldrh, RowHandle *newrh);
 };
 
 }; // TRICEPS_NS
@@ -0,0 +1,64 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The resumable dump of a table in small portions.
+
+#include <table/DumpCursor.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+DumpCursor::DumpCursor(Table *table, IndexType *ixt, Rowop::Opcode op) :
+	table_(table),
+	ixt_(ixt),
+	next_(table),
+	sent_(0),
+	op_(op)
+{
+	if (ixt_.isNull())
+		ixt_ = table->getType()->getFirstLeaf();
+	else if (ixt_->getTabtype() != table->getType())
+		throw Exception::fTrace("The index type for the dump cursor doesn't belong to the type of the table '%s'.",
+			table->getName().c_str());
+
+	next_ = table_->beginIdx(ixt_);
+	table_->cursors_.push_back(this);
+}
+
+DumpCursor::~DumpCursor()
+{
+	Table::CursorVec &cv = table_->cursors_;
+	for (Table::CursorVec::iterator it = cv.begin(); it != cv.end(); ++it) {
+		if (*it == this) {
+			cv.erase(it);
+			break;
+		}
+	}
+}
+
+void DumpCursor::rewind()
+{
+	next_ = table_->beginIdx(ixt_);
+	sent_ = 0;
+}
+
+size_t DumpCursor::step(size_t limit)
+{
+	Label *lb = table_->getDumpLabel();
+	Unit *unit = lb->getUnitPtr();
+	size_t n;
+	for (n = 0; n < limit && !next_.isNull(); n++) {
+		// Advance before sending, in case if the labels downstream
+		// modify the table. The row stays held by the rowop.
+		Autoref<Rowop> rop = new Rowop(lb, op_, next_->getRow());
+		next_ = table_->nextIdx(ixt_, next_.get());
+		sent_++;
+		unit->call(rop);
+	}
+	return n;
+}
+
+}; // TRICEPS_NS
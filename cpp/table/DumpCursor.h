@@ -0,0 +1,109 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The resumable dump of a table in small portions.
+
+#ifndef __Triceps_DumpCursor_h__
+#define __Triceps_DumpCursor_h__
+
+#include <mem/Rhref.h>
+
+namespace TRICEPS_NS {
+
+// A cursor that sends the contents of a table to its dump label
+// in portions, so that a large dump can be interleaved with the
+// other processing instead of blocking the unit for the duration
+// of Table::dumpAllIdx().
+//
+// The cursor remembers the next row handle to send. The table knows
+// all the cursors on it, and when it removes the row where a cursor
+// is positioned, it advances that cursor to the next row.
+// So the modifications done between the steps have the following
+// semantics:
+//   * Every row that stays in the table for the whole duration of the
+//     dump gets sent exactly once.
+//   * A row deleted before the cursor reached it doesn't get sent.
+//   * A row inserted ahead of the cursor position in the index order
+//     gets sent, and inserted behind it doesn't. In a FIFO index the
+//     new rows are always ahead, in a hashed index it's unpredictable.
+//   * A replacement is a delete followed by an insert, so the dump
+//     may contain both the old and the new version of a row (if the old
+//     one was sent before the replacement and the new one lands ahead).
+// These are the same guarantees as if the rowops of the modifications
+// were merged into the dump stream, and the downstream that keeps
+// the state by the key must apply them on top of the dump as usual.
+class DumpCursor : public Starget
+{
+public:
+	// @param table - table to dump
+	// @param ixt - index type that determines the order of the rows,
+	//        from this table's type; NULL means the first leaf index
+	// @param op - opcode to send the rows with
+	//
+	// Throws an Exception if the index type is from a different table type.
+	DumpCursor(Table *table, IndexType *ixt = NULL, Rowop::Opcode op = Rowop::OP_INSERT);
+	~DumpCursor();
+
+	// Send the next portion of the rows to the table's dump label.
+	// May throw an Exception.
+	// @param limit - the maximal number of the rows to send
+	// @return - the number of the rows sent, 0 when the dump is done
+	size_t step(size_t limit);
+
+	// Check whether all the rows have been sent.
+	bool isDone() const
+	{
+		return next_.isNull();
+	}
+
+	// Restart the dump from the beginning of the table.
+	void rewind();
+
+	// Get the total number of the rows sent since the start or rewind.
+	size_t getSent() const
+	{
+		return sent_;
+	}
+
+	Table *getTable() const
+	{
+		return table_;
+	}
+
+	IndexType *getIndexType() const
+	{
+		return ixt_;
+	}
+
+	Rowop::Opcode getOpcode() const
+	{
+		return op_;
+	}
+
+protected:
+	friend class Table;
+
+	// Called by the table before it removes a row handle.
+	void rowRemoved(RowHandle *rh)
+	{
+		if (next_.get() == rh)
+			next_ = table_->nextIdx(ixt_, rh);
+	}
+
+	Autoref<Table> table_;
+	Autoref<IndexType> ixt_;
+	Rhref next_; // the next row to send, NULL when done
+	size_t sent_; // count of rows sent
+	Rowop::Opcode op_;
+
+private:
+	DumpCursor(const DumpCursor &);
+	void operator=(const DumpCursor &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_DumpCursor_h__
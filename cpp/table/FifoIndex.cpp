@@ -186,6 +186,11 @@ void FifoIndex::aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const RhSet
 	// nothing to do
 }
 
+void FifoIndex::aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh)
+{ 
+	// nothing to do
+}
+
 bool FifoIndex::collapse(Tray *dest, const RhSet &replaced)
 {
 	return true;
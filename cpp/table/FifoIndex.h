@@ -42,6 +42,7 @@ public:
 	virtual void remove(RowHandle *rh);
 	virtual void aggregateBefore(Tray *dest, const RhSet &rows, const RhSet &already);
 	virtual void aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const RhSet &rows, const RhSet &future);
+	virtual void aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh);
 	virtual bool collapse(Tray *dest, const RhSet &replaced);
 	virtual Index *findNested(const RowHandle *what, int nestPos) const;
 
@@ -169,6 +169,16 @@ protected:
 	//        "remove" and "insert", and the notifications for inserts are done after remove)
 	virtual void aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const RhSet &rows, const RhSet &future) = 0;
 
+	// The replacement of exactly one row by another, as a shortcut for
+	// aggregateAfter(AO_AFTER_DELETE, {oldrh}, {newrh}) followed by
+	// aggregateAfter(AO_AFTER_INSERT, {newrh}, {}). When both rows end up
+	// in the same group, its aggregators get a single Aggregator::handleUpdate().
+	//
+	// @param dest - destination to send the delayed aggregation changes
+	// @param oldrh - the row that has been removed (but its groups not collapsed yet)
+	// @param newrh - the row that has been inserted
+	virtual void aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh) = 0;
+
 	// Collapse the groups identified by this RowHandle set recursively
 	// if they are found to be empty. "Collapsing" of a group means that the group
 	// that became empty gets removed from its parent index and deleted.
@@ -0,0 +1,75 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The Bloom filter in front of a hashed index instance.
+
+#include <table/IndexBloom.h>
+
+namespace TRICEPS_NS {
+
+//////////////////////////// IndexBloom /////////////////////////
+
+IndexBloom::IndexBloom(const HashedIndexType *type) :
+	type_(type),
+	filter_(type->getBloomCapacity(), type->getBloomFpRate()),
+	entries_(0),
+	stale_(0),
+	probes_(0),
+	rejects_(0),
+	falsePositives_(0),
+	rebuilds_(0)
+{ }
+
+void IndexBloom::clear()
+{
+	filter_.clear();
+	entries_ = 0;
+	stale_ = 0;
+}
+
+void IndexBloom::rebuild(const Set &data)
+{
+	++rebuilds_;
+
+	size_t n = data.size();
+	size_t capacity = filter_.getCapacity();
+	if (n >= capacity) {
+		// grow with some reserve
+		while (capacity <= n)
+			capacity *= 2;
+	} else {
+		// shrink back when the index goes down a lot, but not below the configured size
+		size_t confCapacity = type_->getBloomCapacity();
+		while (capacity > confCapacity && capacity / 4 > n)
+			capacity /= 2;
+		if (capacity < confCapacity)
+			capacity = confCapacity;
+	}
+
+	if (capacity != filter_.getCapacity())
+		filter_ = BloomFilter(capacity, filter_.getFpRate());
+	else
+		filter_.clear();
+
+	for (Set::const_iterator it = data.begin(); it != data.end(); ++it)
+		filter_.add(type_->getHash(*it));
+	entries_ = n;
+	stale_ = 0;
+}
+
+void IndexBloom::addStats(Stats &st) const
+{
+	st.instances_++;
+	st.bits_ += filter_.getBits();
+	st.entries_ += entries_;
+	st.stale_ += stale_;
+	st.probes_ += probes_;
+	st.rejects_ += rejects_;
+	st.falsePositives_ += falsePositives_;
+	st.rebuilds_ += rebuilds_;
+}
+
+}; // TRICEPS_NS
@@ -0,0 +1,107 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The Bloom filter in front of a hashed index instance.
+
+#ifndef __Triceps_IndexBloom_h__
+#define __Triceps_IndexBloom_h__
+
+#include <common/BloomFilter.h>
+#include <type/HashedIndexType.h>
+
+namespace TRICEPS_NS {
+
+// Lets the lookups of the keys that are not in the index get rejected
+// by checking one cache line, without walking the tree.
+// The filter can not remove the values, so it keeps the count of the
+// stale values and gets rebuilt from the index contents when they
+// become too many, or when the index outgrows the filter capacity.
+// Each index instance (i.e. each group of the parent index, for a
+// nested one) has its own filter.
+class IndexBloom
+{
+public:
+	typedef TreeIndexType::Set Set;
+
+	typedef HashedIndexType::BloomStats Stats;
+
+	// @param type - the index type, to get the configuration and the hashes of
+	//        the row handles
+	IndexBloom(const HashedIndexType *type);
+
+	// Check whether the key of a row might be present.
+	// @param rh - row handle with the hash section initialized
+	// @return - false if the key is definitely not in the index
+	bool mayContain(const RowHandle *rh) const
+	{
+		++probes_;
+		if (filter_.mayContain(type_->getHash(rh)))
+			return true;
+		++rejects_;
+		return false;
+	}
+
+	// Count a lookup that has passed the filter but found nothing.
+	void falsePositive() const
+	{
+		++falsePositives_;
+	}
+
+	// Add the key of a row that has just been inserted into the index data.
+	// @param rh - the inserted row or group handle
+	// @param data - the index data, already including rh
+	void added(const RowHandle *rh, const Set &data)
+	{
+		if (entries_ >= filter_.getCapacity())
+			rebuild(data);
+		else {
+			filter_.add(type_->getHash(rh));
+			++entries_;
+		}
+	}
+
+	// Account for a row that has just been removed from the index data.
+	// @param data - the index data, already without the removed row
+	void removed(const Set &data)
+	{
+		++stale_;
+		if (stale_ > MIN_STALE && stale_ > data.size())
+			rebuild(data);
+	}
+
+	// Forget everything, on the clearing of the index data.
+	void clear();
+
+	// Add the statistics of this filter.
+	// @param st - the stats to add to
+	void addStats(Stats &st) const;
+
+protected:
+	enum {
+		MIN_STALE = 64, // the rebuilding of the small filters is not worth it
+	};
+
+	// Rebuild the filter from the index data, resizing it if needed.
+	// @param data - the index data
+	void rebuild(const Set &data);
+
+	Autoref<const HashedIndexType> type_;
+	BloomFilter filter_;
+	size_t entries_; // the values added to the filter, including stale
+	size_t stale_; // the values of the removed rows
+	mutable size_t probes_;
+	mutable size_t rejects_;
+	mutable size_t falsePositives_;
+	size_t rebuilds_;
+
+private:
+	IndexBloom(const IndexBloom &);
+	void operator=(const IndexBloom &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_IndexBloom_h__
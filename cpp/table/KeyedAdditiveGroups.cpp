@@ -0,0 +1,104 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The common part of the gadgets that keep only the additive aggregation
+// state per key, without the rows.
+
+#include <string.h>
+#include <algorithm>
+#include <table/KeyedAdditiveGroups.h>
+#include <type/HashedIndexType.h>
+#include <type/FifoIndexType.h>
+
+namespace TRICEPS_NS {
+
+KeyedAdditiveGroups::KeyedAdditiveGroups(const char *kind, const string &name, RowType *rt,
+		Onceref<NameSet> key, Onceref<AdditiveAggregatorType> agg) :
+	rowType_(rt)
+{
+	// the equivalent table type does all the checking
+	Autoref<NameSet> keyref = key;
+	Autoref<AdditiveAggregatorType> aggref = agg;
+	tableType_ = TableType::make(rt)
+		->addSubIndex("key", HashedIndexType::make(keyref)
+			->addSubIndex("fifo", FifoIndexType::make()
+				->setAggregator(aggref)
+			)
+		);
+	tableType_->initialize();
+	if (!tableType_->getErrors().isNull())
+		throw Exception::fTrace(tableType_->getErrors(), "The %s '%s' has an incorrect definition:",
+			kind, name.c_str());
+
+	aggType_ = static_cast<const AdditiveAggregatorType *>(
+		tableType_->findSubIndex("key")->findSubIndex("fifo")->getAggregator());
+
+	for (NameSet::iterator it = keyref->begin(); it != keyref->end(); ++it)
+		keyIdx_.push_back(rt->findIdx(*it));
+
+	const AdditiveAggregatorType::FieldDefVec &fields = aggType_->getFields();
+	for (size_t i = 0; i < fields.size(); i++) {
+		const AdditiveAggregatorType::FieldDef &fd = fields[i];
+		switch (fd.func_) {
+		case AdditiveAggregatorType::FN_MIN:
+		case AdditiveAggregatorType::FN_MAX:
+		case AdditiveAggregatorType::FN_COUNT_DISTINCT:
+			throw Exception::fTrace("The %s '%s' can not compute the function '%s' in the result field '%s', it needs the rows.",
+				kind, name.c_str(), fd.funcName_.c_str(), fd.name_.c_str());
+		case AdditiveAggregatorType::FN_FIRST:
+		case AdditiveAggregatorType::FN_LAST:
+			if (find(keyIdx_.begin(), keyIdx_.end(), fd.argIdx_) == keyIdx_.end())
+				throw Exception::fTrace("The %s '%s' can compute the function '%s' in the result field '%s' only on a key field, '%s' is not.",
+					kind, name.c_str(), fd.funcName_.c_str(), fd.name_.c_str(), fd.arg_.c_str());
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+int KeyedAdditiveGroups::compareKeys(const Row *r1, const Row *r2) const
+{
+	for (vector<int>::const_iterator it = keyIdx_.begin(); it != keyIdx_.end(); ++it) {
+		const char *p1, *p2;
+		intptr_t len1, len2;
+		bool nn1 = rowType_->getField(r1, *it, p1, len1);
+		bool nn2 = rowType_->getField(r2, *it, p2, len2);
+		if (nn1 != nn2)
+			return nn1? 1 : -1; // the null goes first
+		if (!nn1)
+			continue;
+		if (len1 != len2)
+			return len1 < len2? -1 : 1;
+		int res = memcmp(p1, p2, len1);
+		if (res != 0)
+			return res;
+	}
+	return 0;
+}
+
+Row *KeyedAdditiveGroups::makeKeyRow(const Row *row) const
+{
+	FdataVec data(rowType_->fieldCount()); // the non-key fields stay null
+	for (vector<int>::const_iterator it = keyIdx_.begin(); it != keyIdx_.end(); ++it)
+		data[*it].setFrom(rowType_, row, *it);
+	return rowType_->makeRow(data);
+}
+
+void KeyedAdditiveGroups::makeResult(Group *g, Rowref &res) const
+{
+	res = Rowref(aggType_->getRowType());
+	g->agg_.makeResult(aggType_, rowType_, NULL, res, g->key_);
+}
+
+void KeyedAdditiveGroups::clearGroups(GroupMap &groups)
+{
+	for (GroupMap::iterator it = groups.begin(); it != groups.end(); ++it)
+		delete it->second;
+	groups.clear();
+}
+
+}; // TRICEPS_NS
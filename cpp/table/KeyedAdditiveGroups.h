@@ -0,0 +1,190 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The common part of the gadgets that keep only the additive aggregation
+// state per key, without the rows.
+
+#ifndef __Triceps_KeyedAdditiveGroups_h__
+#define __Triceps_KeyedAdditiveGroups_h__
+
+#include <map>
+#include <type/AdditiveAggregatorType.h>
+#include <type/TableType.h>
+#include <table/AdditiveAggregator.h>
+#include <sched/Label.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+// The definition of the groups by key with an AdditiveAggregator state in each,
+// shared by the AggregationTable and the WindowedAggregation. It checks the
+// aggregator against the equivalent table type (a hashed index on the key
+// fields, with a FIFO index nested in it, and the aggregator on the FIFO index),
+// and against the limitations of not having the rows: the functions min, max
+// and count_distinct are not allowed, first and last are allowed only on the
+// key fields. It also provides the ordering of the rows by the key fields,
+// for the maps of the groups.
+class KeyedAdditiveGroups
+{
+public:
+	// The constructor throws an Exception on errors.
+	//
+	// @param kind - the kind of the owner gadget, for the error messages
+	//        (such as "aggregation table")
+	// @param name - name of the owner gadget, for the error messages
+	// @param rt - row type of the incoming rows
+	// @param key - names of the fields that define the group
+	// @param agg - the aggregator type, gets copied, so the original
+	//        may be reused
+	KeyedAdditiveGroups(const char *kind, const string &name, RowType *rt,
+		Onceref<NameSet> key, Onceref<AdditiveAggregatorType> agg);
+
+	// The state of one group.
+	class Group
+	{
+	public:
+		Group(const AdditiveAggregatorType *type, const RowType *rt, Row *key) :
+			key_(rt, key),
+			agg_(type)
+		{ }
+
+		Rowref key_; // the row with only the key fields set
+		AdditiveAggregator agg_;
+	};
+
+	// Compares the rows by the key fields.
+	class KeyLess
+	{
+	public:
+		KeyLess(const KeyedAdditiveGroups *kg) :
+			kg_(kg)
+		{ }
+
+		bool operator() (const Row *r1, const Row *r2) const
+		{
+			return kg_->compareKeys(r1, r2) < 0;
+		}
+
+	protected:
+		const KeyedAdditiveGroups *kg_;
+	};
+
+	typedef map<const Row *, Group *, KeyLess> GroupMap;
+
+	// Get the type of the rows.
+	const RowType *getRowType() const
+	{
+		return rowType_;
+	}
+
+	// Get the type of the real table that would produce the same
+	// aggregator output.
+	TableType *getTableType() const
+	{
+		return tableType_;
+	}
+
+	// Get the initialized aggregator type.
+	const AdditiveAggregatorType *getAggregatorType() const
+	{
+		return aggType_;
+	}
+
+	// Get the indexes of the key fields.
+	const vector<int> &getKeyIdx() const
+	{
+		return keyIdx_;
+	}
+
+	// Compare the key fields of two rows.
+	// @return - <0, 0 or >0, like strcmp()
+	int compareKeys(const Row *r1, const Row *r2) const;
+
+	// Make a row that contains only the key fields.
+	Row *makeKeyRow(const Row *row) const;
+
+	// Make a new group for the key of a row.
+	Group *makeGroup(const Row *row) const
+	{
+		return new Group(aggType_, rowType_, makeKeyRow(row));
+	}
+
+	// Add a row to a group.
+	void addRow(Group *g, const Row *row) const
+	{
+		g->agg_.addRow(aggType_, rowType_, row);
+	}
+
+	// Remove a row from a group.
+	void removeRow(Group *g, const Row *row) const
+	{
+		g->agg_.removeRow(aggType_, rowType_, row);
+	}
+
+	// Build the current result of a group.
+	// @param g - the group
+	// @param res - place to return the result
+	void makeResult(Group *g, Rowref &res) const;
+
+	// Delete all the groups in a map, leaving it empty.
+	static void clearGroups(GroupMap &groups);
+
+protected:
+	const_Autoref<RowType> rowType_;
+	Autoref<TableType> tableType_;
+	const_Autoref<AdditiveAggregatorType> aggType_;
+	vector<int> keyIdx_; // indexes of the key fields
+
+private:
+	KeyedAdditiveGroups(const KeyedAdditiveGroups &);
+	void operator=(const KeyedAdditiveGroups &);
+};
+
+// The input label of a gadget with the keyed additive groups, that
+// translates the opcodes into the calls of the gadget's insertRow() and
+// deleteRow(), handling OP_UPDATE like a Table does.
+template <class Target>
+class KeyedAdditiveInputLabel : public Label
+{
+public:
+	// @param kind - the kind of the target gadget, for the error messages
+	KeyedAdditiveInputLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name,
+			Target *target, const char *kind) :
+		Label(unit, rtype, name),
+		target_(target),
+		kind_(kind)
+	{ }
+
+	// when the target gets destroyed, it resets this back-link
+	void resetTarget()
+	{
+		target_ = NULL;
+	}
+
+protected:
+	// from Label
+	virtual void execute(Rowop *arg) const
+	{
+		if (target_ == NULL)
+			throw Exception::f("Can not send more input to a destroyed %s", kind_);
+
+		if (arg->getOpcode() == Rowop::OP_UPDATE && arg->getOldRow() != NULL) {
+			target_->deleteRow(arg->getOldRow());
+			target_->insertRow(arg->getRow());
+		} else if (arg->isInsert()) {
+			target_->insertRow(arg->getRow());
+		} else if (arg->isDelete()) {
+			target_->deleteRow(arg->getRow());
+		}
+	}
+
+	Target *target_;
+	const char *kind_;
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_KeyedAdditiveGroups_h__
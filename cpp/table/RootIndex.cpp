@@ -114,6 +114,11 @@ void RootIndex::aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const RhSet
 	type_->groupAggregateAfter(dest, aggop, table_, rootg_, rows, future);
 }
 
+void RootIndex::aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh)
+{
+	type_->groupAggregateUpdate(dest, table_, rootg_, oldrh, newrh);
+}
+
 size_t RootIndex::size() const
 {
 	return type_->groupSize(rootg_);
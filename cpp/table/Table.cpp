@@ -7,6 +7,7 @@
 // The table implementation.
 
 #include <table/Table.h>
+#include <table/DumpCursor.h>
 #include <type/TableType.h>
 #include <type/AggregatorType.h>
 #include <type/RootIndexType.h>
@@ -14,6 +15,8 @@
 #include <mem/Rhref.h>
 #include <common/Exception.h>
 #include <common/BusyMark.h>
+#include <string.h>
+#include <new>
 
 namespace TRICEPS_NS {
 
@@ -29,11 +32,40 @@ void Table::InputLabel::execute(Rowop *arg) const
 	if (table_ == NULL)
 		throw Exception::f("Can not send more input to a destroyed table");
 
-	if (arg->isInsert()) {
-		table_->insertRow(arg->getRow()); // ignore the failures
-	} else if (arg->isDelete()) {
-		table_->deleteRow(arg->getRow());
-	}
+	table_->applyRow(arg->getOpcode(), arg->getRow(), arg->getOldRow());
+}
+
+////////////////////////////////////// Table::FlushLabel ////////////////////////////////////
+
+Table::FlushLabel::FlushLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name, Table *table) :
+	Label(unit, rtype, name),
+	table_(table)
+{ }
+
+void Table::FlushLabel::execute(Rowop *arg) const
+{
+	if (table_ == NULL)
+		return; // the table is gone along with its held results
+
+	table_->flushScheduled_ = false;
+	table_->flushAggregators();
+}
+
+////////////////////////////////////// Table::CoalescedGroup ////////////////////////////////////
+
+Table::CoalescedGroup::CoalescedGroup(const IndexType *ixt, GroupHandle *gh) :
+	ixt_(ixt),
+	gh_(gh),
+	old_(ixt->groupAggs_.size()),
+	new_(ixt->groupAggs_.size())
+{
+	gh_->incref();
+}
+
+Table::CoalescedGroup::~CoalescedGroup()
+{
+	if (gh_->decref() <= 0)
+		ixt_->destroyGroupHandle(gh_);
 }
 
 ////////////////////////////////////// Table ////////////////////////////////////
@@ -49,7 +81,13 @@ Table::Table(Unit *unit, const string &name,
 	preLabel_(new DummyLabel(unit, rowt, name + ".pre")),
 	dumpLabel_(new DummyLabel(unit, rowt, name + ".dump")),
 	name_(name),
-	busy_(false)
+	busy_(false),
+	identicalReplace_(IR_REPLACE),
+	sendUpdates_(false),
+	quiet_(false),
+	orderedLoad_(false),
+	coalesce_(AC_NONE),
+	flushScheduled_(false)
 { 
 	root_ = static_cast<RootIndex *>(tt->root_->makeIndex(tt, this));
 	// fprintf(stderr, "DEBUG Table::Table root=%p\n", root_.get());
@@ -66,6 +104,11 @@ Table::~Table()
 	// fprintf(stderr, "DEBUG Table::~Table root=%p\n", root_.get());
 
 	inputLabel_->resetTable(); // prevent it from sending more data
+	if (!flushLabel_.isNull())
+		flushLabel_->resetTable();
+	// the held groups that are still in the indexes stay there,
+	// the collapsed ones get destroyed
+	dropCoalesced();
 
 	// remove all the rows in the table: this goes more efficiently
 	// if we first move them to a vector, clear the indexes and delete from vector;
@@ -120,6 +163,107 @@ FnReturn *Table::fnReturn() const
 	return fnReturn_;
 }
 
+void Table::setAggregatorCoalesce(AggregatorCoalesce mode)
+{
+	if (mode == AC_NONE)
+		flushAggregators(); // may throw
+	else if (discardTray_.isNull())
+		discardTray_ = new Tray;
+
+	if (mode == AC_DRAIN && flushLabel_.isNull()) {
+		RowType *ert = unit_->getEmptyRowType();
+		FdataVec fields;
+		flushRow_ = Rowref(ert, ert->makeRow(fields));
+		flushLabel_ = new FlushLabel(unit_, ert, name_ + ".aggFlush", this);
+	}
+	coalesce_ = mode;
+}
+
+void Table::flushAggregators()
+{
+	if (coalesced_.empty())
+		return;
+
+	if (busy_)
+		throw Exception::fTrace("Detected a flush of the aggregators in the middle of a modification of the table '%s'.",
+			getName().c_str());
+
+	CoalesceVec groups;
+	groups.swap(coalesced_);
+	coalescedMap_.clear();
+
+	Autoref<Tray> tray = new Tray;
+	for (CoalesceVec::iterator it = groups.begin(); it != groups.end(); ++it) {
+		CoalescedGroup *cg = *it;
+		size_t n = cg->old_.size();
+		for (size_t i = 0; i < n; i++) {
+			Tray *oldt = cg->old_[i];
+			Tray *newt = cg->new_[i];
+			if (oldt != NULL && newt != NULL && oldt->size() == 1 && newt->size() == 1) {
+				// skip the results that haven't changed
+				Rowop *oldop = oldt->front();
+				Rowop *newop = newt->front();
+				if (oldop->isDelete() && newop->isInsert() && oldop->getLabel() == newop->getLabel()
+				&& oldop->getLabel()->getType()->equalRows(oldop->getRow(), newop->getRow()))
+					continue;
+			}
+			if (oldt != NULL)
+				tray->insert(tray->end(), oldt->begin(), oldt->end());
+			if (newt != NULL)
+				tray->insert(tray->end(), newt->begin(), newt->end());
+		}
+		delete cg;
+	}
+
+	unit_->enqueueDelayedTray(tray); // may throw
+}
+
+void Table::dropCoalesced()
+{
+	for (CoalesceVec::iterator it = coalesced_.begin(); it != coalesced_.end(); ++it)
+		delete *it;
+	coalesced_.clear();
+	coalescedMap_.clear();
+}
+
+Tray *Table::coalesceDest(const IndexType *ixt, GroupHandle *gh, int aggn, CoalescePhase phase)
+{
+	discardTray_->clear();
+	if (quiet_)
+		return discardTray_;
+
+	CoalescedGroup *cg;
+	CoalesceMap::iterator it = coalescedMap_.find(gh);
+	if (it == coalescedMap_.end()) {
+		cg = new CoalescedGroup(ixt, gh);
+		coalescedMap_[gh] = cg;
+		coalesced_.push_back(cg);
+		if (coalesce_ == AC_DRAIN && !flushScheduled_) {
+			unit_->schedule(new Rowop(flushLabel_, Rowop::OP_INSERT, flushRow_));
+			flushScheduled_ = true;
+		}
+	} else {
+		cg = it->second;
+	}
+
+	Autoref<Tray> &oldt = cg->old_[aggn];
+	if (phase == CP_BEFORE) {
+		if (!oldt.isNull())
+			return discardTray_; // the old result is already known
+		oldt = new Tray;
+		return oldt;
+	} else {
+		if (oldt.isNull())
+			oldt = new Tray; // a new group had no result before
+		Autoref<Tray> &newt = cg->new_[aggn];
+		if (newt.isNull())
+			newt = new Tray;
+		else
+			newt->clear(); // the previous result gets replaced
+		return newt;
+	}
+}
+
 RowHandle *Table::makeRowHandle(const Row *row) const
 {
 	if (row == NULL)
@@ -189,31 +333,58 @@ bool Table::insert(RowHandle *newrh)
 			return false;
 		}
 
+		if (identicalReplace_ != IR_REPLACE && replace.size() == 1
+		&& rowType_->equalRows((*replace.begin())->getRow(), newrh->getRow())) {
+			// The identical row has the same groups as the old one,
+			// so there is nothing to collapse, just leave the old row in place.
+			if (identicalReplace_ == IR_NOP && !quiet_)
+				send(newrh->getRow(), Rowop::OP_NOP); // may throw
+			checkStickyErrorAfter(); // same as at the normal exit
+			return true;
+		}
+
 		if (!noAggs) {
 			changed.insert(newrh); // OK to add, since the iterators in newrh got populated by replacementPolicy()
 			root_->aggregateBefore(aggTray, replace, emptyRhSet);
 			root_->aggregateBefore(aggTray, changed, replace);
 			// Aggregator "before" changes go before table changes. If there are multiple aggregators,
 			// between themselves they go sort of in parallel.
-			unit_->enqueueDelayedTray(aggTray); // may throw
+			if (!quiet_)
+				unit_->enqueueDelayedTray(aggTray); // may throw
 			aggTray->clear();
 		}
 
+		// with a single replaced row, optionally send it as an update
+		RowHandle *updrh = NULL;
+		if (sendUpdates_ && replace.size() == 1)
+			updrh = *replace.begin();
+
+		snapshot_ = NULL; // the contents are about to change
+
 		// delete the rows that are pushed out but don't collapse the groups yet
 		for (Index::RhSet::iterator rsit = replace.begin(); rsit != replace.end(); ++rsit) {
 			RowHandle *rh = *rsit;
-			if (preLabel_->hasChained()) {
+			if (updrh == NULL && !quiet_ && preLabel_->hasChained()) {
 				Autoref<Rowop> rop = new Rowop(preLabel_, Rowop::OP_DELETE, rh->getRow());
 				unit_->call(rop); // may throw
 			}
+			if (!cursors_.empty())
+				advanceCursors(rh);
 			root_->remove(rh);
+			if (!versions_.isNull())
+				versions_->removed(rh);
 			rh->flags_ &= ~RowHandle::F_INTABLE;
 			deref.push_back(rh);
-			send(rh->getRow(), Rowop::OP_DELETE); // may throw
+			if (updrh == NULL && !quiet_)
+				send(rh->getRow(), Rowop::OP_DELETE); // may throw
 		}
 
-		if (preLabel_->hasChained()) {
-			Autoref<Rowop> rop = new Rowop(preLabel_, Rowop::OP_INSERT, newrh->getRow());
+		if (!quiet_ && preLabel_->hasChained()) {
+			Autoref<Rowop> rop;
+			if (updrh == NULL)
+				rop = new Rowop(preLabel_, Rowop::OP_INSERT, newrh->getRow());
+			else
+				rop = Rowop::makeUpdate(preLabel_, newrh->getRow(), updrh->getRow());
 			unit_->call(rop); // may throw
 		}
 		
@@ -222,14 +393,26 @@ bool Table::insert(RowHandle *newrh)
 		newrh->flags_ |= RowHandle::F_INTABLE;
 
 		root_->insert(newrh);
-		send(newrh->getRow(), Rowop::OP_INSERT); // may throw
+		if (!versions_.isNull())
+			versions_->inserted(newrh);
+		if (!quiet_) {
+			if (updrh == NULL)
+				send(newrh->getRow(), Rowop::OP_INSERT); // may throw
+			else
+				sendUpdate(newrh->getRow(), updrh->getRow()); // may throw
+		}
 
 		if (!noAggs) {
-			root_->aggregateAfter(aggTray, Aggregator::AO_AFTER_DELETE, replace, changed);
-			root_->aggregateAfter(aggTray, Aggregator::AO_AFTER_INSERT, changed, emptyRhSet);
+			if (updrh == NULL) {
+				root_->aggregateAfter(aggTray, Aggregator::AO_AFTER_DELETE, replace, changed);
+				root_->aggregateAfter(aggTray, Aggregator::AO_AFTER_INSERT, changed, emptyRhSet);
+			} else {
+				root_->aggregateUpdate(aggTray, updrh, newrh);
+			}
 			// Aggregator "after" changes go after table changes. If there are multiople aggregators,
 			// between themselves they go sort of in parallel.
-			unit_->enqueueDelayedTray(aggTray); // may throw
+			if (!quiet_)
+				unit_->enqueueDelayedTray(aggTray); // may throw
 			aggTray->clear();
 		}
 
@@ -238,7 +421,8 @@ bool Table::insert(RowHandle *newrh)
 
 		if (!noAggs && !aggTray->empty()) {
 			// The aggregators may have produced more output on collapse.
-			unit_->enqueueDelayedTray(aggTray); // may throw
+			if (!quiet_)
+				unit_->enqueueDelayedTray(aggTray); // may throw
 			aggTray->clear();
 		}
 
@@ -290,26 +474,34 @@ void Table::remove(RowHandle *rh)
 			root_->aggregateBefore(aggTray, replace, emptyRhSet);
 			// Aggregator "before" changes go before table changes. If there are multiople aggregators,
 			// between themselves they go sort of in parallel.
-			unit_->enqueueDelayedTray(aggTray); // may throw
+			if (!quiet_)
+				unit_->enqueueDelayedTray(aggTray); // may throw
 			aggTray->clear();
 		}
 
-		if (preLabel_->hasChained()) {
+		if (!quiet_ && preLabel_->hasChained()) {
 			Autoref<Rowop> rop = new Rowop(preLabel_, Rowop::OP_DELETE, rh->getRow());
 			unit_->call(rop); // may throw
 		}
 
+		snapshot_ = NULL; // the contents are about to change
+		if (!cursors_.empty())
+			advanceCursors(rh);
 		root_->remove(rh);
+		if (!versions_.isNull())
+			versions_->removed(rh);
 		rh->flags_ &= ~RowHandle::F_INTABLE;
 		rhdec = rh;
 
-		send(rh->getRow(), Rowop::OP_DELETE); // may throw
+		if (!quiet_)
+			send(rh->getRow(), Rowop::OP_DELETE); // may throw
 
 		if (!noAggs) {
 			root_->aggregateAfter(aggTray, Aggregator::AO_AFTER_DELETE, replace, emptyRhSet);
 			// Aggregator "after" changes go after table changes. If there are multiple aggregators,
 			// between themselves they go sort of in parallel.
-			unit_->enqueueDelayedTray(aggTray); // may throw
+			if (!quiet_)
+				unit_->enqueueDelayedTray(aggTray); // may throw
 			aggTray->clear();
 		}
 
@@ -317,7 +509,8 @@ void Table::remove(RowHandle *rh)
 		
 		if (!noAggs && !aggTray->empty()) {
 			// The aggregators may have produced more output on collapse.
-			unit_->enqueueDelayedTray(aggTray); // may throw
+			if (!quiet_)
+				unit_->enqueueDelayedTray(aggTray); // may throw
 			aggTray->clear();
 		}
 
@@ -337,8 +530,7 @@ void Table::remove(RowHandle *rh)
 
 bool Table::deleteRow(const Row *row)
 {
-	Rhref what(this, makeRowHandle(row));
-	RowHandle *rh = find(what);
+	RowHandle *rh = findRow(row);
 	if (rh != NULL) {
 		remove(rh); // may throw
 		return true;
@@ -346,6 +538,22 @@ bool Table::deleteRow(const Row *row)
 	return false;
 }
 
+void Table::applyRow(Rowop::Opcode op, const Row *row, const Row *oldRow)
+{
+	if (Rowop::isUpdate(op) && oldRow != NULL) {
+		// The new row replaces the old one by itself if the key is the same,
+		// otherwise the old row has to be deleted explicitly.
+		Rhref oldrh(this, findRow(oldRow));
+		insertRow(row); // ignore the failures
+		if (!oldrh.isNull() && oldrh->isInTable())
+			remove(oldrh.get());
+	} else if (Rowop::isInsert(op)) {
+		insertRow(row); // ignore the failures
+	} else if (Rowop::isDelete(op)) {
+		deleteRow(row);
+	}
+}
+
 RowHandle *Table::begin() const
 {
 	checkStickyError();
@@ -427,25 +635,26 @@ RowHandle *Table::findIdx(IndexType *ixt, const RowHandle *what) const
 
 RowHandle *Table::findRowIdx(IndexType *ixt, const Row *row) const
 {
-	if (row == NULL)
-		return NULL;
+	Probe probe(this, ixt);
+	return probe.find(row);
+}
 
-	RowHandle *rh = makeRowHandle(row);
-	rh->incref();
+void Table::findBatchIdx(IndexType *ixt, const vector<const Row *> &rows, vector<RowHandle *> &results) const
+{
+	checkStickyError();
 
-	RowHandle *res;
+	size_t n = rows.size();
+	results.assign(n, NULL);
 
-	try {
-		res = findIdx(ixt, rh);
-	} catch (Exception e) {
-		if (rh->decref() <= 0)
-			destroyRowHandle(rh);
-		throw;
-	}
+	if (n == 0 || ixt == NULL || ixt->getTabtype() != type_)
+		return;
 
-	if (rh->decref() <= 0)
-		destroyRowHandle(rh);
-	return res;
+	Probe probe(this, ixt);
+	for (size_t i = 0; i < n; i++) {
+		if (i + 1 < n && rows[i + 1] != NULL)
+			__builtin_prefetch(rows[i + 1]);
+		results[i] = probe.find(rows[i]); // may throw
+	}
 }
 
 size_t Table::groupSizeIdx(IndexType *ixt, const RowHandle *what) const
@@ -460,26 +669,8 @@ size_t Table::groupSizeIdx(IndexType *ixt, const RowHandle *what) const
 
 size_t Table::groupSizeRowIdx(IndexType *ixt, const Row *row) const
 {
-	if (row == NULL)
-		return 0;
-
-	RowHandle *rh = makeRowHandle(row);
-	rh->incref();
-
-	size_t res ;
-
-	try {
-		res = groupSizeIdx(ixt, rh);
-	} catch (Exception e) {
-		if (rh->decref() <= 0)
-			destroyRowHandle(rh);
-		throw;
-	}
-
-	if (rh->decref() <= 0)
-		destroyRowHandle(rh);
-
-	return res;
+	Probe probe(this, ixt);
+	return probe.groupSize(row);
 }
 
 void Table::clear(size_t limit)
@@ -506,6 +697,109 @@ void Table::dumpAllIdx(IndexType *ixt, Rowop::Opcode op) const
 		unit_->call(new Rowop(dumpLabel_, op, rh->getRow()));
 }
 
+void Table::advanceCursors(RowHandle *rh)
+{
+	for (CursorVec::iterator it = cursors_.begin(); it != cursors_.end(); ++it)
+		(*it)->rowRemoved(rh);
+}
+
+void Table::enableSnapshots() const
+{
+	if (!versions_.isNull())
+		return;
+
+	versions_ = new TableVersions(rowType_, type_->getVersionsOffset());
+	for (RowHandle *rh = begin(); rh != NULL; rh = next(rh))
+		versions_->inserted(rh);
+}
+
+Onceref<TableSnapshot> Table::snapshot() const
+{
+	checkStickyError();
+
+	if (!snapshot_.isNull())
+		return snapshot_;
+
+	enableSnapshots();
+	snapshot_ = versions_->makeSnapshot(getName());
+	return snapshot_;
+}
+
+////////////////////////////////////// Table::Probe ////////////////////////////////////
+
+Table::Probe::Probe(const Table *table, IndexType *ixt) :
+	table_(table),
+	ixt_(NULL),
+	rh_(NULL),
+	isSet_(false),
+	inline_(false)
+{
+	if (ixt == NULL || ixt->getTabtype() != table->type_)
+		return;
+	ixt_ = ixt;
+
+	intptr_t size = table->rhType_->getSize();
+	if (size <= (intptr_t)sizeof(buf_) - (intptr_t)sizeof(RowHandle)) {
+		memset(buf_, 0, sizeof(buf_)); // same as the normal allocation does
+		rh_ = ::new(buf_) RowHandle(NULL);
+		inline_ = true;
+	} else {
+		rh_ = table->rhType_->makeHandle(NULL);
+	}
+}
+
+Table::Probe::~Probe()
+{
+	reset();
+	if (rh_ != NULL) {
+		if (inline_)
+			rh_->~RowHandle();
+		else
+			delete rh_;
+	}
+}
+
+RowHandle *Table::Probe::set(const Row *row)
+{
+	reset();
+	if (row == NULL || rh_ == NULL)
+		return NULL;
+
+	rh_->row_ = row;
+	ixt_->initPathRowHandle(rh_);
+	isSet_ = true;
+	return rh_;
+}
+
+void Table::Probe::reset()
+{
+	if (isSet_) {
+		ixt_->clearPathRowHandle(rh_);
+		rh_->row_ = NULL;
+		isSet_ = false;
+	}
+}
+
+RowHandle *Table::Probe::find(const Row *row)
+{
+	if (row == NULL)
+		return NULL;
+
+	RowHandle *res = table_->findIdx(ixt_, set(row)); // may throw
+	reset();
+	return res;
+}
+
+size_t Table::Probe::groupSize(const Row *row)
+{
+	if (row == NULL)
+		return 0;
+
+	size_t res = table_->groupSizeIdx(ixt_, set(row)); // may throw
+	reset();
+	return res;
+}
+
 void Table::setStickyError(Erref err)
 {
 	if (stickyErr_.isNull())
@@ -9,8 +9,10 @@
 #ifndef __Triceps_Table_h__
 #define __Triceps_Table_h__
 
+#include <map>
 #include <type/TableType.h>
 #include <table/RootIndex.h>
+#include <table/TableSnapshot.h>
 #include <sched/AggregatorGadget.h>
 #include <sched/FnReturn.h>
 
@@ -20,6 +22,7 @@ class RowType;
 class RowHandleType;
 class TableType;
 class Row;
+class DumpCursor;
 
 class Table : public Gadget
 {
@@ -96,7 +99,181 @@ public:
 	// If something goes very wrong (pretty much the only reason for it is if
 	// you name an aggregator "pre" or "out" or such), it may throw an Exception.
 	FnReturn *fnReturn() const;
-	
+
+	// What to do when an inserted row replaces a row with the
+	// exactly same contents (as found by RowType::equalRows()).
+	// Such no-op replacements are common with the feeds that keep
+	// re-sending the unchanged data.
+	enum IdenticalReplace {
+		IR_REPLACE, // do the replacement as usual, the default
+		IR_SKIP, // leave the old row in place, send nothing and skip the aggregators
+		IR_NOP, // same as IR_SKIP but send the row with OP_NOP on the output label
+	};
+
+	// Set the handling of the identical replacements.
+	// Note that with IR_SKIP and IR_NOP the position of the row in
+	// a FIFO index doesn't get updated, and an identical row pushed out
+	// by a FIFO limit counts as an identical replacement too.
+	// @param mode - the handling mode
+	void setIdenticalReplace(IdenticalReplace mode)
+	{
+		identicalReplace_ = mode;
+	}
+
+	// Get back the handling of the identical replacements.
+	IdenticalReplace getIdenticalReplace() const
+	{
+		return identicalReplace_;
+	}
+
+	// Set the sending of the replacements as updates. When enabled,
+	// an insert that replaces exactly one old row produces a single
+	// OP_UPDATE (carrying both the new and old row) on the "pre" and output
+	// labels instead of an OP_DELETE followed by an OP_INSERT, and the
+	// aggregators get it as one Aggregator::handleUpdate() call when
+	// both rows are in the same group. The replacements of multiple rows
+	// are still sent as the separate deletes and inserts.
+	// The labels that don't understand the updates can be connected
+	// through an UpdateSplitLabel.
+	// @param on - true to send the updates, false (the default) for
+	//        the deletes and inserts
+	void setSendUpdates(bool on)
+	{
+		sendUpdates_ = on;
+	}
+
+	// Check whether the replacements are sent as updates.
+	bool getSendUpdates() const
+	{
+		return sendUpdates_;
+	}
+
+	// Set the quiet mode, used for the bulk loading of the saved state.
+	// In the quiet mode the modifications send nothing to the "pre" and "out"
+	// labels, and the output of the aggregators gets discarded (but they
+	// still get called, so their state stays consistent). The labels
+	// downstream are expected to get their state restored separately,
+	// or to be resynchronized with dumpAll() after the load.
+	// @param on - true to enable the quiet mode
+	void setQuiet(bool on)
+	{
+		quiet_ = on;
+	}
+
+	// Check whether the table is in the quiet mode.
+	bool isQuiet() const
+	{
+		return quiet_;
+	}
+
+	// Sets the quiet mode for the duration of a scope and restores
+	// the previous setting on the scope exit, including by an Exception.
+	class QuietMark
+	{
+	public:
+		QuietMark(Table *table) :
+			table_(table),
+			was_(table->isQuiet())
+		{
+			table_->setQuiet(true);
+		}
+		~QuietMark()
+		{
+			table_->setQuiet(was_);
+		}
+
+	protected:
+		Table *table_;
+		bool was_;
+	};
+
+	// Set the ordered load mode, used by the TableDump when it loads
+	// the rows that have been dumped in the order of an index. In this mode
+	// the tree indexes check first whether a row goes past their end,
+	// making the insertion of the rows in their order cheap, at the cost
+	// of an extra comparison for the rows that come out of order. So it
+	// should not be enabled for the normal modifications.
+	// @param on - true to enable the ordered load mode
+	void setOrderedLoad(bool on)
+	{
+		orderedLoad_ = on;
+	}
+
+	// Check whether the table is in the ordered load mode.
+	bool isOrderedLoad() const
+	{
+		return orderedLoad_;
+	}
+
+	// Sets the ordered load mode for the duration of a scope and restores
+	// the previous setting on the scope exit, including by an Exception.
+	class OrderedLoadMark
+	{
+	public:
+		OrderedLoadMark(Table *table) :
+			table_(table),
+			was_(table->isOrderedLoad())
+		{
+			table_->setOrderedLoad(true);
+		}
+		~OrderedLoadMark()
+		{
+			table_->setOrderedLoad(was_);
+		}
+
+	protected:
+		Table *table_;
+		bool was_;
+	};
+
+	// The coalescing of the aggregator results. When a burst of
+	// modifications (such as from one tray) changes the same group many
+	// times, normally every change sends a DELETE of the previous result
+	// and an INSERT of the new one. With the coalescing, the table
+	// remembers for each modified group the result it had before
+	// the first change (the one that was sent out last) and the
+	// result after the last change, and sends only these two when
+	// the results get flushed. If the group has been created and
+	// destroyed between the flushes, nothing gets sent for it. If its
+	// result ends up the same as before, nothing gets sent either.
+	//
+	// The aggregators are still called on every change as usual,
+	// only their output is held and the intermediate results are
+	// thrown away.
+	enum AggregatorCoalesce {
+		AC_NONE, // send every result right away, the default
+		AC_FLUSH, // hold the results until flushAggregators()
+		AC_DRAIN, // like AC_FLUSH, plus on the first held result schedule
+			// a flush at the end of the outermost unit frame, so that
+			// it happens when the unit drains the rowops queued
+			// before it
+	};
+
+	// Set the coalescing of the aggregator results. Switching to
+	// AC_NONE flushes the results that are held.
+	// May throw an Exception.
+	// @param mode - the coalescing mode
+	void setAggregatorCoalesce(AggregatorCoalesce mode);
+
+	// Get back the coalescing mode.
+	AggregatorCoalesce getAggregatorCoalesce() const
+	{
+		return coalesce_;
+	}
+
+	// Send the held aggregator results: for each modified group the
+	// DELETE of the old result and the INSERT of the new one, in the
+	// order in which the groups got first modified. They get enqueued
+	// in the same way as the aggregator results are normally sent.
+	// May throw an Exception.
+	void flushAggregators();
+
+	// Get the number of groups with the held aggregator results.
+	size_t getCoalescedCount() const
+	{
+		return coalesced_.size();
+	}
+
 	/////// operations on rows
 
 	// Create a new row handle for a row.
@@ -112,6 +289,9 @@ public:
 	// Insert a pre-initialized row handle.
 	// May throw an Exception.
 	// If the handle is already in table, does nothing and returns false.
+	// If the row replaces an identical one and the identical replacements
+	// are not done (see setIdenticalReplace()), returns true but the
+	// handle doesn't get inserted, the old one stays in the table.
 	// @param rh - the row handle to insert (must be held in a Rowref or such at the moment)
 	// @return - true on success, false on failure (if the index policies don't allow it)
 	bool insert(RowHandle *rh);
@@ -129,6 +309,17 @@ public:
 	// @return - true if found and removed, false if not found
 	bool deleteRow(const Row *row);
 
+	// Apply a row operation the way the table's input label does:
+	// an update with the old row inserts the new row and then removes
+	// the old one if it is still in the table (i.e. if the key has changed),
+	// an insert inserts the row (the failures are ignored),
+	// a delete deletes the matching row, anything else is ignored.
+	// May throw an Exception.
+	// @param op - the opcode
+	// @param row - the row to apply
+	// @param oldRow - the previous row for an update, or NULL
+	void applyRow(Rowop::Opcode op, const Row *row, const Row *oldRow);
+
 	// Get the handle of the first record in this table.
 	// A random index will be used for iteration. Usually this will be
 	// the first index, but the table may decide to pick a more efficient one
@@ -223,6 +414,102 @@ public:
 		return findRowIdx(firstLeaf_, what);
 	}
 
+	// Find the matching rows for a whole batch of pattern rows.
+	// The result is the same as calling findRowIdx() for each row
+	// but it's cheaper: a single Probe gets reused for all the rows,
+	// and the data of the next row gets prefetched while the current
+	// one is being looked up. Handy for the lookups of a whole tray
+	// of rows in a join.
+	//
+	// May throw an Exception.
+	//
+	// @param ixt - index type from this table's type
+	// @param rows - the pattern rows; the caller must hold the references
+	//        to them for the duration of the call; the NULL entries
+	//        are allowed and produce the NULL results
+	// @param results - the place to return the found handles, in the same
+	//        order as the rows, NULL for the rows that were not found; the
+	//        previous contents of it gets replaced
+	void findBatchIdx(IndexType *ixt, const vector<const Row *> &rows, vector<RowHandle *> &results) const;
+	void findBatch(const vector<const Row *> &rows, vector<RowHandle *> &results) const
+	{
+		findBatchIdx(firstLeaf_, rows, results);
+	}
+
+	// A reusable pattern handle for the cheap lookups of the rows by
+	// one index type. A handle made with makeRowHandle() references the
+	// row, gets allocated and has the sections of all the indexes
+	// pre-calculated, only to be thrown away after a single lookup.
+	// The Probe initializes only the sections on the path from the root
+	// to its index type, which is all that a lookup needs, doesn't
+	// reference the row, and keeps the handle storage inside itself
+	// when the handle is small enough, so it can live on the stack.
+	// The findRowIdx() and groupSizeRowIdx() use it internally.
+	//
+	// The handle returned by set() must be used only for findIdx() and
+	// groupSizeIdx() with the probe's index type, and only until the next
+	// call of set() or reset().
+	class Probe
+	{
+	public:
+		// @param table - table where the lookups will be done; the probe
+		//        doesn't reference it, so it must not outlive the table
+		// @param ixt - index type from this table's type to do the lookups
+		//        by; if it's NULL or from another table type, all the
+		//        lookups will return nothing
+		Probe(const Table *table, IndexType *ixt);
+		~Probe();
+
+		// Set the pattern row. The probe doesn't reference the row,
+		// so the caller must hold it while the probe is set.
+		// @param row - the pattern row
+		// @return - the pattern handle, or NULL if the row is NULL or the
+		//        index type is not usable
+		RowHandle *set(const Row *row);
+
+		// Clear the pattern row. Happens automatically in set() and
+		// in the destructor.
+		void reset();
+
+		// Find the matching row in the table, like Table::findRowIdx().
+		// May throw an Exception.
+		// @param row - the pattern row
+		// @return - the matching row handle or NULL
+		RowHandle *find(const Row *row);
+
+		// Get the size of the group, like Table::groupSizeRowIdx().
+		// May throw an Exception.
+		// @param row - the pattern row
+		// @return - the size of the group, 0 if not found
+		size_t groupSize(const Row *row);
+
+		// Get back the index type.
+		IndexType *getIndexType() const
+		{
+			return ixt_;
+		}
+
+	protected:
+		// Handles up to this size (in units of RowHandle::AlignType)
+		// get stored inline.
+		enum {
+			INLINE_SIZE = 32
+		};
+
+		// The probe holds no references, to avoid the atomic operations on
+		// every lookup. The table holds its type that holds the index type.
+		const Table *table_;
+		IndexType *ixt_; // NULL if not usable
+		RowHandle *rh_; // the pattern handle
+		bool isSet_; // flag: the handle has the row and sections set
+		bool inline_; // flag: the handle is placed in buf_
+		RowHandle::AlignType buf_[INLINE_SIZE];
+
+	private:
+		Probe(const Probe &);
+		void operator=(const Probe &);
+	};
+
 	// Get the size of the group where the row belongs
 	// (similarly to what can be done in an aggregator).
 	// The group measured is a group under the specified index type
@@ -267,6 +554,7 @@ public:
 	void dumpAll(Rowop::Opcode op = Rowop::OP_INSERT) const;
 
 	// Send the whole contents of the table to the dump label, in a specific order.
+	// For the large tables, see DumpCursor that does the same in small portions.
 	// May throw an Exception.
 	// @param ixt - Index type that determines the ordering of the rows.
 	//        If NULL then the default first leaf index is used.
@@ -274,6 +562,39 @@ public:
 	// @param op - Opcode to use for sending (INSERT by default).
 	void dumpAllIdx(IndexType *ixt, Rowop::Opcode op = Rowop::OP_INSERT) const;
 
+	// Start keeping the history of the table contents for the snapshots.
+	// This is done automatically on the first call of snapshot(), but
+	// since it has to go through all the rows present in the table, it's
+	// O(N), and may be done in advance, on an empty table. After that
+	// every insertion and removal of a row has a small O(log N) overhead.
+	// The rows present at the time of enabling come in the order of the
+	// first leaf index, followed by the ones inserted after that.
+	void enableSnapshots() const;
+
+	// Check whether the snapshots are enabled.
+	bool isSnapshotEnabled() const
+	{
+		return !versions_.isNull();
+	}
+
+	// Get the history of the contents kept for the snapshots (mostly
+	// for the tests), NULL if the snapshots are not enabled.
+	TableVersions *getVersions() const
+	{
+		return versions_;
+	}
+
+	// Take an immutable snapshot of the table contents, that can be read
+	// by the other threads while this thread keeps modifying the table.
+	// Once the snapshots are enabled (see enableSnapshots()), taking a
+	// snapshot is O(1), with the rows collected lazily on the first
+	// access to them. The rows come in the order of insertion.
+	// The snapshot is cached, and until the table gets modified, the
+	// repeated calls return the same snapshot.
+	// May throw an Exception.
+	// @return - the snapshot
+	Onceref<TableSnapshot> snapshot() const;
+
 	// } The dump interface.
 
 	// { The index interface.
@@ -339,6 +660,28 @@ protected:
 		return aggs_[i];
 	}
 
+	// Check whether the aggregator results are coalesced.
+	bool isCoalescing() const
+	{
+		return coalesce_ != AC_NONE;
+	}
+
+	// The point of the group modification where the aggregators get called.
+	enum CoalescePhase {
+		CP_BEFORE, // the sending of the old state
+		CP_AFTER, // the sending of the new state (including the collapse)
+	};
+
+	// For the coalescing of the aggregator results: get the tray where
+	// an aggregator of a group must send its output in this call.
+	// The tray is valid only until the next call.
+	// @param ixt - index type that owns the group
+	// @param gh - the group
+	// @param aggn - index of the aggregator in the group
+	// @param phase - the point of modification
+	// @return - the tray for the aggregator output
+	Tray *coalesceDest(const IndexType *ixt, GroupHandle *gh, int aggn, CoalescePhase phase);
+
 protected:
 	class InputLabel: public Label
 	{
@@ -360,6 +703,67 @@ protected:
 		Table *table_;
 	};
 
+	// Flushes the coalesced aggregator results when the scheduled
+	// rowop comes to it.
+	class FlushLabel: public Label
+	{
+		friend class Table;
+	public:
+		FlushLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name, Table *table);
+
+	protected:
+		// from Label
+		virtual void execute(Rowop *arg) const;
+
+		// when the table gets destroyed, it resets this back-link
+		void resetTable()
+		{
+			table_ = NULL;
+		}
+
+		Table *table_;
+	};
+
+	// The held aggregator results of one group.
+	class CoalescedGroup
+	{
+	public:
+		// Keeps a reference to the group, so that if the group
+		// gets collapsed, its pointer can't be reused by a new group
+		// until the flush.
+		// @param ixt - index type that owns the group
+		// @param gh - the group
+		CoalescedGroup(const IndexType *ixt, GroupHandle *gh);
+		// Releases the reference to the group, destroying it if it
+		// was the last one.
+		~CoalescedGroup();
+
+		typedef vector< Autoref<Tray> > TrayVec;
+
+		const IndexType *ixt_;
+		GroupHandle *gh_;
+		TrayVec old_; // per aggregator, the result before the first modification
+		TrayVec new_; // per aggregator, the result after the last modification
+
+	private:
+		CoalescedGroup(const CoalescedGroup &);
+		void operator=(const CoalescedGroup &);
+	};
+
+	typedef map<GroupHandle *, CoalescedGroup *> CoalesceMap;
+	typedef vector<CoalescedGroup *> CoalesceVec;
+
+	// Drop all the held aggregator results without sending them.
+	void dropCoalesced();
+
+protected:
+	friend class DumpCursor;
+	typedef vector<DumpCursor *> CursorVec;
+
+	// Advance the dump cursors positioned on a row handle that is
+	// about to be removed.
+	void advanceCursors(RowHandle *rh);
+
 protected:
 	typedef vector< Autoref<AggregatorGadget> > AggGadgetVec;
 
@@ -376,6 +780,20 @@ protected:
 	string name_; // base name of the table
 	Erref stickyErr_; // errors from the indexes, that make the table dead
 	bool busy_; // flag: an operation is in progress on the table
+	IdenticalReplace identicalReplace_; // handling of the identical replacements
+	bool sendUpdates_; // flag: send the single-row replacements as OP_UPDATE
+	bool quiet_; // flag: send nothing out on the modifications
+	bool orderedLoad_; // flag: the rows are expected to come in the index order
+	mutable Autoref<TableVersions> versions_; // the history for the snapshots, NULL if not enabled
+	mutable Autoref<TableSnapshot> snapshot_; // the cached snapshot, reset on modification
+	CursorVec cursors_; // the dump cursors on this table, they hold the references to the table
+	AggregatorCoalesce coalesce_; // the coalescing of the aggregator results
+	CoalesceVec coalesced_; // the groups with the held results, in the order of modification
+	CoalesceMap coalescedMap_; // the same groups, for the lookup
+	Autoref<Tray> discardTray_; // collects the aggregator output that is not needed
+	Autoref<FlushLabel> flushLabel_; // created on demand for AC_DRAIN
+	Rowref flushRow_; // the empty row for the flush rowops
+	bool flushScheduled_; // flag: a flush rowop is in the unit queue
 
 private:
 	Table(const Table &t);
@@ -0,0 +1,199 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The binary dump of the table contents into a file and the fast reload from it.
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <table/TableDump.h>
+#include <type/TableType.h>
+#include <mem/Rhref.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+const char TableDump::MAGIC[8] = { 'T', 'R', 'C', 'D', 'U', 'M', 'P', '\n' };
+
+// The fixed part of the file, followed by the type printout and then
+// by the row records. All the parts are padded to 8 bytes, the row
+// records consist of a 4-byte length and the row image, padded to 4 bytes.
+struct TableDumpHeader
+{
+	char magic_[8];
+	uint32_t byteOrder_; // DUMP_BYTE_ORDER written natively
+	uint32_t version_;
+	uint64_t typeLen_; // length of the type printout
+	uint64_t rowCount_;
+};
+
+static const uint32_t DUMP_BYTE_ORDER = 0x01020304;
+
+// Writes into a FILE with the error checking.
+static void writeOrThrow(FILE *f, const void *data, size_t len, const string &fname)
+{
+	if (len != 0 && fwrite(data, len, 1, f) != 1)
+		throw Exception::f("Failed to write the table dump file '%s': %s", fname.c_str(), strerror(errno));
+}
+
+size_t TableDump::write(const Table *table, const string &fname, IndexType *ixt)
+{
+	if (ixt == NULL)
+		ixt = table->getType()->getFirstLeaf();
+
+	string tname = fname + ".tmp";
+	FILE *f = fopen(tname.c_str(), "w");
+	if (f == NULL)
+		throw Exception::f("Failed to create the table dump file '%s': %s", tname.c_str(), strerror(errno));
+
+	static const char zeroes[8] = { 0 };
+	size_t count = 0;
+	try {
+		setvbuf(f, NULL, _IOFBF, 1024*1024);
+
+		string tprint = table->getType()->print();
+
+		TableDumpHeader hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		memcpy(hdr.magic_, MAGIC, sizeof(hdr.magic_));
+		hdr.byteOrder_ = DUMP_BYTE_ORDER;
+		hdr.version_ = VERSION;
+		hdr.typeLen_ = tprint.size();
+		hdr.rowCount_ = table->size();
+		writeOrThrow(f, &hdr, sizeof(hdr), tname);
+		writeOrThrow(f, tprint.c_str(), tprint.size(), tname);
+		writeOrThrow(f, zeroes, (8 - tprint.size() % 8) % 8, tname);
+
+		const RowType *rt = table->getRowType();
+		for (RowHandle *rh = table->beginIdx(ixt); rh != NULL; rh = table->nextIdx(ixt, rh)) {
+			intptr_t len;
+			const char *image = rt->rowImage(rh->getRow(), len);
+			uint32_t len32 = (uint32_t)len;
+			writeOrThrow(f, &len32, sizeof(len32), tname);
+			writeOrThrow(f, image, len, tname);
+			writeOrThrow(f, zeroes, (4 - len % 4) % 4, tname);
+			count++;
+		}
+		if (count != hdr.rowCount_) { // should never happen but just in case
+			hdr.rowCount_ = count;
+			if (fseek(f, 0, SEEK_SET) < 0)
+				throw Exception::f("Failed to seek in the table dump file '%s': %s", tname.c_str(), strerror(errno));
+			writeOrThrow(f, &hdr, sizeof(hdr), tname);
+		}
+
+		if (fflush(f) != 0 || fsync(fileno(f)) < 0)
+			throw Exception::f("Failed to write the table dump file '%s': %s", tname.c_str(), strerror(errno));
+	} catch (Exception e) {
+		fclose(f);
+		unlink(tname.c_str());
+		throw;
+	}
+	if (fclose(f) != 0) {
+		int err = errno;
+		unlink(tname.c_str());
+		throw Exception::f("Failed to write the table dump file '%s': %s", tname.c_str(), strerror(err));
+	}
+	if (rename(tname.c_str(), fname.c_str()) < 0) {
+		int err = errno;
+		unlink(tname.c_str());
+		throw Exception::f("Failed to rename the table dump file '%s' to '%s': %s",
+			tname.c_str(), fname.c_str(), strerror(err));
+	}
+	return count;
+}
+
+size_t TableDump::load(Table *table, const string &fname)
+{
+	int fd = open(fname.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw Exception::f("Failed to open the table dump file '%s': %s", fname.c_str(), strerror(errno));
+
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		int err = errno;
+		close(fd);
+		throw Exception::f("Failed to stat the table dump file '%s': %s", fname.c_str(), strerror(err));
+	}
+	size_t len = (size_t)st.st_size;
+	if (len < sizeof(TableDumpHeader)) {
+		close(fd);
+		throw Exception::f("The table dump file '%s' is too short, %zu bytes.", fname.c_str(), len);
+	}
+
+	void *data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+	int err = errno;
+	close(fd); // the mapping stays valid
+	if (data == MAP_FAILED)
+		throw Exception::f("Failed to map the table dump file '%s': %s", fname.c_str(), strerror(err));
+	madvise(data, len, MADV_SEQUENTIAL);
+
+	size_t count;
+	try {
+		count = loadImage(table, (const char *)data, len, fname);
+	} catch (Exception e) {
+		munmap(data, len);
+		throw;
+	}
+	munmap(data, len);
+	return count;
+}
+
+size_t TableDump::loadImage(Table *table, const char *data, size_t len, const string &fname)
+{
+	TableDumpHeader hdr;
+	if (len < sizeof(hdr))
+		throw Exception::f("The table dump file '%s' is too short, %zu bytes.", fname.c_str(), len);
+	memcpy(&hdr, data, sizeof(hdr));
+
+	if (memcmp(hdr.magic_, MAGIC, sizeof(hdr.magic_)))
+		throw Exception::f("The file '%s' is not a table dump.", fname.c_str());
+	if (hdr.byteOrder_ != DUMP_BYTE_ORDER)
+		throw Exception::f("The table dump file '%s' has been written on a machine with a different byte order.", fname.c_str());
+	if (hdr.version_ != VERSION)
+		throw Exception::f("The table dump file '%s' has the unsupported version %u, expected %d.",
+			fname.c_str(), (unsigned)hdr.version_, (int)VERSION);
+
+	size_t pos = sizeof(hdr);
+	if (hdr.typeLen_ > len - pos)
+		throw Exception::f("The table dump file '%s' is truncated in the type description.", fname.c_str());
+	string tprint(data + pos, hdr.typeLen_);
+	if (tprint != table->getType()->print())
+		throw Exception::f("The table dump file '%s' contains the data of a different table type:\n%s\nwhile the table '%s' has the type:\n%s",
+			fname.c_str(), tprint.c_str(), table->getName().c_str(), table->getType()->print().c_str());
+	pos += (hdr.typeLen_ + 7) & ~(uint64_t)7;
+
+	const RowType *rt = table->getRowType();
+	Table::QuietMark qm(table);
+	Table::OrderedLoadMark olm(table);
+	size_t count = 0;
+	while (count < hdr.rowCount_) {
+		uint32_t rlen;
+		if (pos > len || len - pos < sizeof(rlen))
+			break;
+		memcpy(&rlen, data + pos, sizeof(rlen));
+		pos += sizeof(rlen);
+		if (rlen > len - pos)
+			break;
+		Row *row = rt->makeRowFromImage(data + pos, rlen);
+		if (row == NULL)
+			throw Exception::f("The table dump file '%s' has a corrupted row #%zu at offset %zu.",
+				fname.c_str(), count, pos - sizeof(rlen));
+		Rhref rh(table, row); // the handle owns the row from now on
+		table->insert(rh); // may throw
+		pos += (rlen + 3) & ~(uint32_t)3;
+		count++;
+	}
+	if (count != hdr.rowCount_)
+		throw Exception::f("The table dump file '%s' is truncated after %zu rows of %lld.",
+			fname.c_str(), count, (long long)hdr.rowCount_);
+	return count;
+}
+
+}; // TRICEPS_NS
@@ -0,0 +1,75 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The binary dump of the table contents into a file and the fast reload from it.
+
+#ifndef __Triceps_TableDump_h__
+#define __Triceps_TableDump_h__
+
+#include <table/Table.h>
+
+namespace TRICEPS_NS {
+
+// The dump file contains a header, the printout of the table type (that
+// gets compared on load, to make sure that the table matches the dump),
+// and the images of the rows (as returned by RowType::rowImage()).
+// The rows are written in the order of an index, and when loaded back,
+// the inserts into that index go through its fast path for the
+// ordered data (see Table::setOrderedLoad()). The format is
+// architecture-dependent, the dumps are meant for restarting on the
+// same machine, not for the data exchange.
+//
+// The loading is done by mmap()-ing the file and inserting the rows
+// in the quiet mode of the table (see Table::setQuiet()), so nothing
+// gets sent to the table's labels, and the aggregator output is discarded.
+//
+// All the errors get thrown as Exceptions.
+class TableDump
+{
+public:
+	// The first bytes of every dump file.
+	static const char MAGIC[8];
+	// The current version of the format.
+	enum {
+		VERSION = 1
+	};
+
+	// Write the contents of a table into a file.
+	// The file is first written under a temporary name (fname + ".tmp"),
+	// synced to the disk and then renamed, so a crash during the dump
+	// leaves the previous file intact.
+	//
+	// @param table - table to dump
+	// @param fname - name of the file
+	// @param ixt - index type from this table's type that determines the order
+	//        of the rows; NULL means the first leaf index
+	// @return - the number of rows written
+	static size_t write(const Table *table, const string &fname, IndexType *ixt = NULL);
+
+	// Load the contents of a file into a table. The table normally
+	// should be empty, otherwise the loaded rows get merged into it
+	// following the usual replacement policies.
+	//
+	// @param table - table to load into; its type must print the same as
+	//        the type saved in the dump
+	// @param fname - name of the file
+	// @return - the number of rows read from the file
+	static size_t load(Table *table, const string &fname);
+
+	// Load the rows from a dump image in memory, this is the guts of load()
+	// but can be used on the images obtained by other means too.
+	//
+	// @param table - table to load into
+	// @param data - the image of the whole dump file
+	// @param len - length of the image
+	// @param fname - name of the file, for the error messages
+	// @return - the number of rows read
+	static size_t loadImage(Table *table, const char *data, size_t len, const string &fname);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TableDump_h__
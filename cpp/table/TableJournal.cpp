@@ -0,0 +1,413 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The write-ahead journal of the rowops, for the recovery of the tables.
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <table/TableJournal.h>
+#include <table/TableDump.h>
+#include <mem/Rhref.h>
+#include <common/Hash.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+const char TableJournal::MAGIC[8] = { 'T', 'R', 'C', 'J', 'R', 'N', 'L', '\n' };
+
+// The fixed part of the file, followed by the row type printout
+// padded to 8 bytes, and then by the records.
+struct TableJournalHeader
+{
+	char magic_[8];
+	uint32_t byteOrder_; // JOURNAL_BYTE_ORDER written natively
+	uint32_t version_;
+	uint64_t typeLen_; // length of the type printout
+};
+
+// The fixed part of a record, followed by the image of the row and
+// the image of the old row, each padded to 4 bytes.
+struct TableJournalRecord
+{
+	uint32_t len_; // length of the row image
+	int32_t opcode_;
+	uint32_t oldLen_; // length of the old row image, 0 if none
+	uint32_t cksum_; // checksum of the fields above and of the images
+};
+
+static const uint32_t JOURNAL_BYTE_ORDER = 0x01020304;
+
+// The part of the record before the checksum that goes into the checksum.
+static const size_t RECORD_CKSUM_PREFIX = offsetof(TableJournalRecord, cksum_);
+
+static Hash::Value recordChecksum(const TableJournalRecord &rec,
+	const char *image, const char *oldImage)
+{
+	Hash::Value h = Hash::append(Hash::basis_, (const char *)&rec, RECORD_CKSUM_PREFIX);
+	h = Hash::append(h, image, rec.len_);
+	return Hash::append(h, oldImage, rec.oldLen_);
+}
+
+// Writes the whole buffer into a file descriptor.
+// @return - true on success, false on error (with errno set)
+static bool writeAll(int fd, const char *data, size_t len)
+{
+	while (len != 0) {
+		ssize_t res = ::write(fd, data, len);
+		if (res < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += res;
+		len -= res;
+	}
+	return true;
+}
+
+// Check the header of a journal image.
+// @return - the offset of the first record
+static size_t parseHeader(const char *data, size_t len, const string &fname, const RowType *rt)
+{
+	TableJournalHeader hdr;
+	if (len < sizeof(hdr))
+		throw Exception::f("The journal file '%s' is too short, %zu bytes.", fname.c_str(), len);
+	memcpy(&hdr, data, sizeof(hdr));
+
+	if (memcmp(hdr.magic_, TableJournal::MAGIC, sizeof(hdr.magic_)))
+		throw Exception::f("The file '%s' is not a table journal.", fname.c_str());
+	if (hdr.byteOrder_ != JOURNAL_BYTE_ORDER)
+		throw Exception::f("The journal file '%s' has been written on a machine with a different byte order.", fname.c_str());
+	if (hdr.version_ != TableJournal::VERSION)
+		throw Exception::f("The journal file '%s' has the unsupported version %u, expected %d.",
+			fname.c_str(), (unsigned)hdr.version_, (int)TableJournal::VERSION);
+
+	size_t pos = sizeof(hdr);
+	if (hdr.typeLen_ > len - pos)
+		throw Exception::f("The journal file '%s' is truncated in the type description.", fname.c_str());
+	string tprint(data + pos, hdr.typeLen_);
+	if (tprint != rt->print())
+		throw Exception::f("The journal file '%s' contains the data of a different row type:\n%s\nwhile the expected type is:\n%s",
+			fname.c_str(), tprint.c_str(), rt->print().c_str());
+	pos += (hdr.typeLen_ + 7) & ~(uint64_t)7;
+	if (pos > len)
+		throw Exception::f("The journal file '%s' is truncated in the type description.", fname.c_str());
+	return pos;
+}
+
+// Maps a whole file for reading.
+// @param fd - the file descriptor, gets closed before return
+// @param len - returns the length of the file
+// @return - the mapped data, or NULL if the file is empty
+static const char *mapFile(int fd, const string &fname, size_t &len)
+{
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		int err = errno;
+		close(fd);
+		throw Exception::f("Failed to stat the journal file '%s': %s", fname.c_str(), strerror(err));
+	}
+	len = (size_t)st.st_size;
+	if (len == 0) {
+		close(fd);
+		return NULL;
+	}
+
+	void *data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+	int err = errno;
+	close(fd); // the mapping stays valid
+	if (data == MAP_FAILED)
+		throw Exception::f("Failed to map the journal file '%s': %s", fname.c_str(), strerror(err));
+	madvise(data, len, MADV_SEQUENTIAL);
+	return (const char *)data;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+TableJournal::JournalLabel::JournalLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name, TableJournal *journal) :
+	Label(unit, rtype, name),
+	journal_(journal)
+{ }
+
+void TableJournal::JournalLabel::execute(Rowop *arg) const
+{
+	if (journal_ == NULL)
+		throw Exception::f("Can not write more rowops into a destroyed journal");
+	journal_->append(arg);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+TableJournal::TableJournal(Unit *unit, const_Onceref<RowType> rt, const string &name, const string &fname) :
+	type_(rt),
+	fname_(fname),
+	fd_(-1),
+	bufSize_(64*1024),
+	fileSize_(0),
+	records_(0),
+	syncPolicy_(SYNC_FLUSH),
+	cpLimit_(0)
+{
+	int fd = open(fname.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		// check the existing contents
+		size_t len;
+		const char *data = mapFile(fd, fname, len);
+		if (data != NULL) {
+			try {
+				size_t pos = parseHeader(data, len, fname, type_);
+				records_ = scanImage(data + pos, len - pos, fname, type_, NULL, fileSize_);
+				fileSize_ += pos;
+			} catch (Exception e) {
+				munmap((void *)data, len);
+				throw;
+			}
+			munmap((void *)data, len);
+		}
+	} else if (errno != ENOENT) {
+		throw Exception::f("Failed to open the journal file '%s': %s", fname.c_str(), strerror(errno));
+	}
+
+	fd_ = open(fname.c_str(), O_WRONLY|O_CREAT|O_APPEND, 0666);
+	if (fd_ < 0)
+		throw Exception::f("Failed to open the journal file '%s': %s", fname.c_str(), strerror(errno));
+
+	try {
+		if (fileSize_ == 0) {
+			if (ftruncate(fd_, 0) < 0)
+				throw Exception::f("Failed to truncate the journal file '%s': %s", fname.c_str(), strerror(errno));
+			writeHeader();
+		} else {
+			// drop the torn tail, if any
+			if (ftruncate(fd_, fileSize_) < 0)
+				throw Exception::f("Failed to truncate the journal file '%s': %s", fname.c_str(), strerror(errno));
+		}
+	} catch (Exception e) {
+		::close(fd_);
+		fd_ = -1;
+		throw;
+	}
+
+	label_ = new JournalLabel(unit, rt, name, this);
+}
+
+TableJournal::~TableJournal()
+{
+	label_->resetJournal(); // prevent it from sending more data
+	if (fd_ >= 0) {
+		// no Exceptions in the destructor, do the best effort
+		writeAll(fd_, buf_.c_str(), buf_.size());
+		if (syncPolicy_ != SYNC_NONE)
+			fdatasync(fd_);
+		::close(fd_);
+	}
+}
+
+TableJournal *TableJournal::setCheckpoint(Table *table, const string &dumpName, size_t limit)
+{
+	if (table != NULL && table->getRowType()->print() != type_->print())
+		throw Exception::f("The journal '%s' can not checkpoint the table '%s' with a different row type.",
+			label_->getName().c_str(), table->getName().c_str());
+	cpTable_ = table;
+	cpName_ = dumpName;
+	cpLimit_ = limit;
+	return this;
+}
+
+void TableJournal::append(const Rowop *rop)
+{
+	if (fd_ < 0)
+		throw Exception::f("Can not write more rowops into the closed journal '%s'", label_->getName().c_str());
+	if (!rop->isInsert() && !rop->isDelete())
+		return; // nothing to record for OP_NOP
+
+	static const char zeroes[4] = { 0 };
+	intptr_t len, oldLen = 0;
+	const char *image = type_->rowImage(rop->getRow(), len);
+	const char *oldImage = NULL;
+	if (rop->getOldRow() != NULL)
+		oldImage = type_->rowImage(rop->getOldRow(), oldLen);
+
+	TableJournalRecord rec;
+	rec.len_ = (uint32_t)len;
+	rec.opcode_ = rop->getOpcode();
+	rec.oldLen_ = (uint32_t)oldLen;
+	rec.cksum_ = recordChecksum(rec, image, oldImage);
+
+	buf_.append((const char *)&rec, sizeof(rec));
+	buf_.append(image, len);
+	buf_.append(zeroes, (4 - len % 4) % 4);
+	if (oldLen != 0) {
+		buf_.append(oldImage, oldLen);
+		buf_.append(zeroes, (4 - oldLen % 4) % 4);
+	}
+	records_++;
+
+	if (buf_.size() >= bufSize_ || syncPolicy_ == SYNC_EVERY)
+		writeBuffer();
+}
+
+void TableJournal::writeBuffer()
+{
+	if (buf_.empty())
+		return;
+	if (!writeAll(fd_, buf_.c_str(), buf_.size()))
+		throw Exception::f("Failed to write the journal file '%s': %s", fname_.c_str(), strerror(errno));
+	fileSize_ += buf_.size();
+	buf_.clear();
+	if (syncPolicy_ != SYNC_NONE && fdatasync(fd_) < 0)
+		throw Exception::f("Failed to sync the journal file '%s': %s", fname_.c_str(), strerror(errno));
+}
+
+void TableJournal::writeHeader()
+{
+	static const char zeroes[8] = { 0 };
+	string tprint = type_->print();
+
+	TableJournalHeader hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic_, MAGIC, sizeof(hdr.magic_));
+	hdr.byteOrder_ = JOURNAL_BYTE_ORDER;
+	hdr.version_ = VERSION;
+	hdr.typeLen_ = tprint.size();
+
+	string data((const char *)&hdr, sizeof(hdr));
+	data.append(tprint);
+	data.append(zeroes, (8 - tprint.size() % 8) % 8);
+	if (!writeAll(fd_, data.c_str(), data.size()) || fdatasync(fd_) < 0)
+		throw Exception::f("Failed to write the journal file '%s': %s", fname_.c_str(), strerror(errno));
+	fileSize_ = data.size();
+}
+
+void TableJournal::flush()
+{
+	if (fd_ < 0)
+		return;
+	writeBuffer();
+	if (cpLimit_ != 0 && fileSize_ > cpLimit_)
+		checkpoint();
+}
+
+void TableJournal::checkpoint()
+{
+	if (cpTable_.isNull())
+		throw Exception::f("The journal '%s' has no table set for the checkpoints.", label_->getName().c_str());
+	if (fd_ < 0)
+		throw Exception::f("Can not checkpoint the closed journal '%s'", label_->getName().c_str());
+
+	writeBuffer();
+	TableDump::write(cpTable_, cpName_);
+	// The dump is on the disk now, so the journal can be dropped.
+	// If a crash happens right here, the old journal gets replayed on top
+	// of the new dump, see the idempotence notes in the header.
+	if (ftruncate(fd_, 0) < 0)
+		throw Exception::f("Failed to truncate the journal file '%s': %s", fname_.c_str(), strerror(errno));
+	records_ = 0;
+	writeHeader();
+}
+
+void TableJournal::close()
+{
+	if (fd_ < 0)
+		return;
+	try {
+		writeBuffer();
+	} catch (Exception e) {
+		::close(fd_);
+		fd_ = -1;
+		throw;
+	}
+	if (::close(fd_) < 0) {
+		fd_ = -1;
+		throw Exception::f("Failed to close the journal file '%s': %s", fname_.c_str(), strerror(errno));
+	}
+	fd_ = -1;
+}
+
+size_t TableJournal::scanImage(const char *data, size_t len, const string &fname,
+	const RowType *rt, Table *table, size_t &validEnd)
+{
+	size_t pos = 0, count = 0;
+	validEnd = 0;
+	for (;;) {
+		TableJournalRecord rec;
+		if (len - pos < sizeof(rec))
+			break;
+		memcpy(&rec, data + pos, sizeof(rec));
+		size_t ipos = pos + sizeof(rec);
+		size_t plen = ((size_t)rec.len_ + 3) & ~(size_t)3;
+		size_t poldlen = ((size_t)rec.oldLen_ + 3) & ~(size_t)3;
+		if (plen > len - ipos || poldlen > len - ipos - plen)
+			break;
+		const char *image = data + ipos;
+		const char *oldImage = data + ipos + plen;
+		if (recordChecksum(rec, image, oldImage) != rec.cksum_)
+			break;
+
+		if (table != NULL) {
+			Rowref row(rt, rt->makeRowFromImage(image, rec.len_));
+			if (row.isNull())
+				throw Exception::f("The journal file '%s' has a corrupted row in the record #%zu.",
+					fname.c_str(), count);
+			Rowref oldRow(rt);
+			if (rec.oldLen_ != 0) {
+				oldRow = rt->makeRowFromImage(oldImage, rec.oldLen_);
+				if (oldRow.isNull())
+					throw Exception::f("The journal file '%s' has a corrupted old row in the record #%zu.",
+						fname.c_str(), count);
+			}
+
+			table->applyRow((Rowop::Opcode)rec.opcode_, row, oldRow);
+		}
+
+		pos = ipos + plen + poldlen;
+		validEnd = pos;
+		count++;
+	}
+	return count;
+}
+
+size_t TableJournal::replay(Table *table, const string &fname)
+{
+	int fd = open(fname.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw Exception::f("Failed to open the journal file '%s': %s", fname.c_str(), strerror(errno));
+
+	size_t len;
+	const char *data = mapFile(fd, fname, len);
+	if (data == NULL)
+		return 0; // an empty file is a journal that has been created but not written
+
+	size_t count;
+	try {
+		const RowType *rt = table->getRowType();
+		size_t pos = parseHeader(data, len, fname, rt);
+		Table::QuietMark qm(table);
+		size_t validEnd;
+		count = scanImage(data + pos, len - pos, fname, rt, table, validEnd);
+	} catch (Exception e) {
+		munmap((void *)data, len);
+		throw;
+	}
+	munmap((void *)data, len);
+	return count;
+}
+
+size_t TableJournal::recover(Table *table, const string &dumpName, const string &fname)
+{
+	if (access(dumpName.c_str(), F_OK) == 0)
+		TableDump::load(table, dumpName);
+	if (access(fname.c_str(), F_OK) == 0)
+		replay(table, fname);
+	return table->size();
+}
+
+}; // TRICEPS_NS
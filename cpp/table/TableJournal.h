@@ -0,0 +1,238 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The write-ahead journal of the rowops, for the recovery of the tables.
+
+#ifndef __Triceps_TableJournal_h__
+#define __Triceps_TableJournal_h__
+
+#include <table/Table.h>
+
+namespace TRICEPS_NS {
+
+// The journal records the rowops that modify a table into a file,
+// so that after a restart the table can be restored from the last
+// dump (see TableDump) plus the journal written since that dump.
+//
+// The journal has a label that gets chained either from the table's
+// input label (to record the requested modifications) or from its
+// output label (to record the actual modifications, as they happened
+// after the replacement policies). The rowops are appended to a
+// buffer in memory and written to the file in batches (the group commit),
+// with the syncing to the disk according to the SyncPolicy.
+//
+// The format is architecture-dependent, like in TableDump: a header with
+// the printout of the row type, then the records, each consisting of
+// a fixed part with the opcode, the lengths of the row images and a checksum,
+// followed by the images of the row and of the old row (for OP_UPDATE).
+// A torn record at the end of the file (as left by a crash in the middle
+// of a write) is detected by the checksum and discarded.
+//
+// The replay of the journal into a table is done in the quiet mode of the
+// table (see Table::setQuiet()), so nothing gets sent out during it.
+// The replay is idempotent for the tables where all the indexes are
+// keyed by the same key: the re-applied inserts replace the same rows
+// and the re-applied deletes find nothing to delete. This covers the
+// case of a crash in checkpoint() after the dump has been written but
+// before the journal has been truncated. For the other tables (such as
+// with the FIFO indexes limited in size) the recovery must be done
+// exactly from the dump written by the last checkpoint.
+//
+// All the errors get thrown as Exceptions.
+class TableJournal : public Starget
+{
+public:
+	// The first bytes of every journal file.
+	static const char MAGIC[8];
+	// The current version of the format.
+	enum {
+		VERSION = 1
+	};
+
+	// When the data gets synced to the disk.
+	enum SyncPolicy {
+		SYNC_NONE, // write the buffer to the file but leave the syncing to the OS
+		SYNC_FLUSH, // sync after writing each buffer, the default
+		SYNC_EVERY, // write and sync after each rowop
+	};
+
+	// The journal file gets opened in the constructor. If it already
+	// exists, its row type is checked and any torn tail is truncated,
+	// then the new records get appended after the existing ones.
+	//
+	// @param unit - unit where the journal label belongs
+	// @param rt - type of the rows recorded in the journal
+	// @param name - name of the journal label
+	// @param fname - name of the journal file
+	TableJournal(Unit *unit, const_Onceref<RowType> rt, const string &name, const string &fname);
+	// Writes out the buffered data and closes the file.
+	~TableJournal();
+
+	// Get the label that writes the rowops into the journal.
+	Label *getLabel() const
+	{
+		return label_;
+	}
+
+	// Get the name of the journal file.
+	const string &getFileName() const
+	{
+		return fname_;
+	}
+
+	// Set the size of the buffer for the group commit. The buffer gets
+	// written out when it fills up (and on flush()).
+	// @param size - size in bytes, 0 means writing each rowop as it arrives
+	// @return - this
+	TableJournal *setBufferSize(size_t size)
+	{
+		bufSize_ = size;
+		return this;
+	}
+
+	size_t getBufferSize() const
+	{
+		return bufSize_;
+	}
+
+	// Set the syncing policy.
+	// @param policy - the new policy
+	// @return - this
+	TableJournal *setSyncPolicy(SyncPolicy policy)
+	{
+		syncPolicy_ = policy;
+		return this;
+	}
+
+	SyncPolicy getSyncPolicy() const
+	{
+		return syncPolicy_;
+	}
+
+	// Enable the automatic checkpoints: when the journal file grows
+	// over the limit, flush() calls checkpoint(). Only flush() does it,
+	// not the writes of the full buffer, because the checkpoint can not be done
+	// in the middle of a table modification that sends the rowops to the journal.
+	//
+	// @param table - table to dump, its row type must match the journal
+	// @param dumpName - name of the dump file
+	// @param limit - the size of the journal file that triggers a checkpoint,
+	//        0 disables the automatic checkpoints
+	// @return - this
+	TableJournal *setCheckpoint(Table *table, const string &dumpName, size_t limit);
+
+	// Write out the buffered records, sync them according to the policy,
+	// and if the size limit is reached, do a checkpoint.
+	// Normally called at the end of processing of each batch of the input data,
+	// such as after the Unit has been drained.
+	void flush();
+
+	// Do a checkpoint: write the table set with setCheckpoint() to the dump file,
+	// then truncate the journal. The table must not be in the middle
+	// of a modification.
+	void checkpoint();
+
+	// Write out the buffered data and close the file. After that
+	// any rowops sent to the journal label will throw an Exception.
+	void close();
+
+	// Check whether the journal file is open.
+	bool isOpen() const
+	{
+		return fd_ >= 0;
+	}
+
+	// Get the current size of the journal, including the buffered data.
+	size_t getSize() const
+	{
+		return fileSize_ + buf_.size();
+	}
+
+	// Get the number of records written since the journal has been
+	// opened or truncated by the last checkpoint.
+	size_t getRecordCount() const
+	{
+		return records_;
+	}
+
+	// Replay a journal file into a table.
+	//
+	// @param table - table to replay into, its row type must print the same
+	//        as the one saved in the journal
+	// @param fname - name of the journal file
+	// @return - the number of records replayed
+	static size_t replay(Table *table, const string &fname);
+
+	// Recover a table from a dump and a journal. The table normally
+	// should be empty. Either file may be missing, in which case it's skipped.
+	//
+	// @param table - table to recover
+	// @param dumpName - name of the dump file
+	// @param fname - name of the journal file
+	// @return - the number of rows in the table after the recovery
+	static size_t recover(Table *table, const string &dumpName, const string &fname);
+
+protected:
+	class JournalLabel : public Label
+	{
+		friend class TableJournal;
+	public:
+		JournalLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name, TableJournal *journal);
+
+	protected:
+		// from Label
+		// Throws an Exception if the journal is already destroyed or closed.
+		virtual void execute(Rowop *arg) const;
+
+		// when the journal gets destroyed, it resets this back-link
+		void resetJournal()
+		{
+			journal_ = NULL;
+		}
+
+		TableJournal *journal_;
+	};
+
+	// Append a rowop to the buffer.
+	void append(const Rowop *rop);
+	// Write out the buffer and sync according to the policy.
+	void writeBuffer();
+	// Write out the file header.
+	void writeHeader();
+
+	// Scan the records in a journal image.
+	//
+	// @param data - the image of the whole journal file
+	// @param len - length of the image
+	// @param fname - name of the file, for the error messages
+	// @param rt - the expected row type
+	// @param table - table to apply the records to, or NULL to only check them
+	// @param validEnd - returns the offset after the last valid record
+	// @return - the number of valid records
+	static size_t scanImage(const char *data, size_t len, const string &fname,
+		const RowType *rt, Table *table, size_t &validEnd);
+
+	Autoref<const RowType> type_;
+	Autoref<JournalLabel> label_;
+	string fname_;
+	int fd_; // file descriptor of the journal, -1 when closed
+	string buf_; // the buffered records
+	size_t bufSize_; // size of buffer that triggers the write
+	size_t fileSize_; // size of the data already in the file
+	size_t records_; // count of records
+	SyncPolicy syncPolicy_;
+	Autoref<Table> cpTable_; // table for the checkpoints
+	string cpName_; // dump file name for the checkpoints
+	size_t cpLimit_; // journal size that triggers the checkpoints, 0 for none
+
+private:
+	TableJournal(const TableJournal &);
+	void operator=(const TableJournal &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TableJournal_h__
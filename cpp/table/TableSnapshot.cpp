@@ -0,0 +1,191 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The immutable snapshot of the table contents, for the readers in other threads.
+
+#include <table/TableSnapshot.h>
+#include <table/RowHandle.h>
+#include <sched/Unit.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+////////////////////////////////////// TableVersions ////////////////////////////////////
+
+TableVersions::TableVersions(const RowType *rt, intptr_t offset) :
+	rowType_(rt),
+	head_(NULL),
+	tail_(NULL),
+	gen_(0),
+	entryCount_(0),
+	offset_(offset),
+	minLiveGen_(NO_GEN)
+{ }
+
+TableVersions::~TableVersions()
+{
+	// nobody else can access it any more
+	Entry *next;
+	for (Entry *e = head_; e != NULL; e = next) {
+		next = e->next_;
+		freeEntry(e);
+	}
+	for (EntryDeque::iterator it = retired_.begin(); it != retired_.end(); ++it)
+		freeEntry(*it);
+}
+
+void TableVersions::inserted(RowHandle *rh)
+{
+	Entry *e = new Entry;
+	e->row_ = const_cast<Row *>(rh->getRow());
+	e->row_->incref();
+	e->insertGen_ = gen_;
+	e->deleteGen_ = NO_GEN;
+	e->next_ = NULL;
+	e->prev_ = tail_;
+	e->retireGen_ = 0;
+
+	// publish the fully initialized entry
+	if (tail_ == NULL)
+		__atomic_store_n(&head_, e, __ATOMIC_RELEASE);
+	else
+		__atomic_store_n(&tail_->next_, e, __ATOMIC_RELEASE);
+	tail_ = e;
+	*rh->get<Entry *>(offset_) = e;
+	++entryCount_;
+
+	reclaim();
+}
+
+void TableVersions::removed(RowHandle *rh)
+{
+	Entry **ep = rh->get<Entry *>(offset_);
+	Entry *e = *ep;
+	if (e == NULL)
+		return;
+	*ep = NULL;
+
+	__atomic_store_n(&e->deleteGen_, gen_, __ATOMIC_RELEASE);
+	removed_.push_back(e);
+
+	reclaim();
+}
+
+TableSnapshot *TableVersions::makeSnapshot(const string &tableName)
+{
+	{
+		pw::lockmutex lm(mutex_);
+		liveGens_.insert(gen_);
+		__atomic_store_n(&minLiveGen_, *liveGens_.begin(), __ATOMIC_RELEASE);
+	}
+	TableSnapshot *snap = new TableSnapshot(this, gen_, head_, tableName);
+	// the following modifications will be invisible to this snapshot
+	++gen_;
+	return snap;
+}
+
+void TableVersions::releaseGen(uint64_t gen)
+{
+	pw::lockmutex lm(mutex_);
+	GenSet::iterator it = liveGens_.find(gen);
+	if (it != liveGens_.end())
+		liveGens_.erase(it);
+	__atomic_store_n(&minLiveGen_, liveGens_.empty()? (uint64_t)NO_GEN : *liveGens_.begin(), __ATOMIC_RELEASE);
+}
+
+void TableVersions::reclaim()
+{
+	uint64_t minLive = __atomic_load_n(&minLiveGen_, __ATOMIC_ACQUIRE);
+
+	// The removed entries that no live snapshot can see get unlinked.
+	// The snapshots created after this point won't find them in the list.
+	while (!removed_.empty() && removed_.front()->deleteGen_ <= minLive) {
+		Entry *e = removed_.front();
+		removed_.pop_front();
+		Entry *p = e->prev_;
+		Entry *n = e->next_;
+		if (p == NULL)
+			__atomic_store_n(&head_, n, __ATOMIC_RELEASE);
+		else
+			__atomic_store_n(&p->next_, n, __ATOMIC_RELEASE);
+		if (n == NULL)
+			tail_ = p;
+		else
+			n->prev_ = p;
+		// e->next_ stays, for the readers that might be on e right now
+		e->retireGen_ = gen_;
+		retired_.push_back(e);
+	}
+
+	// The snapshots that existed at the time of the unlinking have the
+	// generations below retireGen_. When all of them are gone, nobody
+	// can be on the entry any more.
+	while (!retired_.empty() && retired_.front()->retireGen_ <= minLive) {
+		freeEntry(retired_.front());
+		retired_.pop_front();
+	}
+}
+
+void TableVersions::freeEntry(Entry *e)
+{
+	if (e->row_->decref() <= 0)
+		rowType_->destroyRow(e->row_);
+	delete e;
+	--entryCount_;
+}
+
+////////////////////////////////////// TableSnapshot ////////////////////////////////////
+
+TableSnapshot::TableSnapshot(TableVersions *versions, uint64_t gen, TableVersions::Entry *head, const string &tableName) :
+	versions_(versions),
+	gen_(gen),
+	head_(head),
+	tableName_(tableName),
+	collected_(false)
+{ }
+
+TableSnapshot::~TableSnapshot()
+{
+	versions_->releaseGen(gen_);
+}
+
+const TableSnapshot::RowVec &TableSnapshot::getRows() const
+{
+	if (__atomic_load_n(&collected_, __ATOMIC_ACQUIRE))
+		return rows_;
+
+	pw::lockmutex lm(mutex_);
+	if (!collected_) {
+		// The entries are in the order of the insertion generations,
+		// so the first one that is too new ends the snapshot.
+		for (TableVersions::Entry *e = head_; e != NULL; e = __atomic_load_n(&e->next_, __ATOMIC_ACQUIRE)) {
+			if (e->insertGen_ > gen_)
+				break;
+			if (__atomic_load_n(&e->deleteGen_, __ATOMIC_ACQUIRE) > gen_)
+				rows_.push_back(e->row_);
+		}
+		__atomic_store_n(&collected_, true, __ATOMIC_RELEASE);
+	}
+	return rows_;
+}
+
+void TableSnapshot::dump(Label *lb, Rowop::Opcode op) const
+{
+	const RowType *rt = getRowType();
+	if (!lb->getType()->match(rt))
+		throw Exception::f("The snapshot of the table '%s' can not be sent to the label '%s' with a non-matching row type.",
+			tableName_.c_str(), lb->getName().c_str());
+
+	Unit *unit = lb->getUnitPtr();
+	if (unit == NULL)
+		throw Exception::f("The snapshot of the table '%s' can not be sent to the cleared label '%s'.",
+			tableName_.c_str(), lb->getName().c_str());
+	const RowVec &rows = getRows();
+	for (RowVec::const_iterator it = rows.begin(); it != rows.end(); ++it)
+		unit->call(new Rowop(lb, op, *it));
+}
+
+}; // TRICEPS_NS
@@ -0,0 +1,216 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The immutable snapshot of the table contents, for the readers in other threads.
+
+#ifndef __Triceps_TableSnapshot_h__
+#define __Triceps_TableSnapshot_h__
+
+#include <set>
+#include <deque>
+#include <pw/ptwrap.h>
+#include <mem/Mtarget.h>
+#include <type/RowType.h>
+#include <sched/Rowop.h>
+
+namespace TRICEPS_NS {
+
+class Label;
+class RowHandle;
+class TableSnapshot;
+
+// The multi-version history of the table contents, shared between the
+// table and its snapshots. The table keeps it only after the snapshots
+// have been enabled (see Table::enableSnapshots()).
+//
+// Every row inserted into the table gets an entry at the end of a linked
+// list, stamped with the generation of the insertion. When the row gets
+// removed from the table, its entry gets stamped with the generation of
+// the removal but stays in the list. Taking a snapshot only remembers the
+// current generation and advances it, so it costs O(1) no matter the size
+// of the table. A snapshot of generation G sees the entries inserted at
+// or before G and not removed at or before G.
+//
+// The list is modified only by the owner thread of the table, and read
+// concurrently by any threads through the snapshots, without locking:
+// the new entries get appended with the atomic publication, and the
+// removal generations are stored atomically.
+//
+// The entries of the removed rows are reclaimed by epochs, with the
+// generations playing the role of the epochs. The table tracks the
+// oldest generation of the live snapshots. Once no live snapshot can see
+// a removed entry, the entry gets unlinked from the list, but a reader
+// that started before the unlinking may still be walking through it, so
+// it gets freed only after all the snapshots older than the unlinking
+// are gone. All this work is done by the owner thread, in O(1) amortized
+// per modification. The entry of a row in the table is found through
+// the pointer in its row handle, in the place reserved by the TableType
+// for every table (see TableType::getVersionsOffset()), so no separate
+// per-row index is needed.
+class TableVersions : public Mtarget
+{
+	friend class TableSnapshot;
+public:
+	enum {
+		// the removal generation of the entries still in the table
+		NO_GEN = ~0ULL,
+	};
+
+	// @param rt - type of the rows
+	// @param offset - offset of the entry pointer in the row handles
+	TableVersions(const RowType *rt, intptr_t offset);
+	~TableVersions();
+
+	// The owner's interface.
+	// {
+
+	// Record the insertion of a row into the table.
+	// @param rh - the handle just inserted
+	void inserted(RowHandle *rh);
+
+	// Record the removal of a row from the table.
+	// @param rh - the handle just removed
+	void removed(RowHandle *rh);
+
+	// Start a new snapshot at the current generation.
+	// @param tableName - name of the table, for the information
+	// @return - the snapshot
+	TableSnapshot *makeSnapshot(const string &tableName);
+
+	// Get the number of the entries, including the removed ones not yet
+	// reclaimed. (Mostly for the tests).
+	size_t getEntryCount() const
+	{
+		return entryCount_;
+	}
+	// }
+
+protected:
+	// One version of a row.
+	struct Entry
+	{
+		Row *row_; // holds a reference
+		uint64_t insertGen_; // generation of the insertion
+		uint64_t deleteGen_; // generation of the removal, NO_GEN if still in the table; atomic
+		Entry *next_; // next entry in the list; atomic
+		Entry *prev_; // previous entry in the list; used only by the owner
+		uint64_t retireGen_; // generation of the unlinking; used only by the owner
+	};
+	typedef deque<Entry *> EntryDeque;
+	typedef multiset<uint64_t> GenSet;
+
+	// Unlink and free the entries that can't be seen any more.
+	void reclaim();
+
+	// Free an entry.
+	void freeEntry(Entry *e);
+
+	// Called from the snapshot's destructor, in any thread.
+	// @param gen - generation of the snapshot
+	void releaseGen(uint64_t gen);
+
+	Autoref<const RowType> rowType_;
+	Entry *head_; // the first entry; atomic
+	Entry *tail_; // the last entry; used only by the owner
+	uint64_t gen_; // the current generation
+	size_t entryCount_;
+	intptr_t offset_; // offset of the entry pointer in the row handles
+	EntryDeque removed_; // the removed entries still in the list, in the order of removal
+	EntryDeque retired_; // the unlinked entries waiting to be freed, in the order of unlinking
+	uint64_t minLiveGen_; // the oldest generation of the live snapshots, NO_GEN if none; atomic
+	pw::pmutex mutex_; // protects liveGens_
+	GenSet liveGens_; // the generations of the live snapshots
+
+private:
+	TableVersions(const TableVersions &);
+	void operator=(const TableVersions &);
+};
+
+// A snapshot of the table contents as of the time it was taken. It's
+// created in O(1) by Table::snapshot(), and can then be passed to and read
+// by any number of threads while the owner thread keeps modifying the
+// table: the modifications don't affect the snapshot, and the rows
+// removed from the table stay alive until no snapshot can see them.
+//
+// The rows come in the order of their insertion into the table (a row
+// that has been replaced comes in the position of its replacement).
+// The work of collecting the rows is done on the first access to them,
+// in the reader's thread.
+class TableSnapshot : public Mtarget
+{
+	friend class TableVersions;
+public:
+	typedef vector<const Row *> RowVec;
+
+	~TableSnapshot();
+
+	// Get the type of the rows.
+	const RowType *getRowType() const
+	{
+		return versions_->rowType_;
+	}
+
+	// Get the name of the table where the snapshot was taken.
+	const string &getTableName() const
+	{
+		return tableName_;
+	}
+
+	// Get the number of rows.
+	size_t size() const
+	{
+		return getRows().size();
+	}
+
+	bool empty() const
+	{
+		return getRows().empty();
+	}
+
+	// Get a row by its position.
+	// @param i - index of the row, must be less than size()
+	const Row *at(size_t i) const
+	{
+		return getRows()[i];
+	}
+
+	// Get all the rows, for the iteration. The rows are held by the
+	// snapshot and stay valid as long as it exists.
+	const RowVec &getRows() const;
+
+	// Send the contents of the snapshot to a label, in the unit of that label.
+	// This is the equivalent of Table::dumpAll() for a reader that has
+	// the snapshot of the table in another thread.
+	// May throw an Exception.
+	//
+	// @param lb - label to send to, its row type must be matching
+	// @param op - opcode to use for sending
+	void dump(Label *lb, Rowop::Opcode op = Rowop::OP_INSERT) const;
+
+protected:
+	// Created by the TableVersions only.
+	// @param versions - the history of the table
+	// @param gen - generation of the snapshot
+	// @param head - the first entry in the list at the time of creation
+	// @param tableName - name of the table, for the information
+	TableSnapshot(TableVersions *versions, uint64_t gen, TableVersions::Entry *head, const string &tableName);
+
+	Autoref<TableVersions> versions_;
+	uint64_t gen_;
+	TableVersions::Entry *head_;
+	string tableName_;
+	mutable pw::pmutex mutex_; // protects the collection of rows_
+	mutable bool collected_; // flag: rows_ has been collected; atomic
+	mutable RowVec rows_; // the visible rows, referenced by the entries
+
+private:
+	TableSnapshot(const TableSnapshot &);
+	void operator=(const TableSnapshot &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TableSnapshot_h__
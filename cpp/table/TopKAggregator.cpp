@@ -0,0 +1,171 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps a bounded summary of the most frequent values.
+
+#include <table/TopKAggregator.h>
+#include <table/Table.h>
+#include <sched/AggregatorGadget.h>
+
+namespace TRICEPS_NS {
+
+TopKAggregator::TopKAggregator(const TopKAggregatorType *type) :
+	type_(type),
+	summary_(type->getCapacity()),
+	changed_(false)
+{ }
+
+int TopKAggregator::findSent(const string &key) const
+{
+	for (size_t i = 0; i < sent_.size(); i++) {
+		if (sent_[i].key_ == key)
+			return (int)i;
+	}
+	return -1;
+}
+
+bool TopKAggregator::before(const SpaceSaving::Counter *c, const Place &p) const
+{
+	// the sent count may be stale, the current one is in the summary
+	const SpaceSaving::Counter *pc = summary_.find(p.key_);
+	if (pc == NULL)
+		return true;
+	return SpaceSaving::ranks(c, pc);
+}
+
+void TopKAggregator::addKey(const string &key)
+{
+	const SpaceSaving::Counter *c;
+	string evicted;
+	bool wasEvicted = summary_.add(key, c, evicted);
+	if (changed_)
+		return; // will be recomputed anyway
+
+	if (wasEvicted && findSent(evicted) >= 0) {
+		changed_ = true;
+		return;
+	}
+
+	// the count only grows, so the value can only move up
+	int pos = findSent(key);
+	if (pos > 0)
+		changed_ = before(c, sent_[pos - 1]);
+	else if (pos < 0)
+		changed_ = (sent_.size() < (size_t)type_->k_ || before(c, sent_.back()));
+}
+
+void TopKAggregator::removeKey(const string &key)
+{
+	summary_.remove(key);
+	if (changed_)
+		return; // will be recomputed anyway
+
+	// the count only decreases, so the value can only move down,
+	// and a value outside of the list stays outside
+	int pos = findSent(key);
+	if (pos < 0)
+		return;
+	const SpaceSaving::Counter *c = summary_.find(key);
+	if (c == NULL) {
+		changed_ = true;
+	} else if ((size_t)pos + 1 < sent_.size()) {
+		const SpaceSaving::Counter *next = summary_.find(sent_[pos + 1].key_);
+		changed_ = (next == NULL || before(next, sent_[pos]));
+	} else {
+		// the last place might be taken by a value from outside
+		changed_ = (summary_.size() > sent_.size());
+	}
+}
+
+void TopKAggregator::sendPlace(AggregatorGadget *gadget, Tray *dest, Rowop::Opcode opcode,
+	const string &key, int rank, int64_t count) const
+{
+	const RowType *resrt = type_->getRowType();
+	FdataVec data(3);
+	int32_t r = rank + 1;
+	data[0].setPtr(true, key.data(), key.size());
+	data[1].setPtr(true, &r, sizeof(r));
+	data[2].setPtr(true, &count, sizeof(count));
+	gadget->sendDelayed(dest, Rowref(resrt, resrt->makeRow(data)), opcode);
+}
+
+void TopKAggregator::handle(Table *table, AggregatorGadget *gadget, Index *index,
+	const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+	AggOp aggop, Rowop::Opcode opcode, RowHandle *rh)
+{
+	const RowType *rt = table->getRowType();
+	bool full = (table->getAggregatorCoalesce() != Table::AC_NONE);
+
+	if (aggop == AO_AFTER_INSERT || aggop == AO_AFTER_DELETE) {
+		const char *ptr;
+		intptr_t len;
+		if (rt->getField(rh->getRow(), type_->keyIdx_, ptr, len)) {
+			string key(ptr, len);
+			if (aggop == AO_AFTER_INSERT)
+				addKey(key);
+			else
+				removeKey(key);
+		}
+		if (parentIndexType->groupSize(gh) == 0) {
+			// the counts of the values that were removed while not counted
+			// may be left over, but the group is empty now
+			summary_.clear();
+			changed_ = !sent_.empty();
+		}
+	}
+
+	if (opcode == Rowop::OP_NOP)
+		return;
+
+	if (aggop == AO_BEFORE_MOD || aggop == AO_COLLAPSE) {
+		// the coalescing needs the whole old result,
+		// otherwise the changes get sent after the modification
+		if (full) {
+			for (size_t i = 0; i < sent_.size(); i++)
+				sendPlace(gadget, dest, Rowop::OP_DELETE, sent_[i].key_, i, sent_[i].count_);
+		}
+		return;
+	}
+
+	if (!changed_ && !full)
+		return;
+
+	PlaceVec now;
+	if (changed_) {
+		SpaceSaving::CounterVec top;
+		summary_.top(type_->k_, top);
+		now.resize(top.size());
+		for (size_t i = 0; i < top.size(); i++) {
+			now[i].key_ = top[i]->key_;
+			now[i].count_ = top[i]->count_;
+		}
+		// the places that haven't changed keep the sent counts
+		for (size_t i = 0; i < now.size() && i < sent_.size(); i++) {
+			if (now[i].key_ == sent_[i].key_)
+				now[i].count_ = sent_[i].count_;
+		}
+	} else {
+		now = sent_;
+	}
+
+	if (full) {
+		for (size_t i = 0; i < now.size(); i++)
+			sendPlace(gadget, dest, Rowop::OP_INSERT, now[i].key_, i, now[i].count_);
+	} else {
+		for (size_t i = 0; i < sent_.size(); i++) {
+			if (i >= now.size() || now[i].key_ != sent_[i].key_)
+				sendPlace(gadget, dest, Rowop::OP_DELETE, sent_[i].key_, i, sent_[i].count_);
+		}
+		for (size_t i = 0; i < now.size(); i++) {
+			if (i >= sent_.size() || now[i].key_ != sent_[i].key_)
+				sendPlace(gadget, dest, Rowop::OP_INSERT, now[i].key_, i, now[i].count_);
+		}
+	}
+	sent_.swap(now);
+	changed_ = false;
+}
+
+}; // TRICEPS_NS
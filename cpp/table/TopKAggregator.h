@@ -0,0 +1,70 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps a bounded summary of the most frequent values.
+
+#ifndef __Triceps_TopKAggregator_h__
+#define __Triceps_TopKAggregator_h__
+
+#include <table/Aggregator.h>
+#include <type/TopKAggregatorType.h>
+#include <common/SpaceSaving.h>
+
+namespace TRICEPS_NS {
+
+class RowType;
+
+// The per-group state of TopKAggregatorType.
+class TopKAggregator : public Aggregator
+{
+public:
+	// @param type - type of this aggregator
+	TopKAggregator(const TopKAggregatorType *type);
+
+	// from Aggregator
+	virtual void handle(Table *table, AggregatorGadget *gadget, Index *index,
+		const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		AggOp aggop, Rowop::Opcode opcode, RowHandle *rh);
+
+protected:
+	// A place in the top list, as it has been sent.
+	struct Place
+	{
+		string key_;
+		int64_t count_;
+	};
+	typedef vector<Place> PlaceVec;
+
+	// Count a value and check whether it might change the top list.
+	void addKey(const string &key);
+	// Uncount a value and check whether it might change the top list.
+	void removeKey(const string &key);
+
+	// Find the place of a value in the sent list.
+	// @return - the index in sent_, or -1 if it's not there
+	int findSent(const string &key) const;
+
+	// Check whether a counted value goes before the one at a place.
+	bool before(const SpaceSaving::Counter *c, const Place &p) const;
+
+	// Send the result rows.
+	// @param key - the value
+	// @param rank - the index in the list, from 0
+	// @param count - the count of the value
+	void sendPlace(AggregatorGadget *gadget, Tray *dest, Rowop::Opcode opcode,
+		const string &key, int rank, int64_t count) const;
+
+	const TopKAggregatorType *type_;
+	SpaceSaving summary_; // counts of the values
+	// The top list as it has been sent. As long as changed_ is false,
+	// it's also the current top list.
+	PlaceVec sent_;
+	bool changed_; // flag: the top list might have changed since it's been sent
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TopKAggregator_h__
@@ -0,0 +1,52 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Implementation of a sorted index with a limit on the number of rows.
+
+#include <table/TopNIndex.h>
+
+namespace TRICEPS_NS {
+
+TopNIndex::TopNIndex(const TableType *tabtype, Table *table, const TopNIndexType *mytype, Less *lessop) :
+	TreeIndex(tabtype, table, mytype, lessop),
+	topType_(mytype)
+{ }
+
+bool TopNIndex::replacementPolicy(RowHandle *rh, RhSet &replaced)
+{
+	size_t before = replaced.size();
+	TreeIndex::replacementPolicy(rh, replaced); // the same key gets replaced
+	if (replaced.size() != before)
+		return true; // the size stays the same
+
+	// Check if there is any row already marked for replacement and present in this index, 
+	// then don't push out another one.
+	size_t subtract = 0;
+	for (RhSet::iterator it = replaced.begin(); it != replaced.end(); ++it) {
+		Index *rind = topType_->findInstance(table_, *it);
+		if (rind == this)
+			++subtract; // it belongs here, so a record will be already pushed out
+	}
+
+	if (data_.size() - subtract < topType_->getLimit() || data_.size() < subtract)
+		return true;
+
+	// the worst row is at the end opposite to the kept one
+	RowHandle *worst;
+	if (topType_->isReverse()) {
+		worst = *data_.begin();
+		if (!(*less_)(worst, rh))
+			return false; // the new row is not better than any
+	} else {
+		worst = *data_.rbegin();
+		if (!(*less_)(rh, worst))
+			return false; // the new row is not better than any
+	}
+	replaced.insert(worst);
+	return true;
+}
+
+}; // TRICEPS_NS
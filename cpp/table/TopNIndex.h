@@ -0,0 +1,37 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Implementation of a sorted index with a limit on the number of rows.
+
+#ifndef __Triceps_TopNIndex_h__
+#define __Triceps_TopNIndex_h__
+
+#include <table/TreeIndex.h>
+#include <type/TopNIndexType.h>
+
+namespace TRICEPS_NS {
+
+class TopNIndex: public TreeIndex
+{
+	friend class TopNIndexType;
+
+public:
+	// @param tabtype - type of table where this index belongs
+	// @param table - the actual table where this index belongs
+	// @param mytype - type that created this index
+	// @param lessop - less functor class for the key, this index will keep a reference
+	TopNIndex(const TableType *tabtype, Table *table, const TopNIndexType *mytype, Less *lessop);
+
+	// from Index
+	virtual bool replacementPolicy(RowHandle *rh, RhSet &replaced);
+
+protected:
+	const TopNIndexType *topType_; // same as type_, with the specific type
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TopNIndex_h__
@@ -9,26 +9,33 @@
 #include <table/TreeIndex.h>
 #include <type/TreeIndexType.h>
 #include <type/RowType.h>
+#include <table/IndexBloom.h>
+#include <table/Table.h>
 
 namespace TRICEPS_NS {
 
 //////////////////////////// TreeIndex /////////////////////////
 
-TreeIndex::TreeIndex(const TableType *tabtype, Table *table, const TreeIndexType *mytype, Less *lessop) :
+TreeIndex::TreeIndex(const TableType *tabtype, Table *table, const TreeIndexType *mytype, Less *lessop,
+		IndexBloom *bloom) :
 	Index(tabtype, table),
 	data_(*lessop),
 	type_(mytype),
-	less_(lessop)
+	less_(lessop),
+	bloom_(bloom)
 { }
 
 TreeIndex::~TreeIndex()
 {
 	assert(data_.empty());
+	delete bloom_;
 }
 
 void TreeIndex::clearData()
 {
 	data_.clear();
+	if (bloom_)
+		bloom_->clear();
 }
 
 const IndexType *TreeIndex::getType() const
@@ -92,11 +99,16 @@ const GroupHandle *TreeIndex::toGroup(const RowHandle *cur) const
 
 RowHandle *TreeIndex::find(const RowHandle *what) const
 {
+	if (bloom_ && !bloom_->mayContain(what))
+		return NULL;
+
 	Set::iterator it = data_.find(const_cast<RowHandle *>(what));
 	// fprintf(stderr, "DEBUG TreeIndex::find(this=%p, what=%p) found %p (of %d)\n", this, what, (it == data_.end()?NULL:*it), (int)data_.size());
-	if (it == data_.end())
+	if (it == data_.end()) {
+		if (bloom_)
+			bloom_->falsePositive();
 		return NULL;
-	else
+	} else
 		return (*it);
 }
 
@@ -107,6 +119,14 @@ Index *TreeIndex::findNested(const RowHandle *what, int nestPos) const
 
 bool TreeIndex::replacementPolicy(RowHandle *rh, RhSet &replaced)
 {
+	if (bloom_ && !bloom_->mayContain(rh))
+		return true; // definitely nothing to replace
+
+	// A cheap check for the rows that come in the index order,
+	// when a table gets loaded from a dump.
+	if (table_->isOrderedLoad() && !data_.empty() && data_.key_comp()(*data_.rbegin(), rh))
+		return true; // goes past the end, nothing to replace
+
 	Set::iterator old = data_.find(rh);
 	// XXX for now just silently replace the old value with the same key
 	if (old != data_.end())
@@ -116,9 +136,20 @@ bool TreeIndex::replacementPolicy(RowHandle *rh, RhSet &replaced)
 
 void TreeIndex::insert(RowHandle *rh)
 {
-	pair<Set::iterator, bool> res = data_.insert(const_cast<RowHandle *>(rh));
-	assert(res.second); // must always succeed
-	type_->setIter(rh, res.first);
+	Set::iterator res;
+	if (table_->isOrderedLoad()) {
+		// The hint makes the insertion of the rows coming in the index
+		// order constant-time, and otherwise costs a single comparison.
+		res = data_.insert(data_.end(), const_cast<RowHandle *>(rh));
+		assert(*res == rh); // must always succeed
+	} else {
+		pair<Set::iterator, bool> ins = data_.insert(const_cast<RowHandle *>(rh));
+		assert(ins.second); // must always succeed
+		res = ins.first;
+	}
+	type_->setIter(rh, res);
+	if (bloom_)
+		bloom_->added(rh, data_);
 	// fprintf(stderr, "DEBUG TreeIndex::insert(this=%p, rh=%p, rs=%p)\n", this, rh, type_->getSection(rh));
 }
 
@@ -126,6 +157,8 @@ void TreeIndex::remove(RowHandle *rh)
 {
 	// fprintf(stderr, "DEBUG TreeIndex::remove(this=%p, rh=%p, rs=%p)\n", this, rh, type_->getSection(rh));
 	data_.erase(type_->getIter(rh));
+	if (bloom_)
+		bloom_->removed(data_);
 }
 
 void TreeIndex::aggregateBefore(Tray *dest, const RhSet &rows, const RhSet &already)
@@ -138,6 +171,11 @@ void TreeIndex::aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const RhSet
 	// nothing to do
 }
 
+void TreeIndex::aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh)
+{ 
+	// nothing to do
+}
+
 bool TreeIndex::collapse(Tray *dest, const RhSet &replaced)
 {
 	// fprintf(stderr, "DEBUG TreeIndex::collapse(this=%p, rhset size=%d)\n", this, (int)replaced.size());
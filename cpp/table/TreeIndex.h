@@ -15,6 +15,7 @@
 namespace TRICEPS_NS {
 
 class RowType;
+class IndexBloom;
 
 class TreeIndex: public Index
 {
@@ -30,7 +31,10 @@ public:
 	// @param lessop - less functor class for the key, this index will keep a reference
 	//        (it should be a private copy created from the IndexType's functor and knowing
 	//        about the table, if it ever wants to report any errors)
-	TreeIndex(const TableType *tabtype, Table *table, const TreeIndexType *mytype, Less *lessop);
+	// @param bloom - the Bloom filter for the hashed index, or NULL; the index
+	//        will own it
+	TreeIndex(const TableType *tabtype, Table *table, const TreeIndexType *mytype, Less *lessop,
+		IndexBloom *bloom = NULL);
 	~TreeIndex();
 
 	// from Index
@@ -48,13 +52,21 @@ public:
 	virtual void remove(RowHandle *rh);
 	virtual void aggregateBefore(Tray *dest, const RhSet &rows, const RhSet &already);
 	virtual void aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const RhSet &rows, const RhSet &future);
+	virtual void aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh);
 	virtual bool collapse(Tray *dest, const RhSet &replaced);
 	virtual Index *findNested(const RowHandle *what, int nestPos) const;
 
+	// Get the Bloom filter, if any.
+	const IndexBloom *getBloom() const
+	{
+		return bloom_;
+	}
+
 protected:
 	Set data_; // the data store
 	Autoref<const TreeIndexType> type_; // type of this index
 	Autoref<Less> less_; // the comparator object, index's own copy
+	IndexBloom *bloom_; // the optional Bloom filter, owned by the index
 };
 
 }; // TRICEPS_NS
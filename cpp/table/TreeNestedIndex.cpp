@@ -9,16 +9,19 @@
 #include <table/TreeNestedIndex.h>
 #include <type/TreeIndexType.h>
 #include <type/RowType.h>
+#include <table/IndexBloom.h>
 
 namespace TRICEPS_NS {
 
 //////////////////////////// TreeNestedIndex /////////////////////////
 
-TreeNestedIndex::TreeNestedIndex(const TableType *tabtype, Table *table, const TreeIndexType *mytype, Less *lessop) :
+TreeNestedIndex::TreeNestedIndex(const TableType *tabtype, Table *table, const TreeIndexType *mytype, Less *lessop,
+		IndexBloom *bloom) :
 	Index(tabtype, table),
 	data_(*lessop),
 	type_(mytype),
-	less_(lessop)
+	less_(lessop),
+	bloom_(bloom)
 { }
 
 TreeNestedIndex::~TreeNestedIndex()
@@ -35,6 +38,7 @@ TreeNestedIndex::~TreeNestedIndex()
 		if (gh->decref() <= 0)
 			type_->destroyGroupHandle(gh);
 	}
+	delete bloom_;
 }
 
 void TreeNestedIndex::clearData()
@@ -43,6 +47,13 @@ void TreeNestedIndex::clearData()
 	for (Set::iterator it = data_.begin(); it != data_.end(); ++it) {
 		type_->groupClearData(static_cast<GroupHandle *>(*it));
 	}
+	// The emptied groups stay in the index, so the filter gets
+	// refilled with only their keys, dropping the stale ones.
+	if (bloom_) {
+		bloom_->clear();
+		for (Set::iterator it = data_.begin(); it != data_.end(); ++it)
+			bloom_->added(*it, data_);
+	}
 }
 
 const IndexType *TreeNestedIndex::getType() const
@@ -161,8 +172,12 @@ Index *TreeNestedIndex::findNested(const RowHandle *what, int nestPos) const
 		// fprintf(stderr, "DEBUG TreeNestedIndex::findNested(this=%p) return index %p\n", this, idx);
 		return idx;
 	} else {
+		if (bloom_ && !bloom_->mayContain(what))
+			return NULL;
 		Set::iterator it = data_.find(const_cast<RowHandle *>(what));
 		if (it == data_.end()) {
+			if (bloom_)
+				bloom_->falsePositive();
 			// fprintf(stderr, "DEBUG TreeNestedIndex::findNested(this=%p) return NULL\n", this);
 			return NULL;
 		} else {
@@ -175,7 +190,11 @@ Index *TreeNestedIndex::findNested(const RowHandle *what, int nestPos) const
 
 bool TreeNestedIndex::replacementPolicy(RowHandle *rh, RhSet &replaced)
 {
-	Set::iterator it = data_.find(rh);
+	Set::iterator it;
+	if (bloom_ && !bloom_->mayContain(rh))
+		it = data_.end(); // definitely a new group
+	else
+		it = data_.find(rh);
 	// the result of find() has to be stored now in rh, to avoid look-up on insert
 	type_->setIter(rh, it);
 	GroupHandle *gh;
@@ -187,6 +206,8 @@ bool TreeNestedIndex::replacementPolicy(RowHandle *rh, RhSet &replaced)
 		pair<Set::iterator, bool> res = data_.insert(gh);
 		type_->setIter(rh, res.first);
 		type_->setIter(gh, res.first);
+		if (bloom_)
+			bloom_->added(gh, data_);
 	} else {
 		gh = static_cast<GroupHandle *>(*it);
 	}
@@ -252,6 +273,23 @@ void TreeNestedIndex::aggregateAfter(Tray *dest, Aggregator::AggOp aggop, const
 	}
 }
 
+void TreeNestedIndex::aggregateUpdate(Tray *dest, RowHandle *oldrh, RowHandle *newrh)
+{
+	// both rows are known to still have their groups
+	GroupHandle *oldgh = static_cast<GroupHandle *>(*type_->getIter(oldrh));
+	GroupHandle *newgh = static_cast<GroupHandle *>(*type_->getIter(newrh));
+
+	if (oldgh == newgh) {
+		type_->groupAggregateUpdate(dest, table_, newgh, oldrh, newrh);
+	} else {
+		RhSet oldset, newset, empty;
+		oldset.insert(oldrh);
+		newset.insert(newrh);
+		type_->groupAggregateAfter(dest, Aggregator::AO_AFTER_DELETE, table_, oldgh, oldset, empty);
+		type_->groupAggregateAfter(dest, Aggregator::AO_AFTER_INSERT, table_, newgh, newset, empty);
+	}
+}
+
 bool TreeNestedIndex::collapse(Tray *dest, const RhSet &replaced)
 {
 	// fprintf(stderr, "DEBUG TreeNestedIndex::collapse(this=%p, rhset size=%d)\n", this, (int)replaced.size());
@@ -274,6 +312,8 @@ bool TreeNestedIndex::collapse(Tray *dest, const RhSet &replaced)
 			}
 			// destroy the group
 			data_.erase(type_->getIter(gh)); // after this the iterator in gh is not valid any more
+			if (bloom_)
+				bloom_->removed(data_);
 			if (gh->decref() <= 0)
 				type_->destroyGroupHandle(gh);
 		} else {
@@ -0,0 +1,255 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The additive aggregation in the event-time windows.
+
+#include <stdint.h>
+#include <table/WindowedAggregation.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+////////////////////////////////////// WindowedAggregation::WatermarkLabel ////////////////////////////////////
+
+WindowedAggregation::WatermarkLabel::WatermarkLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name,
+		WindowedAggregation *wa) :
+	Label(unit, rtype, name),
+	wa_(wa)
+{ }
+
+void WindowedAggregation::WatermarkLabel::execute(Rowop *arg) const
+{
+	if (wa_ == NULL)
+		throw Exception::f("Can not send more watermarks to a destroyed windowed aggregation");
+
+	const RowType *rt = getType();
+	if (rt->isFieldNull(arg->getRow(), 0))
+		return;
+	wa_->advanceWatermark(rt->getInt64(arg->getRow(), 0));
+}
+
+////////////////////////////////////// WindowedAggregation ////////////////////////////////////
+
+WindowedAggregation::WindowedAggregation(Unit *unit, const string &name, RowType *rt,
+		const string &timeField, int64_t size, int64_t slide,
+		Onceref<NameSet> key, Onceref<AdditiveAggregatorType> agg) :
+	Gadget(unit, Gadget::EM_CALL, name + ".out"),
+	name_(name),
+	rowType_(rt),
+	keyed_("windowed aggregation", name, rt, key, agg), // checks the aggregator
+	size_(size),
+	slide_(slide),
+	lateness_(0),
+	autoWatermark_(false),
+	watermark_(INT64_MIN),
+	maxTime_(INT64_MIN),
+	lateCount_(0),
+	groupCount_(0)
+{
+	if (size <= 0)
+		throw Exception::fTrace("The windowed aggregation '%s' must have a positive window size, got %lld.",
+			name.c_str(), (long long)size);
+	if (slide <= 0 || slide > size)
+		throw Exception::fTrace("The windowed aggregation '%s' must have the slide in the range 1..%lld (the window size), got %lld.",
+			name.c_str(), (long long)size, (long long)slide);
+
+	timeIdx_ = rt->findIdx(timeField);
+	if (timeIdx_ < 0)
+		throw Exception::fTrace("The windowed aggregation '%s' can not find the time field '%s' in the row type.",
+			name.c_str(), timeField.c_str());
+	const RowType::Field &tf = rt->fields()[timeIdx_];
+	if (tf.type_->getTypeId() != Type::TT_INT64 || tf.arsz_ != RowType::Field::AR_SCALAR)
+		throw Exception::fTrace("The windowed aggregation '%s' requires the time field '%s' to be an int64, not %s%s.",
+			name.c_str(), timeField.c_str(), tf.type_->print().c_str(),
+			(tf.arsz_ == RowType::Field::AR_SCALAR? "" : "[]"));
+
+	const AdditiveAggregatorType *aggType = keyed_.getAggregatorType();
+	const AdditiveAggregatorType::FieldDefVec &fields = aggType->getFields();
+	for (size_t i = 0; i < fields.size(); i++) {
+		const AdditiveAggregatorType::FieldDef &fd = fields[i];
+		if (fd.name_ == "window_start" || fd.name_ == "window_end")
+			throw Exception::fTrace("The windowed aggregation '%s' can not use the reserved name '%s' for an aggregator result field.",
+				name.c_str(), fd.name_.c_str());
+	}
+
+	// the result is the window bounds followed by the aggregator fields
+	RowType::FieldVec resfld;
+	resfld.push_back(RowType::Field("window_start", Type::r_int64));
+	resfld.push_back(RowType::Field("window_end", Type::r_int64));
+	const RowType::FieldVec &aggfld = aggType->getRowType()->fields();
+	resfld.insert(resfld.end(), aggfld.begin(), aggfld.end());
+	Autoref<RowType> restype = rt->newSameFormat(resfld);
+	if (!restype->getErrors().isNull())
+		throw Exception::fTrace(restype->getErrors(), "The windowed aggregation '%s' has an incorrect result row type:",
+			name.c_str());
+	setRowType(restype);
+
+	RowType::FieldVec wmfld;
+	wmfld.push_back(RowType::Field(timeField, Type::r_int64));
+	watermarkType_ = rt->newSameFormat(wmfld);
+
+	inputLabel_ = new InputLabel(unit, rt, name + ".in", this, "windowed aggregation");
+	watermarkLabel_ = new WatermarkLabel(unit, watermarkType_, name + ".watermark", this);
+}
+
+WindowedAggregation::~WindowedAggregation()
+{
+	// prevent them from sending more data
+	inputLabel_->resetTarget();
+	watermarkLabel_->resetGadget();
+
+	for (WindowMap::iterator it = windows_.begin(); it != windows_.end(); ++it)
+		delete it->second;
+}
+
+void WindowedAggregation::setLateness(int64_t lateness)
+{
+	if (lateness < 0)
+		throw Exception::fTrace("The windowed aggregation '%s' must have a non-negative lateness, got %lld.",
+			name_.c_str(), (long long)lateness);
+	lateness_ = lateness;
+	autoWatermark_ = true;
+}
+
+int64_t WindowedAggregation::lastStart(int64_t t) const
+{
+	int64_t q = t / slide_;
+	if (t % slide_ < 0)
+		--q; // round towards the negative infinity
+	return q * slide_;
+}
+
+void WindowedAggregation::insertRow(const Row *row)
+{
+	if (rowType_->isFieldNull(row, timeIdx_))
+		throw Exception::fTrace("The windowed aggregation '%s' received a row with the null time.",
+			name_.c_str());
+	int64_t t = rowType_->getInt64(row, timeIdx_);
+
+	if (lastStart(t) + size_ <= watermark_)
+		++lateCount_; // all the windows of this row are closed
+	for (int64_t start = lastStart(t); start > t - size_; start -= slide_) {
+		if (start + size_ <= watermark_)
+			break; // this and all the earlier windows are closed
+
+		Window *w;
+		WindowMap::iterator wit = windows_.find(start);
+		if (wit == windows_.end()) {
+			w = new Window(&keyed_);
+			windows_[start] = w;
+		} else {
+			w = wit->second;
+		}
+
+		Group *g;
+		GroupMap::iterator git = w->groups_.find(row);
+		if (git == w->groups_.end()) {
+			g = keyed_.makeGroup(row);
+			w->groups_[g->key_.get()] = g;
+			++groupCount_;
+		} else {
+			g = git->second;
+		}
+		keyed_.addRow(g, row);
+	}
+
+	if (t > maxTime_) {
+		maxTime_ = t;
+		if (autoWatermark_)
+			advanceWatermark(maxTime_ - lateness_);
+	}
+}
+
+void WindowedAggregation::deleteRow(const Row *row)
+{
+	if (rowType_->isFieldNull(row, timeIdx_))
+		throw Exception::fTrace("The windowed aggregation '%s' received a row with the null time.",
+			name_.c_str());
+	int64_t t = rowType_->getInt64(row, timeIdx_);
+
+	if (lastStart(t) + size_ <= watermark_) {
+		++lateCount_; // all the windows of this row are closed
+		return;
+	}
+	for (int64_t start = lastStart(t); start > t - size_; start -= slide_) {
+		if (start + size_ <= watermark_)
+			break; // this and all the earlier windows are closed
+
+		WindowMap::iterator wit = windows_.find(start);
+		if (wit == windows_.end())
+			continue;
+		Window *w = wit->second;
+
+		GroupMap::iterator git = w->groups_.find(row);
+		if (git == w->groups_.end())
+			continue;
+		Group *g = git->second;
+		keyed_.removeRow(g, row);
+		if (g->agg_.getRowCount() <= 0) {
+			w->groups_.erase(git);
+			delete g;
+			--groupCount_;
+			if (w->groups_.empty()) {
+				windows_.erase(wit);
+				delete w;
+			}
+		}
+	}
+}
+
+void WindowedAggregation::advanceWatermark(int64_t wm)
+{
+	if (wm <= watermark_)
+		return;
+	watermark_ = wm;
+
+	// the window gets removed from the map before sending, so that the
+	// recursive calls from the output see a consistent state
+	while (!windows_.empty()) {
+		WindowMap::iterator it = windows_.begin();
+		int64_t start = it->first;
+		if (start + size_ > watermark_)
+			break;
+		Window *w = it->second;
+		windows_.erase(it);
+		closeWindow(start, w);
+	}
+}
+
+void WindowedAggregation::flush()
+{
+	if (windows_.empty())
+		return;
+	advanceWatermark(windows_.rbegin()->first + size_);
+}
+
+void WindowedAggregation::closeWindow(int64_t start, Window *w)
+{
+	int64_t end = start + size_;
+	groupCount_ -= w->groups_.size();
+
+	try {
+		for (GroupMap::iterator it = w->groups_.begin(); it != w->groups_.end(); ++it) {
+			Group *g = it->second;
+			Rowref res;
+			keyed_.makeResult(g, res);
+
+			FdataVec data;
+			res.getType()->splitInto(res, data);
+			data.insert(data.begin(), 2, Fdata());
+			data[0].setPtr(true, &start, sizeof(start));
+			data[1].setPtr(true, &end, sizeof(end));
+			Rowref outrow(type_, type_->makeRow(data));
+			send(outrow, Rowop::OP_INSERT);
+		}
+	} catch (Exception e) {
+		delete w;
+		throw;
+	}
+	delete w;
+}
+
+}; // TRICEPS_NS
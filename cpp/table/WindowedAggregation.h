@@ -0,0 +1,280 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// The additive aggregation in the event-time windows.
+
+#ifndef __Triceps_WindowedAggregation_h__
+#define __Triceps_WindowedAggregation_h__
+
+#include <map>
+#include <table/KeyedAdditiveGroups.h>
+#include <sched/Gadget.h>
+
+namespace TRICEPS_NS {
+
+// The WindowedAggregation splits the rows into the windows by the time
+// in a field of the row (the event time, as opposed to the time of arrival),
+// and keeps the state of an AdditiveAggregatorType per key in each window.
+// Like in the AggregationTable, the rows themselves are not kept, so the
+// same limitations on the aggregation functions apply: min, max and
+// count_distinct are not allowed, first and last are allowed only
+// on the key fields.
+//
+// The windows have a size and a slide, both in the units of the time field.
+// The window starts are the multiples of the slide, and a window covers
+// the times start <= t < start+size. If the slide is equal to the size,
+// these are the tumbling windows, each row belongs to exactly one window.
+// If the slide is less than the size, these are the hopping windows, each
+// row belongs to size/slide (rounded up or down) overlapping windows.
+//
+// The results of a window are produced only once, when the window is
+// complete, and that is determined by the watermark: the promise that
+// no more rows with the time below it will come. As soon as the watermark
+// gets to or past the end of a window, the window sends an OP_INSERT with
+// the result of every its key on the output label (getLabel(), inherited
+// from Gadget), and its state gets freed. The windows are sent in the
+// order of their start times, and the keys in a window in the order of the
+// bytes of the key fields.
+//
+// The watermark can be advanced explicitly, by sending a row to the
+// watermark label, or by calling advanceWatermark(). Or it can follow the
+// data automatically, set after every inserted row to the maximal time seen
+// minus the allowed lateness (see setLateness()). Both ways can be used
+// together. The watermark never goes back, an attempt to move it back
+// gets ignored.
+//
+// The rows that arrive for a window after it has been closed by the
+// watermark can't be included any more. They are dropped and counted
+// (see getLateCount()). With the hopping windows a row is dropped only
+// from the closed windows, the still open ones include it.
+//
+// The inserts and deletes on the input label are handled like in the
+// AggregationTable: a delete removes a row that is expected to have been
+// inserted before.
+//
+// The result rows contain the fields "window_start" and "window_end"
+// (of int64) followed by the fields of the aggregator.
+class WindowedAggregation : public Gadget
+{
+public:
+	// The constructor throws an Exception on errors.
+	//
+	// @param unit - the unit where the gadget belongs
+	// @param name - name of the gadget; the input label will be named
+	//        name.in, the watermark label name.watermark and the output
+	//        label name.out
+	// @param rt - row type of the incoming rows
+	// @param timeField - name of the field with the event time, must be int64
+	// @param size - size of the window, > 0
+	// @param slide - the step between the starts of the consecutive
+	//        windows, 0 < slide <= size; equal to size for the tumbling windows
+	// @param key - names of the fields that define the group in a window
+	// @param agg - the aggregator type, gets copied, so the original
+	//        may be reused
+	WindowedAggregation(Unit *unit, const string &name, RowType *rt,
+		const string &timeField, int64_t size, int64_t slide,
+		Onceref<NameSet> key, Onceref<AdditiveAggregatorType> agg);
+	~WindowedAggregation();
+
+	// Get back the gadget name (the output label has ".out" added to it).
+	const string &getName() const
+	{
+		return name_;
+	}
+
+	// Get the type of the incoming rows.
+	const RowType *getRowType() const
+	{
+		return keyed_.getRowType();
+	}
+
+	// Get the type of the result rows.
+	const RowType *getResultType() const
+	{
+		return type_;
+	}
+
+	// Get the initialized aggregator type.
+	const AdditiveAggregatorType *getAggregatorType() const
+	{
+		return keyed_.getAggregatorType();
+	}
+
+	// Get the label for sending the rowops with the data.
+	// The opcodes are handled like in the Table, including OP_UPDATE.
+	Label *getInputLabel() const
+	{
+		return inputLabel_.get();
+	}
+
+	// Get the label for sending the watermarks. Its row type has one
+	// int64 field, named the same as the time field. Any opcode
+	// advances the watermark, the rows with the null time are ignored.
+	Label *getWatermarkLabel() const
+	{
+		return watermarkLabel_.get();
+	}
+
+	// Get the type of the watermark rows.
+	const RowType *getWatermarkType() const
+	{
+		return watermarkType_;
+	}
+
+	int64_t getSize() const
+	{
+		return size_;
+	}
+
+	int64_t getSlide() const
+	{
+		return slide_;
+	}
+
+	// Enable the automatic watermark: after each inserted row the watermark
+	// gets advanced to the maximal time seen so far minus the lateness.
+	// @param lateness - how far behind the latest row the other
+	//        rows may come and still be included; >= 0
+	void setLateness(int64_t lateness);
+
+	// Check whether the automatic watermark is enabled.
+	bool isAutoWatermark() const
+	{
+		return autoWatermark_;
+	}
+
+	int64_t getLateness() const
+	{
+		return lateness_;
+	}
+
+	// Get the current watermark. Before the first one is set, returns INT64_MIN.
+	int64_t getWatermark() const
+	{
+		return watermark_;
+	}
+
+	// Get the maximal time of the rows inserted so far.
+	// Before the first one, returns INT64_MIN.
+	int64_t getMaxTime() const
+	{
+		return maxTime_;
+	}
+
+	// Get the number of the rows that came too late for all their windows.
+	int64_t getLateCount() const
+	{
+		return lateCount_;
+	}
+
+	// Get the number of the open windows that have some state.
+	size_t windowCount() const
+	{
+		return windows_.size();
+	}
+
+	// Get the number of the groups in all the open windows.
+	size_t groupCount() const
+	{
+		return groupCount_;
+	}
+
+	// Add a row to its windows.
+	// May throw an Exception.
+	// @param row - the row to insert
+	void insertRow(const Row *row);
+
+	// Remove a row from its windows.
+	// May throw an Exception.
+	// @param row - the row to delete
+	void deleteRow(const Row *row);
+
+	// Advance the watermark, sending and freeing the windows that
+	// end at or before it.
+	// May throw an Exception.
+	// @param wm - the new watermark, ignored if not above the current one
+	void advanceWatermark(int64_t wm);
+
+	// Send and free all the open windows, as at the end of the data,
+	// advancing the watermark to the end of the last window.
+	void flush();
+
+protected:
+	typedef KeyedAdditiveInputLabel<WindowedAggregation> InputLabel;
+
+	// Receives the watermarks.
+	class WatermarkLabel : public Label
+	{
+	public:
+		WatermarkLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name, WindowedAggregation *wa);
+
+		// when the gadget gets destroyed, it resets this back-link
+		void resetGadget()
+		{
+			wa_ = NULL;
+		}
+
+	protected:
+		// from Label
+		virtual void execute(Rowop *arg) const;
+
+		WindowedAggregation *wa_;
+	};
+
+	typedef KeyedAdditiveGroups::Group Group;
+	typedef KeyedAdditiveGroups::GroupMap GroupMap;
+
+	// The state of one window.
+	class Window
+	{
+	public:
+		Window(const KeyedAdditiveGroups *keyed) :
+			groups_(KeyedAdditiveGroups::KeyLess(keyed))
+		{ }
+		~Window()
+		{
+			KeyedAdditiveGroups::clearGroups(groups_);
+		}
+
+		GroupMap groups_;
+	};
+
+	// the windows by their start time
+	typedef map<int64_t, Window *> WindowMap;
+
+	// Get the start of the latest window that includes the time.
+	int64_t lastStart(int64_t t) const;
+
+	// Send the results of a window and free it.
+	// @param start - start time of the window
+	// @param w - the window, already removed from windows_
+	void closeWindow(int64_t start, Window *w);
+
+	string name_;
+	const_Autoref<RowType> rowType_;
+	const_Autoref<RowType> watermarkType_;
+	KeyedAdditiveGroups keyed_; // the definition of the groups
+	int timeIdx_; // index of the time field
+	int64_t size_;
+	int64_t slide_;
+	int64_t lateness_;
+	bool autoWatermark_;
+	int64_t watermark_;
+	int64_t maxTime_;
+	int64_t lateCount_;
+	size_t groupCount_;
+	Autoref<InputLabel> inputLabel_;
+	Autoref<WatermarkLabel> watermarkLabel_;
+	WindowMap windows_;
+
+private:
+	WindowedAggregation(const WindowedAggregation &);
+	void operator=(const WindowedAggregation &);
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_WindowedAggregation_h__
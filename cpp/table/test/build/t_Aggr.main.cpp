@@ -0,0 +1,64 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase stringConst;
+	driver.addcase(stringConst, "stringConst");
+
+	extern Utest::Testcase badName;
+	driver.addcase(badName, "badName");
+
+	extern Utest::Testcase tableops;
+	driver.addcase(tableops, "tableops");
+
+	extern Utest::Testcase tableops_fret;
+	driver.addcase(tableops_fret, "tableops_fret");
+
+	extern Utest::Testcase bad_fret;
+	driver.addcase(bad_fret, "bad_fret");
+
+	extern Utest::Testcase aggLast;
+	driver.addcase(aggLast, "aggLast");
+
+	extern Utest::Testcase aggBasicSum;
+	driver.addcase(aggBasicSum, "aggBasicSum");
+
+	extern Utest::Testcase aggSum;
+	driver.addcase(aggSum, "aggSum");
+
+	extern Utest::Testcase aggSumBad;
+	driver.addcase(aggSumBad, "aggSumBad");
+
+	extern Utest::Testcase aggAdditive;
+	driver.addcase(aggAdditive, "aggAdditive");
+
+	extern Utest::Testcase aggAdditiveRandom;
+	driver.addcase(aggAdditiveRandom, "aggAdditiveRandom");
+
+	extern Utest::Testcase aggAdditiveWindow;
+	driver.addcase(aggAdditiveWindow, "aggAdditiveWindow");
+
+	extern Utest::Testcase aggAdditiveQuantile;
+	driver.addcase(aggAdditiveQuantile, "aggAdditiveQuantile");
+
+	extern Utest::Testcase aggAdditiveDistinct;
+	driver.addcase(aggAdditiveDistinct, "aggAdditiveDistinct");
+
+	extern Utest::Testcase aggAdditiveBad;
+	driver.addcase(aggAdditiveBad, "aggAdditiveBad");
+
+	extern Utest::Testcase aggCoalesce;
+	driver.addcase(aggCoalesce, "aggCoalesce");
+
+	extern Utest::Testcase aggTopK;
+	driver.addcase(aggTopK, "aggTopK");
+
+	extern Utest::Testcase aggTopKEmptyKey;
+	driver.addcase(aggTopKEmptyKey, "aggTopKEmptyKey");
+
+	return driver.run();
+}
@@ -0,0 +1,22 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase aggTableBasic;
+	driver.addcase(aggTableBasic, "aggTableBasic");
+
+	extern Utest::Testcase aggTableSame;
+	driver.addcase(aggTableSame, "aggTableSame");
+
+	extern Utest::Testcase aggTableQuantile;
+	driver.addcase(aggTableQuantile, "aggTableQuantile");
+
+	extern Utest::Testcase aggTableErrors;
+	driver.addcase(aggTableErrors, "aggTableErrors");
+
+	return driver.run();
+}
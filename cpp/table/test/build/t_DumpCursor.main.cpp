@@ -0,0 +1,16 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase cursorSteps;
+	driver.addcase(cursorSteps, "cursorSteps");
+
+	extern Utest::Testcase cursorErrors;
+	driver.addcase(cursorErrors, "cursorErrors");
+
+	return driver.run();
+}
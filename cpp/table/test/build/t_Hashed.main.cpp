@@ -0,0 +1,31 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase primaryIndex;
+	driver.addcase(primaryIndex, "primaryIndex");
+
+	extern Utest::Testcase uninitialized;
+	driver.addcase(uninitialized, "uninitialized");
+
+	extern Utest::Testcase withError;
+	driver.addcase(withError, "withError");
+
+	extern Utest::Testcase tableops;
+	driver.addcase(tableops, "tableops");
+
+	extern Utest::Testcase findBatch;
+	driver.addcase(findBatch, "findBatch");
+
+	extern Utest::Testcase bloom;
+	driver.addcase(bloom, "bloom");
+
+	extern Utest::Testcase bloomNested;
+	driver.addcase(bloomNested, "bloomNested");
+
+	return driver.run();
+}
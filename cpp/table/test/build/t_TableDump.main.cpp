@@ -0,0 +1,19 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase dumpLoad;
+	driver.addcase(dumpLoad, "dumpLoad");
+
+	extern Utest::Testcase loadErrors;
+	driver.addcase(loadErrors, "loadErrors");
+
+	extern Utest::Testcase imageCheck;
+	driver.addcase(imageCheck, "imageCheck");
+
+	return driver.run();
+}
@@ -0,0 +1,19 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase journalReplay;
+	driver.addcase(journalReplay, "journalReplay");
+
+	extern Utest::Testcase journalCheckpoint;
+	driver.addcase(journalCheckpoint, "journalCheckpoint");
+
+	extern Utest::Testcase journalErrors;
+	driver.addcase(journalErrors, "journalErrors");
+
+	return driver.run();
+}
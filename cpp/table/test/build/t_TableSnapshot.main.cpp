@@ -0,0 +1,19 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase snapshotBasic;
+	driver.addcase(snapshotBasic, "snapshotBasic");
+
+	extern Utest::Testcase snapshotReclaim;
+	driver.addcase(snapshotReclaim, "snapshotReclaim");
+
+	extern Utest::Testcase snapshotThreads;
+	driver.addcase(snapshotThreads, "snapshotThreads");
+
+	return driver.run();
+}
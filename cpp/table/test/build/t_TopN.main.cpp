@@ -0,0 +1,16 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase topN;
+	driver.addcase(topN, "topN");
+
+	extern Utest::Testcase topNErrors;
+	driver.addcase(topNErrors, "topNErrors");
+
+	return driver.run();
+}
@@ -0,0 +1,22 @@
+
+#include <utest/Utest.h>
+
+int main(int ac, char **av)
+{
+	Utest driver(ac, av);
+
+
+	extern Utest::Testcase tumbling;
+	driver.addcase(tumbling, "tumbling");
+
+	extern Utest::Testcase hopping;
+	driver.addcase(hopping, "hopping");
+
+	extern Utest::Testcase windowFree;
+	driver.addcase(windowFree, "windowFree");
+
+	extern Utest::Testcase windowErrors;
+	driver.addcase(windowErrors, "windowErrors");
+
+	return driver.run();
+}
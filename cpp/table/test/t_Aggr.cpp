@@ -8,6 +8,7 @@
 
 #include <utest/Utest.h>
 #include <string.h>
+#include <math.h>
 
 #include <type/AllTypes.h>
 #include <common/StringUtil.h>
@@ -1164,3 +1165,890 @@ UTESTCASE aggSumBad(Utest *utest)
 		);
 	}
 }
+
+// a label that prints the results of the additive aggregator
+class AddResultLabel : public Label
+{
+public:
+	AddResultLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name = "") :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		const RowType *rt = getType();
+		const Row *row = arg->getRow();
+		res_.append(Rowop::opcodeString(arg->getOpcode()));
+		res_.append(strprintf(" %s", rt->getString(row, 0)));
+		res_.append(strprintf(" n=%d", (int)rt->getInt64(row, 1)));
+		res_.append(strprintf(" cnt=%d", (int)rt->getInt64(row, 2)));
+		res_.append(strprintf(" s=%d", (int)rt->getInt64(row, 3)));
+		if (rt->isFieldNull(row, 4))
+			res_.append(" av=-");
+		else
+			res_.append(strprintf(" av=%g", rt->getFloat64(row, 4)));
+		if (rt->isFieldNull(row, 5))
+			res_.append(" mn=- mx=-");
+		else
+			res_.append(strprintf(" mn=%d mx=%d", (int)rt->getInt64(row, 5), (int)rt->getInt64(row, 6)));
+		res_.append(strprintf(" sd=%g", rt->getFloat64(row, 7)));
+		res_.append(strprintf(" fc=%d\n", (int)rt->getInt64(row, 8)));
+	}
+
+	mutable string res_;
+};
+
+Onceref<TableType> mkAddTabType(Onceref<RowType> rt)
+{
+	return TableType::make(rt)
+		->addSubIndex("primary", HashedIndexType::make( // the default index
+				NameSet::make()->add("c")
+			)
+		)
+		->addSubIndex("byE", HashedIndexType::make(
+				NameSet::make()->add("e")
+			)->addSubIndex("Fifo", FifoIndexType::make()
+				->setAggregator((new AdditiveAggregatorType("aggr"))
+					->addField("e", "last", "e")
+					->addField("n", "count_star")
+					->addField("cnt", "count", "c")
+					->addField("s", "sum", "c")
+					->addField("av", "avg", "c")
+					->addField("mn", "min", "c")
+					->addField("mx", "max", "c")
+					->addField("sd", "sum", "d")
+					->addField("fc", "first", "c")
+				)
+			)
+		);
+}
+
+// the incrementally computed functions
+UTESTCASE aggAdditive(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TableType> tt = mkAddTabType(rt1);
+	tt->initialize();
+	if (UT_ASSERT(tt->getErrors().isNull())) {
+		printf("errors:\n%s", tt->getErrors()->print().c_str());
+		return;
+	}
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Label *aggl = t->getAggregatorLabel("aggr");
+	UT_ASSERT(aggl != NULL);
+	UT_IS(aggl->getType()->print(NOINDENT),
+		"row { string e, int64 n, int64 cnt, int64 s, float64 av, int64 mn, int64 mx, float64 sd, int64 fc, }");
+	Autoref<AddResultLabel> res = new AddResultLabel(unit, aggl->getType(), "res");
+	aggl->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	int64_t ival;
+	dv[2].setPtr(true, &ival, sizeof(ival));
+	double dval;
+	dv[3].setPtr(true, &dval, sizeof(dval));
+	char sval[2] = "A";
+	dv[4].setPtr(true, &sval, sizeof(sval));
+
+	int64_t vals[] = { 5, 3, 8, 4 };
+	for (int i = 0; i < 4; i++) {
+		ival = vals[i];
+		dval = 0.5;
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	}
+	// a different group, with the null c and the matching d
+	sval[0] = 'B';
+	dv[2].setNull();
+	dval = 1.25;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	dv[2].setPtr(true, &ival, sizeof(ival));
+	sval[0] = 'A';
+
+	// delete the maximum, then the minimum, then a middle value
+	ival = 8;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	ival = 3;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	ival = 5;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	// the replacement within the group goes through handleUpdate()
+	ival = 4;
+	dval = 2.;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	// the group becomes empty
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	unit->drainFrame();
+
+	string expect =
+		"OP_INSERT A n=1 cnt=1 s=5 av=5 mn=5 mx=5 sd=0.5 fc=5\n"
+		"OP_DELETE A n=1 cnt=1 s=5 av=5 mn=5 mx=5 sd=0.5 fc=5\n"
+		"OP_INSERT A n=2 cnt=2 s=8 av=4 mn=3 mx=5 sd=1 fc=5\n"
+		"OP_DELETE A n=2 cnt=2 s=8 av=4 mn=3 mx=5 sd=1 fc=5\n"
+		"OP_INSERT A n=3 cnt=3 s=16 av=5.33333 mn=3 mx=8 sd=1.5 fc=5\n"
+		"OP_DELETE A n=3 cnt=3 s=16 av=5.33333 mn=3 mx=8 sd=1.5 fc=5\n"
+		"OP_INSERT A n=4 cnt=4 s=20 av=5 mn=3 mx=8 sd=2 fc=5\n"
+		"OP_INSERT B n=1 cnt=0 s=0 av=- mn=- mx=- sd=1.25 fc=0\n"
+		"OP_DELETE A n=4 cnt=4 s=20 av=5 mn=3 mx=8 sd=2 fc=5\n"
+		"OP_INSERT A n=3 cnt=3 s=12 av=4 mn=3 mx=5 sd=1.5 fc=5\n"
+		"OP_DELETE A n=3 cnt=3 s=12 av=4 mn=3 mx=5 sd=1.5 fc=5\n"
+		"OP_INSERT A n=2 cnt=2 s=9 av=4.5 mn=4 mx=5 sd=1 fc=5\n"
+		"OP_DELETE A n=2 cnt=2 s=9 av=4.5 mn=4 mx=5 sd=1 fc=5\n"
+		"OP_INSERT A n=1 cnt=1 s=4 av=4 mn=4 mx=4 sd=0.5 fc=4\n"
+		"OP_DELETE A n=1 cnt=1 s=4 av=4 mn=4 mx=4 sd=0.5 fc=4\n"
+		"OP_INSERT A n=1 cnt=1 s=4 av=4 mn=4 mx=4 sd=2 fc=4\n"
+		"OP_DELETE A n=1 cnt=1 s=4 av=4 mn=4 mx=4 sd=2 fc=4\n"
+	;
+	if (UT_IS(res->res_, expect)) printf("Expected: \"%s\"\n", expect.c_str());
+}
+
+// the result matches the group iteration after the random changes
+UTESTCASE aggAdditiveRandom(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TableType> tt = mkAddTabType(rt1);
+	tt->initialize();
+	UT_ASSERT(tt->getErrors().isNull());
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Label *aggl = t->getAggregatorLabel("aggr");
+	Autoref<AddResultLabel> res = new AddResultLabel(unit, aggl->getType(), "res");
+	aggl->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	int64_t ival;
+	dv[2].setPtr(true, &ival, sizeof(ival));
+	double dval = 1.;
+	dv[3].setPtr(true, &dval, sizeof(dval));
+	char sval[2] = "A";
+	dv[4].setPtr(true, &sval, sizeof(sval));
+
+	srandom(1);
+	for (int i = 0; i < 2000; i++) {
+		ival = random() % 100;
+		if (random() % 3 == 0)
+			t->deleteRow(Rowref(rt1, rt1->makeRow(dv)));
+		else
+			t->insertRow(Rowref(rt1, rt1->makeRow(dv)));
+	}
+	unit->drainFrame();
+
+	// compute the same by iterating
+	IndexType *ixt = tt->findSubIndex("byE")->findSubIndex("Fifo");
+	int64_t n = 0, s = 0, mn = 0, mx = 0;
+	for (RowHandle *rh = t->beginIdx(ixt); rh != NULL; rh = t->nextIdx(ixt, rh)) {
+		int64_t c = rt1->getInt64(rh->getRow(), 2);
+		if (n == 0 || c < mn)
+			mn = c;
+		if (n == 0 || c > mx)
+			mx = c;
+		s += c;
+		n++;
+	}
+	UT_ASSERT(n > 0);
+
+	// the last line has the current state of the group
+	size_t pos = res->res_.rfind("OP_INSERT ");
+	UT_ASSERT(pos != string::npos);
+	string last = res->res_.substr(pos);
+	string expect = strprintf("OP_INSERT A n=%d cnt=%d s=%d", (int)n, (int)n, (int)s);
+	UT_IS(last.substr(0, expect.size()), expect);
+	UT_ASSERT(last.find(strprintf(" mn=%d mx=%d ", (int)mn, (int)mx)) != string::npos);
+}
+
+// remembers the last result inserted
+class LastRowLabel : public Label
+{
+public:
+	LastRowLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name = "") :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		if (arg->isInsert())
+			last_ = arg;
+		else
+			last_ = NULL;
+	}
+
+	mutable Autoref<Rowop> last_;
+};
+
+// min and max in a sliding window
+UTESTCASE aggAdditiveWindow(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	for (int rev = 0; rev < 2; rev++) {
+		Autoref<TableType> tt = TableType::make(rt1)
+			->addSubIndex("win", FifoIndexType::make(5, false, rev)
+				->setAggregator((new AdditiveAggregatorType("aggr"))
+					->addField("n", "count_star")
+					->addField("s", "sum", "c")
+					->addField("mn", "min", "c")
+					->addField("mx", "max", "c")
+					->addField("dn", "min", "d")
+					->addField("dx", "max", "d")
+				)
+			);
+		tt->initialize();
+		UT_ASSERT(tt->getErrors().isNull());
+		const AdditiveAggregatorType *agt = static_cast<const AdditiveAggregatorType *>(
+			tt->findSubIndex("win")->getAggregator());
+		UT_ASSERT(agt->isWindowed());
+
+		Autoref<Table> t = tt->makeTable(unit, "t");
+		Label *aggl = t->getAggregatorLabel("aggr");
+		Autoref<LastRowLabel> res = new LastRowLabel(unit, aggl->getType(), "res");
+		aggl->chain(res);
+
+		FdataVec dv;
+		mkfdata(dv);
+		int64_t ival;
+		dv[2].setPtr(true, &ival, sizeof(ival));
+		double dval;
+		dv[3].setPtr(true, &dval, sizeof(dval));
+
+		srandom(3);
+		for (int i = 0; i < 3000; i++) {
+			ival = random() % 20;
+			dval = (double)(random() % 20);
+			if (random() % 10 == 0)
+				dv[3].setNull(); // the nulls don't participate in min and max
+			if (random() % 8 == 0)
+				t->deleteRow(Rowref(rt1, rt1->makeRow(dv))); // often from the middle
+			else
+				t->insertRow(Rowref(rt1, rt1->makeRow(dv)));
+			dv[3].setPtr(true, &dval, sizeof(dval));
+
+			// compute the same by iterating
+			int64_t n = 0, s = 0, mn = 0, mx = 0;
+			double dn = 0., dx = 0.;
+			int dcnt = 0;
+			for (RowHandle *rh = t->begin(); rh != NULL; rh = t->next(rh)) {
+				const Row *row = rh->getRow();
+				int64_t c = rt1->getInt64(row, 2);
+				if (n == 0 || c < mn)
+					mn = c;
+				if (n == 0 || c > mx)
+					mx = c;
+				s += c;
+				n++;
+				if (!rt1->isFieldNull(row, 3)) {
+					double d = rt1->getFloat64(row, 3);
+					if (dcnt == 0 || d < dn)
+						dn = d;
+					if (dcnt == 0 || d > dx)
+						dx = d;
+					dcnt++;
+				}
+			}
+
+			const RowType *art = aggl->getType();
+			const Row *last = res->last_.isNull()? NULL : res->last_->getRow();
+			if (n == 0) {
+				if (UT_ASSERT(last == NULL))
+					return;
+				continue;
+			}
+			if (UT_ASSERT(last != NULL))
+				return;
+			if (UT_IS(art->getInt64(last, 0), n)
+			|| UT_IS(art->getInt64(last, 1), s)
+			|| UT_IS(art->getInt64(last, 2), mn)
+			|| UT_IS(art->getInt64(last, 3), mx))
+				return;
+			if (dcnt == 0) {
+				if (UT_ASSERT(art->isFieldNull(last, 4) && art->isFieldNull(last, 5)))
+					return;
+			} else {
+				if (UT_IS(art->getFloat64(last, 4), dn)
+				|| UT_IS(art->getFloat64(last, 5), dx))
+					return;
+			}
+		}
+	}
+}
+
+// the approximate quantiles
+UTESTCASE aggAdditiveQuantile(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	AdditiveAggregatorType *agt = (new AdditiveAggregatorType("aggr"))
+		->addField("n", "count_star")
+		->addField("med", "quantile", "c")
+		->addQuantile("p90", "d", 0.9, 50)
+	;
+	UT_IS(agt->print(NOINDENT), "aggregator additive ( n = count_star(), med = quantile(c, 0.5, 200), p90 = quantile(d, 0.9, 50), ) aggr");
+
+	Autoref<TableType> tt = TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("c")
+			)
+		)
+		->addSubIndex("byE", HashedIndexType::make(
+				NameSet::make()->add("e")
+			)->addSubIndex("Fifo", FifoIndexType::make()
+				->setAggregator(agt)
+			)
+		);
+	tt->initialize();
+	if (UT_ASSERT(tt->getErrors().isNull())) {
+		printf("errors:\n%s", tt->getErrors()->print().c_str());
+		return;
+	}
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Label *aggl = t->getAggregatorLabel("aggr");
+	UT_IS(aggl->getType()->print(NOINDENT), "row { int64 n, float64 med, float64 p90, }");
+	Autoref<LastRowLabel> res = new LastRowLabel(unit, aggl->getType(), "res");
+	aggl->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	int64_t ival;
+	dv[2].setPtr(true, &ival, sizeof(ival));
+	double dval;
+	dv[3].setPtr(true, &dval, sizeof(dval));
+	char sval[2] = "A";
+	dv[4].setPtr(true, &sval, sizeof(sval));
+
+	// a shuffled sequence 0..n-1
+	const int n = 5000;
+	vector<int> perm(n);
+	for (int i = 0; i < n; i++)
+		perm[i] = i;
+	srandom(4);
+	for (int i = n - 1; i > 0; i--)
+		swap(perm[i], perm[random() % (i + 1)]);
+
+	for (int i = 0; i < n; i++) {
+		ival = perm[i];
+		dval = perm[i] * 0.5;
+		t->insertRow(Rowref(rt1, rt1->makeRow(dv)));
+	}
+	const RowType *art = aggl->getType();
+	const Row *last = res->last_->getRow();
+	UT_IS(art->getInt64(last, 0), n);
+	UT_ASSERT(fabs(art->getFloat64(last, 1) - 0.5 * n) < 0.02 * n);
+	UT_ASSERT(fabs(art->getFloat64(last, 2) - 0.45 * n) < 0.05 * n);
+
+	// delete the lower 3/4, that forces the rebuild from the rows
+	for (int i = 0; i < n; i++) {
+		if (perm[i] >= n * 3 / 4)
+			continue;
+		ival = perm[i];
+		dval = perm[i] * 0.5;
+		t->deleteRow(Rowref(rt1, rt1->makeRow(dv)));
+	}
+	last = res->last_->getRow();
+	UT_IS(art->getInt64(last, 0), n / 4);
+	UT_ASSERT(fabs(art->getFloat64(last, 1) - 0.875 * n) < 0.01 * n);
+	UT_ASSERT(fabs(art->getFloat64(last, 2) - 0.4875 * n) < 0.02 * n);
+
+	// the bad quantile parameters
+	Autoref<AdditiveAggregatorType> agbad = (new AdditiveAggregatorType("aggr"))
+		->addQuantile("x", "c", 1.5)
+		->addQuantile("y", "d", 0.5, 2)
+	;
+	tt = TableType::make(rt1)
+		->addSubIndex("Fifo", FifoIndexType::make()
+			->setAggregator(agbad)
+		);
+	tt->initialize();
+	UT_IS(tt->getErrors()->print(),
+		"index error:\n"
+		"  nested index 1 'Fifo':\n"
+		"    aggregator 'aggr':\n"
+		"      The quantile 1.5 in the result field 'x' must be between 0 and 1.\n"
+		"      The accuracy 2 of the quantile in the result field 'y' must be at least 8.\n"
+	);
+}
+
+// the approximate distinct count
+UTESTCASE aggAdditiveDistinct(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	AdditiveAggregatorType *agt = (new AdditiveAggregatorType("aggr"))
+		->addField("n", "count_star")
+		->addField("dc", "count_distinct", "c")
+		->addCountDistinct("dd", "d", 8)
+	;
+	UT_IS(agt->print(NOINDENT), "aggregator additive ( n = count_star(), dc = count_distinct(c, 12), dd = count_distinct(d, 8), ) aggr");
+
+	Autoref<TableType> tt = TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")->add("c")
+			)
+		)
+		->addSubIndex("byE", HashedIndexType::make(
+				NameSet::make()->add("e")
+			)->addSubIndex("Fifo", FifoIndexType::make()
+				->setAggregator(agt)
+			)
+		);
+	tt->initialize();
+	if (UT_ASSERT(tt->getErrors().isNull())) {
+		printf("errors:\n%s", tt->getErrors()->print().c_str());
+		return;
+	}
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Label *aggl = t->getAggregatorLabel("aggr");
+	UT_IS(aggl->getType()->print(NOINDENT), "row { int64 n, int64 dc, int64 dd, }");
+	Autoref<LastRowLabel> res = new LastRowLabel(unit, aggl->getType(), "res");
+	aggl->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	int32_t bval;
+	dv[1].setPtr(true, &bval, sizeof(bval));
+	int64_t ival;
+	dv[2].setPtr(true, &ival, sizeof(ival));
+	double dval;
+	dv[3].setPtr(true, &dval, sizeof(dval));
+	char sval[2] = "A";
+	dv[4].setPtr(true, &sval, sizeof(sval));
+
+	// each value of c repeats 3 times, d has only 3 values
+	const int n = 1000;
+	for (bval = 0; bval < 3; bval++) {
+		for (int i = 0; i < n; i++) {
+			ival = i;
+			dval = bval;
+			t->insertRow(Rowref(rt1, rt1->makeRow(dv)));
+		}
+	}
+	const RowType *art = aggl->getType();
+	const Row *last = res->last_->getRow();
+	UT_IS(art->getInt64(last, 0), 3 * n);
+	UT_ASSERT(fabs((double)art->getInt64(last, 1) - n) < 0.05 * n);
+	UT_IS(art->getInt64(last, 2), 3);
+
+	// delete the upper half of c, that forces the rebuild from the rows
+	for (bval = 0; bval < 3; bval++) {
+		for (int i = n / 2; i < n; i++) {
+			ival = i;
+			dval = bval;
+			t->deleteRow(Rowref(rt1, rt1->makeRow(dv)));
+		}
+	}
+	last = res->last_->getRow();
+	UT_IS(art->getInt64(last, 0), 3 * n / 2);
+	UT_ASSERT(fabs((double)art->getInt64(last, 1) - n / 2) < 0.05 * n / 2);
+	UT_IS(art->getInt64(last, 2), 3);
+
+	// the bad precision
+	Autoref<AdditiveAggregatorType> agbad = (new AdditiveAggregatorType("aggr"))
+		->addCountDistinct("x", "c", 2)
+	;
+	tt = TableType::make(rt1)
+		->addSubIndex("Fifo", FifoIndexType::make()
+			->setAggregator(agbad)
+		);
+	tt->initialize();
+	UT_IS(tt->getErrors()->print(),
+		"index error:\n"
+		"  nested index 1 'Fifo':\n"
+		"    aggregator 'aggr':\n"
+		"      The precision 2 of the count_distinct in the result field 'x' must be between 4 and 16.\n"
+	);
+}
+
+// error detection in AdditiveAggregatorType
+UTESTCASE aggAdditiveBad(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TableType> tt = TableType::make(rt1)
+		->addSubIndex("Hashed", HashedIndexType::make(
+				NameSet::make()->add("e")
+			)->addSubIndex("Fifo", FifoIndexType::make()
+				->setAggregator((new AdditiveAggregatorType("aggr"))
+					->addField("x", "median", "c")
+					->addField("y", "sum", "e")
+					->addField("z", "min", "b")
+					->addField("w", "count_star", "c")
+					->addField("v", "max", "zz")
+				)
+			)
+		);
+
+	tt->initialize();
+	string msg = tt->getErrors()->print();
+	UT_IS(msg,
+		"index error:\n"
+		"  nested index 1 'Hashed':\n"
+		"    nested index 1 'Fifo':\n"
+		"      aggregator 'aggr':\n"
+		"        Unknown function 'median' in the result field 'x'.\n"
+		"        The function 'sum' in the result field 'y' requires a numeric scalar argument, the field 'e' is 'string'.\n"
+		"        The function 'min' in the result field 'z' requires a numeric scalar argument, the field 'b' is 'int32[]'.\n"
+		"        The function 'count_star' in the result field 'w' must have no argument, got 'c'.\n"
+		"        Unknown argument field 'zz' in the result field 'v', the row type is:\n"
+		"          row {\n"
+		"            uint8[10] a,\n"
+		"            int32[] b,\n"
+		"            int64 c,\n"
+		"            float64 d,\n"
+		"            string e,\n"
+		"          }\n"
+	);
+
+	// the printing of the type
+	AdditiveAggregatorType *agt = new AdditiveAggregatorType("aggr");
+	Autoref<AggregatorType> agref = agt;
+	agt->addField("n", "count_star")->addField("s", "sum", "c");
+	UT_IS(agt->print(NOINDENT), "aggregator additive ( n = count_star(), s = sum(c), ) aggr");
+
+	Autoref<AggregatorType> agcopy = agt->copy();
+	UT_ASSERT(agt->equals(agcopy));
+	agt->addField("m", "max", "c");
+	UT_ASSERT(!agt->equals(agcopy));
+}
+
+// the coalesced results of the aggregators
+UTESTCASE aggCoalesce(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TableType> tt = mkAddTabType(rt1);
+	tt->initialize();
+	UT_ASSERT(tt->getErrors().isNull());
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Label *aggl = t->getAggregatorLabel("aggr");
+	Autoref<AddResultLabel> res = new AddResultLabel(unit, aggl->getType(), "res");
+	aggl->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	int64_t ival;
+	dv[2].setPtr(true, &ival, sizeof(ival));
+	double dval = 0.5;
+	dv[3].setPtr(true, &dval, sizeof(dval));
+	char sval[2] = "A";
+	dv[4].setPtr(true, &sval, sizeof(sval));
+
+	UT_IS(t->getAggregatorCoalesce(), Table::AC_NONE);
+	t->setAggregatorCoalesce(Table::AC_FLUSH);
+	UT_IS(t->getAggregatorCoalesce(), Table::AC_FLUSH);
+
+	int64_t vals[] = { 5, 3, 8 };
+	for (int i = 0; i < 3; i++) {
+		ival = vals[i];
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	}
+	unit->drainFrame();
+	UT_IS(res->res_, "");
+	UT_IS(t->getCoalescedCount(), 1);
+	t->flushAggregators();
+	UT_IS(t->getCoalescedCount(), 0);
+	UT_IS(res->res_, "OP_INSERT A n=3 cnt=3 s=16 av=5.33333 mn=3 mx=8 sd=1.5 fc=5\n");
+	res->res_.clear();
+
+	// a new group B, modifications in A, and a group C that comes and goes
+	sval[0] = 'B';
+	dval = 1.25;
+	ival = 1;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	sval[0] = 'A';
+	dval = 0.5;
+	ival = 8;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	ival = 4;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	sval[0] = 'C';
+	ival = 7;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	sval[0] = 'B';
+	dval = 1.25;
+	ival = 2;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(t->getCoalescedCount(), 3);
+	t->flushAggregators();
+	UT_IS(res->res_,
+		"OP_INSERT B n=2 cnt=2 s=3 av=1.5 mn=1 mx=2 sd=2.5 fc=1\n"
+		"OP_DELETE A n=3 cnt=3 s=16 av=5.33333 mn=3 mx=8 sd=1.5 fc=5\n"
+		"OP_INSERT A n=3 cnt=3 s=12 av=4 mn=3 mx=5 sd=1.5 fc=5\n"
+	);
+	res->res_.clear();
+
+	// the result that ends up unchanged is not sent
+	sval[0] = 'A';
+	dval = 0.5;
+	ival = 9;
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(t->getCoalescedCount(), 1);
+	t->flushAggregators();
+	UT_IS(res->res_, "");
+
+	// the flush gets scheduled to the end of the outer frame
+	t->setAggregatorCoalesce(Table::AC_DRAIN);
+	ival = 3;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	ival = 4;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(res->res_, "");
+	unit->drainFrame();
+	UT_IS(t->getCoalescedCount(), 0);
+	UT_IS(res->res_,
+		"OP_DELETE A n=3 cnt=3 s=12 av=4 mn=3 mx=5 sd=1.5 fc=5\n"
+		"OP_INSERT A n=1 cnt=1 s=5 av=5 mn=5 mx=5 sd=0.5 fc=5\n"
+	);
+	res->res_.clear();
+
+	// switching the coalescing off flushes the held results
+	sval[0] = 'B';
+	dval = 1.25;
+	ival = 2;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	t->setAggregatorCoalesce(Table::AC_NONE);
+	UT_IS(t->getCoalescedCount(), 0);
+	ival = 1;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(res->res_,
+		"OP_DELETE B n=2 cnt=2 s=3 av=1.5 mn=1 mx=2 sd=2.5 fc=1\n"
+		"OP_INSERT B n=1 cnt=1 s=1 av=1 mn=1 mx=1 sd=1.25 fc=1\n"
+		"OP_DELETE B n=1 cnt=1 s=1 av=1 mn=1 mx=1 sd=1.25 fc=1\n"
+	);
+
+	// a table destroyed with the held results and a scheduled flush
+	t->setAggregatorCoalesce(Table::AC_DRAIN);
+	sval[0] = 'D';
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	sval[0] = 'A';
+	ival = 5;
+	UT_ASSERT(t->deleteRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(t->getCoalescedCount(), 2);
+	res->res_.clear();
+	t = NULL;
+	unit->drainFrame();
+	UT_IS(res->res_, "");
+}
+
+// prints the rows of the top-k aggregator
+class TopResultLabel : public Label
+{
+public:
+	TopResultLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name = "") :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		const RowType *rt = getType();
+		const Row *row = arg->getRow();
+		const char *ptr;
+		intptr_t len;
+		rt->getField(row, 0, ptr, len); // the value may be empty
+		res_.append(strprintf("%s '%s' rank=%d count=%d\n", Rowop::opcodeString(arg->getOpcode()),
+			string(ptr, strnlen(ptr, len)).c_str(), (int)rt->getInt32(row, 1, 0), (int)rt->getInt64(row, 2, 0)));
+	}
+
+	mutable string res_;
+};
+
+UTESTCASE aggTopK(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TopKAggregatorType> agt = new TopKAggregatorType("top", "e", 2);
+	UT_IS(agt->getCapacity(), 8);
+	Autoref<TableType> tt = TableType::make(rt1)
+		->addSubIndex("fifo", FifoIndexType::make()
+			->setLimit(5)
+			->setAggregator(agt)
+		);
+	tt->initialize();
+	if (UT_ASSERT(tt->getErrors().isNull())) {
+		printf("errors:\n%s", tt->getErrors()->print().c_str());
+		return;
+	}
+	UT_IS(agt->print(NOINDENT), "aggregator topk (e, 2, 8) top");
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Label *aggl = t->getAggregatorLabel("top");
+	UT_IS(aggl->getType()->print(NOINDENT), "row { string e, int32 rank, int64 count, }");
+	Autoref<TopResultLabel> res = new TopResultLabel(unit, aggl->getType(), "res");
+	aggl->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	char sval[2] = "A";
+	dv[4].setPtr(true, &sval, sizeof(sval));
+
+	// only the changes of the places get sent, the last C changes nothing
+	const char *seq = "ABBAC";
+	for (const char *p = seq; *p != 0; p++) {
+		sval[0] = *p;
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	}
+	UT_IS(res->res_,
+		"OP_INSERT \'A\' rank=1 count=1\n"
+		"OP_INSERT \'B\' rank=2 count=1\n"
+		"OP_DELETE \'A\' rank=1 count=1\n"
+		"OP_DELETE \'B\' rank=2 count=1\n"
+		"OP_INSERT \'B\' rank=1 count=2\n"
+		"OP_INSERT \'A\' rank=2 count=1\n"
+		"OP_DELETE \'B\' rank=1 count=2\n"
+		"OP_DELETE \'A\' rank=2 count=1\n"
+		"OP_INSERT \'A\' rank=1 count=2\n"
+		"OP_INSERT \'B\' rank=2 count=2\n"
+	);
+	res->res_.clear();
+
+	// the push-out of the oldest A by another C
+	sval[0] = 'C';
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(res->res_,
+		"OP_DELETE \'A\' rank=1 count=2\n"
+		"OP_DELETE \'B\' rank=2 count=2\n"
+		"OP_INSERT \'B\' rank=1 count=2\n"
+		"OP_INSERT \'C\' rank=2 count=2\n"
+	);
+	res->res_.clear();
+
+	// D pushes out a B
+	sval[0] = 'D';
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	UT_IS(res->res_,
+		"OP_DELETE \'B\' rank=1 count=2\n"
+		"OP_DELETE \'C\' rank=2 count=2\n"
+		"OP_INSERT \'C\' rank=1 count=2\n"
+		"OP_INSERT \'A\' rank=2 count=1\n"
+	);
+	res->res_.clear();
+
+	// the removal of B changes nothing, and the group going empty
+	// removes all the places
+	for (RowHandle *rh = t->begin(); rh != NULL; rh = t->begin())
+		t->remove(rh);
+	UT_IS(res->res_,
+		"OP_DELETE \'A\' rank=2 count=1\n"
+		"OP_INSERT \'D\' rank=2 count=1\n"
+		"OP_DELETE \'C\' rank=1 count=2\n"
+		"OP_DELETE \'D\' rank=2 count=1\n"
+		"OP_INSERT \'D\' rank=1 count=1\n"
+		"OP_DELETE \'D\' rank=1 count=1\n"
+	);
+	res->res_.clear();
+
+	// with the coalescing, the whole list gets replaced
+	t->setAggregatorCoalesce(Table::AC_FLUSH);
+	for (const char *p = seq; *p != 0; p++) {
+		sval[0] = *p;
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	}
+	t->flushAggregators();
+	UT_IS(res->res_,
+		"OP_INSERT \'A\' rank=1 count=2\n"
+		"OP_INSERT \'B\' rank=2 count=2\n"
+	);
+	res->res_.clear();
+	sval[0] = 'B';
+	UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	t->flushAggregators();
+	UT_IS(res->res_,
+		"OP_DELETE \'A\' rank=1 count=2\n"
+		"OP_DELETE \'B\' rank=2 count=2\n"
+		"OP_INSERT \'B\' rank=1 count=3\n"
+		"OP_INSERT \'A\' rank=2 count=1\n"
+	);
+
+	// the errors
+	tt = TableType::make(rt1)
+		->addSubIndex("fifo", FifoIndexType::make()
+			->setAggregator(new TopKAggregatorType("top", "zz", 0))
+		)
+		->addSubIndex("fifo2", FifoIndexType::make()
+			->setAggregator(new TopKAggregatorType("top2", "e", 3, 2))
+		);
+	tt->initialize();
+	string msg = tt->getErrors()->print();
+	UT_ASSERT(msg.find("The number of the top values must be at least 1, got 0.\n") != string::npos);
+	UT_ASSERT(msg.find("Unknown key field 'zz', the row type is:\n") != string::npos);
+	UT_ASSERT(msg.find("The number of the counters 2 must be at least the number of the top values 3.\n") != string::npos);
+}
+
+UTESTCASE aggTopKEmptyKey(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TableType> tt = TableType::make(rt1)
+		->addSubIndex("fifo", FifoIndexType::make()
+			->setAggregator(new TopKAggregatorType("top", "e", 2, 2))
+		);
+	tt->initialize();
+	if (UT_ASSERT(tt->getErrors().isNull())) {
+		printf("errors:\n%s", tt->getErrors()->print().c_str());
+		return;
+	}
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	Autoref<TopResultLabel> res = new TopResultLabel(unit, t->getAggregatorLabel("top")->getType(), "res");
+	t->getAggregatorLabel("top")->chain(res);
+
+	FdataVec dv;
+	mkfdata(dv);
+	// the empty string is a valid value
+	const char *seq[] = { "", "A", "A", "B" };
+	for (size_t i = 0; i < sizeof(seq)/sizeof(seq[0]); i++) {
+		dv[4].setPtr(true, seq[i], strlen(seq[i]));
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+	}
+	// B takes over the counter of the empty value, that must leave the places
+	UT_IS(res->res_,
+		"OP_INSERT '' rank=1 count=1\n"
+		"OP_INSERT 'A' rank=2 count=1\n"
+		"OP_DELETE '' rank=1 count=1\n"
+		"OP_DELETE 'A' rank=2 count=1\n"
+		"OP_INSERT 'A' rank=1 count=2\n"
+		"OP_INSERT '' rank=2 count=1\n"
+		"OP_DELETE '' rank=2 count=1\n"
+		"OP_INSERT 'B' rank=2 count=2\n"
+	);
+}
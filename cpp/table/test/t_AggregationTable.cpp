@@ -0,0 +1,274 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the aggregation-only pseudo-table.
+
+#include <utest/Utest.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/Table.h>
+#include <table/AggregationTable.h>
+#include <mem/Rhref.h>
+
+#include <utest/TestHelpers.h>
+
+// prints the aggregation results
+class ResultLabel : public Label
+{
+public:
+	ResultLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name = "") :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		res_.append(print(getType(), arg->getRow(), arg->getOpcode()));
+	}
+
+	static string print(const RowType *rt, const Row *row, Rowop::Opcode op)
+	{
+		string res = strprintf("%s e=%s n=%d cnt=%d s=%d", Rowop::opcodeString(op),
+			rt->getString(row, 0), (int)rt->getInt64(row, 1),
+			(int)rt->getInt64(row, 2), (int)rt->getInt64(row, 3));
+		if (rt->isFieldNull(row, 4))
+			res.append(" av=-\n");
+		else
+			res.append(strprintf(" av=%g\n", rt->getFloat64(row, 4)));
+		return res;
+	}
+
+	mutable string res_;
+};
+
+Onceref<AdditiveAggregatorType> mkAggType()
+{
+	return (new AdditiveAggregatorType("aggr"))
+		->addField("e", "last", "e")
+		->addField("n", "count_star")
+		->addField("cnt", "count", "c")
+		->addField("s", "sum", "c")
+		->addField("av", "avg", "d")
+	;
+}
+
+Rowref mkrow(RowType *rt, const char *e, int64_t c, double d)
+{
+	FdataVec dv;
+	mkfdata(dv);
+	dv[2].setPtr(true, &c, sizeof(c));
+	dv[3].setPtr(true, &d, sizeof(d));
+	dv[4].setPtr(true, e, strlen(e)+1);
+	return Rowref(rt, rt->makeRow(dv));
+}
+
+UTESTCASE aggTableBasic(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	Autoref<AggregationTable> at = new AggregationTable(unit, "at", rt1, NameSet::make()->add("e"), mkAggType());
+	UT_IS(at->getName(), "at");
+	UT_IS(at->getInputLabel()->getName(), "at.in");
+	UT_IS(at->getLabel()->getName(), "at.out");
+	UT_IS(at->getAggregatorLabel()->getName(), "at.aggr");
+	Autoref<ResultLabel> res = new ResultLabel(unit, at->getAggregatorLabel()->getType(), "res");
+	at->getAggregatorLabel()->chain(res);
+	Autoref<Label> out = new DummyLabel(unit, rt1, "out");
+	at->getLabel()->chain(out);
+
+	unit->call(new Rowop(at->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, "A", 1, 0.5)));
+	unit->call(new Rowop(at->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, "B", 2, 1.)));
+	unit->call(new Rowop(at->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, "A", 3, 1.5)));
+	UT_IS(at->size(), 3);
+	UT_IS(at->groupCount(), 2);
+
+	Rowref r(rt1);
+	UT_ASSERT(at->findResult(mkrow(rt1, "A", 0, 0.), r));
+	UT_IS(ResultLabel::print(r.getType(), r, Rowop::OP_NOP), "OP_NOP e=A n=2 cnt=2 s=4 av=1\n");
+	UT_ASSERT(!at->findResult(mkrow(rt1, "C", 0, 0.), r));
+
+	// an update moves the row between the groups
+	Rowref rnew = mkrow(rt1, "B", 3, 1.5), rold = mkrow(rt1, "A", 3, 1.5);
+	unit->call(Rowop::makeUpdate(at->getInputLabel(), rnew.get(), rold.get()));
+	unit->call(new Rowop(at->getInputLabel(), Rowop::OP_DELETE, mkrow(rt1, "A", 1, 0.5)));
+	// a delete for an unknown group gets ignored
+	unit->call(new Rowop(at->getInputLabel(), Rowop::OP_DELETE, mkrow(rt1, "C", 1, 0.5)));
+	UT_IS(at->size(), 2);
+	UT_IS(at->groupCount(), 1);
+
+	string expect =
+		"OP_INSERT e=A n=1 cnt=1 s=1 av=0.5\n"
+		"OP_INSERT e=B n=1 cnt=1 s=2 av=1\n"
+		"OP_DELETE e=A n=1 cnt=1 s=1 av=0.5\n"
+		"OP_INSERT e=A n=2 cnt=2 s=4 av=1\n"
+		"OP_DELETE e=A n=2 cnt=2 s=4 av=1\n"
+		"OP_INSERT e=A n=1 cnt=1 s=1 av=0.5\n"
+		"OP_DELETE e=B n=1 cnt=1 s=2 av=1\n"
+		"OP_INSERT e=B n=2 cnt=2 s=5 av=1.25\n"
+		"OP_DELETE e=A n=1 cnt=1 s=1 av=0.5\n"
+	;
+	UT_IS(res->res_, expect);
+
+	// the order of the labels matches the Table
+	string tlog = trace->getBuffer()->print();
+	UT_ASSERT(tlog.find(
+		"unit 'u' before label 'at.in' op OP_INSERT\n"
+		"unit 'u' before label 'at.aggr' op OP_DELETE\n"
+		"unit 'u' before label 'res' (chain 'at.aggr') op OP_DELETE\n"
+		"unit 'u' before label 'at.out' op OP_INSERT\n"
+		"unit 'u' before label 'out' (chain 'at.out') op OP_INSERT\n"
+		"unit 'u' before label 'at.aggr' op OP_INSERT\n"
+		) != string::npos);
+
+	restore_uncatchable();
+}
+
+// produces the same aggregation results as the real table
+UTESTCASE aggTableSame(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+
+	Autoref<AggregationTable> at = new AggregationTable(unit, "at", rt1, NameSet::make()->add("e"), mkAggType());
+	Autoref<ResultLabel> res1 = new ResultLabel(unit, at->getAggregatorLabel()->getType(), "res1");
+	at->getAggregatorLabel()->chain(res1);
+
+	Autoref<Table> t = at->getTableType()->makeTable(unit, "t");
+	Autoref<ResultLabel> res2 = new ResultLabel(unit, at->getAggregatorLabel()->getType(), "res2");
+	t->getAggregatorLabel("aggr")->chain(res2);
+
+	const char *keys[] = { "A", "B", "C", "D" };
+	vector<Rhref> inserted;
+	srandom(2);
+	for (int i = 0; i < 1000; i++) {
+		if (!inserted.empty() && random() % 3 == 0) {
+			size_t idx = random() % inserted.size();
+			Rhref rh = inserted[idx];
+			inserted[idx] = inserted.back();
+			inserted.pop_back();
+			UT_ASSERT(at->deleteRow(rh->getRow()));
+			t->remove(rh);
+		} else {
+			Rowref r = mkrow(rt1, keys[random() % 4], random() % 100, (random() % 8) * 0.25);
+			at->insertRow(r);
+			Rhref rh(t, t->makeRowHandle(r));
+			UT_ASSERT(t->insert(rh));
+			inserted.push_back(rh);
+		}
+	}
+
+	UT_IS(at->size(), (int64_t)t->size());
+	UT_ASSERT(res1->res_.size() > 0);
+	UT_ASSERT(res1->res_ == res2->res_);
+
+	restore_uncatchable();
+}
+
+// the quantiles work without the rows, from the sketches of the
+// inserted and deleted values
+UTESTCASE aggTableQuantile(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+
+	Autoref<AggregationTable> at = new AggregationTable(unit, "at", rt1, NameSet::make()->add("e"),
+		(new AdditiveAggregatorType("aggr"))
+			->addField("n", "count_star")
+			->addField("med", "quantile", "c")
+	);
+
+	const int n = 4000;
+	for (int i = 0; i < n; i++)
+		at->insertRow(mkrow(rt1, "A", (i * 7919) % n, 0.));
+
+	Rowref r(rt1);
+	const RowType *art = at->getAggregatorLabel()->getType();
+	UT_ASSERT(at->findResult(mkrow(rt1, "A", 0, 0.), r));
+	UT_IS(art->getInt64(r, 0), n);
+	UT_ASSERT(fabs(art->getFloat64(r, 1) - 0.5 * n) < 0.02 * n);
+
+	// delete the lower half
+	for (int i = 0; i < n; i++) {
+		int64_t v = (i * 7919) % n;
+		if (v < n / 2)
+			at->deleteRow(mkrow(rt1, "A", v, 0.));
+	}
+	UT_ASSERT(at->findResult(mkrow(rt1, "A", 0, 0.), r));
+	UT_IS(art->getInt64(r, 0), n / 2);
+	UT_ASSERT(fabs(art->getFloat64(r, 1) - 0.75 * n) < 0.03 * n);
+
+	restore_uncatchable();
+}
+
+UTESTCASE aggTableErrors(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+
+	string msg;
+	try {
+		new AggregationTable(unit, "at", rt1, NameSet::make()->add("e"),
+			(new AdditiveAggregatorType("aggr"))->addField("m", "max", "c"));
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The aggregation table 'at' can not compute the function 'max' in the result field 'm', it needs the rows.\n");
+
+	msg.clear();
+	try {
+		new AggregationTable(unit, "at", rt1, NameSet::make()->add("e"),
+			(new AdditiveAggregatorType("aggr"))->addCountDistinct("dc", "c"));
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The aggregation table 'at' can not compute the function 'count_distinct' in the result field 'dc', it needs the rows.\n");
+
+	msg.clear();
+	try {
+		new AggregationTable(unit, "at", rt1, NameSet::make()->add("e"),
+			(new AdditiveAggregatorType("aggr"))->addField("l", "last", "c"));
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The aggregation table 'at' can compute the function 'last' in the result field 'l' only on a key field, 'c' is not.\n");
+
+	msg.clear();
+	try {
+		new AggregationTable(unit, "at", rt1, NameSet::make()->add("zz"), mkAggType());
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("The aggregation table 'at' has an incorrect definition:\n") == 0);
+	UT_ASSERT(msg.find("can not find the key field 'zz'") != string::npos);
+
+	restore_uncatchable();
+}
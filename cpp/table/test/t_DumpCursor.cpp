@@ -0,0 +1,143 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the table dump in portions.
+
+#include <utest/Utest.h>
+#include <string.h>
+
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/Table.h>
+#include <table/DumpCursor.h>
+#include <mem/Rhref.h>
+
+#include <utest/TestHelpers.h>
+
+Onceref<TableType> mkTableType(RowType *rt1)
+{
+	return initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)
+		)
+		->addSubIndex("fifo", FifoIndexType::make())
+	);
+}
+
+Rowref mkrow(RowType *rt1, int32_t b, int64_t c)
+{
+	FdataVec dv;
+	mkfdata(dv);
+	dv[1].data_ = (char *)&b; dv[2].data_ = (char *)&c;
+	return Rowref(rt1,  rt1->makeRow(dv));
+}
+
+// collects the values of the field "b" of the dumped rows
+class CollectLabel : public Label
+{
+public:
+	CollectLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		vals_.push_back(getType()->getInt32(arg->getRow(), 1));
+	}
+
+	mutable vector<int32_t> vals_;
+};
+
+UTESTCASE cursorSteps(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	Autoref<CollectLabel> coll = new CollectLabel(unit, rt1, "coll");
+	UT_ASSERT(t1->getDumpLabel()->chain(coll).isNull());
+
+	for (int i = 0; i < 10; i++)
+		t1->insertRow(mkrow(rt1, i, i));
+
+	IndexType *fifo = tt->findSubIndex("fifo");
+	Autoref<DumpCursor> cur = new DumpCursor(t1, fifo);
+	UT_ASSERT(!cur->isDone());
+	UT_IS(cur->getIndexType(), fifo);
+	UT_IS(cur->getOpcode(), Rowop::OP_INSERT);
+
+	UT_IS(cur->step(3), 3);
+	UT_IS(coll->vals_.size(), 3);
+	UT_IS(coll->vals_[2], 2);
+
+	// the modifications between the steps:
+	// deleting the next row skips it
+	t1->deleteRow(mkrow(rt1, 3, 0));
+	// deleting a row behind the cursor doesn't matter
+	t1->deleteRow(mkrow(rt1, 1, 0));
+	// a replacement of a sent row moves it to the end of FIFO, so it gets sent again
+	t1->insertRow(mkrow(rt1, 0, 100));
+	// a new row ahead gets sent
+	t1->insertRow(mkrow(rt1, 20, 20));
+
+	UT_IS(cur->step(4), 4);
+	UT_IS(cur->getSent(), 7);
+	UT_IS(cur->step(100), 4);
+	UT_ASSERT(cur->isDone());
+	UT_IS(cur->step(100), 0);
+
+	int32_t expect[] = { 0, 1, 2, 4, 5, 6, 7, 8, 9, 0, 20 };
+	UT_IS(coll->vals_.size(), sizeof(expect)/sizeof(expect[0]));
+	for (size_t i = 0; i < coll->vals_.size() && i < sizeof(expect)/sizeof(expect[0]); i++)
+		UT_IS(coll->vals_[i], expect[i]);
+
+	// rewind and dump in the default order, while another cursor is present
+	Autoref<DumpCursor> cur2 = new DumpCursor(t1);
+	cur->rewind();
+	coll->vals_.clear();
+	while (cur->step(2) != 0)
+		{ }
+	UT_IS(coll->vals_.size(), t1->size());
+	UT_IS(cur2->getSent(), 0);
+
+	// the table gets cleared with the cursor positioned in it
+	cur2->step(1);
+	t1->clear();
+	UT_ASSERT(cur2->isDone());
+	UT_IS(cur2->step(1), 0);
+
+	// an empty table is done right away
+	cur = new DumpCursor(t1);
+	UT_ASSERT(cur->isDone());
+}
+
+UTESTCASE cursorErrors(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<TableType> tt2 = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+
+	string msg;
+	try {
+		new DumpCursor(t1, tt2->findSubIndex("fifo"));
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("The index type for the dump cursor doesn't belong to the type of the table 't1'.") != string::npos);
+
+	restore_uncatchable();
+}
@@ -13,6 +13,7 @@
 #include <common/StringUtil.h>
 #include <table/Table.h>
 #include <mem/Rhref.h>
+#include <common/BloomFilter.h>
 
 // Make fields of all simple types
 void mkfields(RowType::FieldVec &fields)
@@ -255,3 +256,292 @@ UTESTCASE tableops(Utest *utest)
 }
 
 // queuing is tested in t_HashedNested
+
+UTESTCASE findBatch(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	Autoref<TableType> tt = (new TableType(rt1))
+		->addSubIndex("primary", new HashedIndexType(
+			(new NameSet())->add("a")->add("e"))
+		);
+
+	UT_ASSERT(tt);
+	tt->initialize();
+	UT_ASSERT(tt->getErrors().isNull());
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	UT_ASSERT(!t.isNull());
+
+	IndexType *prim = tt->findSubIndex("primary");
+	UT_ASSERT(prim != NULL);
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+	const char *key2 = "key2";
+	dv[4].setPtr(true, key2, sizeof(key2));
+	Rowref r2(rt1, rt1->makeRow(dv));
+	const char *key3 = "key3";
+	dv[4].setPtr(true, key3, sizeof(key3));
+	Rowref r3(rt1, rt1->makeRow(dv));
+
+	UT_ASSERT(t->insertRow(r1));
+	UT_ASSERT(t->insertRow(r3));
+
+	vector<const Row *> rows;
+	rows.push_back(r1);
+	rows.push_back(r2);
+	rows.push_back(NULL);
+	rows.push_back(r3);
+	rows.push_back(r1);
+
+	vector<RowHandle *> res;
+	res.push_back(NULL); // must be replaced
+	t->findBatchIdx(prim, rows, res);
+	UT_IS(res.size(), 5);
+	UT_ASSERT(res[0] != NULL);
+	UT_IS(res[0], t->findRowIdx(prim, r1));
+	UT_IS(res[1], NULL);
+	UT_IS(res[2], NULL);
+	UT_ASSERT(res[3] != NULL);
+	UT_IS(res[3], t->findRowIdx(prim, r3));
+	UT_IS(res[4], res[0]);
+
+	// the default index
+	t->findBatch(rows, res);
+	UT_IS(res.size(), 5);
+	UT_IS(res[0], t->findRowIdx(prim, r1));
+	UT_IS(res[1], NULL);
+	UT_IS(res[3], t->findRowIdx(prim, r3));
+
+	// an empty batch
+	rows.clear();
+	t->findBatchIdx(prim, rows, res);
+	UT_IS(res.size(), 0);
+
+	// an index from another table type finds nothing
+	Autoref<TableType> tt2 = (new TableType(rt1))
+		->addSubIndex("primary", new HashedIndexType(
+			(new NameSet())->add("a")->add("e"))
+		);
+	tt2->initialize();
+	rows.push_back(r1);
+	t->findBatchIdx(tt2->findSubIndex("primary"), rows, res);
+	UT_IS(res.size(), 1);
+	UT_IS(res[0], NULL);
+}
+
+UTESTCASE bloom(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	// a bad rate
+	{
+		Autoref<TableType> tt = (new TableType(rt1))
+			->addSubIndex("primary", (new HashedIndexType(
+				(new NameSet())->add("b")))->setBloom(10, 1.5)
+			);
+		tt->initialize();
+		UT_ASSERT(tt->getErrors()->hasError());
+		UT_IS(tt->getErrors()->print(), 
+			"index error:\n"
+			"  nested index 1 'primary':\n"
+			"    the Bloom filter false positive rate must be between 0 and 1, got 1.5\n");
+	}
+
+	Autoref<HashedIndexType> hit = (new HashedIndexType(
+		(new NameSet())->add("b")))->setBloom(16, 0.01);
+	UT_IS(hit->getBloomCapacity(), 16);
+	UT_IS(hit->getBloomFpRate(), 0.01);
+	UT_IS(hit->print(), "index HashedIndex(b, bloom=16 fpRate=0.01)");
+
+	// the filter is a part of the type's identity but not of matching
+	Autoref<HashedIndexType> hitplain = new HashedIndexType((new NameSet())->add("b"));
+	UT_ASSERT(!hit->equals(hitplain));
+	UT_ASSERT(hit->match(hitplain));
+	UT_ASSERT(hit->equals(hit->copy()));
+
+	Autoref<TableType> tt = (new TableType(rt1))
+		->addSubIndex("primary", hit);
+	tt->initialize();
+	UT_ASSERT(tt->getErrors().isNull());
+	hit = static_cast<HashedIndexType *>(tt->findSubIndex("primary")); // the copy in the table type
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	UT_ASSERT(!t.isNull());
+
+	HashedIndexType::BloomStats st;
+	// the index instances get created with the first row
+	hit->getBloomStats(t, st);
+	UT_IS(st.instances_, 0);
+	UT_IS(st.bits_, 0);
+
+	FdataVec dv;
+	mkfdata(dv);
+	const int n = 200;
+	int32_t key;
+	dv[1].setPtr(true, &key, sizeof(key));
+	for (key = 0; key < n; key++) {
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_ASSERT(t->insertRow(r));
+	}
+	UT_IS(t->size(), n);
+
+	// the filter has grown with the table
+	hit->getBloomStats(t, st);
+	UT_IS(st.instances_, 1);
+	UT_IS(st.entries_, n);
+	UT_IS(st.stale_, 0);
+	UT_ASSERT(st.bits_ > (size_t)BloomFilter::BLOCK_BITS);
+	UT_ASSERT(st.rebuilds_ > 0);
+
+	// all the present rows are found and the absent ones are not
+	Table::Probe probe(t, hit);
+	for (key = 0; key < n * 2; key++) {
+		Rowref r(rt1, rt1->makeRow(dv));
+		RowHandle *rh = probe.find(r);
+		if (key < n) {
+			if (UT_ASSERT(rh != NULL))
+				break;
+		} else {
+			if (UT_ASSERT(rh == NULL))
+				break;
+		}
+	}
+	hit->getBloomStats(t, st);
+	// the probes on insert go through the filter too
+	UT_ASSERT(st.probes_ >= n * 2);
+	UT_ASSERT(st.rejects_ >= n * 9 / 10);
+	UT_ASSERT(st.falsePositives_ <= n / 10);
+
+	// the replacement still finds the old row
+	key = 5;
+	{
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_ASSERT(t->insertRow(r));
+		UT_IS(t->size(), n);
+		UT_IS(t->findRow(r)->getRow(), r.get());
+	}
+
+	// removal of most of the rows rebuilds the filter
+	size_t rebuilds = st.rebuilds_;
+	for (key = 0; key < n - 10; key++) {
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_ASSERT(t->deleteRow(r));
+	}
+	UT_IS(t->size(), 10);
+	hit->getBloomStats(t, st);
+	UT_ASSERT(st.rebuilds_ > rebuilds);
+	UT_ASSERT(st.stale_ <= st.entries_ + 64);
+	for (key = 0; key < n; key++) {
+		Rowref r(rt1, rt1->makeRow(dv));
+		RowHandle *rh = probe.find(r);
+		if (UT_ASSERT((rh != NULL) == (key >= n - 10)))
+			break;
+	}
+
+	// the stats of a table from another type are empty
+	Autoref<TableType> tt2 = (new TableType(rt1))
+		->addSubIndex("primary", hit->copy());
+	tt2->initialize();
+	Autoref<Table> t2 = tt2->makeTable(unit, "t2");
+	hit->getBloomStats(t2, st);
+	UT_IS(st.instances_, 0);
+}
+
+UTESTCASE bloomNested(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	Autoref<HashedIndexType> outer = (new HashedIndexType(
+		(new NameSet())->add("b")))->setBloom(4);
+	Autoref<HashedIndexType> inner = (new HashedIndexType(
+		(new NameSet())->add("c")))->setBloom(4);
+	outer->addSubIndex("inner", inner);
+
+	Autoref<TableType> tt = (new TableType(rt1))
+		->addSubIndex("outer", outer);
+	tt->initialize();
+	UT_ASSERT(tt->getErrors().isNull());
+	// the copies in the table type
+	outer = static_cast<HashedIndexType *>(tt->findSubIndex("outer"));
+	inner = static_cast<HashedIndexType *>(outer->findSubIndex("inner"));
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	UT_ASSERT(!t.isNull());
+
+	FdataVec dv;
+	mkfdata(dv);
+	int32_t b;
+	int64_t c;
+	dv[1].setPtr(true, &b, sizeof(b));
+	dv[2].setPtr(true, &c, sizeof(c));
+	for (b = 0; b < 3; b++) {
+		for (c = 0; c < 10; c++) {
+			Rowref r(rt1, rt1->makeRow(dv));
+			UT_ASSERT(t->insertRow(r));
+		}
+	}
+	UT_IS(t->size(), 30);
+
+	HashedIndexType::BloomStats st;
+	outer->getBloomStats(t, st);
+	UT_IS(st.instances_, 1);
+	UT_IS(st.entries_, 3);
+	inner->getBloomStats(t, st);
+	UT_IS(st.instances_, 3);
+	UT_IS(st.entries_, 30);
+
+	Table::Probe pouter(t, outer);
+	Table::Probe pinner(t, inner);
+	b = 1; c = 5;
+	{
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_ASSERT(pinner.find(r) != NULL);
+		UT_IS(pouter.groupSize(r), 10);
+	}
+	b = 7; c = 5;
+	{
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_IS(pinner.find(r), NULL);
+		UT_IS(pouter.groupSize(r), 0);
+	}
+	b = 1; c = 50;
+	{
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_IS(pinner.find(r), NULL);
+	}
+
+	// collapse a group
+	b = 2;
+	for (c = 0; c < 10; c++) {
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_ASSERT(t->deleteRow(r));
+	}
+	outer->getBloomStats(t, st);
+	UT_IS(st.stale_, 1);
+	inner->getBloomStats(t, st);
+	UT_IS(st.instances_, 2);
+	b = 2; c = 5;
+	{
+		Rowref r(rt1, rt1->makeRow(dv));
+		UT_IS(pinner.find(r), NULL);
+		UT_IS(pouter.groupSize(r), 0);
+	}
+}
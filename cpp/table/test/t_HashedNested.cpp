@@ -442,3 +442,93 @@ UTESTCASE queuing(Utest *utest)
 	iter = t1->next(iter);
 	UT_IS(iter, NULL);
 }
+
+UTESTCASE probe(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	// a sibling index makes sure that only the path gets initialized
+	Autoref<TableType> tt = mktabtype(rt1)
+		->addSubIndex("fifo", FifoIndexType::make());
+	tt->initialize();
+	UT_ASSERT(tt->getErrors().isNull());
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	UT_ASSERT(!t.isNull());
+
+	IndexType *prim = tt->findSubIndex("primary");
+	UT_ASSERT(prim != NULL);
+	IndexType *sec = prim->findSubIndex("level2");
+	UT_ASSERT(sec != NULL);
+
+	FdataVec dv;
+	mkfdata(dv);
+
+	int32_t one32 = 1, two32 = 2, three32 = 3;
+	int64_t one64 = 1, two64 = 2;
+
+	dv[1].data_ = (char *)&one32; dv[2].data_ = (char *)&one64;
+	Rowref r11(rt1,  rt1->makeRow(dv));
+	dv[1].data_ = (char *)&one32; dv[2].data_ = (char *)&two64;
+	Rowref r12(rt1,  rt1->makeRow(dv));
+	dv[1].data_ = (char *)&two32; dv[2].data_ = (char *)&one64;
+	Rowref r21(rt1,  rt1->makeRow(dv));
+	dv[1].data_ = (char *)&three32; dv[2].data_ = (char *)&one64;
+	Rowref r31(rt1,  rt1->makeRow(dv));
+
+	UT_ASSERT(t->insertRow(r11));
+	UT_ASSERT(t->insertRow(r12));
+	UT_ASSERT(t->insertRow(r21));
+
+	int refs = r11->getref();
+	Table::Probe psec(t, sec);
+	UT_IS(psec.getIndexType(), sec);
+	RowHandle *rh = psec.find(r11);
+	UT_ASSERT(rh != NULL);
+	UT_IS(rh->getRow(), r11.get());
+	UT_IS(psec.find(r12)->getRow(), r12.get());
+	UT_IS(psec.find(r21)->getRow(), r21.get());
+	UT_IS(psec.find(r31), NULL);
+	UT_IS(psec.find(NULL), NULL);
+	// the probe doesn't hold the row
+	UT_IS(r11->getref(), refs);
+
+	// the handle from set() works with the normal calls
+	RowHandle *what = psec.set(r12);
+	UT_ASSERT(what != NULL);
+	UT_ASSERT(!what->isInTable());
+	UT_IS(t->findIdx(sec, what)->getRow(), r12.get());
+	psec.reset();
+
+	Table::Probe pprim(t, prim);
+	UT_IS(pprim.groupSize(r11), 2);
+	UT_IS(pprim.groupSize(r21), 1);
+	UT_IS(pprim.groupSize(r31), 0);
+	rh = pprim.find(r12); // the first row of the group
+	UT_ASSERT(rh != NULL);
+	UT_ASSERT(rh->getRow() == r11.get() || rh->getRow() == r12.get());
+
+	// the same through the Table methods
+	UT_IS(t->groupSizeRowIdx(prim, r11), 2);
+	UT_IS(t->findRowIdx(sec, r21)->getRow(), r21.get());
+
+	// an index type from another table type finds nothing
+	Autoref<TableType> tt2 = mktabtype(rt1);
+	tt2->initialize();
+	Table::Probe pother(t, tt2->findSubIndex("primary"));
+	UT_IS(pother.set(r11), NULL);
+	UT_IS(pother.find(r11), NULL);
+	UT_IS(pother.groupSize(r11), 0);
+	Table::Probe pnull(t, NULL);
+	UT_IS(pnull.find(r11), NULL);
+
+	// deleteRow() goes through the probe too
+	UT_ASSERT(t->deleteRow(r12));
+	UT_IS(psec.find(r12), NULL);
+	UT_IS(pprim.groupSize(r11), 1);
+}
@@ -14,6 +14,8 @@
 #include <type/AllTypes.h>
 #include <common/StringUtil.h>
 #include <table/Table.h>
+#include <type/BasicAggregatorType.h>
+#include <table/BasicAggregator.h>
 #include <mem/Rhref.h>
 
 #include <utest/TestHelpers.h>
@@ -640,3 +642,310 @@ UTESTCASE inputRef(Utest *utest)
 
 	restore_uncatchable();
 }
+
+int aggCalls = 0;
+void countAggCalls(Table *table, AggregatorGadget *gadget, Index *index,
+        const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		Aggregator::AggOp aggop, Rowop::Opcode opcode, RowHandle *rh)
+{
+	aggCalls++;
+}
+
+// sets a sticky error on the table
+class StickyErrorLabel : public Label
+{
+public:
+	StickyErrorLabel(Unit *unit, Onceref<RowType> rtype, const string &name, Table *table) :
+		Label(unit, rtype, name),
+		table_(table)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		table_->setStickyError(new Errors("test error"));
+	}
+
+	Table *table_;
+};
+
+UTESTCASE identicalReplace(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	Autoref<TableType> tt = initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)->setAggregator(new BasicAggregatorType("agg", rt1, countAggCalls))
+		)
+	);
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	UT_ASSERT(!t.isNull());
+	UT_IS(t->getIdenticalReplace(), Table::IR_REPLACE);
+
+	Autoref<Label> dummy = new DummyLabel(unit, rt1, "dummy");
+	UT_ASSERT(t->getPreLabel()->chain(dummy).isNull());
+
+	FdataVec dv;
+	mkfdata(dv);
+	int32_t one32 = 1;
+	int64_t one64 = 1, two64 = 2;
+	dv[1].data_ = (char *)&one32; dv[2].data_ = (char *)&one64;
+	Rowref r1(rt1,  rt1->makeRow(dv));
+	Rowref r1same(rt1,  rt1->makeRow(dv));
+	dv[2].data_ = (char *)&two64;
+	Rowref r1diff(rt1,  rt1->makeRow(dv));
+
+	UT_ASSERT(t->insertRow(r1));
+	RowHandle *rh1 = t->findRow(r1);
+	UT_ASSERT(rh1 != NULL);
+
+	string tlog;
+
+	// the default is to replace
+	trace->clearBuffer();
+	aggCalls = 0;
+	UT_ASSERT(t->insertRow(r1same));
+	tlog = trace->getBuffer()->print();
+	UT_IS(tlog, 
+		"unit 'u' before label 't.pre' op OP_DELETE\n"
+		"unit 'u' before label 'dummy' (chain 't.pre') op OP_DELETE\n"
+		"unit 'u' before label 't.out' op OP_DELETE\n"
+		"unit 'u' before label 't.pre' op OP_INSERT\n"
+		"unit 'u' before label 'dummy' (chain 't.pre') op OP_INSERT\n"
+		"unit 'u' before label 't.out' op OP_INSERT\n"
+	);
+	UT_IS(aggCalls, 3);
+	UT_ASSERT(t->findRow(r1) != rh1);
+	rh1 = t->findRow(r1);
+
+	// skip
+	t->setIdenticalReplace(Table::IR_SKIP);
+	UT_IS(t->getIdenticalReplace(), Table::IR_SKIP);
+	trace->clearBuffer();
+	aggCalls = 0;
+	UT_ASSERT(t->insertRow(r1));
+	UT_ASSERT(t->insertRow(r1same));
+	tlog = trace->getBuffer()->print();
+	UT_IS(tlog, "");
+	UT_IS(aggCalls, 0);
+	UT_IS(t->findRow(r1), rh1);
+	UT_IS(t->size(), 1);
+
+	// a different row still gets replaced
+	trace->clearBuffer();
+	aggCalls = 0;
+	UT_ASSERT(t->insertRow(r1diff));
+	tlog = trace->getBuffer()->print();
+	UT_IS(tlog, 
+		"unit 'u' before label 't.pre' op OP_DELETE\n"
+		"unit 'u' before label 'dummy' (chain 't.pre') op OP_DELETE\n"
+		"unit 'u' before label 't.out' op OP_DELETE\n"
+		"unit 'u' before label 't.pre' op OP_INSERT\n"
+		"unit 'u' before label 'dummy' (chain 't.pre') op OP_INSERT\n"
+		"unit 'u' before label 't.out' op OP_INSERT\n"
+	);
+	UT_IS(aggCalls, 3);
+	UT_IS(t->findRow(r1)->getRow(), r1diff.get());
+
+	// NOP
+	t->setIdenticalReplace(Table::IR_NOP);
+	trace->clearBuffer();
+	aggCalls = 0;
+	UT_ASSERT(t->insertRow(r1diff));
+	tlog = trace->getBuffer()->print();
+	UT_IS(tlog, "unit 'u' before label 't.out' op OP_NOP\n");
+	UT_IS(aggCalls, 0);
+	UT_IS(t->size(), 1);
+
+	// a plain insert is not affected
+	one32 = 2;
+	dv[1].data_ = (char *)&one32;
+	Rowref r3(rt1,  rt1->makeRow(dv));
+	trace->clearBuffer();
+	UT_ASSERT(t->insertRow(r3));
+	tlog = trace->getBuffer()->print();
+	UT_IS(tlog, 
+		"unit 'u' before label 't.pre' op OP_INSERT\n"
+		"unit 'u' before label 'dummy' (chain 't.pre') op OP_INSERT\n"
+		"unit 'u' before label 't.out' op OP_INSERT\n"
+	);
+	UT_IS(t->size(), 2);
+
+	// a sticky error set while sending the NOP gets reported
+	make_catchable();
+	Autoref<Label> lsticky = new StickyErrorLabel(unit, rt1, "lsticky", t);
+	UT_ASSERT(t->getLabel()->chain(lsticky).isNull());
+	string msg;
+	try {
+		t->insertRow(r3);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "test error\n");
+	restore_uncatchable();
+}
+
+// counts the rowops passing through it
+class LabelCount : public Label
+{
+public:
+	LabelCount(Unit *unit, Onceref<RowType> rtype, const string &name) :
+		Label(unit, rtype, name),
+		count_(0)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		count_++;
+	}
+
+	mutable int count_;
+};
+
+int updCalls = 0; // count of the one-step update calls
+
+// an aggregator that counts the one-step updates
+class UpdCountAggregator : public BasicAggregator
+{
+public:
+	virtual void handleUpdate(Table *table, AggregatorGadget *gadget, Index *index,
+		const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		RowHandle *oldrh, RowHandle *newrh)
+	{
+		updCalls++;
+		Aggregator::handleUpdate(table, gadget, index, parentIndexType, gh, dest, oldrh, newrh);
+	}
+};
+
+class UpdCountAggregatorType : public BasicAggregatorType
+{
+public:
+	UpdCountAggregatorType(const string &name, const RowType *rt, Callback *cb) :
+		BasicAggregatorType(name, rt, cb)
+	{ }
+
+	virtual AggregatorType *copy() const
+	{
+		return new UpdCountAggregatorType(*this);
+	}
+
+	virtual Aggregator *makeAggregator(Table *table, AggregatorGadget *gadget) const
+	{
+		return new UpdCountAggregator;
+	}
+};
+
+UTESTCASE sendUpdates(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	Autoref<TableType> tt = initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)->setAggregator(new UpdCountAggregatorType("agg", rt1, countAggCalls))
+		)
+		->addSubIndex("byc", HashedIndexType::make(
+				NameSet::make()->add("c")
+			)->addSubIndex("fifo", FifoIndexType::make()
+				->setAggregator(new UpdCountAggregatorType("aggc", rt1, countAggCalls))
+			)
+		)
+	);
+
+	Autoref<Table> t = tt->makeTable(unit, "t");
+	UT_ASSERT(!t.isNull());
+	UT_ASSERT(!t->getSendUpdates());
+	t->setSendUpdates(true);
+	UT_ASSERT(t->getSendUpdates());
+
+	Autoref<Label> dummy = new DummyLabel(unit, rt1, "dummy");
+	UT_ASSERT(t->getPreLabel()->chain(dummy).isNull());
+
+	FdataVec dv;
+	mkfdata(dv);
+	int32_t one32 = 1;
+	int64_t one64 = 1, two64 = 2;
+	dv[1].data_ = (char *)&one32; dv[2].data_ = (char *)&one64;
+	Rowref r1(rt1,  rt1->makeRow(dv));
+	dv[2].data_ = (char *)&two64;
+	Rowref r2(rt1,  rt1->makeRow(dv));
+
+	UT_ASSERT(t->insertRow(r1));
+
+	// the replacement becomes an update, the aggregator on the primary
+	// index gets a single call, the one on "byc" sees two different groups
+	trace->clearBuffer();
+	aggCalls = updCalls = 0;
+	UT_ASSERT(t->insertRow(r2));
+	string tlog = trace->getBuffer()->print();
+	UT_IS(tlog, 
+		"unit 'u' before label 't.pre' op OP_UPDATE\n"
+		"unit 'u' before label 'dummy' (chain 't.pre') op OP_UPDATE\n"
+		"unit 'u' before label 't.out' op OP_UPDATE\n"
+	);
+	UT_IS(updCalls, 1);
+	UT_IS(aggCalls, 2+2+1+1+1); // 2 before, 2 in update, 1 after delete, 1 after insert, 1 collapse
+	UT_IS(t->size(), 1);
+	UT_IS(t->findRow(r1)->getRow(), r2.get());
+
+	// the same group on both indexes
+	trace->clearBuffer();
+	aggCalls = updCalls = 0;
+	UT_ASSERT(t->insertRow(r2));
+	UT_IS(updCalls, 2);
+
+	// the input label accepts the updates, including the ones that change the key
+	one32 = 2;
+	dv[1].data_ = (char *)&one32;
+	Rowref r3(rt1,  rt1->makeRow(dv));
+	unit->call(Rowop::makeUpdate(t->getInputLabel(), r3, r2));
+	UT_IS(t->size(), 1);
+	UT_ASSERT(t->findRow(r2) == NULL);
+	UT_IS(t->findRow(r3)->getRow(), r3.get());
+
+	// the rowop counts on a replace-heavy workload, with the updates
+	// and with the updates split back into the deletes and inserts
+	unit->setTracer(NULL);
+	Autoref<Table> t2 = tt->makeTable(unit, "t2");
+	Autoref<LabelCount> cntUpd = new LabelCount(unit, rt1, "cntUpd");
+	Autoref<UpdateSplitLabel> split = new UpdateSplitLabel(unit, rt1, "split");
+	Autoref<LabelCount> cntSplit = new LabelCount(unit, rt1, "cntSplit");
+	Autoref<LabelCount> cntOld = new LabelCount(unit, rt1, "cntOld");
+	UT_ASSERT(t->getLabel()->chain(cntUpd).isNull());
+	UT_ASSERT(t->getLabel()->chain(split).isNull());
+	UT_ASSERT(split->getOutputLabel()->chain(cntSplit).isNull());
+	UT_ASSERT(t2->getLabel()->chain(cntOld).isNull());
+
+	t->clear();
+	cntUpd->count_ = cntSplit->count_ = 0;
+	const int nkeys = 10, nrows = 1000;
+	for (int i = 0; i < nrows; i++) {
+		int32_t key = i % nkeys;
+		int64_t val = i;
+		dv[1].data_ = (char *)&key; dv[2].data_ = (char *)&val;
+		Rowref r(rt1,  rt1->makeRow(dv));
+		t->insertRow(r);
+		t2->insertRow(r);
+	}
+	UT_IS(cntOld->count_, nkeys + 2*(nrows - nkeys));
+	UT_IS(cntUpd->count_, nrows);
+	UT_IS(cntSplit->count_, cntOld->count_);
+	UT_IS(t->size(), t2->size());
+}
@@ -0,0 +1,246 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the table dump into a file and the reload from it.
+
+#include <utest/Utest.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/Table.h>
+#include <table/TableDump.h>
+#include <type/BasicAggregatorType.h>
+#include <mem/Rhref.h>
+
+#include <utest/TestHelpers.h>
+
+int aggCalls = 0;
+
+void countAggCalls(Table *table, AggregatorGadget *gadget, Index *index,
+        const IndexType *parentIndexType, GroupHandle *gh, Tray *dest,
+		Aggregator::AggOp aggop, Rowop::Opcode opcode, RowHandle *rh)
+{
+	aggCalls++;
+	if (opcode != Rowop::OP_NOP && rh != NULL)
+		gadget->sendDelayed(dest, rh->getRow(), opcode);
+}
+
+// make a temporary file name for the test
+string tmpName(const char *suffix)
+{
+	return strprintf("/tmp/t_TableDump.%d.%s", (int)getpid(), suffix);
+}
+
+Onceref<TableType> mkTableType(RowType *rt1)
+{
+	return initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)
+		)
+		->addSubIndex("byc", HashedIndexType::make(
+				NameSet::make()->add("c")
+			)->addSubIndex("fifo", FifoIndexType::make()
+				->setAggregator(new BasicAggregatorType("aggr", rt1, countAggCalls))
+			)
+		)
+	);
+}
+
+void fillTable(Table *t, RowType *rt1, int n)
+{
+	FdataVec dv;
+	mkfdata(dv);
+	for (int i = 0; i < n; i++) {
+		int32_t b = i;
+		int64_t c = i % 7;
+		dv[1].data_ = (char *)&b; dv[2].data_ = (char *)&c;
+		if (i % 5 == 0)
+			dv[4].notNull_ = false;
+		else
+			dv[4].notNull_ = true;
+		Rowref r(rt1,  rt1->makeRow(dv));
+		t->insertRow(r);
+	}
+}
+
+UTESTCASE dumpLoad(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	fillTable(t1, rt1, 1000);
+	UT_IS(t1->size(), 1000);
+
+	string fname = tmpName("dump");
+	UT_IS(TableDump::write(t1, fname), 1000);
+	UT_ASSERT(access((fname + ".tmp").c_str(), F_OK) < 0);
+
+	Autoref<Table> t2 = tt->makeTable(unit, "t2");
+	Autoref<Label> dummy = new DummyLabel(unit, rt1, "dummy");
+	UT_ASSERT(t2->getPreLabel()->chain(dummy).isNull());
+	UT_ASSERT(t2->getLabel()->chain(dummy).isNull());
+
+	trace->clearBuffer();
+	aggCalls = 0;
+	UT_IS(TableDump::load(t2, fname), 1000);
+	UT_IS(trace->getBuffer()->print(), ""); // nothing sent
+	UT_ASSERT(unit->empty());
+	UT_ASSERT(aggCalls > 0); // the aggregators still see the rows
+	UT_ASSERT(!t2->isQuiet());
+	UT_ASSERT(!t2->isOrderedLoad());
+
+	// the same contents in the same order
+	UT_IS(t2->size(), 1000);
+	RowHandle *rh1 = t1->begin(), *rh2 = t2->begin();
+	int nmatch = 0;
+	for (; rh1 != NULL && rh2 != NULL; rh1 = t1->next(rh1), rh2 = t2->next(rh2)) {
+		if (rt1->equalRows(rh1->getRow(), rh2->getRow()))
+			nmatch++;
+	}
+	UT_IS(nmatch, 1000);
+	UT_ASSERT(rh1 == NULL && rh2 == NULL);
+
+	// the secondary index works too
+	IndexType *byc = tt->findSubIndex("byc");
+	FdataVec dv;
+	mkfdata(dv);
+	int64_t c = 3;
+	dv[2].data_ = (char *)&c;
+	Rowref pattern(rt1,  rt1->makeRow(dv));
+	UT_IS(t2->groupSizeRowIdx(byc, pattern), t1->groupSizeRowIdx(byc, pattern));
+
+	// the order of another index
+	UT_IS(TableDump::write(t1, fname, tt->findSubIndex("byc")->findSubIndex("fifo")), 1000);
+	Autoref<Table> t3 = tt->makeTable(unit, "t3");
+	UT_IS(TableDump::load(t3, fname), 1000);
+	UT_IS(t3->size(), 1000);
+
+	// an empty table
+	Autoref<Table> t4 = tt->makeTable(unit, "t4");
+	UT_IS(TableDump::write(t4, fname), 0);
+	UT_IS(TableDump::load(t4, fname), 0);
+	UT_IS(t4->size(), 0);
+
+	unlink(fname.c_str());
+}
+
+UTESTCASE loadErrors(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	fillTable(t1, rt1, 100);
+
+	string fname = tmpName("err");
+	UT_IS(TableDump::write(t1, fname), 100);
+
+	string msg;
+
+	// a different table type
+	Autoref<TableType> tt2 = initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("c")
+			)
+		)
+	);
+	Autoref<Table> t2 = tt2->makeTable(unit, "t2");
+	try {
+		TableDump::load(t2, fname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("contains the data of a different table type") != string::npos);
+	UT_IS(t2->size(), 0);
+
+	// truncated file
+	FILE *f = fopen(fname.c_str(), "r+");
+	UT_ASSERT(f != NULL);
+	fseek(f, 0, SEEK_END);
+	long flen = ftell(f);
+	fclose(f);
+	UT_ASSERT(truncate(fname.c_str(), flen - 10) == 0);
+
+	Autoref<Table> t3 = tt->makeTable(unit, "t3");
+	msg.clear();
+	try {
+		TableDump::load(t3, fname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The table dump file '" + fname + "' is truncated after 99 rows of 100.\n");
+	UT_ASSERT(!t3->isQuiet());
+
+	// not a dump
+	f = fopen(fname.c_str(), "w");
+	fprintf(f, "this is not a dump file but has to be long enough\n");
+	fclose(f);
+	msg.clear();
+	try {
+		TableDump::load(t3, fname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The file '" + fname + "' is not a table dump.\n");
+
+	// missing file
+	unlink(fname.c_str());
+	msg.clear();
+	try {
+		TableDump::load(t3, fname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "Failed to open the table dump file '" + fname + "': No such file or directory\n");
+
+	restore_uncatchable();
+}
+
+UTESTCASE imageCheck(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	FdataVec dv;
+	mkfdata(dv);
+	dv[3].notNull_ = false;
+	Rowref r1(rt1,  rt1->makeRow(dv));
+
+	intptr_t len;
+	const char *image = rt1->rowImage(r1, len);
+	UT_ASSERT(len > 0);
+
+	Rowref r2(rt1, rt1->makeRowFromImage(image, len));
+	UT_ASSERT(!r2.isNull());
+	UT_ASSERT(rt1->equalRows(r1, r2));
+	UT_ASSERT(rt1->isFieldNull(r2, 3));
+
+	// the inconsistent images get rejected
+	UT_IS(rt1->makeRowFromImage(image, len - 1), NULL);
+	UT_IS(rt1->makeRowFromImage(image, 3), NULL);
+	string bad(image, len);
+	bad[4] = 0x7f; // the offset of the second field
+	UT_IS(rt1->makeRowFromImage(bad.c_str(), len), NULL);
+}
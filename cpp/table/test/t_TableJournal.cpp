@@ -0,0 +1,258 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the rowop journal and of the table recovery from it.
+
+#include <utest/Utest.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/Table.h>
+#include <table/TableDump.h>
+#include <table/TableJournal.h>
+#include <mem/Rhref.h>
+
+#include <utest/TestHelpers.h>
+
+// make a temporary file name for the test
+string tmpName(const char *suffix)
+{
+	return strprintf("/tmp/t_TableJournal.%d.%s", (int)getpid(), suffix);
+}
+
+Onceref<TableType> mkTableType(RowType *rt1)
+{
+	return initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)
+		)
+	);
+}
+
+Rowref mkrow(RowType *rt1, int32_t b, int64_t c)
+{
+	FdataVec dv;
+	mkfdata(dv);
+	dv[1].data_ = (char *)&b; dv[2].data_ = (char *)&c;
+	return Rowref(rt1,  rt1->makeRow(dv));
+}
+
+// check that two tables have the same contents
+bool sameContents(Table *t1, Table *t2)
+{
+	if (t1->size() != t2->size())
+		return false;
+	for (RowHandle *rh = t1->begin(); rh != NULL; rh = t1->next(rh)) {
+		RowHandle *rh2 = t2->findRow(rh->getRow());
+		if (rh2 == NULL || !t1->getRowType()->equalRows(rh->getRow(), rh2->getRow()))
+			return false;
+	}
+	return true;
+}
+
+UTESTCASE journalReplay(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	UT_ASSERT(rt1->getErrors().isNull());
+	Autoref<TableType> tt = mkTableType(rt1);
+
+	string jname = tmpName("jrnl");
+	unlink(jname.c_str());
+
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	t1->setSendUpdates(true);
+	Autoref<TableJournal> j = new TableJournal(unit, rt1, "j", jname);
+	UT_ASSERT(j->isOpen());
+	UT_IS(j->getRecordCount(), 0);
+	size_t hdrSize = j->getSize();
+	UT_ASSERT(hdrSize > 0);
+	UT_ASSERT(t1->getLabel()->chain(j->getLabel()).isNull());
+
+	for (int i = 0; i < 100; i++)
+		unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, i, i)));
+	for (int i = 0; i < 100; i += 3) // produces the updates
+		unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, i, i+1000)));
+	for (int i = 1; i < 100; i += 3)
+		unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_DELETE, mkrow(rt1, i, 0)));
+	unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_DELETE, mkrow(rt1, 1000, 0))); // not found
+	UT_IS(j->getRecordCount(), 100 + 34 + 33);
+	UT_ASSERT(j->getSize() > hdrSize);
+	j->flush();
+	UT_IS(t1->size(), 100 - 33);
+
+	// replay is quiet
+	Autoref<Table> t2 = tt->makeTable(unit, "t2");
+	UT_ASSERT(t2->getLabel()->chain(new DummyLabel(unit, rt1, "dummy")).isNull());
+	trace->clearBuffer();
+	UT_IS(TableJournal::replay(t2, jname), 100 + 34 + 33);
+	UT_IS(trace->getBuffer()->print(), "");
+	UT_ASSERT(!t2->isQuiet());
+	UT_ASSERT(sameContents(t1, t2));
+
+	// a reopened journal continues after the existing records,
+	// and a torn tail gets truncated
+	j->close();
+	UT_ASSERT(!j->isOpen());
+	t1->getLabel()->clearChained();
+	FILE *f = fopen(jname.c_str(), "a");
+	fprintf(f, "torn");
+	fclose(f);
+
+	Autoref<TableJournal> j2 = new TableJournal(unit, rt1, "j2", jname);
+	UT_IS(j2->getRecordCount(), 100 + 34 + 33);
+	UT_IS(j2->getSize(), j->getSize());
+	UT_ASSERT(t1->getLabel()->chain(j2->getLabel()).isNull());
+	unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, 500, 1)));
+	j2->close();
+
+	Autoref<Table> t3 = tt->makeTable(unit, "t3");
+	UT_IS(TableJournal::replay(t3, jname), 100 + 34 + 33 + 1);
+	UT_ASSERT(sameContents(t1, t3));
+
+	unlink(jname.c_str());
+}
+
+UTESTCASE journalCheckpoint(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+
+	string jname = tmpName("cpjrnl");
+	string dname = tmpName("cpdump");
+	unlink(jname.c_str());
+	unlink(dname.c_str());
+
+	// the journal on the input label, with the group commit
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	Autoref<TableJournal> j = new TableJournal(unit, rt1, "j", jname);
+	j->setBufferSize(1024)->setSyncPolicy(TableJournal::SYNC_NONE);
+	UT_IS(j->getBufferSize(), 1024);
+	UT_IS(j->getSyncPolicy(), TableJournal::SYNC_NONE);
+	UT_ASSERT(t1->getInputLabel()->chain(j->getLabel()).isNull());
+
+	size_t hdrSize = j->getSize();
+	for (int i = 0; i < 50; i++)
+		unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, i, i)));
+	// the limit at about 100 records
+	j->setCheckpoint(t1, dname, hdrSize + (j->getSize() - hdrSize) * 2);
+	j->flush(); // below the limit
+	UT_ASSERT(access(dname.c_str(), F_OK) < 0);
+	for (int i = 0; i < 200; i++)
+		unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, i % 70, i)));
+	j->flush(); // triggers the checkpoint
+	UT_ASSERT(access(dname.c_str(), F_OK) == 0);
+	UT_IS(j->getSize(), hdrSize);
+	UT_IS(j->getRecordCount(), 0);
+
+	for (int i = 0; i < 10; i++)
+		unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_DELETE, mkrow(rt1, i, 0)));
+	unit->call(new Rowop(t1->getInputLabel(), Rowop::OP_INSERT, mkrow(rt1, 100, 100)));
+	j->flush();
+	UT_IS(t1->size(), 61);
+
+	Autoref<Table> t2 = tt->makeTable(unit, "t2");
+	UT_IS(TableJournal::recover(t2, dname, jname), 61);
+	UT_ASSERT(sameContents(t1, t2));
+
+	// a repeated replay changes nothing
+	UT_IS(TableJournal::replay(t2, jname), 11);
+	UT_ASSERT(sameContents(t1, t2));
+
+	// only a journal, without a dump
+	unlink(dname.c_str());
+	Autoref<Table> t3 = tt->makeTable(unit, "t3");
+	UT_IS(TableJournal::recover(t3, dname, jname), 1);
+
+	j->close();
+	unlink(jname.c_str());
+}
+
+UTESTCASE journalErrors(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+
+	string jname = tmpName("errjrnl");
+	unlink(jname.c_str());
+	Autoref<TableJournal> j = new TableJournal(unit, rt1, "j", jname);
+
+	string msg;
+
+	// a different row type
+	fld.pop_back();
+	Autoref<RowType> rt2 = new CompactRowType(fld);
+	try {
+		new TableJournal(unit, rt2, "j2", jname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("contains the data of a different row type") != string::npos);
+
+	// no checkpoint table
+	msg.clear();
+	try {
+		j->checkpoint();
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The journal 'j' has no table set for the checkpoints.\n");
+
+	// sending to a closed journal
+	j->close();
+	msg.clear();
+	try {
+		unit->call(new Rowop(j->getLabel(), Rowop::OP_INSERT, mkrow(rt1, 1, 1)));
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_ASSERT(msg.find("Can not write more rowops into the closed journal 'j'") != string::npos);
+
+	// not a journal
+	FILE *f = fopen(jname.c_str(), "w");
+	fprintf(f, "this is not a journal file but has to be long enough\n");
+	fclose(f);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	msg.clear();
+	try {
+		TableJournal::replay(t1, jname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The file '" + jname + "' is not a table journal.\n");
+
+	// missing file
+	unlink(jname.c_str());
+	msg.clear();
+	try {
+		TableJournal::replay(t1, jname);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "Failed to open the journal file '" + jname + "': No such file or directory\n");
+
+	restore_uncatchable();
+}
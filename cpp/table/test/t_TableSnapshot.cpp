@@ -0,0 +1,251 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the table snapshots.
+
+#include <utest/Utest.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/Table.h>
+#include <mem/Rhref.h>
+
+#include <utest/TestHelpers.h>
+
+Onceref<TableType> mkTableType(RowType *rt1)
+{
+	return initializeOrThrow(TableType::make(rt1)
+		->addSubIndex("primary", HashedIndexType::make(
+				NameSet::make()->add("b")
+			)
+		)
+		->addSubIndex("fifo", FifoIndexType::make())
+	);
+}
+
+Rowref mkrow(RowType *rt1, int32_t b, int64_t c)
+{
+	FdataVec dv;
+	mkfdata(dv);
+	dv[1].data_ = (char *)&b; dv[2].data_ = (char *)&c;
+	return Rowref(rt1,  rt1->makeRow(dv));
+}
+
+int64_t getC(const RowType *rt, const Row *row)
+{
+	return rt->getInt64(row, 2);
+}
+
+UTESTCASE snapshotBasic(Utest *utest)
+{
+	make_catchable();
+
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<Unit::StringNameTracer> trace = new Unit::StringNameTracer;
+	unit->setTracer(trace);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+	t1->enableSnapshots(); // before the rows, for the order of insertion
+
+	for (int i = 0; i < 10; i++)
+		t1->insertRow(mkrow(rt1, i, i));
+
+	Autoref<TableSnapshot> s1 = t1->snapshot();
+	UT_IS(s1->size(), 10);
+	UT_IS(s1->getTableName(), "t1");
+	UT_IS(s1->getRowType(), rt1.get());
+	UT_IS(t1->snapshot().get(), s1.get()); // cached
+
+	// the rows come in the order of insertion
+	for (int i = 0; i < 10; i++)
+		UT_IS(getC(rt1, s1->at(i)), i);
+
+	// the modifications don't change the snapshot
+	t1->insertRow(mkrow(rt1, 3, 100));
+	t1->deleteRow(mkrow(rt1, 5, 0));
+	UT_IS(t1->size(), 9);
+	UT_IS(s1->size(), 10);
+	UT_IS(getC(rt1, s1->at(3)), 3);
+	UT_IS(getC(rt1, s1->at(5)), 5);
+
+	Autoref<TableSnapshot> s3 = t1->snapshot();
+	UT_ASSERT(s3.get() != s1.get());
+	UT_IS(s3->size(), 9);
+	UT_IS(getC(rt1, s3->at(3)), 4);
+	UT_IS(getC(rt1, s3->at(8)), 100);
+
+	// the rows outlive the table
+	t1 = NULL;
+	UT_IS(s3->size(), 9);
+
+	// dumping
+	Autoref<Label> lb = new DummyLabel(unit, rt1, "lb");
+	trace->clearBuffer();
+	s3->dump(lb);
+	UT_IS(trace->getBuffer()->size(), 9);
+
+	// errors
+	string msg;
+	fld.pop_back();
+	Autoref<RowType> rt2 = new CompactRowType(fld);
+	Autoref<Label> lb2 = new DummyLabel(unit, rt2, "lb2");
+	msg.clear();
+	try {
+		s3->dump(lb2);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "The snapshot of the table 't1' can not be sent to the label 'lb2' with a non-matching row type.\n");
+
+	restore_uncatchable();
+}
+
+UTESTCASE snapshotReclaim(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+
+	for (int i = 0; i < 10; i++)
+		t1->insertRow(mkrow(rt1, i, i));
+	UT_ASSERT(!t1->isSnapshotEnabled());
+
+	// the enabling picks up the existing rows
+	t1->enableSnapshots();
+	UT_ASSERT(t1->isSnapshotEnabled());
+	TableVersions *ver = t1->getVersions();
+	UT_IS(ver->getEntryCount(), 10);
+
+	// with no snapshots the removed rows get dropped right away
+	t1->deleteRow(mkrow(rt1, 0, 0));
+	t1->insertRow(mkrow(rt1, 1, 100)); // replaces
+	UT_IS(ver->getEntryCount(), 9);
+
+	// a live snapshot keeps the removed rows
+	Autoref<TableSnapshot> s1 = t1->snapshot();
+	for (int i = 2; i < 10; i++)
+		t1->deleteRow(mkrow(rt1, i, 0));
+	UT_IS(t1->size(), 1);
+	UT_IS(ver->getEntryCount(), 9);
+	UT_IS(s1->size(), 9);
+	UT_IS(getC(rt1, s1->at(8)), 100);
+
+	// a newer snapshot doesn't see them
+	Autoref<TableSnapshot> s2 = t1->snapshot();
+	UT_IS(s2->size(), 1);
+
+	// dropping the old snapshot unlinks them on the next modification,
+	// and the newer snapshot keeps them from being freed until it's gone
+	s1 = NULL;
+	t1->insertRow(mkrow(rt1, 20, 20));
+	UT_IS(ver->getEntryCount(), 10);
+	UT_IS(s2->size(), 1);
+
+	s2 = NULL;
+	t1->insertRow(mkrow(rt1, 21, 21));
+	UT_IS(ver->getEntryCount(), 3);
+	UT_IS(t1->snapshot()->size(), 3);
+}
+
+// The reader reads the snapshots handed over by the owner thread.
+struct SnapshotExchange
+{
+	pthread_mutex_t mutex_;
+	Autoref<TableSnapshot> snap_;
+	size_t size_; // the expected size of snap_
+	bool done_;
+	int64_t checks_;
+	int errors_;
+};
+
+void *snapshotReader(void *arg)
+{
+	SnapshotExchange *ex = (SnapshotExchange *)arg;
+	for (;;) {
+		Autoref<TableSnapshot> snap;
+		pthread_mutex_lock(&ex->mutex_);
+		bool done = ex->done_;
+		snap = ex->snap_;
+		size_t size = ex->size_;
+		pthread_mutex_unlock(&ex->mutex_);
+		if (snap.isNull()) {
+			if (done)
+				break;
+			continue;
+		}
+		// every snapshot must have the rows with b==c in order, as in the table
+		const RowType *rt = snap->getRowType();
+		const TableSnapshot::RowVec &rows = snap->getRows();
+		if (rows.size() != size)
+			ex->errors_++;
+		for (size_t i = 0; i < rows.size(); i++) {
+			if (rt->getInt32(rows[i], 1) != getC(rt, rows[i]))
+				ex->errors_++;
+		}
+		ex->checks_++;
+		if (done)
+			break;
+	}
+	return NULL;
+}
+
+UTESTCASE snapshotThreads(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	Autoref<TableType> tt = mkTableType(rt1);
+	Autoref<Table> t1 = tt->makeTable(unit, "t1");
+
+	SnapshotExchange ex;
+	pthread_mutex_init(&ex.mutex_, NULL);
+	ex.size_ = 0;
+	ex.done_ = false;
+	ex.checks_ = 0;
+	ex.errors_ = 0;
+
+	pthread_t th;
+	pthread_create(&th, NULL, snapshotReader, &ex);
+
+	// keep modifying the table and publishing the snapshots; the old
+	// snapshots get released in whichever thread drops them last
+	for (int i = 0; i < 2000; i++) {
+		t1->insertRow(mkrow(rt1, i % 300, i % 300));
+		if (i % 3 == 0)
+			t1->deleteRow(mkrow(rt1, (i * 7) % 300, 0));
+		if (i % 10 == 0) {
+			Autoref<TableSnapshot> snap = t1->snapshot();
+			pthread_mutex_lock(&ex.mutex_);
+			ex.snap_ = snap;
+			ex.size_ = t1->size();
+			pthread_mutex_unlock(&ex.mutex_);
+		}
+	}
+	pthread_mutex_lock(&ex.mutex_);
+	ex.snap_ = t1->snapshot();
+	ex.size_ = t1->size();
+	ex.done_ = true;
+	pthread_mutex_unlock(&ex.mutex_);
+
+	pthread_join(th, NULL);
+	pthread_mutex_destroy(&ex.mutex_);
+
+	UT_ASSERT(ex.checks_ > 0);
+	UT_IS(ex.errors_, 0);
+}
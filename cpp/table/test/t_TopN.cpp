@@ -0,0 +1,290 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the top-N index.
+
+#include <utest/Utest.h>
+#include <string.h>
+
+#include <common/Common.h>
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/Table.h>
+#include <mem/Rhref.h>
+
+// Make fields of all simple types
+void mkfields(RowType::FieldVec &fields)
+{
+	fields.clear();
+	fields.push_back(RowType::Field("a", Type::r_uint8, 10));
+	fields.push_back(RowType::Field("b", Type::r_int32,0));
+	fields.push_back(RowType::Field("c", Type::r_int64));
+	fields.push_back(RowType::Field("d", Type::r_float64));
+	fields.push_back(RowType::Field("e", Type::r_string));
+}
+
+uint8_t v_uint8[10] = "123456789";
+int32_t v_int32 = 1234;
+int64_t v_int64 = 0xdeadbeefc00c;
+double v_float64 = 9.99e99;
+char v_string[] = "hello world";
+
+void mkfdata(FdataVec &fd)
+{
+	fd.resize(4);
+	fd[0].setPtr(true, &v_uint8, sizeof(v_uint8));
+	fd[1].setPtr(true, &v_int32, sizeof(v_int32));
+	fd[2].setPtr(true, &v_int64, sizeof(v_int64));
+	fd[3].setPtr(true, &v_float64, sizeof(v_float64));
+	// test the constructor
+	fd.push_back(Fdata(true, &v_string, sizeof(v_string)));
+}
+
+// make the exceptions catchable
+void make_catchable()
+{
+	Exception::abort_ = false; // make them catchable
+	Exception::enableBacktrace_ = false; // make the error messages predictable
+}
+
+// restore the exceptions back to the uncatchable state
+void restore_uncatchable()
+{
+	Exception::abort_ = true;
+	Exception::enableBacktrace_ = true;
+}
+
+// sort by field "b"
+class MySortB : public SortedIndexCondition
+{
+public:
+	// no internal configuration, all copies are the same
+	MySortB()
+	{ }
+	MySortB(const MySortB *other, Table *t) :
+		SortedIndexCondition(other, t)
+	{ }
+	virtual TreeIndexType::Less *tableCopy(Table *t) const
+	{
+		return new MySortB(this, t);
+	}
+	virtual bool equals(const SortedIndexCondition *sc) const
+	{
+		return true;
+	}
+	virtual bool match(const SortedIndexCondition *sc) const
+	{
+		return true;
+	}
+	virtual void printTo(string &res, const string &indent = "", const string &subindent = "  ") const
+	{
+		res.append("MySortB()");
+	}
+	virtual SortedIndexCondition *copy() const
+	{
+		return new MySortB(*this);
+	}
+
+	virtual bool operator() (const RowHandle *r1, const RowHandle *r2) const
+	{
+		int32_t a = rt_->getInt32(r1->getRow(), 1);
+		int32_t b = rt_->getInt32(r2->getRow(), 1);
+		return (a < b);
+	}
+};
+
+// sort by field "c"
+class MySortC : public SortedIndexCondition
+{
+public:
+	// no internal configuration, all copies are the same
+	MySortC()
+	{ }
+	MySortC(const MySortC *other, Table *t) :
+		SortedIndexCondition(other, t)
+	{ }
+	virtual TreeIndexType::Less *tableCopy(Table *t) const
+	{
+		return new MySortC(this, t);
+	}
+	virtual bool equals(const SortedIndexCondition *sc) const
+	{
+		return true;
+	}
+	virtual bool match(const SortedIndexCondition *sc) const
+	{
+		return true;
+	}
+	virtual void printTo(string &res, const string &indent = "", const string &subindent = "  ") const
+	{
+		res.append("MySortC()");
+	}
+	virtual SortedIndexCondition *copy() const
+	{
+		return new MySortC(*this);
+	}
+
+	virtual bool operator() (const RowHandle *r1, const RowHandle *r2) const
+	{
+		int64_t a = rt_->getInt64(r1->getRow(), 2);
+		int64_t b = rt_->getInt64(r2->getRow(), 2);
+		return (a < b);
+	}
+};
+
+// records the row operations on the table output
+class OutLabel : public Label
+{
+public:
+	OutLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name = "") :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		const RowType *rt = getType();
+		res_.append(strprintf("%s %s c=%d\n", Rowop::opcodeString(arg->getOpcode()),
+			rt->getString(arg->getRow(), 4), (int)rt->getInt64(arg->getRow(), 2)));
+	}
+
+	mutable string res_;
+};
+
+// the values of c in the group of a row, in the iteration order
+string listGroup(Table *t, IndexType *ixt, RowHandle *what)
+{
+	string res;
+	const RowType *rt = t->getRowType();
+	RowHandle *end = t->nextGroupIdx(ixt, what);
+	for (RowHandle *rh = t->firstOfGroupIdx(ixt, what); rh != end; rh = t->nextIdx(ixt, rh))
+		res.append(strprintf(" %d", (int)rt->getInt64(rh->getRow(), 2)));
+	return res;
+}
+
+UTESTCASE topN(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	for (int rev = 0; rev < 2; rev++) {
+		Autoref<TableType> tt = TableType::make(rt1)
+			->addSubIndex("byE", HashedIndexType::make(
+					NameSet::make()->add("e")
+				)->addSubIndex("top", TopNIndexType::make(new MySortC, 3, rev))
+			);
+		tt->initialize();
+		if (UT_ASSERT(tt->getErrors().isNull())) {
+			printf("errors:\n%s", tt->getErrors()->print().c_str());
+			return;
+		}
+		TopNIndexType *topt = static_cast<TopNIndexType *>(tt->findSubIndex("byE")->findSubIndex("top"));
+		UT_IS(topt->getIndexId(), IndexType::IT_TOPN);
+		UT_IS(topt->getLimit(), 3);
+		UT_IS(topt->isReverse(), (bool)rev);
+		UT_IS(topt->print(), rev? "index TopNIndex(limit=3 reverse) MySortC()" : "index TopNIndex(limit=3) MySortC()");
+
+		Autoref<Table> t = tt->makeTable(unit, "t");
+		Autoref<OutLabel> out = new OutLabel(unit, rt1, "out");
+		t->getLabel()->chain(out);
+
+		FdataVec dv;
+		mkfdata(dv);
+		int64_t ival;
+		dv[2].setPtr(true, &ival, sizeof(ival));
+		char sval[2] = "A";
+		dv[4].setPtr(true, &sval, sizeof(sval));
+
+		int64_t vals[] = { 5, 3, 8, 1, 9, 4 };
+		bool okAsc[] = { true, true, true, true, false, true };
+		bool okDesc[] = { true, true, true, false, true, false };
+		for (int i = 0; i < 6; i++) {
+			ival = vals[i];
+			UT_IS(t->insertRow(Rowref(rt1, rt1->makeRow(dv))), rev? okDesc[i] : okAsc[i]);
+		}
+		// another group is independent
+		sval[0] = 'B';
+		ival = 100;
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+		sval[0] = 'A';
+
+		Rhref what(t, t->makeRowHandle(Rowref(rt1, rt1->makeRow(dv))));
+		RowHandle *first = t->findIdx(tt->findSubIndex("byE"), what);
+		UT_ASSERT(first != NULL);
+		if (rev) {
+			UT_IS(listGroup(t, topt, first), " 5 8 9");
+			UT_IS(out->res_,
+				"OP_INSERT A c=5\n"
+				"OP_INSERT A c=3\n"
+				"OP_INSERT A c=8\n"
+				"OP_DELETE A c=3\n"
+				"OP_INSERT A c=9\n"
+				"OP_INSERT B c=100\n"
+			);
+		} else {
+			UT_IS(listGroup(t, topt, first), " 1 3 4");
+			UT_IS(out->res_,
+				"OP_INSERT A c=5\n"
+				"OP_INSERT A c=3\n"
+				"OP_INSERT A c=8\n"
+				"OP_DELETE A c=8\n"
+				"OP_INSERT A c=1\n"
+				"OP_DELETE A c=5\n"
+				"OP_INSERT A c=4\n"
+				"OP_INSERT B c=100\n"
+			);
+		}
+		out->res_.clear();
+
+		// the same key replaces the old row, without pushing out another one
+		ival = rev? 8 : 3;
+		UT_ASSERT(t->insertRow(Rowref(rt1, rt1->makeRow(dv))));
+		UT_IS(out->res_, strprintf("OP_DELETE A c=%d\nOP_INSERT A c=%d\n", (int)ival, (int)ival));
+		UT_IS(t->size(), 4);
+	}
+}
+
+UTESTCASE topNErrors(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+
+	Autoref<TableType> tt = TableType::make(rt1)
+		->addSubIndex("top", TopNIndexType::make(new MySortC, 0)
+			->addSubIndex("fifo", FifoIndexType::make())
+		);
+	tt->initialize();
+	UT_IS(tt->getErrors()->print(),
+		"index error:\n"
+		"  nested index 1 'top':\n"
+		"    TopNIndexType currently does not support further nested indexes\n"
+		"    TopNIndexType requires a non-0 limit\n"
+	);
+
+	// the copies keep the settings
+	Autoref<TopNIndexType> topt = TopNIndexType::make(new MySortB, 5, true);
+	Autoref<IndexType> cp = topt->copy();
+	UT_ASSERT(topt->equals(cp));
+	UT_ASSERT(topt->match(cp));
+	UT_ASSERT(!topt->equals(TopNIndexType::make(new MySortB, 4, true)));
+	UT_ASSERT(!topt->equals(TopNIndexType::make(new MySortB, 5, false)));
+	UT_ASSERT(!topt->equals(SortedIndexType::make(new MySortB)));
+
+	make_catchable();
+	string msg;
+	tt = TableType::make(rt1)->addSubIndex("top", topt);
+	tt->initialize();
+	try {
+		static_cast<TopNIndexType *>(tt->findSubIndex("top"))->setLimit(10);
+	} catch (Exception e) {
+		msg = e.getErrors()->print();
+	}
+	UT_IS(msg, "Attempted to set the limit on an initialized TopN index type\n");
+	restore_uncatchable();
+}
@@ -0,0 +1,315 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Test of the aggregation in the event-time windows.
+
+#include <utest/Utest.h>
+#include <string.h>
+
+#include <type/AllTypes.h>
+#include <common/StringUtil.h>
+#include <table/WindowedAggregation.h>
+
+#include <utest/TestHelpers.h>
+
+// prints the window results
+class ResultLabel : public Label
+{
+public:
+	ResultLabel(Unit *unit, const_Onceref<RowType> rtype, const string &name = "") :
+		Label(unit, rtype, name)
+	{ }
+
+	virtual void execute(Rowop *arg) const
+	{
+		const RowType *rt = getType();
+		const Row *row = arg->getRow();
+		res_.append(strprintf("%s [%d,%d) k=%s n=%d s=%d\n", Rowop::opcodeString(arg->getOpcode()),
+			(int)rt->getInt64(row, 0), (int)rt->getInt64(row, 1),
+			rt->getString(row, 2), (int)rt->getInt64(row, 3), (int)rt->getInt64(row, 4)));
+	}
+
+	mutable string res_;
+};
+
+Onceref<RowType> mkWinType()
+{
+	RowType::FieldVec fld;
+	fld.push_back(RowType::Field("k", Type::r_string));
+	fld.push_back(RowType::Field("t", Type::r_int64));
+	fld.push_back(RowType::Field("v", Type::r_int64));
+	return new CompactRowType(fld);
+}
+
+Onceref<AdditiveAggregatorType> mkWinAgg()
+{
+	return (new AdditiveAggregatorType("aggr"))
+		->addField("k", "last", "k")
+		->addField("n", "count_star")
+		->addField("s", "sum", "v")
+	;
+}
+
+Rowref mkwrow(RowType *rt, const char *k, int64_t t, int64_t v)
+{
+	FdataVec dv(3);
+	dv[0].setPtr(true, k, strlen(k)+1);
+	dv[1].setPtr(true, &t, sizeof(t));
+	dv[2].setPtr(true, &v, sizeof(v));
+	return Rowref(rt, rt->makeRow(dv));
+}
+
+Rowref mkwm(const RowType *rt, int64_t t)
+{
+	FdataVec dv(1);
+	dv[0].setPtr(true, &t, sizeof(t));
+	return Rowref(rt, rt->makeRow(dv));
+}
+
+UTESTCASE tumbling(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<RowType> rt = mkWinType();
+	Autoref<Unit> unit = new Unit("u");
+
+	Autoref<WindowedAggregation> wa = new WindowedAggregation(unit, "wa", rt, "t", 10, 10,
+		NameSet::make()->add("k"), mkWinAgg());
+	UT_IS(wa->getName(), "wa");
+	UT_IS(wa->getInputLabel()->getName(), "wa.in");
+	UT_IS(wa->getWatermarkLabel()->getName(), "wa.watermark");
+	UT_IS(wa->getLabel()->getName(), "wa.out");
+	UT_IS(wa->getResultType()->fields()[0].name_, "window_start");
+	UT_IS(wa->getResultType()->fields()[1].name_, "window_end");
+	UT_IS(wa->getResultType()->fields()[2].name_, "k");
+	UT_IS(wa->getWatermarkType()->fields()[0].name_, "t");
+	UT_ASSERT(!wa->isAutoWatermark());
+
+	Autoref<ResultLabel> res = new ResultLabel(unit, wa->getLabel()->getType(), "res");
+	wa->getLabel()->chain(res);
+
+	Label *in = wa->getInputLabel();
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "B", 1, 1)));
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 5, 2)));
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 9, 3)));
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 10, 4)));
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", -3, 5)));
+	UT_IS(wa->windowCount(), 3);
+	UT_IS(wa->groupCount(), 4);
+	UT_IS(wa->getMaxTime(), 10);
+	// the deletion of the last row in a group removes the group
+	unit->call(new Rowop(in, Rowop::OP_DELETE, mkwrow(rt, "B", 1, 1)));
+	UT_IS(wa->groupCount(), 3);
+	// nothing is sent until the watermark
+	UT_IS(res->res_, "");
+
+	unit->call(new Rowop(wa->getWatermarkLabel(), Rowop::OP_INSERT, mkwm(wa->getWatermarkType(), 9)));
+	UT_IS(wa->getWatermark(), 9);
+	UT_IS(res->res_, "OP_INSERT [-10,0) k=A n=1 s=5\n");
+	UT_IS(wa->windowCount(), 2);
+
+	unit->call(new Rowop(wa->getWatermarkLabel(), Rowop::OP_INSERT, mkwm(wa->getWatermarkType(), 10)));
+	UT_IS(res->res_,
+		"OP_INSERT [-10,0) k=A n=1 s=5\n"
+		"OP_INSERT [0,10) k=A n=2 s=5\n");
+	UT_IS(wa->windowCount(), 1);
+	UT_IS(wa->groupCount(), 1);
+
+	// the watermark doesn't go back
+	wa->advanceWatermark(5);
+	UT_IS(wa->getWatermark(), 10);
+
+	// the late rows get dropped
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 9, 100)));
+	unit->call(new Rowop(in, Rowop::OP_DELETE, mkwrow(rt, "A", 5, 2)));
+	UT_IS(wa->getLateCount(), 2);
+	UT_IS(wa->windowCount(), 1);
+
+	// an update goes into the open window
+	Rowref rnew = mkwrow(rt, "B", 12, 6), rold = mkwrow(rt, "A", 10, 4);
+	unit->call(Rowop::makeUpdate(in, rnew.get(), rold.get()));
+	UT_IS(wa->groupCount(), 1);
+
+	wa->flush();
+	UT_IS(wa->getWatermark(), 20);
+	UT_IS(wa->windowCount(), 0);
+	UT_IS(wa->groupCount(), 0);
+	UT_IS(res->res_,
+		"OP_INSERT [-10,0) k=A n=1 s=5\n"
+		"OP_INSERT [0,10) k=A n=2 s=5\n"
+		"OP_INSERT [10,20) k=B n=1 s=6\n");
+
+	restore_uncatchable();
+}
+
+UTESTCASE hopping(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<RowType> rt = mkWinType();
+	Autoref<Unit> unit = new Unit("u");
+
+	Autoref<WindowedAggregation> wa = new WindowedAggregation(unit, "wa", rt, "t", 10, 5,
+		NameSet::make()->add("k"), mkWinAgg());
+	wa->setLateness(3);
+	UT_ASSERT(wa->isAutoWatermark());
+	UT_IS(wa->getLateness(), 3);
+
+	Autoref<ResultLabel> res = new ResultLabel(unit, wa->getLabel()->getType(), "res");
+	wa->getLabel()->chain(res);
+
+	Label *in = wa->getInputLabel();
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 2, 1)));
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "B", 7, 2)));
+	UT_IS(wa->getWatermark(), 4);
+	// each row goes into 2 windows
+	UT_IS(wa->windowCount(), 3);
+	UT_IS(wa->groupCount(), 4);
+	UT_IS(res->res_, "");
+
+	// the watermark 10 closes [-5,5) and [0,10)
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 13, 4)));
+	UT_IS(wa->getWatermark(), 10);
+	UT_IS(res->res_,
+		"OP_INSERT [-5,5) k=A n=1 s=1\n"
+		"OP_INSERT [0,10) k=A n=1 s=1\n"
+		"OP_INSERT [0,10) k=B n=1 s=2\n");
+
+	// within the lateness, but only the window [5,15) is still open
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 9, 8)));
+	UT_IS(wa->getLateCount(), 0);
+	// too late for all the windows
+	unit->call(new Rowop(in, Rowop::OP_INSERT, mkwrow(rt, "A", 4, 16)));
+	UT_IS(wa->getLateCount(), 1);
+
+	wa->flush();
+	UT_IS(res->res_,
+		"OP_INSERT [-5,5) k=A n=1 s=1\n"
+		"OP_INSERT [0,10) k=A n=1 s=1\n"
+		"OP_INSERT [0,10) k=B n=1 s=2\n"
+		"OP_INSERT [5,15) k=A n=2 s=12\n"
+		"OP_INSERT [5,15) k=B n=1 s=2\n"
+		"OP_INSERT [10,20) k=A n=1 s=4\n");
+	UT_IS(wa->windowCount(), 0);
+
+	restore_uncatchable();
+}
+
+// the state gets freed as the windows close
+UTESTCASE windowFree(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<RowType> rt = mkWinType();
+	Autoref<Unit> unit = new Unit("u");
+
+	Autoref<WindowedAggregation> wa = new WindowedAggregation(unit, "wa", rt, "t", 100, 50,
+		NameSet::make()->add("k"), mkWinAgg());
+	wa->setLateness(0);
+
+	const char *keys[] = { "A", "B", "C", "D" };
+	size_t maxWindows = 0, maxGroups = 0;
+	for (int i = 0; i < 10000; i++) {
+		wa->insertRow(mkwrow(rt, keys[i % 4], i, 1));
+		if (wa->windowCount() > maxWindows)
+			maxWindows = wa->windowCount();
+		if (wa->groupCount() > maxGroups)
+			maxGroups = wa->groupCount();
+	}
+	UT_IS(maxWindows, 2);
+	UT_IS(maxGroups, 8);
+	UT_IS(wa->getLateCount(), 0);
+
+	restore_uncatchable();
+}
+
+UTESTCASE windowErrors(Utest *utest)
+{
+	make_catchable();
+
+	Autoref<RowType> rt = mkWinType();
+	Autoref<Unit> unit = new Unit("u");
+	Autoref<WindowedAggregation> wa;
+
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "t", 0, 10, NameSet::make()->add("k"), mkWinAgg());
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' must have a positive window size, got 0.\n");
+	}
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "t", 10, 11, NameSet::make()->add("k"), mkWinAgg());
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' must have the slide in the range 1..10 (the window size), got 11.\n");
+	}
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "x", 10, 10, NameSet::make()->add("k"), mkWinAgg());
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' can not find the time field 'x' in the row type.\n");
+	}
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "k", 10, 10, NameSet::make()->add("k"), mkWinAgg());
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' requires the time field 'k' to be an int64, not string.\n");
+	}
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "t", 10, 10, NameSet::make()->add("k"),
+				(new AdditiveAggregatorType("aggr"))->addField("m", "max", "v"));
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' can not compute the function 'max' in the result field 'm', it needs the rows.\n");
+	}
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "t", 10, 10, NameSet::make()->add("k"),
+				(new AdditiveAggregatorType("aggr"))->addField("window_end", "sum", "v"));
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' can not use the reserved name 'window_end' for an aggregator result field.\n");
+	}
+	{
+		string msg;
+		try {
+			wa = new WindowedAggregation(unit, "wa", rt, "t", 10, 10, NameSet::make()->add("k"), mkWinAgg());
+			wa->setLateness(-1);
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' must have a non-negative lateness, got -1.\n");
+	}
+	{
+		string msg;
+		try {
+			FdataVec dv(3); // all null
+			wa->insertRow(Rowref(rt, rt->makeRow(dv)));
+		} catch (Exception e) {
+			msg = e.getErrors()->print();
+		}
+		UT_IS(msg, "The windowed aggregation 'wa' received a row with the null time.\n");
+	}
+
+	restore_uncatchable();
+}
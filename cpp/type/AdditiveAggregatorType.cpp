@@ -0,0 +1,285 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps the additive state of SQL-like functions.
+
+#include <type/AdditiveAggregatorType.h>
+#include <type/TableType.h>
+#include <type/FifoIndexType.h>
+#include <table/AdditiveAggregator.h>
+#include <sched/AggregatorGadget.h>
+#include <common/StringUtil.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+Valname addAggFunctions[] = {
+	{ AdditiveAggregatorType::FN_FIRST, "first" },
+	{ AdditiveAggregatorType::FN_LAST, "last" },
+	{ AdditiveAggregatorType::FN_COUNT_STAR, "count_star" },
+	{ AdditiveAggregatorType::FN_COUNT, "count" },
+	{ AdditiveAggregatorType::FN_SUM, "sum" },
+	{ AdditiveAggregatorType::FN_AVG, "avg" },
+	{ AdditiveAggregatorType::FN_MIN, "min" },
+	{ AdditiveAggregatorType::FN_MAX, "max" },
+	{ AdditiveAggregatorType::FN_QUANTILE, "quantile" },
+	{ AdditiveAggregatorType::FN_COUNT_DISTINCT, "count_distinct" },
+	{ -1, NULL }
+};
+
+const char *AdditiveAggregatorType::functionString(int code, const char *def)
+{
+	return enum2string(addAggFunctions, code, def);
+}
+
+int AdditiveAggregatorType::stringFunction(const char *code)
+{
+	return string2enum(addAggFunctions, code);
+}
+
+AdditiveAggregatorType::FieldDef::FieldDef(const string &name, const string &func, const string &arg) :
+	name_(name),
+	funcName_(func),
+	arg_(arg),
+	func_(stringFunction(func.c_str())),
+	argIdx_(-1),
+	argType_(Type::TT_VOID),
+	q_(0.5),
+	k_(QuantileSketch::DEFAULT_K),
+	precision_(HyperLogLog::DEFAULT_PRECISION)
+{ }
+
+AdditiveAggregatorType::AdditiveAggregatorType(const string &name) :
+	AggregatorType(name, NULL),
+	windowed_(false),
+	windowReverse_(false)
+{ }
+
+AdditiveAggregatorType::AdditiveAggregatorType(const AdditiveAggregatorType &agg, HoldRowTypes *holder) :
+	AggregatorType(agg, holder),
+	fields_(agg.fields_),
+	windowed_(false),
+	windowReverse_(false)
+{ }
+
+AdditiveAggregatorType *AdditiveAggregatorType::addField(const string &fname, const string &func, const string &arg)
+{
+	if (initialized_)
+		throw Exception::fTrace("Attempted to add a field '%s' to an initialized additive aggregator '%s'.",
+			fname.c_str(), name_.c_str());
+	fields_.push_back(FieldDef(fname, func, arg));
+	return this;
+}
+
+AdditiveAggregatorType *AdditiveAggregatorType::addQuantile(const string &fname, const string &arg, double q, int k)
+{
+	addField(fname, "quantile", arg); // may throw
+	FieldDef &fd = fields_.back();
+	fd.q_ = q;
+	fd.k_ = k;
+	return this;
+}
+
+AdditiveAggregatorType *AdditiveAggregatorType::addCountDistinct(const string &fname, const string &arg, int precision)
+{
+	addField(fname, "count_distinct", arg); // may throw
+	fields_.back().precision_ = precision;
+	return this;
+}
+
+AggregatorType *AdditiveAggregatorType::copy() const
+{
+	return new AdditiveAggregatorType(*this);
+}
+
+AggregatorType *AdditiveAggregatorType::deepCopy(HoldRowTypes *holder) const
+{
+	return new AdditiveAggregatorType(*this, holder);
+}
+
+void AdditiveAggregatorType::initialize(TableType *tabtype, IndexType *intype)
+{
+	if (initialized_)
+		return;
+
+	const RowType *rt = tabtype->rowType();
+	const RowType::FieldVec &tfld = rt->fields();
+	RowType::FieldVec fld;
+
+	if (fields_.empty())
+		errors_.f("The additive aggregator must have at least one result field.");
+
+	for (size_t i = 0; i < fields_.size(); i++) {
+		FieldDef &fd = fields_[i];
+		if (fd.func_ < 0) {
+			errors_.f("Unknown function '%s' in the result field '%s'.", fd.funcName_.c_str(), fd.name_.c_str());
+			continue;
+		}
+		if (fd.func_ == FN_COUNT_STAR) {
+			if (!fd.arg_.empty())
+				errors_.f("The function 'count_star' in the result field '%s' must have no argument, got '%s'.",
+					fd.name_.c_str(), fd.arg_.c_str());
+			fld.push_back(RowType::Field(fd.name_, Type::r_int64));
+			continue;
+		}
+
+		fd.argIdx_ = rt->findIdx(fd.arg_);
+		if (fd.argIdx_ < 0) {
+			errors_.fAppend(new Errors(rt->print()), "Unknown argument field '%s' in the result field '%s', the row type is:",
+				fd.arg_.c_str(), fd.name_.c_str());
+			continue;
+		}
+		const RowType::Field &arg = tfld[fd.argIdx_];
+		Type::TypeId argtype = arg.type_->getTypeId();
+		fd.argType_ = argtype;
+
+		switch (fd.func_) {
+		case FN_FIRST:
+		case FN_LAST:
+			fld.push_back(RowType::Field(fd.name_, arg.type_, arg.arsz_));
+			continue;
+		case FN_COUNT:
+			fld.push_back(RowType::Field(fd.name_, Type::r_int64));
+			continue;
+		case FN_COUNT_DISTINCT:
+			if (fd.precision_ < HyperLogLog::MIN_PRECISION || fd.precision_ > HyperLogLog::MAX_PRECISION)
+				errors_.f("The precision %d of the count_distinct in the result field '%s' must be between %d and %d.",
+					fd.precision_, fd.name_.c_str(), (int)HyperLogLog::MIN_PRECISION, (int)HyperLogLog::MAX_PRECISION);
+			fld.push_back(RowType::Field(fd.name_, Type::r_int64));
+			continue;
+		default:
+			break;
+		}
+
+		if (arg.arsz_ != RowType::Field::AR_SCALAR
+		|| (argtype != Type::TT_UINT8 && argtype != Type::TT_INT32
+			&& argtype != Type::TT_INT64 && argtype != Type::TT_FLOAT64)) {
+			errors_.f("The function '%s' in the result field '%s' requires a numeric scalar argument, the field '%s' is '%s%s'.",
+				fd.funcName_.c_str(), fd.name_.c_str(), fd.arg_.c_str(), arg.type_->print().c_str(),
+				(arg.arsz_ == RowType::Field::AR_SCALAR? "" : "[]"));
+			continue;
+		}
+
+		switch (fd.func_) {
+		case FN_SUM:
+			fld.push_back(RowType::Field(fd.name_, argtype == Type::TT_FLOAT64? Type::r_float64 : Type::r_int64));
+			break;
+		case FN_AVG:
+			fld.push_back(RowType::Field(fd.name_, Type::r_float64));
+			break;
+		case FN_QUANTILE:
+			if (!(fd.q_ >= 0. && fd.q_ <= 1.))
+				errors_.f("The quantile %g in the result field '%s' must be between 0 and 1.",
+					fd.q_, fd.name_.c_str());
+			if (fd.k_ < QuantileSketch::MIN_K)
+				errors_.f("The accuracy %d of the quantile in the result field '%s' must be at least %d.",
+					fd.k_, fd.name_.c_str(), (int)QuantileSketch::MIN_K);
+			fld.push_back(RowType::Field(fd.name_, Type::r_float64));
+			break;
+		default: // FN_MIN, FN_MAX
+			fld.push_back(RowType::Field(fd.name_, arg.type_));
+			break;
+		}
+	}
+
+	// the row type gets set even on errors, to avoid the extra complaints
+	// about it from the index type
+	Autoref<RowType> resrt = rt->newSameFormat(fld);
+	if (errors_.isNull())
+		errors_.fAppend(resrt->getErrors(), "The result row type is incorrect:");
+	setRowType(resrt);
+
+	windowed_ = (intype->getIndexId() == IndexType::IT_FIFO);
+	windowReverse_ = windowed_ && static_cast<FifoIndexType *>(intype)->isReverse();
+
+	AggregatorType::initialize(tabtype, intype);
+}
+
+bool AdditiveAggregatorType::equals(const Type *t) const
+{
+	if (this == t)
+		return true; // self-comparison, shortcut
+
+	if (!AggregatorType::equals(t))
+		return false;
+
+	const AdditiveAggregatorType *at = static_cast<const AdditiveAggregatorType *>(t);
+
+	if (fields_.size() != at->fields_.size())
+		return false;
+	for (size_t i = 0; i < fields_.size(); i++) {
+		if (fields_[i].name_ != at->fields_[i].name_
+		|| fields_[i].funcName_ != at->fields_[i].funcName_
+		|| fields_[i].arg_ != at->fields_[i].arg_
+		|| fields_[i].q_ != at->fields_[i].q_
+		|| fields_[i].k_ != at->fields_[i].k_
+		|| fields_[i].precision_ != at->fields_[i].precision_)
+			return false;
+	}
+
+	return true;
+}
+
+bool AdditiveAggregatorType::match(const Type *t) const
+{
+	if (this == t)
+		return true; // self-comparison, shortcut
+
+	if (!AggregatorType::match(t))
+		return false;
+
+	const AdditiveAggregatorType *at = static_cast<const AdditiveAggregatorType *>(t);
+
+	// the field names may differ, as with the row types
+	if (fields_.size() != at->fields_.size())
+		return false;
+	for (size_t i = 0; i < fields_.size(); i++) {
+		if (fields_[i].funcName_ != at->fields_[i].funcName_
+		|| fields_[i].arg_ != at->fields_[i].arg_
+		|| fields_[i].q_ != at->fields_[i].q_
+		|| fields_[i].k_ != at->fields_[i].k_
+		|| fields_[i].precision_ != at->fields_[i].precision_)
+			return false;
+	}
+
+	return true;
+}
+
+void AdditiveAggregatorType::printTo(string &res, const string &indent, const string &subindent) const
+{
+	string bufindent;
+	const string &passni = nextindent(indent, subindent, bufindent);
+
+	res.append("aggregator additive (");
+	for (FieldDefVec::const_iterator it = fields_.begin(); it != fields_.end(); ++it) {
+		newlineTo(res, passni);
+		res.append(it->name_);
+		res.append(" = ");
+		res.append(it->funcName_);
+		res.append("(");
+		res.append(it->arg_);
+		if (it->func_ == FN_QUANTILE)
+			res.append(strprintf(", %g, %d", it->q_, it->k_));
+		else if (it->func_ == FN_COUNT_DISTINCT)
+			res.append(strprintf(", %d", it->precision_));
+		res.append("),");
+	}
+	newlineTo(res, indent);
+	res.append(") ");
+	res.append(name_);
+}
+
+AggregatorGadget *AdditiveAggregatorType::makeGadget(Table *table, IndexType *intype) const
+{
+	return new AggregatorGadget(this, table, intype);
+}
+
+Aggregator *AdditiveAggregatorType::makeAggregator(Table *table, AggregatorGadget *gadget) const
+{
+	return new AdditiveAggregator(this);
+}
+
+}; // TRICEPS_NS
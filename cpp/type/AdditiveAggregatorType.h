@@ -0,0 +1,190 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps the additive state of SQL-like functions.
+
+#ifndef __Triceps_AdditiveAggregatorType_h__
+#define __Triceps_AdditiveAggregatorType_h__
+
+#include <type/AggregatorType.h>
+#include <table/Aggregator.h>
+#include <common/QuantileSketch.h>
+#include <common/HyperLogLog.h>
+
+namespace TRICEPS_NS {
+
+class AdditiveAggregator;
+
+// The aggregator that computes the SQL-like functions, like
+// Perl's SimpleAggregator, but instead of iterating through the whole group
+// on every change keeps the state of the functions in each group
+// and updates it with the inserted and deleted rows. This makes the cost
+// of an update O(1), independently of the group size.
+//
+// The only exception are min() and max(): if the row with the current
+// extreme value gets deleted, the extreme has to be found again by iterating
+// through the group. This is done lazily, on the next computation of the result.
+//
+// When the aggregator is placed on a FifoIndexType, the group is treated
+// as a sliding window: the rows come in at one end and get pushed out
+// (normally by the FIFO limit) at the other end. Then min() and max()
+// keep a monotonic deque of the candidate values, and the push-outs of the
+// oldest row cost O(1) amortized too. Only a deletion from the middle
+// of the window falls back to the iteration through the group.
+//
+// The result row type is built from the list of the fields, with the
+// types deduced from the functions and their arguments. The functions are:
+//   first - value of the argument field in the first row of the group
+//           (as defined by the index order), any field type;
+//   last - value of the argument field in the last row of the group,
+//          any field type;
+//   count_star - number of rows in the group, no argument, int64;
+//   count - number of non-null values of the argument, int64;
+//   sum - sum of the non-null values of the argument, int64 for the integer
+//         arguments, float64 for the float64 argument;
+//   avg - average of the non-null values of the argument, float64,
+//         null if there are no such values;
+//   min, max - the minimal or maximal non-null value of the argument,
+//         of the same type as the argument, null if there are no such values;
+//   quantile - the approximate quantile (0.5 by default, i.e. the median,
+//         see addQuantile()) of the non-null values of the argument, float64,
+//         null if there are no such values;
+//   count_distinct - the approximate number of the distinct non-null values
+//         of the argument (see addCountDistinct()), any field type, int64.
+// The functions other than first, last and count_distinct (and count_star
+// which has no argument) accept only the numeric scalar arguments: uint8,
+// int32, int64, float64.
+//
+// The quantile keeps a QuantileSketch per group, so its memory is bounded
+// no matter the size of the group. The deleted values go into a separate
+// sketch that gets subtracted. When the deleted values start outnumbering
+// the ones left in the group, the sketch gets rebuilt from the rows of the
+// group on the next computation of the result (this is not possible in an
+// AggregationTable that has no rows, there the subtraction continues, at
+// the cost of the accuracy).
+//
+// The count_distinct keeps a HyperLogLog per group, of 2^precision bytes,
+// instead of a nested index with a row per distinct value. The values can't
+// be removed from it, so after a deletion it gets rebuilt from the rows
+// of the group on the next computation of the result, like min and max.
+//
+// The result gets sent the same way as by the typical aggregator, with the
+// state before the modification sent as OP_DELETE, and the state after it
+// as OP_INSERT, except for the empty groups that send nothing.
+class AdditiveAggregatorType : public AggregatorType
+{
+public:
+	// The function codes.
+	// (The prefix is not AF_ because <sys/socket.h> defines AF_MAX).
+	enum Function {
+		FN_FIRST,
+		FN_LAST,
+		FN_COUNT_STAR,
+		FN_COUNT,
+		FN_SUM,
+		FN_AVG,
+		FN_MIN,
+		FN_MAX,
+		FN_QUANTILE,
+		FN_COUNT_DISTINCT,
+	};
+
+	// Convert the function code to string and back.
+	// The strings are the same as the function names listed above.
+	static const char *functionString(int code, const char *def = "???");
+	static int stringFunction(const char *code);
+
+	// Definition of a result field.
+	class FieldDef
+	{
+	public:
+		FieldDef(const string &name, const string &func, const string &arg);
+
+		string name_; // name of the result field
+		string funcName_; // name of the function
+		string arg_; // name of the argument field, empty for count_star
+		int func_; // function code, or -1 if unknown
+		int argIdx_; // index of the argument field in the table's row type
+		int argType_; // type id of the argument field, set during initialization
+		double q_; // for quantile: the quantile to compute
+		int k_; // for quantile: the accuracy of the sketch
+		int precision_; // for count_distinct: the precision of the sketch
+	};
+	typedef vector<FieldDef> FieldDefVec;
+
+	// @param name - name for aggregators' gadget in the table, will be tablename.name
+	AdditiveAggregatorType(const string &name);
+	// the default copy constructor works well
+
+	// for deep copy
+	AdditiveAggregatorType(const AdditiveAggregatorType &agg, HoldRowTypes *holder);
+
+	// Add a result field. The errors (such as an unknown function or field)
+	// will be reported on initialization.
+	//
+	// @param fname - name of the result field
+	// @param func - name of the function
+	// @param arg - name of the argument field in the table's row type
+	//        (empty for count_star)
+	// @return - the same object, for chaining
+	AdditiveAggregatorType *addField(const string &fname, const string &func, const string &arg = "");
+
+	// Add a result field with the function quantile.
+	//
+	// @param fname - name of the result field
+	// @param arg - name of the argument field in the table's row type
+	// @param q - the quantile to compute, 0 <= q <= 1
+	// @param k - accuracy of the sketch, see QuantileSketch
+	// @return - the same object, for chaining
+	AdditiveAggregatorType *addQuantile(const string &fname, const string &arg, double q,
+		int k = QuantileSketch::DEFAULT_K);
+
+	// Add a result field with the function count_distinct.
+	//
+	// @param fname - name of the result field
+	// @param arg - name of the argument field in the table's row type
+	// @param precision - precision of the sketch, see HyperLogLog
+	// @return - the same object, for chaining
+	AdditiveAggregatorType *addCountDistinct(const string &fname, const string &arg,
+		int precision = HyperLogLog::DEFAULT_PRECISION);
+
+	// Get back the field definitions.
+	const FieldDefVec &getFields() const
+	{
+		return fields_;
+	}
+
+	// Check whether the aggregator treats the groups as sliding windows,
+	// known after initialization.
+	bool isWindowed() const
+	{
+		return windowed_;
+	}
+
+	// from Type
+	virtual bool equals(const Type *t) const;
+	virtual bool match(const Type *t) const;
+	virtual void printTo(string &res, const string &indent = "", const string &subindent = "  ") const;
+
+	// from AggregatorType
+	virtual void initialize(TableType *tabtype, IndexType *intype);
+	virtual AggregatorType *copy() const;
+	virtual AggregatorType *deepCopy(HoldRowTypes *holder) const;
+	// creates just the generic AggregatorGadget, nothing special
+	virtual AggregatorGadget *makeGadget(Table *table, IndexType *intype) const;
+	virtual Aggregator *makeAggregator(Table *table, AggregatorGadget *gadget) const;
+
+protected:
+	friend class AdditiveAggregator;
+
+	FieldDefVec fields_;
+	bool windowed_; // flag: placed on a FIFO index
+	bool windowReverse_; // flag: the FIFO index iterates from the newest row
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_AdditiveAggregatorType_h__
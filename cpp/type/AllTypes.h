@@ -14,10 +14,13 @@
 #include <type/RowSetType.h>
 #include <type/HashedIndexType.h>
 #include <type/SortedIndexType.h>
+#include <type/TopNIndexType.h>
 #include <type/FifoIndexType.h>
 #include <type/RootIndexType.h>
 #include <type/TableType.h>
 #include <type/BasicAggregatorType.h>
+#include <type/AdditiveAggregatorType.h>
+#include <type/TopKAggregatorType.h>
 #include <type/GroupHandleType.h>
 
 namespace TRICEPS_NS {
@@ -132,4 +132,34 @@ bool CompactRowType::isRowEmpty(const Row *row) const
 	return cr->isRowEmpty((int)fields_.size());
 }
 
+const char *CompactRowType::rowImage(const Row *row, intptr_t &len) const
+{
+	const CompactRow *cr = static_cast<const CompactRow *>(row);
+	len = cr->off_[fields_.size()];
+	return (const char *)cr->off_;
+}
+
+Row *CompactRowType::makeRowFromImage(const char *image, intptr_t len) const
+{
+	int n = (int)fields_.size();
+	intptr_t payoff = CompactRow::payloadOffset(n);
+	if (len < payoff)
+		return NULL;
+
+	CompactRow *row = new (CompactRow::variableLen(n, len - payoff)) CompactRow;
+	memcpy(row->off_, image, len);
+
+	// the offsets must go in order and end exactly at the end of the image
+	intptr_t prev = payoff;
+	for (int i = 0; i <= n; i++) {
+		intptr_t off = (row->off_[i] & CompactRow::OFFMASK);
+		if (off < prev || off > len || (i == n && (off != len || row->off_[i] != off))) {
+			delete row;
+			return NULL;
+		}
+		prev = off;
+	}
+	return row;
+}
+
 }; // TRICEPS_NS
@@ -32,6 +32,8 @@ public:
 	virtual void hexdumpRow(string &dest, const Row *row, const string &indent="") const;
 	virtual bool equalRows(const Row *row1, const Row *row2) const;
 	virtual bool isRowEmpty(const Row *row) const;
+	virtual const char *rowImage(const Row *row, intptr_t &len) const;
+	virtual Row *makeRowFromImage(const char *image, intptr_t len) const;
 };
 
 }; // TRICEPS_NS
@@ -11,6 +11,7 @@
 #include <table/TreeIndex.h>
 #include <table/TreeNestedIndex.h>
 #include <table/Table.h>
+#include <table/IndexBloom.h>
 #include <string.h>
 
 namespace TRICEPS_NS {
@@ -86,16 +87,33 @@ bool HashedIndexType::Less::operator() (const RowHandle *r1, const RowHandle *r2
 	return false; // gets here only on equal values
 }
 
+//////////////////////////// HashedIndexType::BloomStats  /////////////////////////
+
+HashedIndexType::BloomStats::BloomStats() :
+	instances_(0),
+	bits_(0),
+	entries_(0),
+	stale_(0),
+	probes_(0),
+	rejects_(0),
+	falsePositives_(0),
+	rebuilds_(0)
+{ }
+
 //////////////////////////// HashedIndexType /////////////////////////
 
 HashedIndexType::HashedIndexType(NameSet *key) :
 	TreeIndexType(IT_HASHED),
-	key_(key)
+	key_(key),
+	bloomCapacity_(0),
+	bloomFpRate_(0.01)
 {
 }
 
 HashedIndexType::HashedIndexType(const HashedIndexType &orig, bool flat) :
-	TreeIndexType(orig, flat)
+	TreeIndexType(orig, flat),
+	bloomCapacity_(orig.bloomCapacity_),
+	bloomFpRate_(orig.bloomFpRate_)
 {
 	if (!orig.key_.isNull()) {
 		key_ = new NameSet(*orig.key_);
@@ -103,7 +121,9 @@ HashedIndexType::HashedIndexType(const HashedIndexType &orig, bool flat) :
 }
 
 HashedIndexType::HashedIndexType(const HashedIndexType &orig, HoldRowTypes *holder) :
-	TreeIndexType(orig, holder)
+	TreeIndexType(orig, holder),
+	bloomCapacity_(orig.bloomCapacity_),
+	bloomFpRate_(orig.bloomFpRate_)
 {
 	if (!orig.key_.isNull()) {
 		key_ = new NameSet(*orig.key_);
@@ -120,6 +140,36 @@ HashedIndexType *HashedIndexType::setKey(NameSet *key)
 	return this;
 }
 
+HashedIndexType *HashedIndexType::setBloom(size_t capacity, double fpRate)
+{
+	if (initialized_) {
+		Autoref<HashedIndexType> cleaner = this;
+		throw Exception::fTrace("Attempted to set the Bloom filter on an initialized Hashed index type");
+	}
+	bloomCapacity_ = capacity;
+	bloomFpRate_ = fpRate;
+	return this;
+}
+
+void HashedIndexType::getBloomStats(const Table *table, BloomStats &st) const
+{
+	st = BloomStats();
+	if (bloomCapacity_ == 0 || table->getType() != getTabtype())
+		return;
+
+	vector<Index *> instances;
+	collectInstances(table, instances);
+	for (vector<Index *>::iterator it = instances.begin(); it != instances.end(); ++it) {
+		const IndexBloom *bloom;
+		if (nested_.empty())
+			bloom = static_cast<TreeIndex *>(*it)->getBloom();
+		else
+			bloom = static_cast<TreeNestedIndex *>(*it)->getBloom();
+		if (bloom != NULL)
+			bloom->addStats(st);
+	}
+}
+
 const NameSet *HashedIndexType::getKey() const
 {
 	return key_;
@@ -141,6 +191,10 @@ bool HashedIndexType::equals(const Type *t) const
 	if (!key_->equals(pit->key_))
 		return false;
 
+	if (bloomCapacity_ != pit->bloomCapacity_
+	|| (bloomCapacity_ != 0 && bloomFpRate_ != pit->bloomFpRate_))
+		return false;
+
 	// if initialized, check the translation of key to field indexes
 	const TableType *tt1 = getTabtype();
 	const TableType *tt2 = pit->getTabtype();
@@ -215,6 +269,8 @@ void HashedIndexType::printTo(string &res, const string &indent, const string &s
 			res.append(", "); // extra comma after last field doesn't hurt
 		}
 	}
+	if (bloomCapacity_ != 0)
+		res.append(strprintf("bloom=%zu fpRate=%g", bloomCapacity_, bloomFpRate_));
 	res.append(")");
 	printSubelementsTo(res, indent, subindent);
 }
@@ -251,6 +307,9 @@ void HashedIndexType::initialize()
 		keyFld_[i] = idx;
 	}
 	// XXX should it check that the fields don't repeat?
+
+	if (bloomCapacity_ != 0 && !(bloomFpRate_ > 0. && bloomFpRate_ < 1.))
+		errors_.f("the Bloom filter false positive rate must be between 0 and 1, got %g", bloomFpRate_);
 	
 	less_ = new Less(tabtype_->rowType(), rhOffset_, keyFld_);
 }
@@ -262,10 +321,13 @@ Index *HashedIndexType::makeIndex(const TableType *tabtype, Table *table) const
 		return NULL; 
 	// no need to report the errors, so can just use the same less_,
 	// without creating a copy with the table pointer
+	IndexBloom *bloom = NULL;
+	if (bloomCapacity_ != 0)
+		bloom = new IndexBloom(this);
 	if (nested_.empty())
-		return new TreeIndex(tabtype, table, this, less_);
+		return new TreeIndex(tabtype, table, this, less_, bloom);
 	else
-		return new TreeNestedIndex(tabtype, table, this, less_);
+		return new TreeNestedIndex(tabtype, table, this, less_, bloom);
 }
 
 void HashedIndexType::initRowHandleSection(RowHandle *rh) const
@@ -33,6 +33,60 @@ public:
 	// Keeps a reference of key.
 	HashedIndexType *setKey(NameSet *key);
 
+	// Add a Bloom filter in front of the index, for the cheap rejection
+	// of the lookups of the keys that are not in the table (until
+	// initialized, afterwards will throw an Exception). Each instance
+	// of the index (i.e. each group of the parent index, if nested)
+	// gets its own filter, which grows as needed and gets rebuilt
+	// as the rows get removed.
+	// If an Exception is thrown, tries to free the unreferenced (this).
+	// @param capacity - the number of rows expected in an instance of the
+	//        index, 0 disables the filter
+	// @param fpRate - the wanted rate of false positives, 0 < fpRate < 1
+	HashedIndexType *setBloom(size_t capacity, double fpRate = 0.01);
+
+	// Get back the Bloom filter configuration.
+	// @return - the expected number of rows, 0 if the filter is disabled
+	size_t getBloomCapacity() const
+	{
+		return bloomCapacity_;
+	}
+	double getBloomFpRate() const
+	{
+		return bloomFpRate_;
+	}
+
+	// The statistics of the Bloom filters, summed up for all
+	// the instances of this index type in a table.
+	struct BloomStats
+	{
+		BloomStats();
+
+		size_t instances_; // number of index instances with the filters
+		size_t bits_; // total size of the filters, in bits
+		size_t entries_; // values in the filters, including the stale ones
+		size_t stale_; // values of the removed rows still present in the filters
+		size_t probes_; // lookups checked against the filters
+		size_t rejects_; // lookups rejected by the filters
+		size_t falsePositives_; // lookups passed by the filters but not found
+		size_t rebuilds_; // times the filters got rebuilt
+	};
+
+	// Collect the statistics of the Bloom filters of this index type in a table.
+	// If the filter is not enabled, the result will be all zeroes.
+	// The index instances get created lazily, with the first row in them,
+	// so an empty table has no instances.
+	// @param table - table, which must be of this index type's table type
+	// @param st - the place to return the stats
+	void getBloomStats(const Table *table, BloomStats &st) const;
+
+	// Get the hash value of the key, as pre-calculated in the row handle.
+	// @param rh - row handle, with this index's section initialized
+	Hash::Value getHash(const RowHandle *rh) const
+	{
+		return rh->get<RhSection>(rhOffset_)->hash_;
+	}
+
 	// from Type
 	virtual bool equals(const Type *t) const;
 	virtual bool match(const Type *t) const;
@@ -89,6 +143,8 @@ protected:
 	Autoref<Less> less_;
 	Autoref<NameSet> key_;
 	vector<int32_t> keyFld_; // indexes of key fields in the record
+	size_t bloomCapacity_; // rows expected per index instance, 0 if no Bloom filter
+	double bloomFpRate_; // the false positive rate of the Bloom filter
 };
 
 }; // TRICEPS_NS
@@ -694,11 +694,13 @@ void IndexType::groupAggregateBefore(Tray *dest, Table *table, GroupHandle *gh,
 		int an = (int)groupAggs_.size();
 		Aggregator **aggs = getGhAggs(gh);
 
+		bool coalesce = table->isCoalescing();
 		for (int i = 0; i < an; i++) {
 			const IndexAggTypePair &iap = groupAggs_[i];
+			Tray *adest = coalesce? table->coalesceDest(this, gh, i, Table::CP_BEFORE) : dest;
 			// no matter how many rows are in the set, call only once per group
 			aggs[i]->handle(table, table->getAggregatorGadget(iap.agg_->getPos()), 
-				gs->subidx_[iap.index_->nestPos_], this, gh, dest,
+				gs->subidx_[iap.index_->nestPos_], this, gh, adest,
 				Aggregator::AO_BEFORE_MOD, Rowop::OP_DELETE, NULL);
 		}
 	}
@@ -730,13 +732,15 @@ void IndexType::groupAggregateAfter(Tray *dest, Aggregator::AggOp aggop, Table *
 			lastRow = *rows.rbegin();
 		}
 
+		bool coalesce = table->isCoalescing();
 		for (int i = 0; i < an; i++) {
 			const IndexAggTypePair &iap = groupAggs_[i];
 			AggregatorGadget *gadget = table->getAggregatorGadget(iap.agg_->getPos());
 			Index *subidx = gs->subidx_[iap.index_->nestPos_];
+			Tray *adest = coalesce? table->coalesceDest(this, gh, i, Table::CP_AFTER) : dest;
 
 			for (RhSet::const_iterator rit = rows.begin(); rit != rows.end(); ++rit) {
-				aggs[i]->handle(table, gadget, subidx, this, gh, dest, aggop, 
+				aggs[i]->handle(table, gadget, subidx, this, gh, adest, aggop, 
 					(*rit == lastRow ? Rowop::OP_INSERT : Rowop::OP_NOP), 
 					*rit);
 			}
@@ -748,6 +752,35 @@ void IndexType::groupAggregateAfter(Tray *dest, Aggregator::AggOp aggop, Table *
 	}
 }
 
+void IndexType::groupAggregateUpdate(Tray *dest, Table *table, GroupHandle *gh, RowHandle *oldrh, RowHandle *newrh) const
+{
+	assert(gh != NULL);
+
+	GhSection *gs = getGhSection(gh);
+	int nn = (int)nested_.size();
+
+	if (!groupAggs_.empty()) {
+		gh->flags_ |= GroupHandle::F_GROUP_AGGREGATED;
+
+		int an = (int)groupAggs_.size();
+		Aggregator **aggs = getGhAggs(gh);
+
+		bool coalesce = table->isCoalescing();
+		for (int i = 0; i < an; i++) {
+			const IndexAggTypePair &iap = groupAggs_[i];
+			AggregatorGadget *gadget = table->getAggregatorGadget(iap.agg_->getPos());
+			Index *subidx = gs->subidx_[iap.index_->nestPos_];
+			Tray *adest = coalesce? table->coalesceDest(this, gh, i, Table::CP_AFTER) : dest;
+
+			aggs[i]->handleUpdate(table, gadget, subidx, this, gh, adest, oldrh, newrh);
+		}
+	}
+
+	for (int i = 0; i < nn; i++) {
+		gs->subidx_[i]->aggregateUpdate(dest, oldrh, newrh);
+	}
+}
+
 bool IndexType::groupCollapse(Tray *dest, GroupHandle *gh, const RhSet &replaced) const
 {
 	assert(gh != NULL);
@@ -799,10 +832,12 @@ void IndexType::aggregateCollapse(Tray *dest, Table *table, GroupHandle *gh) con
 	if (n != 0) {
 		GhSection *gs = getGhSection(gh);
 		Aggregator **aggs = getGhAggs(gh);
+		bool coalesce = table->isCoalescing();
 		for (int i = 0; i < n; i++) {
 			const IndexAggTypePair &iap = groupAggs_[i];
+			Tray *adest = coalesce? table->coalesceDest(this, gh, i, Table::CP_AFTER) : dest;
 			aggs[i]->handle(table, table->getAggregatorGadget(iap.agg_->getPos()), 
-				gs->subidx_[iap.index_->nestPos_], this, gh, dest,
+				gs->subidx_[iap.index_->nestPos_], this, gh, adest,
 				Aggregator::AO_COLLAPSE, Rowop::OP_NOP, NULL);
 		}
 	}
@@ -849,6 +884,21 @@ Index *IndexType::findNestedIndex(int nestPos, const Table *table, const RowHand
 	return myinst->findNested(what, nestPos);
 }
 
+void IndexType::collectInstances(const Table *table, vector<Index *> &res) const
+{
+	if (parent_ == NULL) {
+		res.push_back(table->getRoot());
+		return;
+	}
+
+	vector<Index *> parents;
+	parent_->collectInstances(table, parents);
+	for (vector<Index *>::iterator it = parents.begin(); it != parents.end(); ++it) {
+		for (const GroupHandle *gh = (*it)->beginGroup(); gh != NULL; gh = (*it)->nextGroup(gh))
+			res.push_back(parent_->groupToIndex(const_cast<GroupHandle *>(gh), nestPos_));
+	}
+}
+
 size_t IndexType::groupSizeOfRecord(const Table *table, const RowHandle *what) const
 {
 	if (isLeaf())
@@ -869,6 +919,7 @@ Valname indexids[] = {
 	{ IndexType::IT_HASHED, "IT_HASHED" },
 	{ IndexType::IT_FIFO, "IT_FIFO" },
 	{ IndexType::IT_SORTED, "IT_SORTED" },
+	{ IndexType::IT_TOPN, "IT_TOPN" },
 	{ IndexType::IT_LAST, "IT_LAST" },
 	{ -1, NULL }
 };
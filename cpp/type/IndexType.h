@@ -131,6 +131,7 @@ public:
 		IT_HASHED, // HashedIndexType
 		IT_FIFO, // FifoIndexType
 		IT_SORTED, // SortedIndexType
+		IT_TOPN, // TopNIndexType
 		// add new types here
 		IT_LAST
 	};
@@ -394,6 +395,22 @@ protected:
 		nested_.clearRowHandle(rh);
 	}
 
+	// Initialize only the row handle sections on the path from the root
+	// to this index type: this one and all its parents, but not the
+	// nested or sibling index types. That's enough for findRecord()
+	// and groupSizeOfRecord() on this index type.
+	void initPathRowHandle(RowHandle *rh) const
+	{
+		for (const IndexType *it = this; it != NULL; it = it->parent_)
+			it->initRowHandleSection(rh);
+	}
+	// Clear the sections initialized by initPathRowHandle().
+	void clearPathRowHandle(RowHandle *rh) const
+	{
+		for (const IndexType *it = this; it != NULL; it = it->parent_)
+			it->clearRowHandleSection(rh);
+	}
+
 	// Copy the precalculated row handle values from one row's handle
 	// to another handle for the same row.
 	// (This is used to initialize the group handles, which would normally be the destinations).
@@ -401,6 +418,12 @@ protected:
 	// @param fromrh - the original handle
 	virtual void copyRowHandleSection(RowHandle *rh, const RowHandle *fromrh) const = 0;
 
+	// Collect all the instances of this index type in a table: one
+	// for each group of the parent index type.
+	// @param table - table where to look
+	// @param res - vector to append the instances to
+	void collectInstances(const Table *table, vector<Index *> &res) const;
+
 	// Find a row in the table, according to this index type.
 	// It goes recursively to the root of the table and then back down, finding the
 	// concrete path of indexes for this row.
@@ -607,6 +630,17 @@ public:
 	//        be called separtely in the future, modifies the Rowop::Opcode
 	void groupAggregateAfter(Tray *dest, Aggregator::AggOp aggop, Table *table, GroupHandle *gh, const RhSet &rows, const RhSet &future) const;
 
+	// Call the aggregators for a replacement of one row by another within
+	// this group, then recurse into the nested indexes.
+	// See the details in Index.h.
+	//
+	// @param dest - destination to send the delayed aggregation changes
+	// @param table - table where the group belongs
+	// @param gh - the group instance, may NOT be NULL
+	// @param oldrh - the row that has been removed
+	// @param newrh - the row that has been inserted
+	void groupAggregateUpdate(Tray *dest, Table *table, GroupHandle *gh, RowHandle *oldrh, RowHandle *newrh) const;
+
 	// Attempt to collapse all the sub-indexes of the group
 	// (see the detailed discussion of the semantics in table/Index.h).
 	// @param dest - destination to send the delayed aggregation changes
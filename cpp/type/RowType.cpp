@@ -189,6 +189,19 @@ Row *RowType::copyRow(const RowType *rtype, const Row *row) const
 	return makeRow(v);
 }
 
+Hash::Value RowType::hashFields(const Row *row, const vector<int> &idx) const
+{
+	Hash::Value h = Hash::basis_;
+	for (vector<int>::const_iterator it = idx.begin(); it != idx.end(); ++it) {
+		const char *ptr;
+		intptr_t len;
+		bool notNull = getField(row, *it, ptr, len);
+		h = Hash::addByte(h, notNull);
+		h = Hash::append(h, ptr, len);
+	}
+	return h;
+}
+
 void RowType::fillFdata(FdataVec &v, int nf)
 {
 	int oldsz = (int) v.size();
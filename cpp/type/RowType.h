@@ -11,6 +11,7 @@
 
 #include <type/SimpleType.h>
 #include <common/Common.h>
+#include <common/Hash.h>
 #include <mem/Row.h>
 #include <map>
 
@@ -180,6 +181,32 @@ public:
 	// considered empty.
 	// @return - true if all the fields are empty
 	virtual bool isRowEmpty(const Row *row) const = 0;
+
+	// Get the binary image of the row, as stored (not including the ref
+	// counter and anything before it). It's meaningful only for the same
+	// format of the row type and the same machine architecture, and is used
+	// for the dumping of the tables into the files.
+	// @param row - row to get the image of
+	// @param len - place to return the length of the image
+	// @return - pointer to the image, valid while the row is alive
+	virtual const char *rowImage(const Row *row, intptr_t &len) const = 0;
+
+	// Make a row from a binary image produced by rowImage().
+	// The image gets checked for the consistency, so a corrupted
+	// image would not produce a row that crashes on access.
+	// @param image - the image, needs no particular alignment
+	// @param len - length of the image
+	// @return - the newly created row, or NULL if the image is inconsistent
+	virtual Row *makeRowFromImage(const char *image, intptr_t len) const = 0;
+
+	// Compute the FNV hash of a set of fields. For each field in turn
+	// it hashes a byte with the not-null flag, then the field data.
+	// This is the common definition used to distribute the rows by keys,
+	// so that it's the same from C++ and from the scripting languages.
+	// @param row - row to operate on
+	// @param idx - indexes of the fields to hash, in order
+	// @return - the hash value
+	Hash::Value hashFields(const Row *row, const vector<int> &idx) const;
 	// }
 	
 	// {
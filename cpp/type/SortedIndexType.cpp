@@ -69,6 +69,13 @@ SortedIndexType::SortedIndexType(Onceref<SortedIndexCondition> sc) :
 	assert(sc_.get() != NULL);
 }
 
+SortedIndexType::SortedIndexType(Onceref<SortedIndexCondition> sc, IndexId it) :
+	TreeIndexType(it),
+	sc_(sc)
+{ 
+	assert(sc_.get() != NULL);
+}
+
 SortedIndexType::SortedIndexType(const SortedIndexType &orig, bool flat) :
 	TreeIndexType(orig, flat),
 	sc_(orig.sc_->copy())
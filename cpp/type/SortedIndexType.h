@@ -219,6 +219,10 @@ public:
 	virtual void copyRowHandleSection(RowHandle *rh, const RowHandle *fromrh) const;
 
 protected:
+	// for the subclasses
+	// @param sc - the object defining the sorting order
+	// @param it - the id of the subclass
+	SortedIndexType(Onceref<SortedIndexCondition> sc, IndexId it);
 	// used by copy(), copies sc_
 	SortedIndexType(const SortedIndexType &orig, bool flat);
 	// used by deepCopy(), deep-copies sc_
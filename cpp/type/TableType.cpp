@@ -19,6 +19,7 @@ TableType::TableType(Onceref<RowType> rt) :
 	Type(false, TT_TABLE),
 	root_(new RootIndexType),
 	rowType_(rt),
+	versionsOffset_(0),
 	initialized_(false)
 { }
 
@@ -122,6 +123,8 @@ void TableType::initialize()
 	errors_->append("row type error:", rowType_->getErrors());
 
 	rhType_ = new RowHandleType;
+	// the entry of the row in the snapshot history, see TableVersions
+	versionsOffset_ = rhType_->allocate(sizeof(void *));
 
 	// collect the aggregators
 	root_->collectAggregators(aggs_);
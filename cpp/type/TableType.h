@@ -99,6 +99,14 @@ public:
 		return rhType_;
 	}
 
+	// Get the offset of the place in the row handles that the table
+	// uses for the snapshot history (see TableVersions).
+	// Works only after initialization.
+	intptr_t getVersionsOffset() const
+	{
+		return versionsOffset_;
+	}
+
 	// Create an instance table of this type.
 	// @param unit - unit where the table belongs
 	// @param name - name of the table,  the input label will be named name.in, the output label name.out,
@@ -130,6 +138,7 @@ protected:
 	Autoref<RowType> rowType_; // row for this table
 	Erref errors_;
 	Autoref<RowHandleType> rhType_; // for building the row handles
+	intptr_t versionsOffset_; // offset of the snapshot history entry in the row handles
 	IndexAggTypeVec aggs_; // all the aggregators, collected during initialization
 	bool initialized_; // flag: has already been initialized, no more changes allowed
 
@@ -0,0 +1,120 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps a bounded summary of the most frequent values.
+
+#include <type/TopKAggregatorType.h>
+#include <type/TableType.h>
+#include <table/TopKAggregator.h>
+#include <sched/AggregatorGadget.h>
+#include <common/StringUtil.h>
+
+namespace TRICEPS_NS {
+
+TopKAggregatorType::TopKAggregatorType(const string &name, const string &key, int k, int capacity) :
+	AggregatorType(name, NULL),
+	key_(key),
+	k_(k),
+	capacity_(capacity),
+	keyIdx_(-1)
+{ }
+
+TopKAggregatorType::TopKAggregatorType(const TopKAggregatorType &agg, HoldRowTypes *holder) :
+	AggregatorType(agg, holder),
+	key_(agg.key_),
+	k_(agg.k_),
+	capacity_(agg.capacity_),
+	keyIdx_(agg.keyIdx_)
+{ }
+
+AggregatorType *TopKAggregatorType::copy() const
+{
+	return new TopKAggregatorType(*this);
+}
+
+AggregatorType *TopKAggregatorType::deepCopy(HoldRowTypes *holder) const
+{
+	return new TopKAggregatorType(*this, holder);
+}
+
+void TopKAggregatorType::initialize(TableType *tabtype, IndexType *intype)
+{
+	if (initialized_)
+		return;
+
+	const RowType *rt = tabtype->rowType();
+	RowType::FieldVec fld;
+
+	if (k_ < 1)
+		errors_.f("The number of the top values must be at least 1, got %d.", k_);
+	if (capacity_ != 0 && capacity_ < k_)
+		errors_.f("The number of the counters %d must be at least the number of the top values %d.",
+			capacity_, k_);
+
+	keyIdx_ = rt->findIdx(key_);
+	if (keyIdx_ < 0) {
+		errors_.fAppend(new Errors(rt->print()), "Unknown key field '%s', the row type is:",
+			key_.c_str());
+	} else {
+		fld.push_back(rt->fields()[keyIdx_]);
+	}
+	fld.push_back(RowType::Field("rank", Type::r_int32));
+	fld.push_back(RowType::Field("count", Type::r_int64));
+
+	// the row type gets set even on errors, to avoid the extra complaints
+	// about it from the index type
+	Autoref<RowType> resrt = rt->newSameFormat(fld);
+	if (errors_.isNull())
+		errors_.fAppend(resrt->getErrors(), "The result row type is incorrect:");
+	setRowType(resrt);
+
+	AggregatorType::initialize(tabtype, intype);
+}
+
+bool TopKAggregatorType::equals(const Type *t) const
+{
+	if (this == t)
+		return true; // self-comparison, shortcut
+
+	if (!AggregatorType::equals(t))
+		return false;
+
+	const TopKAggregatorType *at = static_cast<const TopKAggregatorType *>(t);
+
+	return key_ == at->key_ && k_ == at->k_ && getCapacity() == at->getCapacity();
+}
+
+bool TopKAggregatorType::match(const Type *t) const
+{
+	if (this == t)
+		return true; // self-comparison, shortcut
+
+	if (!AggregatorType::match(t))
+		return false;
+
+	const TopKAggregatorType *at = static_cast<const TopKAggregatorType *>(t);
+
+	// the field names may differ, as with the row types
+	return keyIdx_ == at->keyIdx_ && k_ == at->k_ && getCapacity() == at->getCapacity();
+}
+
+void TopKAggregatorType::printTo(string &res, const string &indent, const string &subindent) const
+{
+	res.append(strprintf("aggregator topk (%s, %d, %d) ", key_.c_str(), k_, getCapacity()));
+	res.append(name_);
+}
+
+AggregatorGadget *TopKAggregatorType::makeGadget(Table *table, IndexType *intype) const
+{
+	return new AggregatorGadget(this, table, intype);
+}
+
+Aggregator *TopKAggregatorType::makeAggregator(Table *table, AggregatorGadget *gadget) const
+{
+	return new TopKAggregator(this);
+}
+
+}; // TRICEPS_NS
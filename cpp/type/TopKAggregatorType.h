@@ -0,0 +1,93 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// Aggregator that keeps a bounded summary of the most frequent values.
+
+#ifndef __Triceps_TopKAggregatorType_h__
+#define __Triceps_TopKAggregatorType_h__
+
+#include <type/AggregatorType.h>
+#include <table/Aggregator.h>
+
+namespace TRICEPS_NS {
+
+class TopKAggregator;
+
+// The aggregator that finds the k most frequent values of a field in
+// each group (the "heavy hitters"), without a nested index on the counts.
+// Each group keeps a SpaceSaving summary with a fixed number of counters,
+// so the memory per group is constant no matter how many distinct values
+// go through it, and the counts are approximate (see SpaceSaving).
+//
+// The result has one row per place in the top k, with the fields:
+//   <key field> - the value, of the same type as the key field in the table;
+//   rank - int32, the place, starting from 1;
+//   count - int64, the estimated count of the value.
+// The rows are sent only when the set of the top values or their order
+// changes, and only for the places that have changed: OP_DELETE for the
+// value that left the place and OP_INSERT for the one that took it.
+// A change of the count alone sends nothing, so the count in the result
+// is the one at the time when the value got its current place.
+//
+// When the Table coalesces the aggregator results (see
+// Table::setAggregatorCoalesce()), the whole top k gets sent on each flush
+// instead, as the deletion of the old list and the insertion of the new one.
+//
+// The null values of the key field don't get counted.
+class TopKAggregatorType : public AggregatorType
+{
+public:
+	// @param name - name for aggregators' gadget in the table, will be tablename.name
+	// @param key - name of the field whose values get counted
+	// @param k - number of the top values to report
+	// @param capacity - number of the counters per group, 0 means 4*k;
+	//        the more counters the more precise the counts
+	TopKAggregatorType(const string &name, const string &key, int k, int capacity = 0);
+	// the default copy constructor works well
+
+	// for deep copy
+	TopKAggregatorType(const TopKAggregatorType &agg, HoldRowTypes *holder);
+
+	// Get back the parameters.
+	const string &getKey() const
+	{
+		return key_;
+	}
+	int getK() const
+	{
+		return k_;
+	}
+	// The actual number of counters, with the default filled in.
+	int getCapacity() const
+	{
+		return capacity_ == 0? 4 * k_ : capacity_;
+	}
+
+	// from Type
+	virtual bool equals(const Type *t) const;
+	virtual bool match(const Type *t) const;
+	virtual void printTo(string &res, const string &indent = "", const string &subindent = "  ") const;
+
+	// from AggregatorType
+	virtual void initialize(TableType *tabtype, IndexType *intype);
+	virtual AggregatorType *copy() const;
+	virtual AggregatorType *deepCopy(HoldRowTypes *holder) const;
+	// creates just the generic AggregatorGadget, nothing special
+	virtual AggregatorGadget *makeGadget(Table *table, IndexType *intype) const;
+	virtual Aggregator *makeAggregator(Table *table, AggregatorGadget *gadget) const;
+
+protected:
+	friend class TopKAggregator;
+
+	string key_; // name of the key field
+	int k_; // number of the top values
+	int capacity_; // number of the counters, 0 for default
+	int keyIdx_; // index of the key field in the table's row type
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TopKAggregatorType_h__
@@ -0,0 +1,128 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A sorted index that keeps only a limited number of the best rows.
+
+#include <type/TopNIndexType.h>
+#include <type/TableType.h>
+#include <table/TopNIndex.h>
+#include <common/StringUtil.h>
+#include <common/Exception.h>
+
+namespace TRICEPS_NS {
+
+TopNIndexType::TopNIndexType(Onceref<SortedIndexCondition> sc, size_t limit, bool reverse) :
+	SortedIndexType(sc, IT_TOPN),
+	limit_(limit),
+	reverse_(reverse)
+{ }
+
+TopNIndexType::TopNIndexType(const TopNIndexType &orig, bool flat) :
+	SortedIndexType(orig, flat),
+	limit_(orig.limit_),
+	reverse_(orig.reverse_)
+{ }
+
+TopNIndexType::TopNIndexType(const TopNIndexType &orig, HoldRowTypes *holder) :
+	SortedIndexType(orig, holder),
+	limit_(orig.limit_),
+	reverse_(orig.reverse_)
+{ }
+
+TopNIndexType *TopNIndexType::setLimit(size_t limit)
+{
+	if (initialized_) {
+		Autoref<TopNIndexType> cleaner = this;
+		throw Exception::fTrace("Attempted to set the limit on an initialized TopN index type");
+	}
+	limit_ = limit;
+	return this;
+}
+
+TopNIndexType *TopNIndexType::setReverse(bool reverse)
+{
+	if (initialized_) {
+		Autoref<TopNIndexType> cleaner = this;
+		throw Exception::fTrace("Attempted to set the reverse mode on an initialized TopN index type");
+	}
+	reverse_ = reverse;
+	return this;
+}
+
+bool TopNIndexType::equals(const Type *t) const
+{
+	if (this == t)
+		return true; // self-comparison, shortcut
+
+	if (!SortedIndexType::equals(t))
+		return false;
+	
+	const TopNIndexType *tit = static_cast<const TopNIndexType *>(t);
+
+	return (limit_ == tit->limit_ 
+		&& reverse_ == tit->reverse_);
+}
+
+bool TopNIndexType::match(const Type *t) const
+{
+	if (this == t)
+		return true; // self-comparison, shortcut
+
+	if (!SortedIndexType::match(t))
+		return false;
+	
+	const TopNIndexType *tit = static_cast<const TopNIndexType *>(t);
+
+	return (limit_ == tit->limit_ 
+		&& reverse_ == tit->reverse_);
+}
+
+void TopNIndexType::printTo(string &res, const string &indent, const string &subindent) const
+{
+	res.append(strprintf("index TopNIndex(limit=%zd", limit_));
+	if (reverse_)
+		res.append(" reverse");
+	res.append(") ");
+	sc_->printTo(res, indent, subindent);
+	printSubelementsTo(res, indent, subindent);
+}
+
+IndexType *TopNIndexType::copy(bool flat) const
+{
+	return new TopNIndexType(*this, flat);
+}
+
+IndexType *TopNIndexType::deepCopy(HoldRowTypes *holder) const
+{
+	return new TopNIndexType(*this, holder);
+}
+
+void TopNIndexType::initialize()
+{
+	if (isInitialized())
+		return; // nothing to do
+
+	SortedIndexType::initialize();
+
+	if (nested_.size() != 0)
+		errors_->appendMsg(true, "TopNIndexType currently does not support further nested indexes");
+
+	if (limit_ == 0)
+		errors_->appendMsg(true, "TopNIndexType requires a non-0 limit");
+}
+
+Index *TopNIndexType::makeIndex(const TableType *tabtype, Table *table) const
+{
+	if (!isInitialized() 
+	|| errors_->hasError())
+		return NULL; 
+
+	// give the index a custom copy of the comparator that can report
+	// errors to the table
+	return new TopNIndex(tabtype, table, this, sc_->tableCopy(table));
+}
+
+}; // TRICEPS_NS
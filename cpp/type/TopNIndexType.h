@@ -0,0 +1,89 @@
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+//
+// A sorted index that keeps only a limited number of the best rows.
+
+#ifndef __Triceps_TopNIndexType_h__
+#define __Triceps_TopNIndexType_h__
+
+#include <type/SortedIndexType.h>
+
+namespace TRICEPS_NS {
+
+// A SortedIndexType with a limit on the number of rows. The rows are
+// ordered by the sort condition, and the best rows are the ones at the
+// front of the order (or at the back, for the reverse index). When
+// a new row comes into a full index, the worst row gets pushed out by
+// the replacement policy, as a normal deletion from the table. If the
+// new row itself is worse than all the rows in a full index, it doesn't
+// get inserted at all, and the table's insert returns false.
+//
+// So the usual way to keep the best N rows per key is to nest this index
+// under a HashedIndexType on the key. As with the sorted index, the sort
+// condition also defines the uniqueness: a new row with the same sort key
+// replaces the old one.
+//
+// The iteration always goes in the order of the sort condition, the
+// reverse flag only selects which end of it is kept.
+//
+// The pushing out costs O(log N), like any other deletion from the tree.
+// The index can not have any further nested indexes.
+class TopNIndexType : public SortedIndexType
+{
+public:
+	// @param sc - the object defining the sorting order
+	// @param limit - the maximal number of rows, at least 1
+	// @param reverse - flag: keep the rows at the back of the sort order
+	//        instead of the front
+	TopNIndexType(Onceref<SortedIndexCondition> sc, size_t limit, bool reverse = false);
+	// Constructors duplicated as make() for syntactically better usage.
+	static TopNIndexType *make(Onceref<SortedIndexCondition> sc, size_t limit, bool reverse = false)
+	{
+		return new TopNIndexType(sc, limit, reverse);
+	}
+
+	size_t getLimit() const
+	{
+		return limit_;
+	}
+
+	bool isReverse() const
+	{
+		return reverse_;
+	}
+
+	// Set the limit later (only until initialized).
+	TopNIndexType *setLimit(size_t limit);
+	// Set the reverse flag later (only until initialized).
+	TopNIndexType *setReverse(bool reverse);
+
+	// from Type
+	virtual bool equals(const Type *t) const;
+	virtual bool match(const Type *t) const;
+	virtual void printTo(string &res, const string &indent = "", const string &subindent = "  ") const;
+
+	// from IndexType
+	virtual IndexType *copy(bool flat = false) const;
+	virtual IndexType *deepCopy(HoldRowTypes *holder) const;
+	virtual void initialize();
+	virtual Index *makeIndex(const TableType *tabtype, Table *table) const;
+
+protected:
+	// interface for the index instances
+	friend class TopNIndex;
+
+	// used by copy()
+	TopNIndexType(const TopNIndexType &orig, bool flat);
+	// used by deepCopy()
+	TopNIndexType(const TopNIndexType &orig, HoldRowTypes *holder);
+
+	size_t limit_; // the maximal number of rows
+	bool reverse_; // flag: keep the back of the sort order
+};
+
+}; // TRICEPS_NS
+
+#endif // __Triceps_TopNIndexType_h__
@@ -91,6 +91,7 @@ protected:
 	// index instance interface
 	friend class TreeIndex;
 	friend class TreeNestedIndex;
+	friend class IndexBloom;
 
 	// Not a set of Autoref<RowHandle> because the row is owned by the whole table once,
 	// not by each index; this also improves the performance a lot.
@@ -474,6 +474,38 @@ UTESTCASE equal(Utest *utest)
 	UT_ASSERT(!rt1->equalRows(r3, r4));
 }
 
+UTESTCASE hash_fields(Utest *utest)
+{
+	RowType::FieldVec fld;
+	mkfields(fld);
+
+	Autoref<RowType> rt1 = new CompactRowType(fld);
+	if (UT_ASSERT(rt1->getErrors().isNull())) return;
+
+	FdataVec dv;
+	mkfdata(dv);
+	Rowref r1(rt1,  rt1->makeRow(dv));
+	dv[1].notNull_ = false;
+	Rowref r2(rt1,  rt1->makeRow(dv));
+
+	vector<int> idx;
+	UT_IS(rt1->hashFields(r1, idx), Hash::basis_);
+
+	idx.push_back(4);
+	idx.push_back(1);
+	Hash::Value h = Hash::basis_;
+	h = Hash::addByte(h, 1);
+	h = Hash::append(h, v_string, sizeof(v_string));
+	Hash::Value h2 = h;
+	h = Hash::addByte(h, 1);
+	h = Hash::append(h, (char *)&v_int32, sizeof(v_int32));
+	UT_IS(rt1->hashFields(r1, idx), h);
+
+	// a null field still contributes its flag
+	h2 = Hash::addByte(h2, 0);
+	UT_IS(rt1->hashFields(r2, idx), h2);
+}
+
 
 UTESTCASE hold_row_types(Utest *utest)
 {
@@ -0,0 +1,392 @@
+/*
+ * This file was generated automatically by ExtUtils::ParseXS version 3.45 from the
+ * contents of AutoFnBind.xs. Do not edit this file, edit AutoFnBind.xs instead.
+ *
+ *    ANY CHANGES MADE HERE WILL BE LOST!
+ *
+ */
+
+#line 1 "AutoFnBind.xs"
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+// The wrapper for AutoFnBind.
+
+#include "EXTERN.h"
+#include "perl.h"
+#include "XSUB.h"
+
+#include "ppport.h"
+
+#include "TricepsPerl.h"
+#include "TricepsOpt.h"
+
+#line 27 "AutoFnBind.c"
+#ifndef PERL_UNUSED_VAR
+#  define PERL_UNUSED_VAR(var) if (0) var = var
+#endif
+
+#ifndef dVAR
+#  define dVAR		dNOOP
+#endif
+
+
+/* This stuff is not part of the API! You have been warned. */
+#ifndef PERL_VERSION_DECIMAL
+#  define PERL_VERSION_DECIMAL(r,v,s) (r*1000000 + v*1000 + s)
+#endif
+#ifndef PERL_DECIMAL_VERSION
+#  define PERL_DECIMAL_VERSION \
+	  PERL_VERSION_DECIMAL(PERL_REVISION,PERL_VERSION,PERL_SUBVERSION)
+#endif
+#ifndef PERL_VERSION_GE
+#  define PERL_VERSION_GE(r,v,s) \
+	  (PERL_DECIMAL_VERSION >= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+#ifndef PERL_VERSION_LE
+#  define PERL_VERSION_LE(r,v,s) \
+	  (PERL_DECIMAL_VERSION <= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+
+/* XS_INTERNAL is the explicit static-linkage variant of the default
+ * XS macro.
+ *
+ * XS_EXTERNAL is the same as XS_INTERNAL except it does not include
+ * "STATIC", ie. it exports XSUB symbols. You probably don't want that
+ * for anything but the BOOT XSUB.
+ *
+ * See XSUB.h in core!
+ */
+
+
+/* TODO: This might be compatible further back than 5.10.0. */
+#if PERL_VERSION_GE(5, 10, 0) && PERL_VERSION_LE(5, 15, 1)
+#  undef XS_EXTERNAL
+#  undef XS_INTERNAL
+#  if defined(__CYGWIN__) && defined(USE_DYNAMIC_LOADING)
+#    define XS_EXTERNAL(name) __declspec(dllexport) XSPROTO(name)
+#    define XS_INTERNAL(name) STATIC XSPROTO(name)
+#  endif
+#  if defined(__SYMBIAN32__)
+#    define XS_EXTERNAL(name) EXPORT_C XSPROTO(name)
+#    define XS_INTERNAL(name) EXPORT_C STATIC XSPROTO(name)
+#  endif
+#  ifndef XS_EXTERNAL
+#    if defined(HASATTRIBUTE_UNUSED) && !defined(__cplusplus)
+#      define XS_EXTERNAL(name) void name(pTHX_ CV* cv __attribute__unused__)
+#      define XS_INTERNAL(name) STATIC void name(pTHX_ CV* cv __attribute__unused__)
+#    else
+#      ifdef __cplusplus
+#        define XS_EXTERNAL(name) extern "C" XSPROTO(name)
+#        define XS_INTERNAL(name) static XSPROTO(name)
+#      else
+#        define XS_EXTERNAL(name) XSPROTO(name)
+#        define XS_INTERNAL(name) STATIC XSPROTO(name)
+#      endif
+#    endif
+#  endif
+#endif
+
+/* perl >= 5.10.0 && perl <= 5.15.1 */
+
+
+/* The XS_EXTERNAL macro is used for functions that must not be static
+ * like the boot XSUB of a module. If perl didn't have an XS_EXTERNAL
+ * macro defined, the best we can do is assume XS is the same.
+ * Dito for XS_INTERNAL.
+ */
+#ifndef XS_EXTERNAL
+#  define XS_EXTERNAL(name) XS(name)
+#endif
+#ifndef XS_INTERNAL
+#  define XS_INTERNAL(name) XS(name)
+#endif
+
+/* Now, finally, after all this mess, we want an ExtUtils::ParseXS
+ * internal macro that we're free to redefine for varying linkage due
+ * to the EXPORT_XSUB_SYMBOLS XS keyword. This is internal, use
+ * XS_EXTERNAL(name) or XS_INTERNAL(name) in your code if you need to!
+ */
+
+#undef XS_EUPXS
+#if defined(PERL_EUPXS_ALWAYS_EXPORT)
+#  define XS_EUPXS(name) XS_EXTERNAL(name)
+#else
+   /* default to internal */
+#  define XS_EUPXS(name) XS_INTERNAL(name)
+#endif
+
+#ifndef PERL_ARGS_ASSERT_CROAK_XS_USAGE
+#define PERL_ARGS_ASSERT_CROAK_XS_USAGE assert(cv); assert(params)
+
+/* prototype to pass -Wmissing-prototypes */
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params);
+
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params)
+{
+    const GV *const gv = CvGV(cv);
+
+    PERL_ARGS_ASSERT_CROAK_XS_USAGE;
+
+    if (gv) {
+        const char *const gvname = GvNAME(gv);
+        const HV *const stash = GvSTASH(gv);
+        const char *const hvname = stash ? HvNAME(stash) : NULL;
+
+        if (hvname)
+	    Perl_croak_nocontext("Usage: %s::%s(%s)", hvname, gvname, params);
+        else
+	    Perl_croak_nocontext("Usage: %s(%s)", gvname, params);
+    } else {
+        /* Pants. I don't think that it should be possible to get here. */
+	Perl_croak_nocontext("Usage: CODE(0x%" UVxf ")(%s)", PTR2UV(cv), params);
+    }
+}
+#undef  PERL_ARGS_ASSERT_CROAK_XS_USAGE
+
+#define croak_xs_usage        S_croak_xs_usage
+
+#endif
+
+/* NOTE: the prototype of newXSproto() is different in versions of perls,
+ * so we define a portable version of newXSproto()
+ */
+#ifdef newXS_flags
+#define newXSproto_portable(name, c_impl, file, proto) newXS_flags(name, c_impl, file, proto, 0)
+#else
+#define newXSproto_portable(name, c_impl, file, proto) (PL_Sv=(SV*)newXS(name, c_impl, file), sv_setpv(PL_Sv, proto), (CV*)PL_Sv)
+#endif /* !defined(newXS_flags) */
+
+#if PERL_VERSION_LE(5, 21, 5)
+#  define newXS_deffile(a,b) Perl_newXS(aTHX_ a,b,file)
+#else
+#  define newXS_deffile(a,b) Perl_newXS_deffile(aTHX_ a,b)
+#endif
+
+#line 171 "AutoFnBind.c"
+
+XS_EUPXS(XS_Triceps__AutoFnBind_CLONE_SKIP); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__AutoFnBind_CLONE_SKIP)
+{
+    dVAR; dXSARGS;
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+    {
+	int	RETVAL;
+	dXSTARG;
+#line 23 "AutoFnBind.xs"
+		RETVAL = 1;
+#line 184 "AutoFnBind.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__AutoFnBind_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__AutoFnBind_DESTROY)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapAutoFnBind *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapAutoFnBind *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::AutoFnBind::DESTROY(): self has an incorrect magic for WrapAutoFnBindPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::AutoFnBind::DESTROY(): self is not a blessed SV reference to WrapAutoFnBindPtr" );
+	}
+;
+#line 32 "AutoFnBind.xs"
+		// warn("AutoFnBind destroyed!");
+		clearErrMsg();
+		try {
+			self->get()->clear();
+		} catch(Exception e) {
+			Erref err;
+			err.fAppend(e.getErrors(), "Triceps::AutoFnBind::DESTROY: encountered an FnReturn corruption");
+			err->appendMsg(true, "Perl does not allow to die properly in a destructor, so will just exit.");
+			warn("%sTo see a full call stack, add an explicit clear() of the AutoFnBind before the end of block starting", err->print().c_str());
+			_exit(1);
+		}
+		delete self;
+#line 223 "AutoFnBind.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__AutoFnBind_new); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__AutoFnBind_new)
+{
+    dVAR; dXSARGS;
+    if (items < 1)
+       croak_xs_usage(cv,  "CLASS, ...");
+    {
+	WrapAutoFnBind *	RETVAL;
+	char *	CLASS = (char *)SvPV_nolen(ST(0))
+;
+#line 52 "AutoFnBind.xs"
+		static char funcName[] =  "Triceps::AutoFnBind::new";
+		clearErrMsg();
+		Autoref<AutoFnBind> mbret;
+		try {
+			if (items % 2 != 1) {
+				throw Exception("Usage: Triceps::AutoFnBind::new(CLASS, ret1 => binding1, ...), FnReturn and FnBinding objects must go in pairs", false);
+			}
+			Autoref<AutoFnBind> mb = new AutoFnBind;
+			for (int i = 1; i < items; i += 2) {
+				FnReturn *ret = TRICEPS_GET_WRAP(FnReturn, ST(i), "%s: argument %d", funcName, i)->get();
+				FnBinding *bind = TRICEPS_GET_WRAP(FnBinding, ST(i+1), "%s: argument %d", funcName, i+1)->get();
+
+				try {
+					mb->add(ret, bind);
+				} catch (Exception e) {
+					throw Exception(e, strprintf("%s: invalid arguments:", funcName));
+				}
+			}
+			mbret = mb; // no exceptions may happen after this
+		} TRICEPS_CATCH_CROAK;
+
+		RETVAL = new WrapAutoFnBind(mbret);
+#line 262 "AutoFnBind.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__AutoFnBind_clear); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__AutoFnBind_clear)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapAutoFnBind *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapAutoFnBind *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::AutoFnBind::clear(): self has an incorrect magic for WrapAutoFnBindPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::AutoFnBind::clear(): self is not a blessed SV reference to WrapAutoFnBindPtr" );
+	}
+;
+#line 83 "AutoFnBind.xs"
+		clearErrMsg();
+		try {
+			try {
+				self->get()->clear();
+			} catch(Exception e) {
+				throw Exception(e, "Triceps::AutoFnBind::clear: encountered an FnReturn corruption");
+			}
+		} TRICEPS_CATCH_CROAK;
+#line 301 "AutoFnBind.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__AutoFnBind_same); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__AutoFnBind_same)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, other");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapAutoFnBind *	self;
+	WrapAutoFnBind *	other;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapAutoFnBind *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::AutoFnBind::same(): self has an incorrect magic for WrapAutoFnBindPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::AutoFnBind::same(): self is not a blessed SV reference to WrapAutoFnBindPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		other = (WrapAutoFnBind *)SvIV((SV*)SvRV( ST(1) ));
+		if (other == 0 || other->badMagic()) {
+			croakWithMsg( "Triceps::AutoFnBind::same(): other has an incorrect magic for WrapAutoFnBindPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::AutoFnBind::same(): other is not a blessed SV reference to WrapAutoFnBindPtr" );
+	}
+;
+#line 96 "AutoFnBind.xs"
+		clearErrMsg();
+		AutoFnBind *fb = self->get();
+		AutoFnBind *ofb = other->get();
+		RETVAL = (fb == ofb);
+#line 343 "AutoFnBind.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+XS_EXTERNAL(boot_Triceps__AutoFnBind); /* prototype to pass -Wmissing-prototypes */
+XS_EXTERNAL(boot_Triceps__AutoFnBind)
+{
+#if PERL_VERSION_LE(5, 21, 5)
+    dVAR; dXSARGS;
+#else
+    dVAR; dXSBOOTARGSXSAPIVERCHK;
+#endif
+#if PERL_VERSION_LE(5, 8, 999) /* PERL_VERSION_LT is 5.33+ */
+    char* file = __FILE__;
+#else
+    const char* file = __FILE__;
+#endif
+
+    PERL_UNUSED_VAR(file);
+
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+#if PERL_VERSION_LE(5, 21, 5)
+    XS_VERSION_BOOTCHECK;
+#  ifdef XS_APIVERSION_BOOTCHECK
+    XS_APIVERSION_BOOTCHECK;
+#  endif
+#endif
+
+        newXS_deffile("Triceps::AutoFnBind::CLONE_SKIP", XS_Triceps__AutoFnBind_CLONE_SKIP);
+        newXS_deffile("Triceps::AutoFnBind::DESTROY", XS_Triceps__AutoFnBind_DESTROY);
+        newXS_deffile("Triceps::AutoFnBind::new", XS_Triceps__AutoFnBind_new);
+        newXS_deffile("Triceps::AutoFnBind::clear", XS_Triceps__AutoFnBind_clear);
+        newXS_deffile("Triceps::AutoFnBind::same", XS_Triceps__AutoFnBind_same);
+#if PERL_VERSION_LE(5, 21, 5)
+#  if PERL_VERSION_GE(5, 9, 0)
+    if (PL_unitcheckav)
+        call_list(PL_scopestack_ix, PL_unitcheckav);
+#  endif
+    XSRETURN_YES;
+#else
+    Perl_xs_boot_epilog(aTHX_ ax);
+#endif
+}
+
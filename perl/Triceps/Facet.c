@@ -0,0 +1,880 @@
+/*
+ * This file was generated automatically by ExtUtils::ParseXS version 3.45 from the
+ * contents of Facet.xs. Do not edit this file, edit Facet.xs instead.
+ *
+ *    ANY CHANGES MADE HERE WILL BE LOST!
+ *
+ */
+
+#line 1 "Facet.xs"
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+// The wrapper for Facet.
+
+#include "EXTERN.h"
+#include "perl.h"
+#include "XSUB.h"
+
+#include "ppport.h"
+
+#include "TricepsPerl.h"
+#include "app/Facet.h"
+
+#line 27 "Facet.c"
+#ifndef PERL_UNUSED_VAR
+#  define PERL_UNUSED_VAR(var) if (0) var = var
+#endif
+
+#ifndef dVAR
+#  define dVAR		dNOOP
+#endif
+
+
+/* This stuff is not part of the API! You have been warned. */
+#ifndef PERL_VERSION_DECIMAL
+#  define PERL_VERSION_DECIMAL(r,v,s) (r*1000000 + v*1000 + s)
+#endif
+#ifndef PERL_DECIMAL_VERSION
+#  define PERL_DECIMAL_VERSION \
+	  PERL_VERSION_DECIMAL(PERL_REVISION,PERL_VERSION,PERL_SUBVERSION)
+#endif
+#ifndef PERL_VERSION_GE
+#  define PERL_VERSION_GE(r,v,s) \
+	  (PERL_DECIMAL_VERSION >= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+#ifndef PERL_VERSION_LE
+#  define PERL_VERSION_LE(r,v,s) \
+	  (PERL_DECIMAL_VERSION <= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+
+/* XS_INTERNAL is the explicit static-linkage variant of the default
+ * XS macro.
+ *
+ * XS_EXTERNAL is the same as XS_INTERNAL except it does not include
+ * "STATIC", ie. it exports XSUB symbols. You probably don't want that
+ * for anything but the BOOT XSUB.
+ *
+ * See XSUB.h in core!
+ */
+
+
+/* TODO: This might be compatible further back than 5.10.0. */
+#if PERL_VERSION_GE(5, 10, 0) && PERL_VERSION_LE(5, 15, 1)
+#  undef XS_EXTERNAL
+#  undef XS_INTERNAL
+#  if defined(__CYGWIN__) && defined(USE_DYNAMIC_LOADING)
+#    define XS_EXTERNAL(name) __declspec(dllexport) XSPROTO(name)
+#    define XS_INTERNAL(name) STATIC XSPROTO(name)
+#  endif
+#  if defined(__SYMBIAN32__)
+#    define XS_EXTERNAL(name) EXPORT_C XSPROTO(name)
+#    define XS_INTERNAL(name) EXPORT_C STATIC XSPROTO(name)
+#  endif
+#  ifndef XS_EXTERNAL
+#    if defined(HASATTRIBUTE_UNUSED) && !defined(__cplusplus)
+#      define XS_EXTERNAL(name) void name(pTHX_ CV* cv __attribute__unused__)
+#      define XS_INTERNAL(name) STATIC void name(pTHX_ CV* cv __attribute__unused__)
+#    else
+#      ifdef __cplusplus
+#        define XS_EXTERNAL(name) extern "C" XSPROTO(name)
+#        define XS_INTERNAL(name) static XSPROTO(name)
+#      else
+#        define XS_EXTERNAL(name) XSPROTO(name)
+#        define XS_INTERNAL(name) STATIC XSPROTO(name)
+#      endif
+#    endif
+#  endif
+#endif
+
+/* perl >= 5.10.0 && perl <= 5.15.1 */
+
+
+/* The XS_EXTERNAL macro is used for functions that must not be static
+ * like the boot XSUB of a module. If perl didn't have an XS_EXTERNAL
+ * macro defined, the best we can do is assume XS is the same.
+ * Dito for XS_INTERNAL.
+ */
+#ifndef XS_EXTERNAL
+#  define XS_EXTERNAL(name) XS(name)
+#endif
+#ifndef XS_INTERNAL
+#  define XS_INTERNAL(name) XS(name)
+#endif
+
+/* Now, finally, after all this mess, we want an ExtUtils::ParseXS
+ * internal macro that we're free to redefine for varying linkage due
+ * to the EXPORT_XSUB_SYMBOLS XS keyword. This is internal, use
+ * XS_EXTERNAL(name) or XS_INTERNAL(name) in your code if you need to!
+ */
+
+#undef XS_EUPXS
+#if defined(PERL_EUPXS_ALWAYS_EXPORT)
+#  define XS_EUPXS(name) XS_EXTERNAL(name)
+#else
+   /* default to internal */
+#  define XS_EUPXS(name) XS_INTERNAL(name)
+#endif
+
+#ifndef PERL_ARGS_ASSERT_CROAK_XS_USAGE
+#define PERL_ARGS_ASSERT_CROAK_XS_USAGE assert(cv); assert(params)
+
+/* prototype to pass -Wmissing-prototypes */
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params);
+
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params)
+{
+    const GV *const gv = CvGV(cv);
+
+    PERL_ARGS_ASSERT_CROAK_XS_USAGE;
+
+    if (gv) {
+        const char *const gvname = GvNAME(gv);
+        const HV *const stash = GvSTASH(gv);
+        const char *const hvname = stash ? HvNAME(stash) : NULL;
+
+        if (hvname)
+	    Perl_croak_nocontext("Usage: %s::%s(%s)", hvname, gvname, params);
+        else
+	    Perl_croak_nocontext("Usage: %s(%s)", gvname, params);
+    } else {
+        /* Pants. I don't think that it should be possible to get here. */
+	Perl_croak_nocontext("Usage: CODE(0x%" UVxf ")(%s)", PTR2UV(cv), params);
+    }
+}
+#undef  PERL_ARGS_ASSERT_CROAK_XS_USAGE
+
+#define croak_xs_usage        S_croak_xs_usage
+
+#endif
+
+/* NOTE: the prototype of newXSproto() is different in versions of perls,
+ * so we define a portable version of newXSproto()
+ */
+#ifdef newXS_flags
+#define newXSproto_portable(name, c_impl, file, proto) newXS_flags(name, c_impl, file, proto, 0)
+#else
+#define newXSproto_portable(name, c_impl, file, proto) (PL_Sv=(SV*)newXS(name, c_impl, file), sv_setpv(PL_Sv, proto), (CV*)PL_Sv)
+#endif /* !defined(newXS_flags) */
+
+#if PERL_VERSION_LE(5, 21, 5)
+#  define newXS_deffile(a,b) Perl_newXS(aTHX_ a,b,file)
+#else
+#  define newXS_deffile(a,b) Perl_newXS_deffile(aTHX_ a,b)
+#endif
+
+#line 171 "Facet.c"
+
+XS_EUPXS(XS_Triceps__Facet_CLONE_SKIP); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_CLONE_SKIP)
+{
+    dVAR; dXSARGS;
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+    {
+	int	RETVAL;
+	dXSTARG;
+#line 23 "Facet.xs"
+		RETVAL = 1;
+#line 184 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_DESTROY)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::DESTROY(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::DESTROY(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 30 "Facet.xs"
+		// Facet *fa = self->get();
+		// warn("Facet %s %p wrap %p destroyed!", fa->getFullName().c_str(), to, self);
+		delete self;
+#line 214 "Facet.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_same); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_same)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, other");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+	WrapFacet *	other;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::same(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::same(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		other = (WrapFacet *)SvIV((SV*)SvRV( ST(1) ));
+		if (other == 0 || other->badMagic()) {
+			croakWithMsg( "Triceps::Facet::same(): other has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::same(): other is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 38 "Facet.xs"
+		clearErrMsg();
+		Facet *fa1 = self->get();
+		Facet *fa2 = other->get();
+		RETVAL = (fa1 == fa2);
+#line 256 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_getShortName); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_getShortName)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	char *	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::getShortName(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::getShortName(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 48 "Facet.xs"
+		clearErrMsg();
+		Facet *fa = self->get();
+		RETVAL = (char *)fa->getShortName().c_str();
+#line 288 "Facet.c"
+	sv_setpv(TARG, RETVAL);
+	XSprePUSH;
+	PUSHTARG;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_getFullName); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_getFullName)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	char *	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::getFullName(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::getFullName(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 57 "Facet.xs"
+		clearErrMsg();
+		Facet *fa = self->get();
+		RETVAL = (char *)fa->getFullName().c_str();
+#line 321 "Facet.c"
+	sv_setpv(TARG, RETVAL);
+	XSprePUSH;
+	PUSHTARG;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_isWriter); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_isWriter)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::isWriter(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::isWriter(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 66 "Facet.xs"
+		clearErrMsg();
+		RETVAL = self->get()->isWriter();
+#line 353 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_isReverse); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_isReverse)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::isReverse(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::isReverse(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 74 "Facet.xs"
+		clearErrMsg();
+		RETVAL = self->get()->isReverse();
+#line 384 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_queueLimit); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_queueLimit)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::queueLimit(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::queueLimit(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 82 "Facet.xs"
+		clearErrMsg();
+		RETVAL = self->get()->queueLimit();
+#line 415 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_DEFAULT_QUEUE_LIMIT); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_DEFAULT_QUEUE_LIMIT)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	int	RETVAL;
+	dXSTARG;
+#line 91 "Facet.xs"
+		RETVAL = Facet::DEFAULT_QUEUE_LIMIT;
+#line 434 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_getFnReturn); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_getFnReturn)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapFnReturn *	RETVAL;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::getFnReturn(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::getFnReturn(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 99 "Facet.xs"
+		static char CLASS[] = "Triceps::FnReturn";
+		clearErrMsg();
+		RETVAL = new WrapFnReturn(self->get()->getFnReturn());
+#line 465 "Facet.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_nexus); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_nexus)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapNexus *	RETVAL;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::nexus(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::nexus(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 108 "Facet.xs"
+		static char CLASS[] = "Triceps::Nexus";
+		clearErrMsg();
+		RETVAL = new WrapNexus(self->get()->nexus());
+#line 500 "Facet.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_beginIdx); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_beginIdx)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::beginIdx(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::beginIdx(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 117 "Facet.xs"
+		clearErrMsg();
+		RETVAL = self->get()->beginIdx();
+#line 535 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_endIdx); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_endIdx)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::endIdx(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::endIdx(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 125 "Facet.xs"
+		clearErrMsg();
+		RETVAL = self->get()->endIdx();
+#line 566 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_getLabel); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_getLabel)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, name");
+    {
+	WrapLabel *	RETVAL;
+	WrapFacet *	self;
+	char *	name = (char *)SvPV_nolen(ST(1))
+;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::getLabel(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::getLabel(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 135 "Facet.xs"
+		// for casting of return valus
+		static char CLASS[] = "Triceps::Label";
+		clearErrMsg();
+		RETVAL = NULL;
+		try {
+			Facet *obj = self->get();
+			Label *lb = obj->getFnReturn()->getLabel(name);
+			if (lb == NULL)
+				throw Exception::f("Triceps::Facet::getLabel: unknown label name '%s'.", name);
+			RETVAL = new WrapLabel(lb);
+		} TRICEPS_CATCH_CROAK;
+#line 607 "Facet.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_impRowTypesHash); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_impRowTypesHash)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	RETVAL;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::impRowTypesHash(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::impRowTypesHash(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 156 "Facet.xs"
+		// for casting of return value
+		static char CLASS[] = "Triceps::RowType";
+		clearErrMsg();
+		Facet *fa = self->get();
+		const Facet::RowTypeMap &m = fa->rowTypes();
+		for (Facet::RowTypeMap::const_iterator it = m.begin(); it != m.end(); ++it) {
+			XPUSHs(sv_2mortal(newSVpvn(it->first.c_str(), it->first.size())));
+
+			SV *sub = newSV(0);
+			sv_setref_pv( sub, CLASS, (void*)(new WrapRowType(it->second)) );
+			XPUSHs(sv_2mortal(sub));
+		}
+#line 653 "Facet.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_impRowType); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_impRowType)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, name");
+    {
+	WrapRowType *	RETVAL;
+	WrapFacet *	self;
+	char *	name = (char *)SvPV_nolen(ST(1))
+;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::impRowType(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::impRowType(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 172 "Facet.xs"
+		// for casting of return valus
+		static char CLASS[] = "Triceps::RowType";
+		clearErrMsg();
+		RETVAL = NULL;
+		try {
+			Facet *obj = self->get();
+			RowType *rt = obj->impRowType(name);
+			if (rt == NULL) // XXX add list of valid names in the error message?
+				throw Exception::f("Triceps::Facet::impRowType: unknown row type name '%s'", name);
+			RETVAL = new WrapRowType(rt);
+		} TRICEPS_CATCH_CROAK;
+#line 693 "Facet.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_impTableTypesHash); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_impTableTypesHash)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	RETVAL;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::impTableTypesHash(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::impTableTypesHash(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 193 "Facet.xs"
+		// for casting of return value
+		static char CLASS[] = "Triceps::TableType";
+		clearErrMsg();
+		Facet *fa = self->get();
+		const Facet::TableTypeMap &m = fa->tableTypes();
+		for (Facet::TableTypeMap::const_iterator it = m.begin(); it != m.end(); ++it) {
+			XPUSHs(sv_2mortal(newSVpvn(it->first.c_str(), it->first.size())));
+
+			SV *sub = newSV(0);
+			sv_setref_pv( sub, CLASS, (void*)(new WrapTableType(it->second)) );
+			XPUSHs(sv_2mortal(sub));
+		}
+#line 739 "Facet.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_impTableType); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_impTableType)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, name");
+    {
+	WrapTableType *	RETVAL;
+	WrapFacet *	self;
+	char *	name = (char *)SvPV_nolen(ST(1))
+;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::impTableType(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::impTableType(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 209 "Facet.xs"
+		// for casting of return valus
+		static char CLASS[] = "Triceps::TableType";
+		clearErrMsg();
+		RETVAL = NULL;
+		try {
+			Facet *obj = self->get();
+			TableType *tt = obj->impTableType(name);
+			if (tt == NULL) // XXX add list of valid names in the error message?
+				throw Exception::f("Triceps::Facet::impTableType: unknown table type name '%s'", name);
+			RETVAL = new WrapTableType(tt);
+		} TRICEPS_CATCH_CROAK;
+#line 779 "Facet.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Facet_flushWriter); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Facet_flushWriter)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapFacet *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapFacet *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Facet::flushWriter(): self has an incorrect magic for WrapFacetPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Facet::flushWriter(): self is not a blessed SV reference to WrapFacetPtr" );
+	}
+;
+#line 226 "Facet.xs"
+		clearErrMsg();
+		RETVAL = 0;
+		try {
+			RETVAL = self->get()->flushWriter();
+		} TRICEPS_CATCH_CROAK;
+#line 817 "Facet.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+XS_EXTERNAL(boot_Triceps__Facet); /* prototype to pass -Wmissing-prototypes */
+XS_EXTERNAL(boot_Triceps__Facet)
+{
+#if PERL_VERSION_LE(5, 21, 5)
+    dVAR; dXSARGS;
+#else
+    dVAR; dXSBOOTARGSXSAPIVERCHK;
+#endif
+#if PERL_VERSION_LE(5, 8, 999) /* PERL_VERSION_LT is 5.33+ */
+    char* file = __FILE__;
+#else
+    const char* file = __FILE__;
+#endif
+
+    PERL_UNUSED_VAR(file);
+
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+#if PERL_VERSION_LE(5, 21, 5)
+    XS_VERSION_BOOTCHECK;
+#  ifdef XS_APIVERSION_BOOTCHECK
+    XS_APIVERSION_BOOTCHECK;
+#  endif
+#endif
+
+        newXS_deffile("Triceps::Facet::CLONE_SKIP", XS_Triceps__Facet_CLONE_SKIP);
+        newXS_deffile("Triceps::Facet::DESTROY", XS_Triceps__Facet_DESTROY);
+        newXS_deffile("Triceps::Facet::same", XS_Triceps__Facet_same);
+        newXS_deffile("Triceps::Facet::getShortName", XS_Triceps__Facet_getShortName);
+        newXS_deffile("Triceps::Facet::getFullName", XS_Triceps__Facet_getFullName);
+        newXS_deffile("Triceps::Facet::isWriter", XS_Triceps__Facet_isWriter);
+        newXS_deffile("Triceps::Facet::isReverse", XS_Triceps__Facet_isReverse);
+        newXS_deffile("Triceps::Facet::queueLimit", XS_Triceps__Facet_queueLimit);
+        newXS_deffile("Triceps::Facet::DEFAULT_QUEUE_LIMIT", XS_Triceps__Facet_DEFAULT_QUEUE_LIMIT);
+        newXS_deffile("Triceps::Facet::getFnReturn", XS_Triceps__Facet_getFnReturn);
+        newXS_deffile("Triceps::Facet::nexus", XS_Triceps__Facet_nexus);
+        newXS_deffile("Triceps::Facet::beginIdx", XS_Triceps__Facet_beginIdx);
+        newXS_deffile("Triceps::Facet::endIdx", XS_Triceps__Facet_endIdx);
+        newXS_deffile("Triceps::Facet::getLabel", XS_Triceps__Facet_getLabel);
+        newXS_deffile("Triceps::Facet::impRowTypesHash", XS_Triceps__Facet_impRowTypesHash);
+        newXS_deffile("Triceps::Facet::impRowType", XS_Triceps__Facet_impRowType);
+        newXS_deffile("Triceps::Facet::impTableTypesHash", XS_Triceps__Facet_impTableTypesHash);
+        newXS_deffile("Triceps::Facet::impTableType", XS_Triceps__Facet_impTableType);
+        newXS_deffile("Triceps::Facet::flushWriter", XS_Triceps__Facet_flushWriter);
+#if PERL_VERSION_LE(5, 21, 5)
+#  if PERL_VERSION_GE(5, 9, 0)
+    if (PL_unitcheckav)
+        call_list(PL_scopestack_ix, PL_unitcheckav);
+#  endif
+    XSRETURN_YES;
+#else
+    Perl_xs_boot_epilog(aTHX_ ax);
+#endif
+}
+
@@ -0,0 +1,1079 @@
+/*
+ * This file was generated automatically by ExtUtils::ParseXS version 3.45 from the
+ * contents of Label.xs. Do not edit this file, edit Label.xs instead.
+ *
+ *    ANY CHANGES MADE HERE WILL BE LOST!
+ *
+ */
+
+#line 1 "Label.xs"
+//
+// (C) Copyright 2011-2014 Sergey A. Babkin.
+// This file is a part of Triceps.
+// See the file COPYRIGHT for the copyright notice and license information
+//
+// The wrapper for Label.
+
+#include "EXTERN.h"
+#include "perl.h"
+#include "XSUB.h"
+
+#include "ppport.h"
+
+#include "TricepsPerl.h"
+#include "PerlCallback.h"
+
+#line 27 "Label.c"
+#ifndef PERL_UNUSED_VAR
+#  define PERL_UNUSED_VAR(var) if (0) var = var
+#endif
+
+#ifndef dVAR
+#  define dVAR		dNOOP
+#endif
+
+
+/* This stuff is not part of the API! You have been warned. */
+#ifndef PERL_VERSION_DECIMAL
+#  define PERL_VERSION_DECIMAL(r,v,s) (r*1000000 + v*1000 + s)
+#endif
+#ifndef PERL_DECIMAL_VERSION
+#  define PERL_DECIMAL_VERSION \
+	  PERL_VERSION_DECIMAL(PERL_REVISION,PERL_VERSION,PERL_SUBVERSION)
+#endif
+#ifndef PERL_VERSION_GE
+#  define PERL_VERSION_GE(r,v,s) \
+	  (PERL_DECIMAL_VERSION >= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+#ifndef PERL_VERSION_LE
+#  define PERL_VERSION_LE(r,v,s) \
+	  (PERL_DECIMAL_VERSION <= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+
+/* XS_INTERNAL is the explicit static-linkage variant of the default
+ * XS macro.
+ *
+ * XS_EXTERNAL is the same as XS_INTERNAL except it does not include
+ * "STATIC", ie. it exports XSUB symbols. You probably don't want that
+ * for anything but the BOOT XSUB.
+ *
+ * See XSUB.h in core!
+ */
+
+
+/* TODO: This might be compatible further back than 5.10.0. */
+#if PERL_VERSION_GE(5, 10, 0) && PERL_VERSION_LE(5, 15, 1)
+#  undef XS_EXTERNAL
+#  undef XS_INTERNAL
+#  if defined(__CYGWIN__) && defined(USE_DYNAMIC_LOADING)
+#    define XS_EXTERNAL(name) __declspec(dllexport) XSPROTO(name)
+#    define XS_INTERNAL(name) STATIC XSPROTO(name)
+#  endif
+#  if defined(__SYMBIAN32__)
+#    define XS_EXTERNAL(name) EXPORT_C XSPROTO(name)
+#    define XS_INTERNAL(name) EXPORT_C STATIC XSPROTO(name)
+#  endif
+#  ifndef XS_EXTERNAL
+#    if defined(HASATTRIBUTE_UNUSED) && !defined(__cplusplus)
+#      define XS_EXTERNAL(name) void name(pTHX_ CV* cv __attribute__unused__)
+#      define XS_INTERNAL(name) STATIC void name(pTHX_ CV* cv __attribute__unused__)
+#    else
+#      ifdef __cplusplus
+#        define XS_EXTERNAL(name) extern "C" XSPROTO(name)
+#        define XS_INTERNAL(name) static XSPROTO(name)
+#      else
+#        define XS_EXTERNAL(name) XSPROTO(name)
+#        define XS_INTERNAL(name) STATIC XSPROTO(name)
+#      endif
+#    endif
+#  endif
+#endif
+
+/* perl >= 5.10.0 && perl <= 5.15.1 */
+
+
+/* The XS_EXTERNAL macro is used for functions that must not be static
+ * like the boot XSUB of a module. If perl didn't have an XS_EXTERNAL
+ * macro defined, the best we can do is assume XS is the same.
+ * Dito for XS_INTERNAL.
+ */
+#ifndef XS_EXTERNAL
+#  define XS_EXTERNAL(name) XS(name)
+#endif
+#ifndef XS_INTERNAL
+#  define XS_INTERNAL(name) XS(name)
+#endif
+
+/* Now, finally, after all this mess, we want an ExtUtils::ParseXS
+ * internal macro that we're free to redefine for varying linkage due
+ * to the EXPORT_XSUB_SYMBOLS XS keyword. This is internal, use
+ * XS_EXTERNAL(name) or XS_INTERNAL(name) in your code if you need to!
+ */
+
+#undef XS_EUPXS
+#if defined(PERL_EUPXS_ALWAYS_EXPORT)
+#  define XS_EUPXS(name) XS_EXTERNAL(name)
+#else
+   /* default to internal */
+#  define XS_EUPXS(name) XS_INTERNAL(name)
+#endif
+
+#ifndef PERL_ARGS_ASSERT_CROAK_XS_USAGE
+#define PERL_ARGS_ASSERT_CROAK_XS_USAGE assert(cv); assert(params)
+
+/* prototype to pass -Wmissing-prototypes */
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params);
+
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params)
+{
+    const GV *const gv = CvGV(cv);
+
+    PERL_ARGS_ASSERT_CROAK_XS_USAGE;
+
+    if (gv) {
+        const char *const gvname = GvNAME(gv);
+        const HV *const stash = GvSTASH(gv);
+        const char *const hvname = stash ? HvNAME(stash) : NULL;
+
+        if (hvname)
+	    Perl_croak_nocontext("Usage: %s::%s(%s)", hvname, gvname, params);
+        else
+	    Perl_croak_nocontext("Usage: %s(%s)", gvname, params);
+    } else {
+        /* Pants. I don't think that it should be possible to get here. */
+	Perl_croak_nocontext("Usage: CODE(0x%" UVxf ")(%s)", PTR2UV(cv), params);
+    }
+}
+#undef  PERL_ARGS_ASSERT_CROAK_XS_USAGE
+
+#define croak_xs_usage        S_croak_xs_usage
+
+#endif
+
+/* NOTE: the prototype of newXSproto() is different in versions of perls,
+ * so we define a portable version of newXSproto()
+ */
+#ifdef newXS_flags
+#define newXSproto_portable(name, c_impl, file, proto) newXS_flags(name, c_impl, file, proto, 0)
+#else
+#define newXSproto_portable(name, c_impl, file, proto) (PL_Sv=(SV*)newXS(name, c_impl, file), sv_setpv(PL_Sv, proto), (CV*)PL_Sv)
+#endif /* !defined(newXS_flags) */
+
+#if PERL_VERSION_LE(5, 21, 5)
+#  define newXS_deffile(a,b) Perl_newXS(aTHX_ a,b,file)
+#else
+#  define newXS_deffile(a,b) Perl_newXS_deffile(aTHX_ a,b)
+#endif
+
+#line 171 "Label.c"
+
+XS_EUPXS(XS_Triceps__Label_CLONE_SKIP); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_CLONE_SKIP)
+{
+    dVAR; dXSARGS;
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+    {
+	int	RETVAL;
+	dXSTARG;
+#line 27 "Label.xs"
+		RETVAL = 1;
+#line 184 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_DESTROY)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::DESTROY(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::DESTROY(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 34 "Label.xs"
+		// warn("Label destroyed!");
+		delete self;
+#line 213 "Label.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__Label_getType); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_getType)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapRowType *	RETVAL;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::getType(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::getType(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 40 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+
+		// for casting of return value
+		static char CLASS[] = "Triceps::RowType";
+		RETVAL = new WrapRowType(const_cast<RowType *>(lab->getType()));
+#line 245 "Label.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_getRowType); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_getRowType)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapRowType *	RETVAL;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::getRowType(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::getRowType(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 54 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+
+		// for casting of return value
+		static char CLASS[] = "Triceps::RowType";
+		RETVAL = new WrapRowType(const_cast<RowType *>(lab->getType()));
+#line 283 "Label.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_getUnit); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_getUnit)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapUnit *	RETVAL;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::getUnit(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::getUnit(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 66 "Label.xs"
+		// for casting of return value
+		static char CLASS[] = "Triceps::Unit";
+		clearErrMsg();
+		RETVAL = NULL; // shut up the compiler
+
+		try { do {
+			Label *lab = self->get();
+			Unit *unit = lab->getUnitPtr();
+
+			if (unit == NULL)
+				throw Exception::f("Triceps::Label::getUnit: label has been already cleared");
+
+			RETVAL = new WrapUnit(unit);
+		} while(0); } TRICEPS_CATCH_CROAK;
+#line 329 "Label.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_chain); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_chain)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, other");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+	WrapLabel *	other;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::chain(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::chain(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		other = (WrapLabel *)SvIV((SV*)SvRV( ST(1) ));
+		if (other == 0 || other->badMagic()) {
+			croakWithMsg( "Triceps::Label::chain(): other has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::chain(): other is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 87 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		Label *olab = other->get();
+
+		try { do {
+			Erref err = lab->chain(olab);
+			if (err->hasError())
+				throw Exception::f(err, "Triceps::Label::chain: failed");
+		} while(0); } TRICEPS_CATCH_CROAK;
+		RETVAL = 1;
+#line 383 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_chainFront); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_chainFront)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, other");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+	WrapLabel *	other;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::chainFront(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::chainFront(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		other = (WrapLabel *)SvIV((SV*)SvRV( ST(1) ));
+		if (other == 0 || other->badMagic()) {
+			croakWithMsg( "Triceps::Label::chainFront(): other has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::chainFront(): other is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 105 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		Label *olab = other->get();
+
+		try { do {
+			Erref err = lab->chain(olab, true);
+			if (err->hasError())
+				throw Exception::f(err, "Triceps::Label::chainFront: failed");
+		} while(0); } TRICEPS_CATCH_CROAK;
+		RETVAL = 1;
+#line 433 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_clearChained); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_clearChained)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::clearChained(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::clearChained(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 121 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		lab->clearChained();
+#line 463 "Label.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__Label_getChain); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_getChain)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	RETVAL;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::getChain(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::getChain(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 129 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+
+		// for casting of return value
+		static char CLASS[] = "Triceps::Label";
+
+		const Label::ChainedVec &cv = lab->getChain();
+		int nf = cv.size();
+		for (int i = 0; i < nf; i++) {
+			WrapLabel *cl = new WrapLabel(cv[i].get());
+
+			SV *sv = newSV(0);
+			sv_setref_pv( sv, CLASS, (void*)cl );
+			XPUSHs(sv_2mortal(sv));
+		}
+#line 506 "Label.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Triceps__Label_hasChained); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_hasChained)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::hasChained(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::hasChained(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 148 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+
+		RETVAL = lab->hasChained()? 1 : 0;
+#line 538 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_getName); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_getName)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	char *	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::getName(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::getName(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 158 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+
+		RETVAL = (char *)lab->getName().c_str();
+#line 571 "Label.c"
+	sv_setpv(TARG, RETVAL);
+	XSprePUSH;
+	PUSHTARG;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_setNonReentrant); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_setNonReentrant)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::setNonReentrant(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::setNonReentrant(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 169 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		lab->setNonReentrant();
+#line 602 "Label.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__Label_same); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_same)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, other");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+	WrapLabel *	other;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::same(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::same(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		other = (WrapLabel *)SvIV((SV*)SvRV( ST(1) ));
+		if (other == 0 || other->badMagic()) {
+			croakWithMsg( "Triceps::Label::same(): other has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::same(): other is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 177 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		Label *olab = other->get();
+		RETVAL = (lab == olab);
+#line 644 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_makeRowop); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_makeRowop)
+{
+    dVAR; dXSARGS;
+    if (items < 3)
+       croak_xs_usage(cv,  "self, opcode, row, ...");
+    {
+	WrapRowop *	RETVAL;
+	WrapLabel *	self;
+	SV *	opcode = ST(1)
+;
+	WrapRow *	row;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::makeRowop(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::makeRowop(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+
+	if( sv_isobject(ST(2)) && (SvTYPE(SvRV(ST(2))) == SVt_PVMG) ) {
+		row = (WrapRow *)SvIV((SV*)SvRV( ST(2) ));
+		if (row == 0 || row->badMagic()) {
+			croakWithMsg( "Triceps::Label::makeRowop(): row has an incorrect magic for WrapRowPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::makeRowop(): row is not a blessed SV reference to WrapRowPtr" );
+	}
+;
+#line 188 "Label.xs"
+		// for casting of return value
+		static char CLASS[] = "Triceps::Rowop";
+
+		static char funcName[] =  "Triceps::Label::makeRowop";
+
+		clearErrMsg();
+		RETVAL = NULL; // shut up the compiler
+
+		try { do {
+			Label *lab = self->get();
+			const RowType *lt = lab->getType();
+			const RowType *rt = row->ref_.getType();
+			Row *r = row->ref_.get();
+
+			if ((lt != rt) && !lt->match(rt)) {
+				throw Exception(strprintf("%s: row types do not match\n  Label:\n    ", funcName)
+						+ lt->print("    ") + "\n  Row:\n    " + rt->print("    "),
+					false
+				);
+			}
+
+			Rowop::Opcode op = parseOpcode(funcName, opcode); // may throw
+
+			Autoref<Rowop> rop;
+			if (items == 3) {
+				rop = new Rowop(lab, op, r);
+			} else if (items == 4) {
+				Gadget::EnqMode em = parseEnqMode(funcName, ST(3)); // may throw
+				rop = new Rowop(lab, op, r, em);
+			} else {
+				throw Exception::f("Usage: %s(label, opcode, row [, enqMode]), received too many arguments", funcName);
+			}
+			RETVAL = new WrapRowop(rop);
+		} while(0); } TRICEPS_CATCH_CROAK;
+#line 719 "Label.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_makeRowopUpdate); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_makeRowopUpdate)
+{
+    dVAR; dXSARGS;
+    if (items != 3)
+       croak_xs_usage(cv,  "self, row, oldRow");
+    {
+	WrapRowop *	RETVAL;
+	WrapLabel *	self;
+	WrapRow *	row;
+	WrapRow *	oldRow;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::makeRowopUpdate(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::makeRowopUpdate(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		row = (WrapRow *)SvIV((SV*)SvRV( ST(1) ));
+		if (row == 0 || row->badMagic()) {
+			croakWithMsg( "Triceps::Label::makeRowopUpdate(): row has an incorrect magic for WrapRowPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::makeRowopUpdate(): row is not a blessed SV reference to WrapRowPtr" );
+	}
+;
+
+	if( sv_isobject(ST(2)) && (SvTYPE(SvRV(ST(2))) == SVt_PVMG) ) {
+		oldRow = (WrapRow *)SvIV((SV*)SvRV( ST(2) ));
+		if (oldRow == 0 || oldRow->badMagic()) {
+			croakWithMsg( "Triceps::Label::makeRowopUpdate(): oldRow has an incorrect magic for WrapRowPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::makeRowopUpdate(): oldRow is not a blessed SV reference to WrapRowPtr" );
+	}
+;
+#line 229 "Label.xs"
+		// for casting of return value
+		static char CLASS[] = "Triceps::Rowop";
+
+		static char funcName[] =  "Triceps::Label::makeRowopUpdate";
+
+		clearErrMsg();
+		RETVAL = NULL; // shut up the compiler
+
+		try { do {
+			Label *lab = self->get();
+			const RowType *lt = lab->getType();
+			WrapRow *rows[2] = { row, oldRow };
+			for (int i = 0; i < 2; i++) {
+				const RowType *rt = rows[i]->ref_.getType();
+				if ((lt != rt) && !lt->match(rt)) {
+					throw Exception(strprintf("%s: row types do not match\n  Label:\n    ", funcName)
+							+ lt->print("    ") + "\n  Row:\n    " + rt->print("    "),
+						false
+					);
+				}
+			}
+
+			Autoref<Rowop> rop = Rowop::makeUpdate(lab, row->ref_.get(), oldRow->ref_.get());
+			RETVAL = new WrapRowop(rop);
+		} while(0); } TRICEPS_CATCH_CROAK;
+#line 798 "Label.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_adopt); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_adopt)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, wrop");
+    {
+	WrapRowop *	RETVAL;
+	WrapLabel *	self;
+	WrapRowop *	wrop;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::adopt(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::adopt(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+
+	if( sv_isobject(ST(1)) && (SvTYPE(SvRV(ST(1))) == SVt_PVMG) ) {
+		wrop = (WrapRowop *)SvIV((SV*)SvRV( ST(1) ));
+		if (wrop == 0 || wrop->badMagic()) {
+			croakWithMsg( "Triceps::Label::adopt(): wrop has an incorrect magic for WrapRowopPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::adopt(): wrop is not a blessed SV reference to WrapRowopPtr" );
+	}
+;
+#line 262 "Label.xs"
+		// for casting of return value
+		static char CLASS[] = "Triceps::Rowop";
+
+		static char funcName[] =  "Triceps::Label::adopt";
+
+		clearErrMsg();
+		RETVAL = NULL; // shut up the compiler
+
+		try { do {
+			Label *lab = self->get();
+			Rowop *orop = wrop->get();
+			const Label *olab = orop->getLabel();
+
+			if (!lab->getType()->match(olab->getType())) {
+				throw Exception(strprintf("%s: row types do not match\n  Label:\n    ", funcName)
+						+ lab->getType()->print("    ") + "\n  Row:\n    " + olab->getType()->print("    "),
+					false
+				);
+			}
+
+			Autoref<Rowop> rop = new Rowop(lab, orop);
+			RETVAL = new WrapRowop(rop);
+		} while(0); } TRICEPS_CATCH_CROAK;
+#line 864 "Label.c"
+	{
+	    SV * RETVALSV;
+	    RETVALSV = sv_newmortal();
+	    sv_setref_pv( RETVALSV, CLASS, (void*)RETVAL );
+	    ST(0) = RETVALSV;
+	}
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_getCode); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_getCode)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	RETVAL;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::getCode(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::getCode(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 294 "Label.xs"
+		clearErrMsg();
+		RETVAL = NULL; // shut up the compiler
+
+		try { do {
+			Label *lab = self->get();
+			PerlLabel *plab = dynamic_cast<PerlLabel *>(lab);
+			if (plab == NULL) {
+				throw Exception::f("Triceps::Label::getCode: label is not a Perl Label, has no Perl code");
+			}
+			SV *code = plab->getCode();
+			if (code == NULL)
+				break; // sets the error in the function
+
+			SV *ret = newSV(0);
+			sv_setsv(ret, code);
+			RETVAL = ret;
+		} while(0); } TRICEPS_CATCH_CROAK;
+#line 913 "Label.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_clear); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_clear)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::clear(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::clear(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 318 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		lab->clear();
+#line 943 "Label.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Triceps__Label_isCleared); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_isCleared)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::isCleared(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::isCleared(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 326 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		RETVAL = lab->isCleared();
+#line 973 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Triceps__Label_isNonReentrant); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Triceps__Label_isNonReentrant)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	int	RETVAL;
+	dXSTARG;
+	WrapLabel *	self;
+
+	if( sv_isobject(ST(0)) && (SvTYPE(SvRV(ST(0))) == SVt_PVMG) ) {
+		self = (WrapLabel *)SvIV((SV*)SvRV( ST(0) ));
+		if (self == 0 || self->badMagic()) {
+			croakWithMsg( "Triceps::Label::isNonReentrant(): self has an incorrect magic for WrapLabelPtr" );
+		}
+	} else{
+		croakWithMsg( "Triceps::Label::isNonReentrant(): self is not a blessed SV reference to WrapLabelPtr" );
+	}
+;
+#line 336 "Label.xs"
+		clearErrMsg();
+		Label *lab = self->get();
+		RETVAL = lab->isNonReentrant();
+#line 1005 "Label.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+XS_EXTERNAL(boot_Triceps__Label); /* prototype to pass -Wmissing-prototypes */
+XS_EXTERNAL(boot_Triceps__Label)
+{
+#if PERL_VERSION_LE(5, 21, 5)
+    dVAR; dXSARGS;
+#else
+    dVAR; dXSBOOTARGSXSAPIVERCHK;
+#endif
+#if PERL_VERSION_LE(5, 8, 999) /* PERL_VERSION_LT is 5.33+ */
+    char* file = __FILE__;
+#else
+    const char* file = __FILE__;
+#endif
+
+    PERL_UNUSED_VAR(file);
+
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+#if PERL_VERSION_LE(5, 21, 5)
+    XS_VERSION_BOOTCHECK;
+#  ifdef XS_APIVERSION_BOOTCHECK
+    XS_APIVERSION_BOOTCHECK;
+#  endif
+#endif
+
+        newXS_deffile("Triceps::Label::CLONE_SKIP", XS_Triceps__Label_CLONE_SKIP);
+        newXS_deffile("Triceps::Label::DESTROY", XS_Triceps__Label_DESTROY);
+        newXS_deffile("Triceps::Label::getType", XS_Triceps__Label_getType);
+        newXS_deffile("Triceps::Label::getRowType", XS_Triceps__Label_getRowType);
+        newXS_deffile("Triceps::Label::getUnit", XS_Triceps__Label_getUnit);
+        newXS_deffile("Triceps::Label::chain", XS_Triceps__Label_chain);
+        newXS_deffile("Triceps::Label::chainFront", XS_Triceps__Label_chainFront);
+        newXS_deffile("Triceps::Label::clearChained", XS_Triceps__Label_clearChained);
+        newXS_deffile("Triceps::Label::getChain", XS_Triceps__Label_getChain);
+        newXS_deffile("Triceps::Label::hasChained", XS_Triceps__Label_hasChained);
+        newXS_deffile("Triceps::Label::getName", XS_Triceps__Label_getName);
+        newXS_deffile("Triceps::Label::setNonReentrant", XS_Triceps__Label_setNonReentrant);
+        newXS_deffile("Triceps::Label::same", XS_Triceps__Label_same);
+        newXS_deffile("Triceps::Label::makeRowop", XS_Triceps__Label_makeRowop);
+        newXS_deffile("Triceps::Label::makeRowopUpdate", XS_Triceps__Label_makeRowopUpdate);
+        newXS_deffile("Triceps::Label::adopt", XS_Triceps__Label_adopt);
+        newXS_deffile("Triceps::Label::getCode", XS_Triceps__Label_getCode);
+        newXS_deffile("Triceps::Label::clear", XS_Triceps__Label_clear);
+        newXS_deffile("Triceps::Label::isCleared", XS_Triceps__Label_isCleared);
+        newXS_deffile("Triceps::Label::isNonReentrant", XS_Triceps__Label_isNonReentrant);
+
+    /* Initialisation Section */
+
+#line 22 "Label.xs"
+// fprintf(stderr, "DEBUG Label items=%d sp=%p mark=%p\n", items, sp, mark);
+
+#line 1066 "Label.c"
+
+    /* End of Initialisation Section */
+
+#if PERL_VERSION_LE(5, 21, 5)
+#  if PERL_VERSION_GE(5, 9, 0)
+    if (PL_unitcheckav)
+        call_list(PL_scopestack_ix, PL_unitcheckav);
+#  endif
+    XSRETURN_YES;
+#else
+    Perl_xs_boot_epilog(aTHX_ ax);
+#endif
+}
+
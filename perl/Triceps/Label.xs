@@ -222,6 +222,38 @@ makeRowop(WrapLabel *self, SV *opcode, WrapRow *row, ...)
 	OUTPUT:
 		RETVAL
 
+#// make an OP_UPDATE rowop that carries both the new and the old row
+WrapRowop *
+makeRowopUpdate(WrapLabel *self, WrapRow *row, WrapRow *oldRow)
+	CODE:
+		// for casting of return value
+		static char CLASS[] = "Triceps::Rowop";
+
+		static char funcName[] =  "Triceps::Label::makeRowopUpdate";
+
+		clearErrMsg();
+		RETVAL = NULL; // shut up the compiler
+
+		try { do {
+			Label *lab = self->get();
+			const RowType *lt = lab->getType();
+			WrapRow *rows[2] = { row, oldRow };
+			for (int i = 0; i < 2; i++) {
+				const RowType *rt = rows[i]->ref_.getType();
+				if ((lt != rt) && !lt->match(rt)) {
+					throw Exception(strprintf("%s: row types do not match\n  Label:\n    ", funcName)
+							+ lt->print("    ") + "\n  Row:\n    " + rt->print("    "),
+						false
+					);
+				}
+			}
+
+			Autoref<Rowop> rop = Rowop::makeUpdate(lab, row->ref_.get(), oldRow->ref_.get());
+			RETVAL = new WrapRowop(rop);
+		} while(0); } TRICEPS_CATCH_CROAK;
+	OUTPUT:
+		RETVAL
+
 #// adopt a rowop from another label (of a matching type) by making
 #// a copy of it for this label
 WrapRowop *
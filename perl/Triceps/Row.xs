@@ -158,6 +158,29 @@ get(WrapRow *self, char *fname)
 			XPUSHs(sv_2mortal(bytesToVal(fld[i].type_->getTypeId(), fld[i].arsz_, notNull, data, dlen, fld[i].name_.c_str())));
 		} while(0); } TRICEPS_CATCH_CROAK;
 
+#// compute the FNV hash of the fields, in the same way as the C++ RowType::hashFields()
+UV
+hashFields(WrapRow *self, ...)
+	CODE:
+		static char funcName[] =  "Triceps::Row::hashFields";
+		RETVAL = 0;
+		try { do {
+			clearErrMsg();
+			const RowType *t = self->ref_.getType();
+
+			vector<int> idx;
+			for (int i = 1; i < items; i++) {
+				const char *fname = SvPV_nolen(ST(i));
+				int n = t->findIdx(fname);
+				if ( n < 0 )
+					throw Exception::f("%s: unknown field '%s'", funcName, fname);
+				idx.push_back(n);
+			}
+			RETVAL = t->hashFields(self->ref_.get(), idx);
+		} while(0); } TRICEPS_CATCH_CROAK;
+	OUTPUT:
+		RETVAL
+
 #// get the type of the row
 WrapRowType*
 getType(WrapRow *self)
@@ -116,6 +116,21 @@ getRow(WrapRowop *self)
 	OUTPUT:
 		RETVAL
 
+#// returns undef if the rowop has no old row (i.e. is not an OP_UPDATE)
+WrapRow *
+getOldRow(WrapRowop *self)
+	CODE:
+		// for casting of return value
+		static char CLASS[] = "Triceps::Row";
+		clearErrMsg();
+		Rowop *rop = self->get();
+		const Row *old = rop->getOldRow();
+		if (old == NULL)
+			XSRETURN_UNDEF;
+		RETVAL = new WrapRow(const_cast<RowType *>(rop->getLabel()->getType()), const_cast<Row *>(old));
+	OUTPUT:
+		RETVAL
+
 int
 getEnqMode(WrapRowop *self)
 	CODE:
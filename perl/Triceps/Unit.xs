@@ -14,6 +14,7 @@
 #include "TricepsPerl.h"
 #include "PerlCallback.h"
 #include "sched/FnReturn.h"
+#include "common/Tsc.h"
 
 MODULE = Triceps::Unit		PACKAGE = Triceps::Unit
 ###################################################################################
@@ -314,6 +315,152 @@ maxRecursionDepth(WrapUnit *self)
 	OUTPUT:
 		RETVAL
 
+#// the label statistics
+void
+setLabelStats(WrapUnit *self, int on)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		u->setLabelStats(on != 0);
+
+int
+isLabelStats(WrapUnit *self)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		RETVAL = u->isLabelStats()? 1 : 0;
+	OUTPUT:
+		RETVAL
+
+void
+setLabelHistograms(WrapUnit *self, int on)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		u->setLabelHistograms(on != 0);
+
+int
+isLabelHistograms(WrapUnit *self)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		RETVAL = u->isLabelHistograms()? 1 : 0;
+	OUTPUT:
+		RETVAL
+
+void
+clearLabelStats(WrapUnit *self)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		u->clearLabelStats();
+
+#// returns the pairs of (label, hash ref of the statistics values);
+#// the times are in nanoseconds, the histogram is an array ref of
+#// the counts in the buckets of the Tsc ticks
+SV *
+getLabelStats(WrapUnit *self)
+	PPCODE:
+		// for casting of return value
+		static char CLASS[] = "Triceps::Label";
+
+		clearErrMsg();
+		Unit *u = self->get();
+		Unit::LabelStatsVec sv;
+		u->getLabelStats(sv);
+		for (Unit::LabelStatsVec::iterator it = sv.begin(); it != sv.end(); ++it) {
+			SV *lab = newSV(0);
+			sv_setref_pv( lab, CLASS, (void*)(new WrapLabel(it->label_)) );
+			XPUSHs(sv_2mortal(lab));
+
+			const LabelStats &st = it->stats_;
+			HV *hash = newHV();
+			hv_store(hash, "calls", 5, newSVuv(st.calls_), 0);
+			hv_store(hash, "rows", 4, newSVuv(st.rows_), 0);
+			hv_store(hash, "totalNs", 7, newSVnv(Tsc::toNs(st.totalTicks_)), 0);
+			hv_store(hash, "selfNs", 6, newSVnv(Tsc::toNs(st.selfTicks_)), 0);
+			hv_store(hash, "exceptions", 10, newSVuv(st.exceptions_), 0);
+			hv_store(hash, "rejects", 7, newSVuv(st.rejects_), 0);
+			hv_store(hash, "maxRecursion", 12, newSViv(st.maxRecursion_), 0);
+			AV *hist = newAV();
+			for (int i = 0; i < LabelStats::HISTOGRAM_SIZE; i++)
+				av_push(hist, newSVuv(st.histogram_[i]));
+			hv_store(hash, "histogram", 9, newRV_noinc((SV *)hist), 0);
+			XPUSHs(sv_2mortal(newRV_noinc((SV *)hash)));
+		}
+
+#// reject a rowop, on behalf of its label
+void
+reject(WrapUnit *self, WrapRowop *wrop, char *msg)
+	CODE:
+		try {
+			clearErrMsg();
+			Unit *u = self->get();
+			Rowop *rop = wrop->get();
+			const Label *lab = rop->getLabel();
+			if (lab->getUnitPtr() != u) {
+				throw Exception::f("Triceps::Unit::reject: the rowop's label '%s' belongs to the unit '%s', not '%s'",
+					lab->getName().c_str(), lab->getUnitName().c_str(), u->getName().c_str());
+			}
+			u->reject(lab, rop, msg);
+		} TRICEPS_CATCH_CROAK;
+
+IV
+getRejectCount(WrapUnit *self)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		RETVAL = u->getRejectCount();
+	OUTPUT:
+		RETVAL
+
+#// returns the list of array refs [label, rowop, message],
+#// the oldest rejection first
+SV *
+getRejects(WrapUnit *self)
+	PPCODE:
+		// for casting of return value
+		static char LABEL_CLASS[] = "Triceps::Label";
+		static char ROWOP_CLASS[] = "Triceps::Rowop";
+
+		clearErrMsg();
+		Unit *u = self->get();
+		const Unit::RejectionDeque &rejects = u->getRejects();
+		for (Unit::RejectionDeque::const_iterator it = rejects.begin(); it != rejects.end(); ++it) {
+			AV *rj = newAV();
+			SV *lab = newSV(0);
+			sv_setref_pv( lab, LABEL_CLASS, (void*)(new WrapLabel(const_cast<Label *>(it->label_.get()))) );
+			av_push(rj, lab);
+			SV *rop = newSV(0);
+			sv_setref_pv( rop, ROWOP_CLASS, (void*)(new WrapRowop(it->rop_)) );
+			av_push(rj, rop);
+			av_push(rj, newSVpvn(it->msg_.c_str(), it->msg_.size()));
+			XPUSHs(sv_2mortal(newRV_noinc((SV *)rj)));
+		}
+
+void
+clearRejects(WrapUnit *self)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		u->clearRejects();
+
+void
+setMaxRejects(WrapUnit *self, int n)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		u->setMaxRejects(n);
+
+int
+getMaxRejects(WrapUnit *self)
+	CODE:
+		clearErrMsg();
+		Unit *u = self->get();
+		RETVAL = u->getMaxRejects();
+	OUTPUT:
+		RETVAL
+
 #// get the empty row type
 WrapRowType *
 getEmptyRowType(WrapUnit *self)
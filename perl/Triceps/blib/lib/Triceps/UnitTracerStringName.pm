@@ -0,0 +1,12 @@
+#
+# (C) Copyright 2011-2014 Sergey A. Babkin.
+# This file is a part of Triceps.
+# See the file COPYRIGHT for the copyright notice and license information
+#
+
+package Triceps::UnitTracerStringName;
+
+our $VERSION = 'v2.0.0';
+
+our @ISA = qw(Triceps::UnitTracer);
+1;
@@ -148,6 +148,7 @@ require Triceps::JoinTwo;
 require Triceps::Triead;
 require Triceps::TrieadOwner;
 require Triceps::App;
+require Triceps::ShardedTable;
 require Triceps::Braced;
 require Triceps::Code;
 # The X subpackages contain the eXperimental, eXample, eXtraneous code.
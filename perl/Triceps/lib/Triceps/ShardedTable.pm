@@ -0,0 +1,258 @@
+#
+# (C) Copyright 2011-2014 Sergey A. Babkin.
+# This file is a part of Triceps.
+# See the file COPYRIGHT for the copyright notice and license information
+#
+# A table split by the key into multiple shards, each owned by its own thread.
+
+package Triceps::ShardedTable;
+
+sub CLONE_SKIP { 1; }
+
+our $VERSION = 'v2.0.0';
+
+use Carp;
+use strict;
+
+# A constructor to create a sharded table. It builds the same topology
+# as the C++ ShardedTable: the rowops get routed by the hash of the key
+# fields to N shard threads, each owning a copy of the table, and the
+# output of all the shards gets merged into one nexus.
+#
+# It must be called in the owner thread before it becomes ready.
+# In this thread it creates:
+#   * the nexuses <name>.in<N>, one per shard, imported for writing,
+#     with the labels "in" (the data for the table) and "lookup"
+#     (the lookup requests);
+#   * the nexus <name>.out with the labels "out" (the output of the tables)
+#     and "lookup" (the lookup results), written by all the shards;
+#   * the input label and the lookup label that route the rowops by the key
+#     to the right shard.
+# Then it starts the shard threads <name>.shard<N>.
+#
+# The rowops for the same key always go to the same shard, and the output
+# of each shard comes in the same order as its input. The lookups are
+# asynchronous: the owning shard sends the found row with OP_INSERT,
+# or the request row with OP_NOP if nothing is found, to the label
+# "lookup" of the output nexus.
+#
+# The arguments are specified as option name-value pairs:
+# owner - the TrieadOwner of the owner thread
+# name - the base name of the nexuses, threads and labels
+# tableType - the table type, will be initialized if not yet
+# key - the key fields that determine the shard, a reference to array of strings
+# shards - number of shards
+# importOutput - flag: import the output nexus into the owner thread for
+#   reading (then it's marked as reverse, since it forms a loop with
+#   the input nexuses), otherwise leave it for the other threads to import;
+#   default: 1
+#
+# Confesses on any error.
+sub new # ($class, $optName => $optValue, ...)
+{
+	my $class = shift;
+	my $self = {};
+
+	&Triceps::Opt::parse($class, $self, {
+		owner => [ undef, sub { &Triceps::Opt::ck_mandatory(@_); &Triceps::Opt::ck_ref(@_, "Triceps::TrieadOwner") } ],
+		name => [ undef, \&Triceps::Opt::ck_mandatory ],
+		tableType => [ undef, sub { &Triceps::Opt::ck_mandatory(@_); &Triceps::Opt::ck_ref(@_, "Triceps::TableType") } ],
+		key => [ undef, sub { &Triceps::Opt::ck_mandatory(@_); &Triceps::Opt::ck_ref(@_, "ARRAY", "") } ],
+		shards => [ undef, \&Triceps::Opt::ck_mandatory ],
+		importOutput => [ 1, undef ],
+	}, @_);
+
+	my $owner = $self->{owner};
+	my $name = $self->{name};
+	my $tt = $self->{tableType};
+	my $nshards = $self->{shards};
+
+	confess "$class: option 'shards' must be at least 1, got '$nshards'"
+		unless ($nshards =~ /^\d+$/ && $nshards >= 1);
+	confess "$class: option 'key' must contain at least one field"
+		unless ($#{$self->{key}} >= 0);
+
+	$tt->initialize() unless ($tt->isInitialized());
+	my $rt = $tt->getRowType();
+	my %fields = $rt->getdef();
+	foreach my $f (@{$self->{key}}) {
+		confess "$class: the key field '$f' is not found in the table's row type:\n" . $rt->print()
+			unless (exists $fields{$f});
+	}
+
+	my $unit = $owner->unit();
+
+	$self->{inputs} = [];
+	for (my $i = 0; $i < $nshards; $i++) {
+		push @{$self->{inputs}}, $owner->makeNexus(
+			name => "$name.in$i",
+			labels => [
+				in => $rt,
+				lookup => $rt,
+			],
+			tableTypes => [
+				table => $tt,
+			],
+			import => "writer",
+		);
+	}
+	$self->{output} = $owner->makeNexus(
+		name => "$name.out",
+		labels => [
+			out => $rt,
+			lookup => $rt,
+		],
+		reverse => ($self->{importOutput}? 1 : 0),
+		import => ($self->{importOutput}? "reader" : "none"),
+	);
+	delete $self->{output} unless ($self->{importOutput});
+
+	# start the threads before creating any closures, to keep them
+	# out of the thread cloning
+	for (my $i = 0; $i < $nshards; $i++) {
+		Triceps::Triead::start(
+			app => $owner->app()->getName(),
+			thread => "$name.shard$i",
+			main => \&shardT,
+			from => $owner->getName(),
+			name => $name,
+			shard => $i,
+		);
+	}
+
+	my @inDest = map { $_->getLabel("in") } @{$self->{inputs}};
+	my @lookupDest = map { $_->getLabel("lookup") } @{$self->{inputs}};
+	my $key = $self->{key};
+	$self->{lbIn} = $unit->makeLabel($rt, "$name.in", undef, sub {
+		my $rop = $_[1];
+		$unit->call($inDest[&shardOfRow($rop->getRow(), $key, $nshards)]->adopt($rop));
+	});
+	$self->{lbLookup} = $unit->makeLabel($rt, "$name.lookup", undef, sub {
+		my $rop = $_[1];
+		$unit->call($lookupDest[&shardOfRow($rop->getRow(), $key, $nshards)]->adopt($rop));
+	});
+
+	delete $self->{owner}; # avoid keeping the reference to the owner
+	bless $self, $class;
+	return $self;
+}
+
+# (internal)
+# Compute the shard of a row. Uses the same hash of the key fields
+# as the C++ ShardedTable, so a row goes to the same shard either way.
+# @param row - the row
+# @param key - reference to the array of the key field names
+# @param nshards - the number of shards
+# @return - the shard index
+sub shardOfRow # ($row, $key, $nshards)
+{
+	my ($row, $key, $nshards) = @_;
+	return $row->hashFields(@$key) % $nshards;
+}
+
+# Compute the shard of a row.
+# @param row - the row of the table's row type
+# @return - the shard index
+sub shardOf # ($self, $row)
+{
+	my ($self, $row) = @_;
+	return &shardOfRow($row, $self->{key}, $self->{shards});
+}
+
+# (internal)
+# The main function of the shard threads.
+sub shardT # (@opts)
+{
+	my $opts = {};
+	&Triceps::Opt::parse("Triceps::ShardedTable::shardT", $opts, {@Triceps::Triead::opts,
+		from => [ undef, \&Triceps::Opt::ck_mandatory ], # owner thread name
+		name => [ undef, \&Triceps::Opt::ck_mandatory ], # the sharded table name
+		shard => [ undef, \&Triceps::Opt::ck_mandatory ], # index of this shard
+	}, @_);
+	undef @_; # avoids a leak in threads module
+	my $owner = $opts->{owner};
+	my $unit = $owner->unit();
+	my $from = $opts->{from};
+	my $name = $opts->{name};
+
+	# the nexuses have been created before this thread has started
+	my $faIn = $owner->importNexus(
+		from => "$from/$name.in" . $opts->{shard},
+		import => "reader",
+		immed => 1,
+	);
+	my $faOut = $owner->importNexus(
+		from => "$from/$name.out",
+		import => "writer",
+		immed => 1,
+	);
+
+	my $tt = $faIn->impTableType("table");
+	$tt->initialize();
+	my $table = $unit->makeTable($tt, "table");
+
+	$faIn->getLabel("in")->chain($table->getInputLabel());
+	$table->getOutputLabel()->chain($faOut->getLabel("out"));
+
+	my $lbLookupRes = $faOut->getLabel("lookup");
+	$faIn->getLabel("lookup")->makeChained("lookup", undef, sub {
+		my $row = $_[1]->getRow();
+		my $rh = $table->find($row);
+		if ($rh->isNull()) {
+			$unit->call($lbLookupRes->makeRowop("OP_NOP", $row));
+		} else {
+			$unit->call($lbLookupRes->makeRowop("OP_INSERT", $rh->getRow()));
+		}
+	});
+
+	$owner->readyReady();
+	$owner->mainLoop();
+}
+
+# Get the label that routes the data into the shard tables.
+sub getInputLabel # ($self)
+{
+	my $self = shift;
+	return $self->{lbIn};
+}
+
+# Get the label that routes the lookup requests to the shards.
+sub getLookupLabel # ($self)
+{
+	my $self = shift;
+	return $self->{lbLookup};
+}
+
+# Get the label with the merged output of the shard tables,
+# undef if the output was not imported.
+sub getOutputLabel # ($self)
+{
+	my $self = shift;
+	return undef unless (defined $self->{output});
+	return $self->{output}->getLabel("out");
+}
+
+# Get the label with the merged lookup results,
+# undef if the output was not imported.
+sub getLookupResultLabel # ($self)
+{
+	my $self = shift;
+	return undef unless (defined $self->{output});
+	return $self->{output}->getLabel("lookup");
+}
+
+# Get the name of the output nexus, for import by the other threads.
+sub getOutputNexusName # ($self)
+{
+	my $self = shift;
+	return $self->{name} . ".out";
+}
+
+# Get the number of shards.
+sub getShardCount # ($self)
+{
+	my $self = shift;
+	return $self->{shards};
+}
+
+1;
@@ -16,7 +16,7 @@
 use ExtUtils::testlib;
 
 use Test;
-BEGIN { plan tests => 78 };
+BEGIN { plan tests => 83 };
 use Triceps;
 ok(1); # If we made it this far, we're ok.
 
@@ -114,6 +114,22 @@ $rempty = $rt1->makeRowHash();
 ok(ref $rempty, "Triceps::Row");
 ok($rempty->isEmpty(), 1);
 
+# hashing of the fields, the FNV-1a of the not-null flag and the data of each field
+sub fnv # (@bytestrings)
+{
+	my $h = 2166136261;
+	foreach my $c (unpack("C*", join("", @_))) {
+		$h = (($h ^ $c) * 16777619) % 4294967296;
+	}
+	return $h;
+}
+ok($r1->hashFields("e"), &fnv("\x01", "string\0"));
+ok($r1->hashFields("a", "e"), &fnv("\x01", "uint8", "\x01", "string\0"));
+ok($r2->hashFields("a", "e"), &fnv("\x00", "\x00"));
+ok($r1->hashFields(), &fnv());
+eval { $r1->hashFields("zz"); };
+ok($@, qr/^Triceps::Row::hashFields: unknown field 'zz'/);
+
 # arrays
 @dataset3 = (
 	a => "uint8",
@@ -15,7 +15,7 @@
 use ExtUtils::testlib;
 
 use Test;
-BEGIN { plan tests => 76 };
+BEGIN { plan tests => 85 };
 use Triceps;
 ok(1); # If we made it this far, we're ok.
 
@@ -155,6 +155,27 @@ ok($rop2->printP(), "tab1.in OP_DELETE a=\"123\" b=\"456\" c=\"3000000000000000\
 eval { $lb->makeRowop("OP_INSERT", $row3, "EM_CALL"); };
 ok($@, qr/^Triceps::Label::makeRowop: row types do not match\n  Label:\n    row {\n      uint8 a,\n      int32 b,\n      int64 c,\n      float64 d,\n      string e,\n    }\n  Row:\n    row {\n      string e,\n      uint8 a,\n      int32 b,\n      int64 c,\n      float64 d,\n    }/);
 
+####
+# the rowops with the old row
+
+ok(!defined $rop1->getOldRow());
+
+$row4 = $rt1->makeRowHash(@dataset1, b => 789);
+$rop = $lb->makeRowopUpdate($row4, $row1);
+ok(ref $rop, "Triceps::Rowop");
+ok($rop->getOpcode(), &Triceps::OP_UPDATE);
+ok($rop->isInsert());
+ok($rop->getRow()->same($row4));
+ok($rop->getOldRow()->same($row1));
+ok(ref $rop->getOldRow()->getType(), "Triceps::RowType");
+
+# a matching row type is OK
+$rop = $lb->makeRowopUpdate($row4, $row2);
+ok($rop->getOldRow()->same($row2));
+
+eval { $lb->makeRowopUpdate($row1, $row3); };
+ok($@, qr/^Triceps::Label::makeRowopUpdate: row types do not match/);
+
 ####
 # convenience factories
 
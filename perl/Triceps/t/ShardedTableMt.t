@@ -0,0 +1,101 @@
+#
+# (C) Copyright 2011-2014 Sergey A. Babkin.
+# This file is a part of Triceps.
+# See the file COPYRIGHT for the copyright notice and license information
+#
+# The test for the table sharded between the threads.
+
+#########################
+
+# change 'tests => 1' to 'tests => last_test_to_print';
+
+use ExtUtils::testlib;
+
+use Test;
+BEGIN { plan tests => 9 };
+use Triceps;
+use Carp;
+ok(1); # If we made it this far, we're ok.
+
+use strict;
+
+#########################
+
+# Insert your test code below, the Test::More module is use()ed here so read
+# its man page ( perldoc Test::More ) for help writing this test script.
+
+#########################
+
+my $rt1 = Triceps::RowType->new(
+	b => "int32",
+	c => "int64",
+);
+ok(ref $rt1, "Triceps::RowType");
+
+{
+	my %out; # output by key
+	my @lookup;
+	my $count = 0;
+
+	Triceps::Triead::startHere(
+		app => "a1",
+		thread => "main",
+		main => sub {
+			my $opts = {};
+			&Triceps::Opt::parse("main main", $opts, {@Triceps::Triead::opts}, @_);
+			my $owner = $opts->{owner};
+			my $app = $owner->app();
+			my $unit = $owner->unit();
+
+			my $tt1 = Triceps::TableType->new($rt1)
+				->addSubIndex("primary",
+					Triceps::IndexType->newHashed(key => [ "b" ])
+				)
+			;
+
+			my $st = Triceps::ShardedTable->new(
+				owner => $owner,
+				name => "st",
+				tableType => $tt1,
+				key => [ "b" ],
+				shards => 3,
+			);
+			ok($st->getShardCount(), 3);
+			ok($st->getOutputNexusName(), "st.out");
+
+			$st->getOutputLabel()->makeChained("collect", undef, sub {
+				my $row = $_[1]->getRow();
+				push @{$out{$row->get("b")}}, &Triceps::opcodeString($_[1]->getOpcode()) . " " . $row->get("c");
+				$count++;
+			});
+			$st->getLookupResultLabel()->makeChained("collectLookup", undef, sub {
+				push @lookup, $_[1]->printP();
+			});
+
+			$owner->readyReady();
+
+			for (my $i = 0; $i < 30; $i++) {
+				$unit->makeHashCall($st->getInputLabel(), "OP_INSERT", b => $i, c => 1);
+			}
+			for (my $i = 0; $i < 30; $i += 2) {
+				$unit->makeHashCall($st->getInputLabel(), "OP_INSERT", b => $i, c => 2);
+			}
+			for (my $i = 0; $i < 30; $i += 3) {
+				$unit->makeHashCall($st->getInputLabel(), "OP_DELETE", b => $i);
+			}
+			$unit->makeHashCall($st->getLookupLabel(), "OP_INSERT", b => 4);
+			$owner->flushWriters();
+
+			# 30 inserts, 15 replacements, 10 deletes, and a lookup
+			while ($count < 30 + 15*2 + 10 || $#lookup < 0) {
+				last unless ($owner->nextXtray());
+			}
+			$app->shutdown();
+		},
+	);
+	ok($count, 70);
+	ok(join(",", @{$out{0}}), "OP_INSERT 1,OP_DELETE 1,OP_INSERT 2,OP_DELETE 2");
+	ok(join(",", @{$out{1}}), "OP_INSERT 1");
+	ok(join(",", @{$out{4}}), "OP_INSERT 1,OP_DELETE 1,OP_INSERT 2");
+	ok(join(",", @lookup), "st.out.lookup OP_INSERT b=\"4\" c=\"2\" ");
+}
@@ -15,7 +15,7 @@
 use ExtUtils::testlib;
 
 use Test;
-BEGIN { plan tests => 170 };
+BEGIN { plan tests => 173 };
 use Triceps;
 ok(1); # If we made it this far, we're ok.
 
@@ -49,7 +49,8 @@ ok(&Triceps::IT_ROOT, 0);
 ok(&Triceps::IT_HASHED, 1);
 ok(&Triceps::IT_FIFO, 2);
 ok(&Triceps::IT_SORTED, 3);
-ok(&Triceps::IT_LAST, 4);
+ok(&Triceps::IT_TOPN, 4);
+ok(&Triceps::IT_LAST, 5);
 
 ok(&Triceps::AO_BEFORE_MOD, 0);
 ok(&Triceps::AO_AFTER_DELETE, 1);
@@ -108,6 +109,7 @@ ok(&Triceps::stringIndexId("IT_ROOT"), &Triceps::IT_ROOT);
 ok(&Triceps::stringIndexId("IT_HASHED"), &Triceps::IT_HASHED);
 ok(&Triceps::stringIndexId("IT_FIFO"), &Triceps::IT_FIFO);
 ok(&Triceps::stringIndexId("IT_SORTED"), &Triceps::IT_SORTED);
+ok(&Triceps::stringIndexId("IT_TOPN"), &Triceps::IT_TOPN);
 ok(&Triceps::stringIndexId("IT_LAST"), &Triceps::IT_LAST);
 ok(eval { &Triceps::stringIndexId("xxx"); }, undef);
 ok($@, qr/^Triceps::stringIndexId: bad index id string 'xxx' at/);
@@ -173,6 +175,7 @@ ok(&Triceps::indexIdString(&Triceps::IT_ROOT), "IT_ROOT");
 ok(&Triceps::indexIdString(&Triceps::IT_HASHED), "IT_HASHED");
 ok(&Triceps::indexIdString(&Triceps::IT_FIFO), "IT_FIFO");
 ok(&Triceps::indexIdString(&Triceps::IT_SORTED), "IT_SORTED");
+ok(&Triceps::indexIdString(&Triceps::IT_TOPN), "IT_TOPN");
 ok(&Triceps::indexIdString(&Triceps::IT_LAST), "IT_LAST");
 ok(eval { &Triceps::indexIdString(999); }, undef);
 ok($@, qr/^Triceps::indexIdString: index id value '999' not defined in the enum at/);
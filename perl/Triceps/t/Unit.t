@@ -15,7 +15,7 @@
 use ExtUtils::testlib;
 
 use Test;
-BEGIN { plan tests => 142 };
+BEGIN { plan tests => 167 };
 use Triceps;
 ok(1); # If we made it this far, we're ok.
 
@@ -457,6 +457,82 @@ Called through the label 'reclab'. at [^\n]*
 $u1->setMaxStackDepth(0);
 $u1->setMaxRecursionDepth(1);
 
+#############################################################
+# Test the label statistics.
+
+{
+	my $s_u = Triceps::Unit->new("s_u");
+	ok(!$s_u->isLabelStats());
+	ok(!$s_u->isLabelHistograms());
+	my $s_lab = $s_u->makeDummyLabel($rt1, "s_lab");
+
+	$s_u->setLabelStats(1);
+	$s_u->setLabelHistograms(1);
+	ok($s_u->isLabelStats());
+	ok($s_u->isLabelHistograms());
+	$s_u->call($s_lab->makeRowop("OP_INSERT", $row1));
+	$s_u->call($s_lab->makeRowop("OP_DELETE", $row1));
+
+	my @stats = $s_u->getLabelStats();
+	ok($#stats, 1);
+	ok($stats[0]->same($s_lab));
+	ok($stats[1]->{calls}, 2);
+	ok($stats[1]->{rows}, 2);
+	ok($stats[1]->{exceptions}, 0);
+	ok($stats[1]->{maxRecursion}, 1);
+	ok($stats[1]->{totalNs} >= $stats[1]->{selfNs});
+	my $hsum = 0;
+	foreach my $h (@{$stats[1]->{histogram}}) {
+		$hsum += $h;
+	}
+	ok($hsum, 2);
+
+	$s_u->clearLabelStats();
+	@stats = $s_u->getLabelStats();
+	ok($#stats, -1);
+	$s_u->setLabelStats(0);
+	ok(!$s_u->isLabelStats());
+}
+
+#############################################################
+# Test the rejection of the rowops.
+
+{
+	my $r_u = Triceps::Unit->new("r_u");
+	ok($r_u->getRejectCount(), 0);
+	ok($r_u->getMaxRejects(), 100);
+	my $r_lab = $r_u->makeLabel($rt1, "r_lab", undef, sub {
+		my ($label, $rop) = @_;
+		$r_u->reject($rop, "deletes are not accepted") if ($rop->isDelete());
+	});
+	my $r_opd = $r_lab->makeRowop("OP_DELETE", $row1);
+	$r_u->call($r_opd);
+	$r_u->call($r_lab->makeRowop("OP_INSERT", $row1));
+	$r_u->call($r_opd);
+	ok($r_u->getRejectCount(), 2);
+
+	my @rejects = $r_u->getRejects();
+	ok($#rejects, 1);
+	ok($rejects[0]->[0]->same($r_lab));
+	ok($rejects[0]->[1]->same($r_opd));
+	ok($rejects[0]->[2], "deletes are not accepted");
+
+	$r_u->setMaxRejects(1);
+	ok($r_u->getMaxRejects(), 1);
+	@rejects = $r_u->getRejects();
+	ok($#rejects, 0);
+
+	$r_u->clearRejects();
+	ok($r_u->getRejectCount(), 0);
+
+	# a rowop of another unit
+	eval {
+		$r_u->reject($dumlab->makeRowop("OP_INSERT", $row1), "msg");
+	};
+	ok($@, qr/^Triceps::Unit::reject: the rowop's label 'dumlab' belongs to the unit 'u1', not 'r_u'/);
+	$r_u->clearLabels();
+}
+
 #############################################################
 # Test the current frame emptiness.
 